@@ -25,6 +25,162 @@
 ******************************************************************************/
 /* `#START ADC_SYS_VAR`  */
 
+/* Analog joystick, X on channel 0 and Y on channel 1.  The SysTick starts a
+*  scan of both channels every millisecond; at the end of the scan the ISR
+*  filters the readings, finds the centre from the first scans after start-up
+*  and then publishes the shaped position.  Joystick_Read() copies it without
+*  ever waiting for a conversion. */
+#include "CyLib.h"
+#include "header01.h"
+
+#define JOYSTICK_CAL_SCANS      (64u)   /* scans averaged for the centre       */
+#define JOYSTICK_IIR_SHIFT      (2u)    /* filter weight of a new reading: 1/4 */
+#define JOYSTICK_DEAD           (64)    /* counts about the centre read as 0   */
+#define JOYSTICK_TOP            (2047)  /* reading at the top of the range     */
+#define JOYSTICK_EDGE           (32)    /* counts at either end read as full   */
+
+static volatile JOYSTICK Joystick_state;
+static volatile uint32 Joystick_seq = 0u;       /* bumped by each new state     */
+static int32 Joystick_filter[2u];               /* readings, 1/16 count         */
+static int32 Joystick_centre[2u];
+static uint32 Joystick_scans = 0u;
+
+static void Joystick_Tick(void);
+static void Joystick_Scan(void);
+static int16 Joystick_Shape(int32 value, int32 centre);
+
+
+/******************************************************************************
+* Function Name: Joystick_Start
+*******************************************************************************
+*
+* Summary:
+*  Start the ADC and scan the joystick every millisecond.  Leave it alone
+*  for the first JOYSTICK_CAL_SCANS ms: that is where its centre is taken
+*  to be.
+*
+******************************************************************************/
+void Joystick_Start(void)
+{
+    Joystick_scans = 0u;
+    Joystick_state.ready = 0u;
+    ADC_Start();
+    CyIntEnable(ADC_INTC_NUMBER);
+    CySysTickStart();
+    (void)CySysTickSetCallback(JOYSTICK_SYSTICK_SLOT, &Joystick_Tick);
+}
+
+/******************************************************************************
+* Function Name: Joystick_Read
+*******************************************************************************
+*
+* Summary:
+*  Copy the latest position.  The ISR cannot be interrupted by the reader,
+*  so a copy that saw no new state start is whole.
+*
+* Parameters:
+*  stick:  Filled in with x and y, -JOYSTICK_MAX .. JOYSTICK_MAX, and
+*          whether the centre has been found yet
+*
+******************************************************************************/
+void Joystick_Read(JOYSTICK *stick)
+{
+    uint32 seq;
+
+    do
+    {
+        seq = Joystick_seq;
+        *stick = Joystick_state;
+    }
+    while(seq != Joystick_seq);
+}
+
+/******************************************************************************
+* Function Name: Joystick_Tick
+*******************************************************************************
+*
+* Summary:
+*  SysTick callback: start the next scan, the last one being long done.
+*
+******************************************************************************/
+static void Joystick_Tick(void)
+{
+    ADC_SAR_START_CTRL_REG = ADC_FW_TRIGGER;
+}
+
+/******************************************************************************
+* Function Name: Joystick_Scan
+*******************************************************************************
+*
+* Summary:
+*  End of a scan, from the ISR: filter both channels, and calibrate or
+*  publish.
+*
+******************************************************************************/
+static void Joystick_Scan(void)
+{
+    uint32 chan;
+    int32 raw;
+
+    for(chan = 0u; chan < 2u; chan++)
+    {
+        raw = (int32)ADC_GetResult16(chan) * 16;
+        if(Joystick_scans == 0u)
+        {
+            Joystick_filter[chan] = raw;
+            Joystick_centre[chan] = 0;
+        }
+        Joystick_filter[chan] += (raw - Joystick_filter[chan]) / (1 << JOYSTICK_IIR_SHIFT);
+    }
+
+    if(Joystick_scans < JOYSTICK_CAL_SCANS)
+    {
+        Joystick_centre[0u] += Joystick_filter[0u];
+        Joystick_centre[1u] += Joystick_filter[1u];
+        Joystick_scans++;
+        if(Joystick_scans == JOYSTICK_CAL_SCANS)
+        {
+            Joystick_centre[0u] /= (int32)JOYSTICK_CAL_SCANS;
+            Joystick_centre[1u] /= (int32)JOYSTICK_CAL_SCANS;
+            Joystick_state.ready = 1u;
+        }
+        return;
+    }
+
+    Joystick_state.x = Joystick_Shape(Joystick_filter[0u], Joystick_centre[0u]);
+    Joystick_state.y = Joystick_Shape(Joystick_filter[1u], Joystick_centre[1u]);
+    Joystick_seq++;
+}
+
+/******************************************************************************
+* Function Name: Joystick_Shape
+*******************************************************************************
+*
+* Summary:
+*  A filtered reading as a position: nothing within the dead zone, full
+*  scale at either end of the range, however far off middle the centre
+*  is, and half linear, half square in between for fine control near the
+*  centre.
+*
+******************************************************************************/
+static int16 Joystick_Shape(int32 value, int32 centre)
+{
+    int32 d = (value - centre) / 16;
+    int32 span = (d > 0) ? (JOYSTICK_TOP - (centre / 16)) : (centre / 16);
+    int32 m;
+
+    m = ((d < 0) ? -d : d) - JOYSTICK_DEAD;
+    span -= JOYSTICK_DEAD + JOYSTICK_EDGE;
+    if((m <= 0) || (span <= 0))
+    {
+        return (0);
+    }
+    m = (m * JOYSTICK_MAX) / span;
+    m = (m > JOYSTICK_MAX) ? JOYSTICK_MAX : m;
+    m = ((m * m) + (m * JOYSTICK_MAX)) / (2 * JOYSTICK_MAX);
+    return ((int16)((d < 0) ? -m : m));
+}
+
 /* `#END`  */
 
 #if(ADC_IRQ_REMOVE == 0u)
@@ -59,7 +215,10 @@
         *  - add user ISR code between the following #START and #END tags
         *************************************************************************/
         /* `#START MAIN_ADC_ISR`  */
-
+        if((intr_status & ADC_EOS_MASK) != 0u)
+        {
+            Joystick_Scan();
+        }
         /* `#END`  */
 
         /* Clear handled interrupt */
@@ -35,6 +35,20 @@
 #define GLCD_SPIM_UDB_TYPE    0u 
 #define GLCD_SPIM_SCB_TYPE    1u 
 
+/* Depth of the transmit queue in 9-bit words (2 bytes RAM each), used when */
+/* the SPIM has its TX interrupt.  Must be a power of two.                  */
+#if !defined(GLCD_TX_QUEUE_SIZE)
+#define GLCD_TX_QUEUE_SIZE      128u
+#endif
+
+/* Set to 1 to keep a shadow of the display memory: a bit per pixel and an  */
+/* ink color per 8x8 block, 2822 bytes of RAM.  Pixels and spans that would */
+/* not change the screen are then not sent, and GLCD_GetPixel()     */
+/* can read the screen back.                                                */
+#if !defined(GLCD_SHADOW)
+#define GLCD_SHADOW             0u
+#endif
+
 
 /*******************************************************
 *				Function Prototypes                    
@@ -48,12 +62,43 @@ void GLCD_Contrast(int32 setting);
 
 void GLCD_Pixel(int32 x, int32 y, int32 color );
 void GLCD_DrawCircle (int32 x, int32 y, int32 radius, int32 color);
+void GLCD_FillCircle(int32 x, int32 y, int32 radius, int32 color);
+void GLCD_FillSector(int32 x, int32 y, int32 radius, int32 startAngle, int32 endAngle, int32 color);
 
 void GLCD_PrintChar(uint8 c, int32 x, int32 y, int32 fColor, int32 bColor);
 void GLCD_PrintString(char *pString, int32 x, int32 y, int32 fColor, int32 bColor);
 
 void GLCD_DrawLine(int32 x0, int32 y0, int32 x1, int32 y1, int32 color);
 void GLCD_DrawRect(int32 x0, int32 y0, int32 x1, int32 y1, int32 fill, int32 color);
+void GLCD_DrawHLine(int32 x, int32 y0, int32 y1, int32 color);
+void GLCD_DrawVLine(int32 x0, int32 x1, int32 y, int32 color);
+
+/* Clip rectangle for the drawing functions above */
+void GLCD_SetClip(int32 x0, int32 y0, int32 x1, int32 y1);
+void GLCD_ClearClip(void);
+void GLCD_GetClip(int32 *x0, int32 *y0, int32 *x1, int32 *y1);
+
+/* Streaming window writes: address a rectangle once, then push pixels. */
+void GLCD_SetWindow(int32 x0, int32 y0, int32 x1, int32 y1);
+void GLCD_WritePixels(const uint16 *colors, uint32 n);
+void GLCD_FillWindow(int32 color, uint32 n);
+void GLCD_WriteIndexed(const uint8 *indices, uint32 n);
+const uint16 *GLCD_BlitRLE(int32 x0, int32 y0, int32 x1, int32 y1, const uint16 *rle);
+void   GLCD_SetScan(uint32 order);
+uint32 GLCD_GetScan(void);
+
+/* Pixel format and the 8-bit palette */
+void   GLCD_SetColorMode(uint32 mode);
+uint32 GLCD_GetColorMode(void);
+void   GLCD_SetPalette(const uint8 *palette);
+int32  GLCD_PaletteColor(uint32 index);
+
+/* Fixed-point trig.  Angles are in 1/GLCD_TRIG_STEPS degree steps (use  */
+/* GLCD_DEG() to convert from degrees), 0 along +y and 90 degrees along  */
+/* +x.  Results are Q1.15, 32767 = 1.0.                                     */
+int32 GLCD_SinQ15(int32 angle);
+int32 GLCD_CosQ15(int32 angle);
+void  GLCD_PolarToXY(int32 x0, int32 y0, int32 radius, int32 angle, int32 *x, int32 *y);
 
 /* Low level commands used by the normal commands.  */
 void  GLCD_Command(uint32 datacmd);
@@ -61,11 +106,55 @@ void  GLCD_Data(uint32 datadt);
 int32 GLCD_SwapColors(int32 in);
 void  GLCD_On(void);
 void  GLCD_Off(void);
+void  GLCD_Invert(uint32 on);
+int32 GLCD_GetContrast(void);
+
+/* Hardware vertical scroll */
+void  GLCD_ScrollSetArea(int32 x0, int32 x1);
+int32 GLCD_ScrollTo(int32 offset);
+int32 GLCD_ScrollRamRow(int32 x);
+
+/* Timed screen effects, see GLCD_Effects.c */
+void   GLCD_FlashInvert(uint32 ticks);
+void   GLCD_FadeContrast(int32 target, uint32 ticks, uint32 returnTicks);
+void   GLCD_Blank(uint32 ticks);
+uint32 GLCD_EffectTick(void);
+
+/* Transmit queue */
+void   GLCD_Flush(void);
+uint32 GLCD_TxQueueDepth(void);
+uint32 GLCD_TxQueueHighWater(void);
+void   GLCD_TxQueueResetHighWater(void);
+uint32 GLCD_BytesSent(void);
+
+/* Address window cache: PAGEADDR/COLADDR commands skipped and sent */
+uint32 GLCD_WindowCacheHits(void);
+uint32 GLCD_WindowCacheMisses(void);
+void   GLCD_WindowCacheResetStats(void);
+
+#if (GLCD_SHADOW != 0u)
+/* Shadow of the display memory */
+int32  GLCD_GetPixel(int32 x, int32 y);
+uint32 GLCD_ShadowSkipped(void);
+#endif
 
 
 const uint8 GLCD_FONT8x16[97][16];
 
 
+/*******************************************************
+*                Fixed-Point Trig Definitions
+********************************************************/
+#define GLCD_TRIG_STEPS       4u     /* Table entries per degree; must match GLCD_Trig.c */
+#define GLCD_TRIG_QUADRANT    (90u * GLCD_TRIG_STEPS)
+#define GLCD_TRIG_CIRCLE      (360u * GLCD_TRIG_STEPS)
+#define GLCD_DEG(degrees)     ((degrees) * (int32)GLCD_TRIG_STEPS)
+#define GLCD_Q15_ONE          32767
+
+/* One quadrant of sin(), generated into GLCD_Trig.c at build time */
+extern const int16 GLCD_SIN_TABLE[GLCD_TRIG_QUADRANT + 1u];
+
+
 /********************************************************************
 *                                                                  
 *					LCD Dimension Definitions                       
@@ -130,6 +219,9 @@ const uint8 GLCD_FONT8x16[97][16];
 #define GLCD_COMSCN      0xBB	/* Common scan direction      */
 #define GLCD_DISCTL      0xCA	/* Display control            */
 #define GLCD_DATCTL      0xBC	/* Data scan direction, etc.  */
+#define GLCD_DATCTL_PINV  0x01	/* DATCTL 1st byte: page address inverse   */
+#define GLCD_DATCTL_CINV  0x02	/*   column address inverse                */
+#define GLCD_DATCTL_PSCAN 0x04	/*   page address steps first              */
 #define GLCD_RGBSET8     0xCE	/* 256-color position set     */
 #define GLCD_RAMRD       0x5D	/* Reading from memory        */
 #define GLCD_PTLIN       0xA8	/* Partial display in         */
@@ -162,7 +254,12 @@ const uint8 GLCD_FONT8x16[97][16];
 #define	GLCD_NORON		0x13	/* Normal display mode on          */
 #define GLCD_RGBSET	    0x2D	/* Color set                       */
 #define	GLCD_MADCTL		0x36	/* Memory data access control      */
+#define GLCD_MADCTL_MY   0x80	/*   mirror page addresses         */
+#define GLCD_MADCTL_MX   0x40	/*   mirror column addresses       */
+#define GLCD_MADCTL_V    0x20	/*   page address steps first      */
 #define	GLCD_COLMOD		0x3A	/* Interface pixel format          */
+#define GLCD_VSCRDEF     0x33	/* Vertical scrolling definition   */
+#define GLCD_VSCRSADD    0x37	/* Vertical scrolling start address */
 #define GLCD_DISCTR     0xB9	/* Super frame inversion           */
 #define	GLCD_EC			0xC0	/* Internal or external oscillator */
 
@@ -198,6 +295,397 @@ const uint8 GLCD_FONT8x16[97][16];
 #define GLCD_YELLOW		0xFF0
 #define GLCD_WHITE		0xFFF
 
+/*******************************************************
+*				Run-Length Encoded Images
+********************************************************/
+
+/* Words of an image for GLCD_BlitRLE(), n from 1 to 32767 */
+#define GLCD_RLE_RUN(n)     ((uint16)(0x8000u | (n)))   /* then one color, n times */
+#define GLCD_RLE_COPY(n)    ((uint16)(n))               /* then n colors           */
+
+/*******************************************************
+*				Window Fill Order
+********************************************************/
+
+/* Window fill orders for GLCD_SetScan() */
+#define GLCD_SCAN_ROWS      0u  /* along a row (y), then the next row    */
+#define GLCD_SCAN_COLUMNS   1u  /* down a column (x), then the next one  */
+
+/*******************************************************
+*				8-Bit Color Definitions
+********************************************************/
+
+/* Modes for GLCD_SetColorMode(), in bits per pixel */
+#define GLCD_COLOR_12BIT    12u
+#define GLCD_COLOR_8BIT     8u
+
+/* Palette levels: 8 red, 8 green, 4 blue */
+#define GLCD_PALETTE_SIZE   20u
+
+/* Linear ramps, loaded by Start */
+extern const uint8 GLCD_DEFAULT_PALETTE[GLCD_PALETTE_SIZE];
+
+/* A color argument with this bit set is an RRRGGGBB palette index. */
+/* Any drawing function accepts one, in either color mode.           */
+#define GLCD_INDEXED        0x1000
+#define GLCD_INDEX(index)   (GLCD_INDEXED | ((int32)(index) & 0xFF))
+
+
+/*******************************************************
+*				Color Slot Animation
+********************************************************/
+
+/* Animated color slots (about 16 bytes of RAM each), at most 32 */
+#if !defined(GLCD_ANIM_SLOTS)
+#define GLCD_ANIM_SLOTS     8u
+#endif
+#define GLCD_ANIM_CYCLES    2u      /* slot ranges that can cycle at once */
+
+/* A color argument with this bit set takes the current color of a slot. */
+#define GLCD_SLOTTED        0x2000
+#define GLCD_SLOT(slot)     (GLCD_SLOTTED | ((int32)(slot) & 0xFF))
+
+/* What a slot does after its last key */
+#define GLCD_ANIM_ONCE      0u      /* hold the last key       */
+#define GLCD_ANIM_LOOP      1u      /* go on to the first key  */
+#define GLCD_ANIM_PINGPONG  2u      /* play the keys backwards */
+
+/* How a slot moves between keys */
+#define GLCD_CURVE_STEP     0u      /* jump at the next key    */
+#define GLCD_CURVE_LINEAR   1u
+#define GLCD_CURVE_EASE     2u      /* slow in, slow out       */
+
+typedef struct
+{
+    uint16 color;       /* 12-bit color                              */
+    uint16 ticks;       /* ticks taken to reach the following key    */
+} GLCD_ANIM_KEY;
+
+/* Defined in GLCD_Anim.c */
+void   GLCD_AnimSetColor(uint32 slot, int32 color);
+void   GLCD_AnimSetKeys(uint32 slot, const GLCD_ANIM_KEY *keys, uint32 count, uint32 mode, uint32 curve);
+void   GLCD_AnimCycle(uint32 range, uint32 first, uint32 count, uint32 ticks);
+uint32 GLCD_AnimTick(void);
+int32  GLCD_AnimColor(uint32 slot);
+
+
+/*******************************************************
+*				Tile Layer
+********************************************************/
+
+/* 8x8 tiles covering the screen; the last row and column are cut to 4    */
+/* pixels.  The map takes a byte per tile of RAM, the images are in flash. */
+#define GLCD_TILE_SIZE      8u
+#define GLCD_TILE_ROWS      17u     /* down the screen (x)     */
+#define GLCD_TILE_COLS      17u     /* across the screen (y)   */
+#define GLCD_TILE_BYTES     (GLCD_TILE_SIZE * GLCD_TILE_SIZE)
+
+/* Map entry for a place the layer leaves alone */
+#define GLCD_TILE_NONE      0xFFu
+
+/* Defined in GLCD_Tile.c */
+void   GLCD_TileSetGraphics(const uint8 *graphics);
+void   GLCD_TileSet(uint32 row, uint32 col, uint32 tile);
+uint32 GLCD_TileGet(uint32 row, uint32 col);
+int32  GLCD_TilePixel(int32 x, int32 y);
+void   GLCD_TileFill(uint32 tile);
+void   GLCD_TileInvalidate(int32 x0, int32 y0, int32 x1, int32 y1);
+uint32 GLCD_TileFlush(void);
+
+
+/*******************************************************
+*				Sprite Layer
+********************************************************/
+
+/* Sprites over the background and tiles, about 20 bytes of RAM each */
+#if !defined(GLCD_SPRITES)
+#define GLCD_SPRITES        4u
+#endif
+
+/* Sprite flag: tiles are drawn in front of the sprite */
+#define GLCD_SPRITE_BEHIND  0x01u
+
+/* Sprite image in flash: height rows of width RRRGGGBB indices, top row */
+/* first; pixels equal to key are see-through.                           */
+typedef struct
+{
+    uint8 width;                /* columns (y)             */
+    uint8 height;               /* rows (x)                */
+    uint8 key;
+    const uint8 *pixels;
+} GLCD_SPRITE_IMAGE;
+
+/* What lies under the sprites: fills colors[0 .. y1 - y0] for row x */
+typedef void (*GLCD_BACKGROUND_ROW)(int32 x, int32 y0, int32 y1, uint16 *colors);
+
+/* Defined in GLCD_Sprite.c */
+void   GLCD_SpriteSetBackground(GLCD_BACKGROUND_ROW background);
+void   GLCD_SpriteShow(uint32 n, const GLCD_SPRITE_IMAGE *image, int32 x, int32 y, uint32 flags);
+void   GLCD_SpriteMove(uint32 n, int32 x, int32 y);
+void   GLCD_SpriteHide(uint32 n);
+void   GLCD_SpriteInvalidate(int32 x0, int32 y0, int32 x1, int32 y1);
+uint32 GLCD_SpriteFlush(void);
+void   GLCD_ComposeBackground(int32 x, int32 y0, int32 y1, uint16 *colors);
+void   GLCD_ComposeLayers(int32 x, int32 y0, int32 y1, uint16 *colors);
+
+
+/*******************************************************
+*				Band Renderer
+********************************************************/
+
+/* Rows of the RAM band, 2 bytes a pixel: 1 row of 132 takes 264 bytes.   */
+/* A narrower area fits more of its rows in the band, so a box up to 66   */
+/* wide still renders 2 rows at a time.  Raise it on parts with RAM spare. */
+#if !defined(GLCD_BAND_ROWS)
+#define GLCD_BAND_ROWS      1u
+#endif
+#define GLCD_BAND_PIXELS    (GLCD_BAND_ROWS * GLCD_ROW_LENGTH)
+
+/* Shapes queued for one render, 12 bytes of RAM each */
+#if !defined(GLCD_BAND_SHAPES)
+#define GLCD_BAND_SHAPES    8u
+#endif
+
+/* Defined in GLCD_Band.c */
+uint32 GLCD_BandRect(int32 x0, int32 y0, int32 x1, int32 y1, int32 color);
+uint32 GLCD_BandDisc(int32 x0, int32 y0, int32 radius, int32 color);
+uint32 GLCD_BandRing(int32 x0, int32 y0, int32 radius, int32 width, int32 color);
+uint32 GLCD_BandRender(int32 x0, int32 y0, int32 x1, int32 y1);
+
+
+/*******************************************************
+*				Display List
+********************************************************/
+
+/* Pixels and fills recorded per frame, 6 bytes of RAM each.  A full list */
+/* is played out early and recording goes on.                             */
+#if !defined(GLCD_LIST_SIZE)
+#define GLCD_LIST_SIZE      32u
+#endif
+
+/* What the last frame cost */
+typedef struct
+{
+    uint16 recorded;            /* pixels and fills recorded                */
+    uint16 culled;              /* hidden by a later one, never sent        */
+    uint16 merged;              /* sent through a window opened for another */
+    uint16 windows;             /* windows opened                           */
+    uint32 bytes;               /* bytes sent playing the list out          */
+} GLCD_FRAME_STATS;
+
+/* Non-zero between GLCD_BeginFrame() and GLCD_EndFrame() */
+extern uint8 GLCD_recording;
+
+/* Defined in GLCD_List.c */
+void   GLCD_BeginFrame(void);
+void   GLCD_EndFrame(void);
+const GLCD_FRAME_STATS *GLCD_FrameStats(void);
+uint32 GLCD_ListRecord(int32 x0, int32 y0, int32 x1, int32 y1, int32 color);
+void   GLCD_ListPlay(void);
+
+
+/*******************************************************
+*				Game Loop
+********************************************************/
+
+/* SysTick callback slot the loop takes, of CY_SYS_SYST_NUM_OF_CALLBACKS */
+#if !defined(GLCD_LOOP_SYSTICK_SLOT)
+#define GLCD_LOOP_SYSTICK_SLOT  0u
+#endif
+
+/* Most updates run in one pass; ticks later than that are dropped */
+#if !defined(GLCD_LOOP_MAX_UPDATES)
+#define GLCD_LOOP_MAX_UPDATES   4u
+#endif
+
+/* Most renders skipped in a row to catch up */
+#if !defined(GLCD_LOOP_MAX_SKIPS)
+#define GLCD_LOOP_MAX_SKIPS     3u
+#endif
+
+/* The game.  render() gets how far time is from the last tick to the     */
+/* next, 0 to 255, to draw moving things between their tick positions.    */
+typedef struct
+{
+    void (*input)(void);        /* once a pass, before the updates */
+    void (*update)(void);       /* once a tick, or NULL            */
+    void (*render)(uint32 alpha);
+} GLCD_GAME;
+
+/* Where the time of the last pass went, and totals */
+typedef struct
+{
+    uint32 updateUs;            /* input and updates                      */
+    uint32 renderUs;            /* render, 0 when skipped                 */
+    uint32 idleUs;              /* asleep waiting for a tick              */
+    uint16 updates;             /* updates run                            */
+    uint16 renders;             /* total renders                          */
+    uint16 skipped;             /* total renders skipped to catch up      */
+    uint16 dropped;             /* total ticks dropped, the game slowed   */
+} GLCD_LOOP_STATS;
+
+/* Defined in GLCD_Loop.c */
+void   GLCD_LoopStart(uint32 hz);
+void   GLCD_LoopStep(const GLCD_GAME *game);
+const GLCD_LOOP_STATS *GLCD_LoopStats(void);
+uint32 GLCD_LoopTicks(void);
+uint32 GLCD_LoopMicros(void);
+
+
+/*******************************************************
+*				Cooperative Tasks
+********************************************************/
+
+/* Tasks that can run at once, 16 bytes of RAM each */
+#if !defined(GLCD_TASK_MAX)
+#define GLCD_TASK_MAX       4u
+#endif
+
+/* What a task function returns */
+#define GLCD_TASK_WAITING   0u      /* run it again            */
+#define GLCD_TASK_DONE      1u      /* remove it               */
+
+typedef struct GLCD_TASK_S GLCD_TASK;
+typedef uint32 (*GLCD_TASK_FUNC)(GLCD_TASK *task);
+
+/* A task table entry.  Locals of a task function are lost when it yields; */
+/* x, y and n are kept.                                                     */
+struct GLCD_TASK_S
+{
+    GLCD_TASK_FUNC run;     /* NULL for a free entry        */
+    uint32 wake;                        /* loop tick to sleep until     */
+    uint16 line;                        /* where to carry on            */
+    int16  x, y;                        /* start arguments              */
+    int16  n;                           /* the task's own counter       */
+};
+
+/* Protothread macros for the body of a task function.  The body goes      */
+/* between BEGIN and END and must not use switch itself round a yield.     */
+#define GLCD_TASK_BEGIN(t)  switch((t)->line) { case 0u:
+
+#define GLCD_TASK_YIELD(t)  \
+    do { (t)->line = (uint16)__LINE__; return (GLCD_TASK_WAITING); case __LINE__: ; } while(0)
+
+/* Yield for ticks game loop ticks, at least one slice */
+#define GLCD_TASK_SLEEP(t, ticks)   \
+    do { (t)->wake = GLCD_LoopTicks() + (uint32)(ticks); GLCD_TASK_YIELD(t); } while(0)
+
+/* Yield until cond holds */
+#define GLCD_TASK_WAIT(t, cond)     \
+    do { while(!(cond)) { GLCD_TASK_YIELD(t); } } while(0)
+
+#define GLCD_TASK_END(t)    } (t)->line = 0u; return (GLCD_TASK_DONE)
+
+/* Defined in GLCD_Task.c */
+int32  GLCD_TaskStart(GLCD_TASK_FUNC run, int32 x, int32 y);
+void   GLCD_TaskStop(int32 task);
+uint32 GLCD_TaskRunning(GLCD_TASK_FUNC run);
+uint32 GLCD_TaskRun(void);
+
+
+/*******************************************************
+*				Timers
+********************************************************/
+
+/* SysTick callback slot the timers take */
+#if !defined(GLCD_TIMER_SYSTICK_SLOT)
+#define GLCD_TIMER_SYSTICK_SLOT 1u
+#endif
+
+/* Slots in the timer wheel, a power of 2, 4 bytes of RAM each.  Each   */
+/* millisecond looks through the timers of one slot.                    */
+#if !defined(GLCD_TIMER_SLOTS)
+#define GLCD_TIMER_SLOTS    8u
+#endif
+
+typedef struct GLCD_TIMER_S GLCD_TIMER;
+typedef void (*GLCD_TIMER_FUNC)(GLCD_TIMER *timer);
+
+/* A timer, owned by the caller; only the timer functions touch it */
+struct GLCD_TIMER_S
+{
+    GLCD_TIMER *next;       /* in a wheel slot or the due list */
+    GLCD_TIMER *prev;
+    uint32 expires;                     /* GLCD_TimerNow() to fire at */
+    uint32 period;                      /* ms, 0 for once only             */
+    GLCD_TIMER_FUNC func;
+    uint8  list;                        /* the list it is on               */
+    uint8  state;
+};
+
+/* Defined in GLCD_Timer.c */
+void   GLCD_TimerStart(void);
+uint32 GLCD_TimerNow(void);
+void   GLCD_TimerArm(GLCD_TIMER *timer, uint32 delay, uint32 period, GLCD_TIMER_FUNC func);
+void   GLCD_TimerCancel(GLCD_TIMER *timer);
+uint32 GLCD_TimerArmed(const GLCD_TIMER *timer);
+uint32 GLCD_TimerService(void);
+
+
+/*******************************************************
+*				Buttons
+********************************************************/
+
+/* SysTick callback slot the buttons take */
+#if !defined(GLCD_INPUT_SYSTICK_SLOT)
+#define GLCD_INPUT_SYSTICK_SLOT 2u
+#endif
+
+/* Most buttons, 8 bytes of RAM each, and events queued, a power of 2, */
+/* 4 bytes each                                                         */
+#if !defined(GLCD_INPUT_MAX)
+#define GLCD_INPUT_MAX        6u
+#endif
+#if !defined(GLCD_INPUT_QUEUE)
+#define GLCD_INPUT_QUEUE      8u
+#endif
+
+/* Milliseconds a pin must be quiet after an edge, a button down before */
+/* the held event, and between repeats after that                       */
+#if !defined(GLCD_INPUT_DEBOUNCE_MS)
+#define GLCD_INPUT_DEBOUNCE_MS    5u
+#endif
+#if !defined(GLCD_INPUT_HOLD_MS)
+#define GLCD_INPUT_HOLD_MS        500u
+#endif
+#if !defined(GLCD_INPUT_REPEAT_MS)
+#define GLCD_INPUT_REPEAT_MS      100u
+#endif
+
+/* Event types */
+#define GLCD_INPUT_PRESSED    0u
+#define GLCD_INPUT_RELEASED   1u
+#define GLCD_INPUT_HELD       2u      /* down for the hold time        */
+#define GLCD_INPUT_REPEAT     3u      /* still down, every repeat time */
+
+/* A button pin: its port registers, from cyfitter.h */
+typedef struct
+{
+    reg32 *ps;                  /* pin state              */
+    reg32 *intcfg;              /* interrupt edge select  */
+    reg32 *intstat;             /* interrupt status       */
+    uint8  shift;               /* pin number in the port */
+    uint8  irq;                 /* port interrupt number  */
+} GLCD_INPUT_PIN;
+
+/* Table entry for a Pins component.  The GPIO port interrupts of the    */
+/* PSoC 4100/4200 are interrupts 0 to 4, one for each port.              */
+#define GLCD_INPUT_PIN_INIT(pin)  \
+    { (reg32 *)(pin##__PS), (reg32 *)(pin##__INTCFG), (reg32 *)(pin##__INTSTAT), (uint8)(pin##__SHIFT), (uint8)(pin##__PORT) }
+
+typedef struct
+{
+    uint16 time;                /* ms: when pressed or released, at the first edge */
+    uint8  button;              /* place in the pin table                          */
+    uint8  type;
+} GLCD_INPUT_EVENT;
+
+/* Defined in GLCD_Input.c */
+void   GLCD_InputStart(const GLCD_INPUT_PIN *pins, uint32 count);
+uint32 GLCD_InputRead(GLCD_INPUT_EVENT *event);
+uint32 GLCD_InputHeld(void);
+uint32 GLCD_InputLost(void);
+
 
 
 /*******************************************************
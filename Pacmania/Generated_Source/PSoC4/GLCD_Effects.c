@@ -0,0 +1,177 @@
+/*******************************************************************************
+* File Name: GLCD_Effects.c
+* Version 0.3
+*
+*  Description:
+*    Whole-screen effects done by the controller instead of by repainting:
+*    an inversion flash, a contrast fade down and back up, and blanking.
+*    Each is started with a few bytes of commands and then timed by
+*    GLCD_EffectTick(), called once per frame or from a periodic
+*    tick, so drawing can carry on while the effect runs.
+*
+********************************************************************************/
+
+#include "cytypes.h"
+#include "GLCD.h"
+
+typedef struct
+{
+    uint16 invertLeft;          /* ticks until the inversion flash ends    */
+    uint16 blankLeft;           /* ticks until the display comes back on   */
+    uint32 fadePhase;           /* 0 idle, 1 towards target, 2 returning   */
+    int32  fadeFrom;
+    int32  fadeTo;
+    int32  fadeBase;            /* contrast to return to                    */
+    uint16 fadeTicks;           /* length of the current phase              */
+    uint16 fadeElapsed;
+    uint16 returnTicks;         /* length of the return phase, 0 for none   */
+} GLCD_EFFECTS;
+
+static GLCD_EFFECTS GLCD_effects;
+
+
+/*******************************************************************************
+* Function Name: GLCD_FlashInvert
+********************************************************************************
+*
+* Summary:
+*  Invert the whole display now and put it back after ticks ticks.
+*  Starting a flash while one is running just extends it.
+*
+* Parameters:
+*  ticks:  Length of the flash in GLCD_EffectTick() calls
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_FlashInvert(uint32 ticks)
+{
+    if(GLCD_effects.invertLeft == 0u)
+    {
+        GLCD_Invert(1u);
+    }
+    GLCD_effects.invertLeft = (uint16)((ticks != 0u) ? ticks : 1u);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_FadeContrast
+********************************************************************************
+*
+* Summary:
+*  Move the contrast in steps from its current setting to target over ticks
+*  ticks, then back again over returnTicks ticks.  Fading towards a low
+*  setting darkens the screen, towards a high one washes it out.  Only
+*  steps that change the setting are sent, a few bytes each.
+*
+* Parameters:
+*  target:       Contrast setting to fade to, as for GLCD_Contrast()
+*  ticks:        Ticks to get there
+*  returnTicks:  Ticks to come back, or 0 to stay at target
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_FadeContrast(int32 target, uint32 ticks, uint32 returnTicks)
+{
+    GLCD_EFFECTS *e = &GLCD_effects;
+
+    if(e->fadePhase == 0u)
+    {
+        e->fadeBase = GLCD_GetContrast();
+    }
+    e->fadeFrom = GLCD_GetContrast();
+    e->fadeTo = target;
+    e->fadeTicks = (uint16)((ticks != 0u) ? ticks : 1u);
+    e->fadeElapsed = 0u;
+    e->returnTicks = (uint16)returnTicks;
+    e->fadePhase = 1u;
+}
+
+/*******************************************************************************
+* Function Name: GLCD_Blank
+********************************************************************************
+*
+* Summary:
+*  Turn the display off, keeping its contents, and back on after ticks
+*  ticks.  Drawing done meanwhile appears all at once when it comes back.
+*
+* Parameters:
+*  ticks:  Ticks to stay blank, or 0 to stay blank until GLCD_On()
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_Blank(uint32 ticks)
+{
+    GLCD_Off();
+    GLCD_effects.blankLeft = (uint16)ticks;
+}
+
+/*******************************************************************************
+* Function Name: GLCD_EffectTick
+********************************************************************************
+*
+* Summary:
+*  Advance the running screen effects by one tick.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Non-zero while any effect is still running.
+*
+*******************************************************************************/
+uint32 GLCD_EffectTick(void)
+{
+    GLCD_EFFECTS *e = &GLCD_effects;
+    int32 level;
+
+    if(e->invertLeft != 0u)
+    {
+        if(--e->invertLeft == 0u)
+        {
+            GLCD_Invert(0u);
+        }
+    }
+
+    if(e->blankLeft != 0u)
+    {
+        if(--e->blankLeft == 0u)
+        {
+            GLCD_On();
+        }
+    }
+
+    if(e->fadePhase != 0u)
+    {
+        e->fadeElapsed++;
+        level = e->fadeFrom + (((e->fadeTo - e->fadeFrom) * (int32)e->fadeElapsed) / (int32)e->fadeTicks);
+        if(level != GLCD_GetContrast())
+        {
+            GLCD_Contrast(level);
+        }
+
+        if(e->fadeElapsed >= e->fadeTicks)
+        {
+            if((e->fadePhase == 1u) && (e->returnTicks != 0u))
+            {
+                e->fadePhase = 2u;
+                e->fadeFrom = e->fadeTo;
+                e->fadeTo = e->fadeBase;
+                e->fadeTicks = e->returnTicks;
+                e->fadeElapsed = 0u;
+            }
+            else
+            {
+                e->fadePhase = 0u;
+            }
+        }
+    }
+
+    return (((e->invertLeft | e->blankLeft) != 0u) || (e->fadePhase != 0u)) ? 1u : 0u;
+}
+
+/* [] END OF FILE */
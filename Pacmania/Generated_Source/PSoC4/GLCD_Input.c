@@ -0,0 +1,290 @@
+/*******************************************************************************
+* File Name: GLCD_Input.c
+* Version 0.3
+*
+*  Description:
+*    Buttons on GPIO interrupts.  A port interrupt notes the time of each
+*    edge of a button pin; once the pin has been quiet for the debounce time
+*    the SysTick callback takes its level, and if that changed queues a
+*    pressed or released event stamped with the first edge.  A button kept
+*    down gives a held event, then repeats.  The queue has one writer, the
+*    SysTick interrupt, and one reader, the main loop, so it needs no lock.
+*
+*    Presses are caught however long the main loop takes over a frame, and
+*    their times are the times of the presses.
+*
+********************************************************************************/
+
+#include <stddef.h>
+#include "cytypes.h"
+#include "CyLib.h"
+#include "GLCD.h"
+
+#define GLCD_INPUT_F_DOWN      0x01u   /* debounced level: pressed      */
+#define GLCD_INPUT_F_PENDING   0x02u   /* edges since the last look     */
+#define GLCD_INPUT_F_HELD      0x04u   /* held event given              */
+#define GLCD_INPUT_F_QUIET     0x08u   /* down from the start, no events */
+
+#if((GLCD_INPUT_QUEUE & (GLCD_INPUT_QUEUE - 1u)) != 0u)
+    #error GLCD_INPUT_QUEUE must be a power of 2
+#endif
+
+typedef struct
+{
+    uint16 firstEdge;           /* first edge of a change                    */
+    uint16 lastEdge;            /* the latest edge, for the debounce time    */
+    uint16 next;                /* when the next held or repeat event is due */
+    uint8  flags;
+} GLCD_INPUT_STATE;
+
+static const GLCD_INPUT_PIN *GLCD_inputPins = NULL;
+static uint32 GLCD_inputCount = 0u;
+static GLCD_INPUT_STATE GLCD_inputState[GLCD_INPUT_MAX];
+static volatile uint16 GLCD_inputNow = 0u;
+
+static GLCD_INPUT_EVENT GLCD_inputQueue[GLCD_INPUT_QUEUE];
+static volatile uint8 GLCD_inputHead = 0u;     /* written by the SysTick interrupt */
+static volatile uint8 GLCD_inputTail = 0u;     /* written by the main loop        */
+static volatile uint16 GLCD_inputLost = 0u;
+
+static void GLCD_InputTick(void);
+static void GLCD_InputPush(uint32 button, uint32 type, uint16 time);
+static CY_ISR_PROTO(GLCD_InputIsr);
+
+
+/*******************************************************************************
+* Function Name: GLCD_InputStart
+********************************************************************************
+*
+* Summary:
+*  Watch the button pins: each pin interrupts on both edges, and its port
+*  interrupt is pointed at the input handler.  Buttons are numbered in the
+*  order of the table, pressed when the pin reads 0.  Starts the SysTick
+*  timer at 1 ms if it is not running already.
+*
+* Parameters:
+*  pins:   Table of pins, made with GLCD_INPUT_PIN_INIT(); it is
+*          kept, not copied
+*  count:  Number of pins, up to GLCD_INPUT_MAX
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_InputStart(const GLCD_INPUT_PIN *pins, uint32 count)
+{
+    const GLCD_INPUT_PIN *pin;
+    uint32 i;
+    uint8 intr;
+
+    count = (count > GLCD_INPUT_MAX) ? GLCD_INPUT_MAX : count;
+
+    intr = CyEnterCriticalSection();
+    GLCD_inputPins = pins;
+    GLCD_inputCount = count;
+    for(i = 0u; i < count; i++)
+    {
+        pin = &pins[i];
+        GLCD_inputState[i].flags = ((*pin->ps & (1u << pin->shift)) == 0u) ?
+                                               (GLCD_INPUT_F_DOWN | GLCD_INPUT_F_QUIET) : 0u;
+        *pin->intcfg = (*pin->intcfg & ~(3u << (pin->shift * 2u))) | (3u << (pin->shift * 2u));
+        *pin->intstat = (1u << pin->shift);
+        (void)CyIntSetVector(pin->irq, &GLCD_InputIsr);
+        CyIntEnable(pin->irq);
+    }
+    CyExitCriticalSection(intr);
+
+    CySysTickStart();
+    (void)CySysTickSetCallback(GLCD_INPUT_SYSTICK_SLOT, &GLCD_InputTick);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_InputRead
+********************************************************************************
+*
+* Summary:
+*  Take the oldest event off the queue.
+*
+* Parameters:
+*  event:  Filled in with the event
+*
+* Return:
+*  1 if there was one, 0 if the queue is empty
+*
+*******************************************************************************/
+uint32 GLCD_InputRead(GLCD_INPUT_EVENT *event)
+{
+    uint8 tail = GLCD_inputTail;
+
+    if(tail == GLCD_inputHead)
+    {
+        return (0u);
+    }
+    *event = GLCD_inputQueue[tail];
+    GLCD_inputTail = (uint8)((tail + 1u) & (GLCD_INPUT_QUEUE - 1u));
+    return (1u);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_InputHeld
+********************************************************************************
+*
+* Summary:
+*  The buttons down now, debounced.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Bit n set while button n is down
+*
+*******************************************************************************/
+uint32 GLCD_InputHeld(void)
+{
+    uint32 held = 0u;
+    uint32 i;
+
+    for(i = 0u; i < GLCD_inputCount; i++)
+    {
+        if((GLCD_inputState[i].flags & GLCD_INPUT_F_DOWN) != 0u)
+        {
+            held |= (1u << i);
+        }
+    }
+    return (held);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_InputLost
+********************************************************************************
+*
+* Summary:
+*  Events dropped because the queue was full.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Number of events lost since the start
+*
+*******************************************************************************/
+uint32 GLCD_InputLost(void)
+{
+    return (GLCD_inputLost);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_InputIsr
+********************************************************************************
+*
+* Summary:
+*  Port interrupt for the button pins: clears their interrupts and notes
+*  the time of the edges.
+*
+*******************************************************************************/
+static CY_ISR(GLCD_InputIsr)
+{
+    const GLCD_INPUT_PIN *pin;
+    GLCD_INPUT_STATE *st;
+    uint16 now = GLCD_inputNow;
+    uint32 i;
+
+    for(i = 0u; i < GLCD_inputCount; i++)
+    {
+        pin = &GLCD_inputPins[i];
+        if((*pin->intstat & (1u << pin->shift)) != 0u)
+        {
+            *pin->intstat = (1u << pin->shift);
+            st = &GLCD_inputState[i];
+            if((st->flags & GLCD_INPUT_F_PENDING) == 0u)
+            {
+                st->firstEdge = now;
+                st->flags |= GLCD_INPUT_F_PENDING;
+            }
+            st->lastEdge = now;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: GLCD_InputTick
+********************************************************************************
+*
+* Summary:
+*  SysTick callback, every millisecond.  Takes the level of the pins that
+*  have been quiet for the debounce time since an edge, and gives held and
+*  repeat events for the buttons kept down.
+*
+*******************************************************************************/
+static void GLCD_InputTick(void)
+{
+    GLCD_INPUT_STATE *st;
+    const GLCD_INPUT_PIN *pin;
+    uint16 now = GLCD_inputNow + 1u;
+    uint32 down;
+    uint32 i;
+    uint8 intr;
+
+    GLCD_inputNow = now;
+    for(i = 0u; i < GLCD_inputCount; i++)
+    {
+        st = &GLCD_inputState[i];
+        pin = &GLCD_inputPins[i];
+
+        /* The port interrupt may come in between */
+        intr = CyEnterCriticalSection();
+        if(((st->flags & GLCD_INPUT_F_PENDING) != 0u) &&
+           ((uint16)(now - st->lastEdge) >= GLCD_INPUT_DEBOUNCE_MS))
+        {
+            st->flags &= (uint8)~GLCD_INPUT_F_PENDING;
+            down = ((*pin->ps & (1u << pin->shift)) == 0u) ? GLCD_INPUT_F_DOWN : 0u;
+            if(down != (st->flags & GLCD_INPUT_F_DOWN))
+            {
+                st->flags &= (uint8)~(GLCD_INPUT_F_DOWN | GLCD_INPUT_F_HELD | GLCD_INPUT_F_QUIET);
+                st->flags |= (uint8)down;
+                st->next = st->firstEdge + GLCD_INPUT_HOLD_MS;
+                GLCD_InputPush(i, (down != 0u) ? GLCD_INPUT_PRESSED : GLCD_INPUT_RELEASED,
+                                           st->firstEdge);
+            }
+        }
+
+        /* Held down since a press, and no edge since */
+        if(((st->flags & (GLCD_INPUT_F_DOWN | GLCD_INPUT_F_PENDING | GLCD_INPUT_F_QUIET)) == GLCD_INPUT_F_DOWN) &&
+           ((int16)(now - st->next) >= 0))
+        {
+            GLCD_InputPush(i, ((st->flags & GLCD_INPUT_F_HELD) == 0u) ?
+                                       GLCD_INPUT_HELD : GLCD_INPUT_REPEAT, now);
+            st->flags |= GLCD_INPUT_F_HELD;
+            st->next = now + GLCD_INPUT_REPEAT_MS;
+        }
+        CyExitCriticalSection(intr);
+    }
+}
+
+/*******************************************************************************
+* Function Name: GLCD_InputPush
+********************************************************************************
+*
+* Summary:
+*  Put an event on the queue, or count it lost if the queue is full.
+*
+*******************************************************************************/
+static void GLCD_InputPush(uint32 button, uint32 type, uint16 time)
+{
+    GLCD_INPUT_EVENT *e;
+    uint8 head = GLCD_inputHead;
+    uint8 next = (uint8)((head + 1u) & (GLCD_INPUT_QUEUE - 1u));
+
+    if(next == GLCD_inputTail)
+    {
+        GLCD_inputLost++;
+        return;
+    }
+    e = &GLCD_inputQueue[head];
+    e->time = time;
+    e->button = (uint8)button;
+    e->type = (uint8)type;
+    GLCD_inputHead = next;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,316 @@
+/*******************************************************************************
+* File Name: GLCD_List.c
+* Version 0.3
+*
+*  Description:
+*    Display list.  Between GLCD_BeginFrame() and
+*    GLCD_EndFrame() pixels and filled spans and rectangles,
+*    whichever drawing call made them, are recorded instead of sent.  At the
+*    end of the frame the list is played out: anything a later entry covers
+*    completely is dropped, the rest is put in screen order where that does
+*    not change what overlaps what, and neighbours on a row go out through
+*    one window.
+*
+*    Window streams (GLCD_SetWindow() and what uses it: text,
+*    tiles, sprites, the band) cannot be recorded; the list so far is played
+*    out before them so that everything still lands in the order drawn.
+*
+********************************************************************************/
+
+#include "cytypes.h"
+#include "GLCD.h"
+
+typedef struct
+{
+    uint8  x0, y0;              /* corners, on the screen, x0 <= x1, y0 <= y1 */
+    uint8  x1, y1;
+    uint16 color;
+} GLCD_LIST_ENTRY;
+
+uint8 GLCD_recording = 0u;
+
+static GLCD_LIST_ENTRY GLCD_list[GLCD_LIST_SIZE];
+static uint32 GLCD_listCount = 0u;
+
+static GLCD_FRAME_STATS GLCD_frame;
+static GLCD_FRAME_STATS GLCD_lastFrame;
+
+static void GLCD_ListSort(void);
+
+
+/*******************************************************************************
+* Function Name: GLCD_BeginFrame
+********************************************************************************
+*
+* Summary:
+*  Start recording a frame.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_BeginFrame(void)
+{
+    GLCD_ListPlay();
+    GLCD_frame.recorded = 0u;
+    GLCD_frame.culled = 0u;
+    GLCD_frame.merged = 0u;
+    GLCD_frame.windows = 0u;
+    GLCD_frame.bytes = 0u;
+    GLCD_recording = 1u;
+}
+
+/*******************************************************************************
+* Function Name: GLCD_EndFrame
+********************************************************************************
+*
+* Summary:
+*  Play out what was recorded and stop recording.  Its cost is then given
+*  by GLCD_FrameStats().
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_EndFrame(void)
+{
+    GLCD_ListPlay();
+    GLCD_recording = 0u;
+    GLCD_lastFrame = GLCD_frame;
+}
+
+/*******************************************************************************
+* Function Name: GLCD_FrameStats
+********************************************************************************
+*
+* Summary:
+*  What the last frame recorded and sent.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Counts for the frame ended by the last GLCD_EndFrame()
+*
+*******************************************************************************/
+const GLCD_FRAME_STATS *GLCD_FrameStats(void)
+{
+    return (&GLCD_lastFrame);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_ListRecord
+********************************************************************************
+*
+* Summary:
+*  Record a filled rectangle, called by the drawing functions while a frame
+*  is being recorded.  The part off the screen is dropped, and so are the
+*  entries already recorded that it covers completely.  When the list is
+*  full it is played out first.
+*
+* Parameters:
+*  x0, y0:  One corner
+*  x1, y1:  The opposite corner (inclusive)
+*  color:   Fill color
+*
+* Return:
+*  1 when recorded, 0 when not recording
+*
+*******************************************************************************/
+uint32 GLCD_ListRecord(int32 x0, int32 y0, int32 x1, int32 y1, int32 color)
+{
+    GLCD_LIST_ENTRY *e;
+    int32 tmp;
+    uint32 i;
+    uint32 kept = 0u;
+
+    if(GLCD_recording == 0u)
+    {
+        return (0u);
+    }
+
+    if(x0 > x1)
+    {
+        tmp = x0; x0 = x1; x1 = tmp;
+    }
+    if(y0 > y1)
+    {
+        tmp = y0; y0 = y1; y1 = tmp;
+    }
+    x0 = (x0 < (int32)GLCD_MINX) ? (int32)GLCD_MINX : x0;
+    y0 = (y0 < (int32)GLCD_MINY) ? (int32)GLCD_MINY : y0;
+    x1 = (x1 > (int32)GLCD_MAXX) ? (int32)GLCD_MAXX : x1;
+    y1 = (y1 > (int32)GLCD_MAXY) ? (int32)GLCD_MAXY : y1;
+    if((x0 > x1) || (y0 > y1))
+    {
+        return (1u);
+    }
+
+    for(i = 0u; i < GLCD_listCount; i++)
+    {
+        e = &GLCD_list[i];
+        if(((int32)e->x0 >= x0) && ((int32)e->x1 <= x1) && ((int32)e->y0 >= y0) && ((int32)e->y1 <= y1))
+        {
+            GLCD_frame.culled++;
+        }
+        else
+        {
+            GLCD_list[kept++] = *e;
+        }
+    }
+    GLCD_listCount = kept;
+
+    if(GLCD_listCount >= GLCD_LIST_SIZE)
+    {
+        GLCD_ListPlay();
+    }
+    e = &GLCD_list[GLCD_listCount++];
+    e->x0 = (uint8)x0;
+    e->y0 = (uint8)y0;
+    e->x1 = (uint8)x1;
+    e->y1 = (uint8)y1;
+    e->color = (uint16)color;
+    GLCD_frame.recorded++;
+    return (1u);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_ListPlay
+********************************************************************************
+*
+* Summary:
+*  Send the entries recorded so far and empty the list; recording goes on.
+*  Single-row entries that follow on along a row share one window, each
+*  streaming its own color.  Same-colored rectangles stacked over the same
+*  columns are sent as one.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_ListPlay(void)
+{
+    const GLCD_LIST_ENTRY *e;
+    const GLCD_LIST_ENTRY *next;
+    uint32 bytes;
+    uint32 n;
+    uint32 i, k, m;
+    int32 end;
+
+    if(GLCD_listCount == 0u)
+    {
+        return;
+    }
+    GLCD_recording = 0u;
+    bytes = GLCD_BytesSent();
+
+    n = GLCD_listCount;
+    GLCD_ListSort();
+
+    for(i = 0u; i < n; i = k)
+    {
+        e = &GLCD_list[i];
+        k = i + 1u;
+
+        /* A run along one row */
+        end = e->y1;
+        if(e->x0 == e->x1)
+        {
+            for( ; k < n; k++)
+            {
+                next = &GLCD_list[k];
+                if((next->x0 != e->x0) || (next->x1 != e->x0) || ((int32)next->y0 != (end + 1)))
+                {
+                    break;
+                }
+                end = next->y1;
+            }
+        }
+        if(k > (i + 1u))
+        {
+            GLCD_SetScan(GLCD_SCAN_ROWS);
+            GLCD_SetWindow(e->x0, e->y0, e->x0, end);
+            for(m = i; m < k; m++)
+            {
+                next = &GLCD_list[m];
+                GLCD_FillWindow((int32)next->color, ((uint32)next->y1 - next->y0) + 1u);
+            }
+        }
+        else
+        {
+            /* Or the same color over the same columns, row after row */
+            end = e->x1;
+            for( ; k < n; k++)
+            {
+                next = &GLCD_list[k];
+                if((next->color != e->color) || (next->y0 != e->y0) || (next->y1 != e->y1) ||
+                   ((int32)next->x0 != (end + 1)))
+                {
+                    break;
+                }
+                end = next->x1;
+            }
+            if(((int32)e->x0 == end) && (e->y0 == e->y1))
+            {
+                GLCD_Pixel(e->x0, e->y0, (int32)e->color);
+            }
+            else
+            {
+                GLCD_DrawRect(e->x0, e->y0, end, e->y1, 1, (int32)e->color);
+            }
+        }
+        GLCD_frame.merged += (uint16)((k - i) - 1u);
+        GLCD_frame.windows++;
+    }
+
+    GLCD_listCount = 0u;
+    GLCD_frame.bytes += GLCD_BytesSent() - bytes;
+    GLCD_recording = 1u;
+}
+
+/*******************************************************************************
+* Function Name: GLCD_ListSort
+********************************************************************************
+*
+* Summary:
+*  Put the entries in screen order, by row and then column.  An entry is
+*  never moved ahead of one it overlaps, so overlapping entries are still
+*  drawn in the order they were recorded.
+*
+*******************************************************************************/
+static void GLCD_ListSort(void)
+{
+    GLCD_LIST_ENTRY e;
+    const GLCD_LIST_ENTRY *prev;
+    uint32 i, j;
+
+    for(i = 1u; i < GLCD_listCount; i++)
+    {
+        e = GLCD_list[i];
+        for(j = i; j > 0u; j--)
+        {
+            prev = &GLCD_list[j - 1u];
+            if((prev->x0 < e.x0) || ((prev->x0 == e.x0) && (prev->y0 <= e.y0)))
+            {
+                break;
+            }
+            if((prev->x0 <= e.x1) && (prev->x1 >= e.x0) && (prev->y0 <= e.y1) && (prev->y1 >= e.y0))
+            {
+                break;
+            }
+            GLCD_list[j] = *prev;
+        }
+        GLCD_list[j] = e;
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,299 @@
+/*******************************************************************************
+* File Name: GLCD_Tile.c
+* Version 0.3
+*
+*  Description:
+*    Background tile layer.  The screen is covered by a map of 8x8 tiles,
+*    one byte each, whose images are RRRGGGBB palette indices kept in flash.
+*    There is no frame buffer: changing a map entry only marks the tile
+*    dirty, and GLCD_TileFlush() sends the dirty tiles, a run of
+*    neighbouring tiles in a row at a time through one address window.
+*    Map entries set to GLCD_TILE_NONE are not part of the
+*    layer and are never drawn, so other drawing shows there.
+*
+********************************************************************************/
+
+#include <stddef.h>
+#include "cytypes.h"
+#include "GLCD.h"
+
+#if (GLCD_TILE_COLS > 32u)
+    #error "a row of tiles must fit the 32-bit dirty mask"
+#endif
+
+#define GLCD_TILE_ALL   ((uint32)((1uL << GLCD_TILE_COLS) - 1uL))
+
+typedef struct
+{
+    const uint8 *graphics;                          /* NULL: nothing to draw */
+    uint8  map[GLCD_TILE_ROWS][GLCD_TILE_COLS];
+    uint32 dirty[GLCD_TILE_ROWS];       /* bit c: tile (r, c)     */
+} GLCD_TILE_LAYER;
+
+static GLCD_TILE_LAYER GLCD_tiles;
+
+
+/*******************************************************************************
+* Function Name: GLCD_TileSetGraphics
+********************************************************************************
+*
+* Summary:
+*  Give the layer its tile images and mark the whole map to be drawn.
+*
+* Parameters:
+*  graphics:  GLCD_TILE_BYTES bytes per tile, tile 0 first; each
+*             tile is 8 rows of 8 RRRGGGBB indices, top row first
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_TileSetGraphics(const uint8 *graphics)
+{
+    GLCD_tiles.graphics = graphics;
+    GLCD_TileInvalidate(GLCD_MINX, GLCD_MINY, GLCD_MAXX, GLCD_MAXY);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_TileSet
+********************************************************************************
+*
+* Summary:
+*  Put a tile in the map.  The tile is marked dirty only if it changes.
+*
+* Parameters:
+*  row:   Tile row, 0 .. GLCD_TILE_ROWS - 1, covering screen rows
+*         8 * row to 8 * row + 7
+*  col:   Tile column, 0 .. GLCD_TILE_COLS - 1
+*  tile:  Tile number, or GLCD_TILE_NONE
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_TileSet(uint32 row, uint32 col, uint32 tile)
+{
+    if((row < GLCD_TILE_ROWS) && (col < GLCD_TILE_COLS) &&
+       (GLCD_tiles.map[row][col] != (uint8)tile))
+    {
+        GLCD_tiles.map[row][col] = (uint8)tile;
+        GLCD_tiles.dirty[row] |= (uint32)1u << col;
+    }
+}
+
+/*******************************************************************************
+* Function Name: GLCD_TileGet
+********************************************************************************
+*
+* Summary:
+*  The tile at a place in the map.
+*
+* Parameters:
+*  row, col:  Tile row and column
+*
+* Return:
+*  Tile number, or GLCD_TILE_NONE off the map
+*
+*******************************************************************************/
+uint32 GLCD_TileGet(uint32 row, uint32 col)
+{
+    uint32 tile = GLCD_TILE_NONE;
+
+    if((row < GLCD_TILE_ROWS) && (col < GLCD_TILE_COLS))
+    {
+        tile = GLCD_tiles.map[row][col];
+    }
+    return (tile);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_TilePixel
+********************************************************************************
+*
+* Summary:
+*  The color the tile layer has at a pixel, for drawing other layers over it.
+*
+* Parameters:
+*  x, y:  Pixel
+*
+* Return:
+*  GLCD_INDEX() color, or -1 where the layer has no tile
+*
+*******************************************************************************/
+int32 GLCD_TilePixel(int32 x, int32 y)
+{
+    uint32 tile;
+    int32 color = -1;
+
+    if((GLCD_tiles.graphics != NULL) && (x >= 0) && (y >= 0))
+    {
+        tile = GLCD_TileGet((uint32)x / GLCD_TILE_SIZE, (uint32)y / GLCD_TILE_SIZE);
+        if(tile != GLCD_TILE_NONE)
+        {
+            color = GLCD_INDEX(GLCD_tiles.graphics[(tile * GLCD_TILE_BYTES) +
+                ((((uint32)x % GLCD_TILE_SIZE) * GLCD_TILE_SIZE) + ((uint32)y % GLCD_TILE_SIZE))]);
+        }
+    }
+    return (color);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_TileFill
+********************************************************************************
+*
+* Summary:
+*  Set every map entry to one tile and mark them all dirty.
+*
+* Parameters:
+*  tile:  Tile number, or GLCD_TILE_NONE to empty the layer
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_TileFill(uint32 tile)
+{
+    uint32 r;
+    uint32 c;
+
+    for(r = 0u; r < GLCD_TILE_ROWS; r++)
+    {
+        for(c = 0u; c < GLCD_TILE_COLS; c++)
+        {
+            GLCD_tiles.map[r][c] = (uint8)tile;
+        }
+        GLCD_tiles.dirty[r] = GLCD_TILE_ALL;
+    }
+}
+
+/*******************************************************************************
+* Function Name: GLCD_TileInvalidate
+********************************************************************************
+*
+* Summary:
+*  Mark the tiles under a rectangle of the screen dirty, e.g. after drawing
+*  over them, so that the next flush puts the background back.
+*
+* Parameters:
+*  x0, y0:  One corner of the rectangle
+*  x1, y1:  The opposite corner (inclusive); parts off the screen are ignored
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_TileInvalidate(int32 x0, int32 y0, int32 x1, int32 y1)
+{
+    int32 tmp;
+    uint32 mask;
+
+    if(x0 > x1)
+    {
+        tmp = x0; x0 = x1; x1 = tmp;
+    }
+    if(y0 > y1)
+    {
+        tmp = y0; y0 = y1; y1 = tmp;
+    }
+    if((x1 < (int32)GLCD_MINX) || (x0 > (int32)GLCD_MAXX) ||
+       (y1 < (int32)GLCD_MINY) || (y0 > (int32)GLCD_MAXY))
+    {
+        return;
+    }
+    x0 = (x0 < (int32)GLCD_MINX) ? (int32)GLCD_MINX : x0;
+    y0 = (y0 < (int32)GLCD_MINY) ? (int32)GLCD_MINY : y0;
+    x1 = (x1 > (int32)GLCD_MAXX) ? (int32)GLCD_MAXX : x1;
+    y1 = (y1 > (int32)GLCD_MAXY) ? (int32)GLCD_MAXY : y1;
+
+    /* Columns y0 / 8 .. y1 / 8 */
+    mask = ((uint32)2u << (y1 / (int32)GLCD_TILE_SIZE)) - ((uint32)1u << (y0 / (int32)GLCD_TILE_SIZE));
+    for(tmp = x0 / (int32)GLCD_TILE_SIZE; tmp <= (x1 / (int32)GLCD_TILE_SIZE); tmp++)
+    {
+        GLCD_tiles.dirty[tmp] |= mask;
+    }
+}
+
+/*******************************************************************************
+* Function Name: GLCD_TileFlush
+********************************************************************************
+*
+* Summary:
+*  Draw the dirty tiles and mark them clean.  Neighbouring dirty tiles in a
+*  row are sent through one window, row by row across all of them, and the
+*  tiles on the bottom and right edges are cut to the screen.  Sprites the
+*  tiles were drawn over are marked to be drawn again.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Number of tiles drawn
+*
+*******************************************************************************/
+uint32 GLCD_TileFlush(void)
+{
+    const uint8 *pRow;
+    uint32 r, c, c0, c1;
+    uint32 bits;
+    uint32 drawn = 0u;
+    int32 x0, x1, y1;
+    int32 i;
+
+    if(GLCD_tiles.graphics == NULL)
+    {
+        return (0u);
+    }
+    GLCD_SetScan(GLCD_SCAN_ROWS);
+
+    for(r = 0u; r < GLCD_TILE_ROWS; r++)
+    {
+        bits = GLCD_tiles.dirty[r];
+        GLCD_tiles.dirty[r] = 0u;
+
+        /* Leave out tiles that are not part of the layer */
+        for(c = 0u; c < GLCD_TILE_COLS; c++)
+        {
+            if(GLCD_tiles.map[r][c] == GLCD_TILE_NONE)
+            {
+                bits &= ~((uint32)1u << c);
+            }
+        }
+
+        x0 = (int32)(r * GLCD_TILE_SIZE);
+        x1 = x0 + (int32)(GLCD_TILE_SIZE - 1u);
+        x1 = (x1 > (int32)GLCD_MAXX) ? (int32)GLCD_MAXX : x1;
+
+        for(c0 = 0u; bits != 0u; c0 = c1 + 1u)
+        {
+            /* Next run of dirty tiles, c0 .. c1 */
+            while((bits & ((uint32)1u << c0)) == 0u)
+            {
+                c0++;
+            }
+            for(c1 = c0; (bits & ((uint32)2u << c1)) != 0u; c1++)
+            {
+            }
+            bits &= ~(((uint32)2u << c1) - ((uint32)1u << c0));
+            drawn += (c1 - c0) + 1u;
+
+            y1 = (int32)((c1 * GLCD_TILE_SIZE) + (GLCD_TILE_SIZE - 1u));
+            y1 = (y1 > (int32)GLCD_MAXY) ? (int32)GLCD_MAXY : y1;
+            GLCD_SetWindow(x0, (int32)(c0 * GLCD_TILE_SIZE), x1, y1);
+            GLCD_SpriteInvalidate(x0, (int32)(c0 * GLCD_TILE_SIZE), x1, y1);
+
+            for(i = 0; i <= (x1 - x0); i++)
+            {
+                for(c = c0; c < c1; c++)
+                {
+                    pRow = GLCD_tiles.graphics + ((uint32)GLCD_tiles.map[r][c] * GLCD_TILE_BYTES) + ((uint32)i * GLCD_TILE_SIZE);
+                    GLCD_WriteIndexed(pRow, GLCD_TILE_SIZE);
+                }
+                pRow = GLCD_tiles.graphics + ((uint32)GLCD_tiles.map[r][c1] * GLCD_TILE_BYTES) + ((uint32)i * GLCD_TILE_SIZE);
+                GLCD_WriteIndexed(pRow, (uint32)(y1 - (int32)(c1 * GLCD_TILE_SIZE)) + 1u);
+            }
+        }
+    }
+    return (drawn);
+}
+
+/* [] END OF FILE */
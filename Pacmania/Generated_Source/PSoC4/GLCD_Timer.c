@@ -0,0 +1,316 @@
+/*******************************************************************************
+* File Name: GLCD_Timer.c
+* Version 0.3
+*
+*  Description:
+*    Timers in milliseconds on the SysTick timer, kept in a hashed timer
+*    wheel: a timer goes in the slot its expiry time falls in, modulo the
+*    number of slots, so arming and cancelling are a list insert and unlink
+*    and each SysTick interrupt looks at one slot only.  Timers that expire
+*    are moved to a due list; their callbacks run from the main loop, in
+*    GLCD_TimerService(), where they may draw.
+*
+*    The timers themselves belong to the caller, usually as statics.
+*
+********************************************************************************/
+
+#include <stddef.h>
+#include "cytypes.h"
+#include "CyLib.h"
+#include "GLCD.h"
+
+#define GLCD_TIMER_IDLE     0u
+#define GLCD_TIMER_ARMED    1u
+#define GLCD_TIMER_DUE      2u
+
+/* The due list is the one after the wheel slots */
+#define GLCD_TIMER_DUE_LIST GLCD_TIMER_SLOTS
+
+#if((GLCD_TIMER_SLOTS & (GLCD_TIMER_SLOTS - 1u)) != 0u)
+    #error GLCD_TIMER_SLOTS must be a power of 2
+#endif
+
+static volatile uint32 GLCD_timerNow = 0u;
+static GLCD_TIMER * volatile GLCD_timerLists[GLCD_TIMER_SLOTS + 1u];
+static GLCD_TIMER *GLCD_timerDueLast = NULL;
+
+static void GLCD_TimerTick(void);
+static void GLCD_TimerLink(GLCD_TIMER *timer, uint32 list);
+static void GLCD_TimerUnlink(GLCD_TIMER *timer);
+
+
+/*******************************************************************************
+* Function Name: GLCD_TimerStart
+********************************************************************************
+*
+* Summary:
+*  Start the SysTick timer at 1 ms, if it is not running already, and hook
+*  the timer wheel onto it.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_TimerStart(void)
+{
+    CySysTickStart();
+    (void)CySysTickSetCallback(GLCD_TIMER_SYSTICK_SLOT, &GLCD_TimerTick);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_TimerNow
+********************************************************************************
+*
+* Summary:
+*  Milliseconds since GLCD_TimerStart(), the time timers go by.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Time in milliseconds
+*
+*******************************************************************************/
+uint32 GLCD_TimerNow(void)
+{
+    return (GLCD_timerNow);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_TimerArm
+********************************************************************************
+*
+* Summary:
+*  Set a timer going, first cancelling it if it is armed.  Its callback
+*  runs from GLCD_TimerService() once delay ms have passed, then
+*  every period ms after that, counted from when it was due so that a
+*  periodic timer does not drift when the callback is late.
+*
+* Parameters:
+*  timer:   The timer, owned by the caller
+*  delay:   Milliseconds to the first time, at least 1
+*  period:  Milliseconds between times after that, or 0 for once only
+*  func:    The callback
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_TimerArm(GLCD_TIMER *timer, uint32 delay, uint32 period, GLCD_TIMER_FUNC func)
+{
+    uint8 intr;
+
+    intr = CyEnterCriticalSection();
+    if(timer->state != GLCD_TIMER_IDLE)
+    {
+        GLCD_TimerUnlink(timer);
+    }
+    timer->func = func;
+    timer->period = period;
+    timer->expires = GLCD_timerNow + ((delay == 0u) ? 1u : delay);
+    GLCD_TimerLink(timer, timer->expires & (GLCD_TIMER_SLOTS - 1u));
+    CyExitCriticalSection(intr);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_TimerCancel
+********************************************************************************
+*
+* Summary:
+*  Stop a timer, also when it is due and its callback has not run yet.
+*
+* Parameters:
+*  timer:  The timer
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_TimerCancel(GLCD_TIMER *timer)
+{
+    uint8 intr;
+
+    intr = CyEnterCriticalSection();
+    if(timer->state != GLCD_TIMER_IDLE)
+    {
+        GLCD_TimerUnlink(timer);
+    }
+    CyExitCriticalSection(intr);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_TimerArmed
+********************************************************************************
+*
+* Summary:
+*  Whether a timer is armed or due.
+*
+* Parameters:
+*  timer:  The timer
+*
+* Return:
+*  Non-zero while armed
+*
+*******************************************************************************/
+uint32 GLCD_TimerArmed(const GLCD_TIMER *timer)
+{
+    return ((timer->state != GLCD_TIMER_IDLE) ? 1u : 0u);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_TimerService
+********************************************************************************
+*
+* Summary:
+*  Run the callbacks of the timers that are due, in the order they came
+*  due; call it from the main loop.  A periodic timer is armed again before
+*  its callback runs, so the callback may cancel it or arm it anew.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Number of callbacks run
+*
+*******************************************************************************/
+uint32 GLCD_TimerService(void)
+{
+    GLCD_TIMER *timer;
+    uint32 n = 0u;
+    uint8 intr;
+
+    for(;;)
+    {
+        intr = CyEnterCriticalSection();
+        timer = GLCD_timerLists[GLCD_TIMER_DUE_LIST];
+        if(timer == NULL)
+        {
+            CyExitCriticalSection(intr);
+            break;
+        }
+        GLCD_TimerUnlink(timer);
+        if(timer->period != 0u)
+        {
+            timer->expires += timer->period;
+            if((int32)(GLCD_timerNow - timer->expires) >= 0)
+            {
+                /* A whole period behind: start again from now */
+                timer->expires = GLCD_timerNow + 1u;
+            }
+            GLCD_TimerLink(timer, timer->expires & (GLCD_TIMER_SLOTS - 1u));
+        }
+        CyExitCriticalSection(intr);
+
+        timer->func(timer);
+        n++;
+    }
+    return (n);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_TimerTick
+********************************************************************************
+*
+* Summary:
+*  SysTick callback, every millisecond.  Moves the timers of this
+*  millisecond's slot that have expired to the end of the due list; those
+*  a turn of the wheel or more away stay.
+*
+*******************************************************************************/
+static void GLCD_TimerTick(void)
+{
+    GLCD_TIMER *timer;
+    GLCD_TIMER *next;
+    uint32 now = GLCD_timerNow + 1u;
+
+    GLCD_timerNow = now;
+    for(timer = GLCD_timerLists[now & (GLCD_TIMER_SLOTS - 1u)]; timer != NULL; timer = next)
+    {
+        next = timer->next;
+        if((int32)(now - timer->expires) >= 0)
+        {
+            GLCD_TimerUnlink(timer);
+            GLCD_TimerLink(timer, GLCD_TIMER_DUE_LIST);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: GLCD_TimerLink
+********************************************************************************
+*
+* Summary:
+*  Put a timer in a wheel slot, at the front, or on the due list, at the
+*  end.  Called with interrupts off, or from the SysTick interrupt.
+*
+*******************************************************************************/
+static void GLCD_TimerLink(GLCD_TIMER *timer, uint32 list)
+{
+    GLCD_TIMER *first;
+
+    timer->list = (uint8)list;
+    if(list == GLCD_TIMER_DUE_LIST)
+    {
+        timer->state = GLCD_TIMER_DUE;
+        timer->next = NULL;
+        timer->prev = GLCD_timerDueLast;
+        if(GLCD_timerDueLast != NULL)
+        {
+            GLCD_timerDueLast->next = timer;
+        }
+        else
+        {
+            GLCD_timerLists[list] = timer;
+        }
+        GLCD_timerDueLast = timer;
+    }
+    else
+    {
+        timer->state = GLCD_TIMER_ARMED;
+        first = GLCD_timerLists[list];
+        timer->prev = NULL;
+        timer->next = first;
+        if(first != NULL)
+        {
+            first->prev = timer;
+        }
+        GLCD_timerLists[list] = timer;
+    }
+}
+
+/*******************************************************************************
+* Function Name: GLCD_TimerUnlink
+********************************************************************************
+*
+* Summary:
+*  Take a timer off the list it is on and make it idle.  Called with
+*  interrupts off, or from the SysTick interrupt.
+*
+*******************************************************************************/
+static void GLCD_TimerUnlink(GLCD_TIMER *timer)
+{
+    if(timer->prev != NULL)
+    {
+        timer->prev->next = timer->next;
+    }
+    else
+    {
+        GLCD_timerLists[timer->list] = timer->next;
+    }
+    if(timer->next != NULL)
+    {
+        timer->next->prev = timer->prev;
+    }
+    else if(timer->list == GLCD_TIMER_DUE_LIST)
+    {
+        GLCD_timerDueLast = timer->prev;
+    }
+    timer->next = NULL;
+    timer->prev = NULL;
+    timer->state = GLCD_TIMER_IDLE;
+}
+
+/* [] END OF FILE */
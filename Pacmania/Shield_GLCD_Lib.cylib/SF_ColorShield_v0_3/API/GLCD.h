@@ -35,6 +35,20 @@
 #define `$INSTANCE_NAME`_SPIM_UDB_TYPE    0u 
 #define `$INSTANCE_NAME`_SPIM_SCB_TYPE    1u 
 
+/* Depth of the transmit queue in 9-bit words (2 bytes RAM each), used when */
+/* the SPIM has its TX interrupt.  Must be a power of two.                  */
+#if !defined(`$INSTANCE_NAME`_TX_QUEUE_SIZE)
+#define `$INSTANCE_NAME`_TX_QUEUE_SIZE      128u
+#endif
+
+/* Set to 1 to keep a shadow of the display memory: a bit per pixel and an  */
+/* ink color per 8x8 block, 2822 bytes of RAM.  Pixels and spans that would */
+/* not change the screen are then not sent, and `$INSTANCE_NAME`_GetPixel()     */
+/* can read the screen back.                                                */
+#if !defined(`$INSTANCE_NAME`_SHADOW)
+#define `$INSTANCE_NAME`_SHADOW             0u
+#endif
+
 
 /*******************************************************
 *				Function Prototypes                    
@@ -48,12 +62,43 @@ void `$INSTANCE_NAME`_Contrast(int32 setting);
 
 void `$INSTANCE_NAME`_Pixel(int32 x, int32 y, int32 color );
 void `$INSTANCE_NAME`_DrawCircle (int32 x, int32 y, int32 radius, int32 color);
+void `$INSTANCE_NAME`_FillCircle(int32 x, int32 y, int32 radius, int32 color);
+void `$INSTANCE_NAME`_FillSector(int32 x, int32 y, int32 radius, int32 startAngle, int32 endAngle, int32 color);
 
 void `$INSTANCE_NAME`_PrintChar(uint8 c, int32 x, int32 y, int32 fColor, int32 bColor);
 void `$INSTANCE_NAME`_PrintString(char *pString, int32 x, int32 y, int32 fColor, int32 bColor);
 
 void `$INSTANCE_NAME`_DrawLine(int32 x0, int32 y0, int32 x1, int32 y1, int32 color);
 void `$INSTANCE_NAME`_DrawRect(int32 x0, int32 y0, int32 x1, int32 y1, int32 fill, int32 color);
+void `$INSTANCE_NAME`_DrawHLine(int32 x, int32 y0, int32 y1, int32 color);
+void `$INSTANCE_NAME`_DrawVLine(int32 x0, int32 x1, int32 y, int32 color);
+
+/* Clip rectangle for the drawing functions above */
+void `$INSTANCE_NAME`_SetClip(int32 x0, int32 y0, int32 x1, int32 y1);
+void `$INSTANCE_NAME`_ClearClip(void);
+void `$INSTANCE_NAME`_GetClip(int32 *x0, int32 *y0, int32 *x1, int32 *y1);
+
+/* Streaming window writes: address a rectangle once, then push pixels. */
+void `$INSTANCE_NAME`_SetWindow(int32 x0, int32 y0, int32 x1, int32 y1);
+void `$INSTANCE_NAME`_WritePixels(const uint16 *colors, uint32 n);
+void `$INSTANCE_NAME`_FillWindow(int32 color, uint32 n);
+void `$INSTANCE_NAME`_WriteIndexed(const uint8 *indices, uint32 n);
+const uint16 *`$INSTANCE_NAME`_BlitRLE(int32 x0, int32 y0, int32 x1, int32 y1, const uint16 *rle);
+void   `$INSTANCE_NAME`_SetScan(uint32 order);
+uint32 `$INSTANCE_NAME`_GetScan(void);
+
+/* Pixel format and the 8-bit palette */
+void   `$INSTANCE_NAME`_SetColorMode(uint32 mode);
+uint32 `$INSTANCE_NAME`_GetColorMode(void);
+void   `$INSTANCE_NAME`_SetPalette(const uint8 *palette);
+int32  `$INSTANCE_NAME`_PaletteColor(uint32 index);
+
+/* Fixed-point trig.  Angles are in 1/`$INSTANCE_NAME`_TRIG_STEPS degree steps (use  */
+/* `$INSTANCE_NAME`_DEG() to convert from degrees), 0 along +y and 90 degrees along  */
+/* +x.  Results are Q1.15, 32767 = 1.0.                                     */
+int32 `$INSTANCE_NAME`_SinQ15(int32 angle);
+int32 `$INSTANCE_NAME`_CosQ15(int32 angle);
+void  `$INSTANCE_NAME`_PolarToXY(int32 x0, int32 y0, int32 radius, int32 angle, int32 *x, int32 *y);
 
 /* Low level commands used by the normal commands.  */
 void  `$INSTANCE_NAME`_Command(uint32 datacmd);
@@ -61,11 +106,55 @@ void  `$INSTANCE_NAME`_Data(uint32 datadt);
 int32 `$INSTANCE_NAME`_SwapColors(int32 in);
 void  `$INSTANCE_NAME`_On(void);
 void  `$INSTANCE_NAME`_Off(void);
+void  `$INSTANCE_NAME`_Invert(uint32 on);
+int32 `$INSTANCE_NAME`_GetContrast(void);
+
+/* Hardware vertical scroll */
+void  `$INSTANCE_NAME`_ScrollSetArea(int32 x0, int32 x1);
+int32 `$INSTANCE_NAME`_ScrollTo(int32 offset);
+int32 `$INSTANCE_NAME`_ScrollRamRow(int32 x);
+
+/* Timed screen effects, see `$INSTANCE_NAME`_Effects.c */
+void   `$INSTANCE_NAME`_FlashInvert(uint32 ticks);
+void   `$INSTANCE_NAME`_FadeContrast(int32 target, uint32 ticks, uint32 returnTicks);
+void   `$INSTANCE_NAME`_Blank(uint32 ticks);
+uint32 `$INSTANCE_NAME`_EffectTick(void);
+
+/* Transmit queue */
+void   `$INSTANCE_NAME`_Flush(void);
+uint32 `$INSTANCE_NAME`_TxQueueDepth(void);
+uint32 `$INSTANCE_NAME`_TxQueueHighWater(void);
+void   `$INSTANCE_NAME`_TxQueueResetHighWater(void);
+uint32 `$INSTANCE_NAME`_BytesSent(void);
+
+/* Address window cache: PAGEADDR/COLADDR commands skipped and sent */
+uint32 `$INSTANCE_NAME`_WindowCacheHits(void);
+uint32 `$INSTANCE_NAME`_WindowCacheMisses(void);
+void   `$INSTANCE_NAME`_WindowCacheResetStats(void);
+
+#if (`$INSTANCE_NAME`_SHADOW != 0u)
+/* Shadow of the display memory */
+int32  `$INSTANCE_NAME`_GetPixel(int32 x, int32 y);
+uint32 `$INSTANCE_NAME`_ShadowSkipped(void);
+#endif
 
 
 const uint8 `$INSTANCE_NAME`_FONT8x16[97][16];
 
 
+/*******************************************************
+*                Fixed-Point Trig Definitions
+********************************************************/
+#define `$INSTANCE_NAME`_TRIG_STEPS       4u     /* Table entries per degree; must match `$INSTANCE_NAME`_Trig.c */
+#define `$INSTANCE_NAME`_TRIG_QUADRANT    (90u * `$INSTANCE_NAME`_TRIG_STEPS)
+#define `$INSTANCE_NAME`_TRIG_CIRCLE      (360u * `$INSTANCE_NAME`_TRIG_STEPS)
+#define `$INSTANCE_NAME`_DEG(degrees)     ((degrees) * (int32)`$INSTANCE_NAME`_TRIG_STEPS)
+#define `$INSTANCE_NAME`_Q15_ONE          32767
+
+/* One quadrant of sin(), generated into `$INSTANCE_NAME`_Trig.c at build time */
+extern const int16 `$INSTANCE_NAME`_SIN_TABLE[`$INSTANCE_NAME`_TRIG_QUADRANT + 1u];
+
+
 /********************************************************************
 *                                                                  
 *					LCD Dimension Definitions                       
@@ -130,6 +219,9 @@ const uint8 `$INSTANCE_NAME`_FONT8x16[97][16];
 #define `$INSTANCE_NAME`_COMSCN      0xBB	/* Common scan direction      */
 #define `$INSTANCE_NAME`_DISCTL      0xCA	/* Display control            */
 #define `$INSTANCE_NAME`_DATCTL      0xBC	/* Data scan direction, etc.  */
+#define `$INSTANCE_NAME`_DATCTL_PINV  0x01	/* DATCTL 1st byte: page address inverse   */
+#define `$INSTANCE_NAME`_DATCTL_CINV  0x02	/*   column address inverse                */
+#define `$INSTANCE_NAME`_DATCTL_PSCAN 0x04	/*   page address steps first              */
 #define `$INSTANCE_NAME`_RGBSET8     0xCE	/* 256-color position set     */
 #define `$INSTANCE_NAME`_RAMRD       0x5D	/* Reading from memory        */
 #define `$INSTANCE_NAME`_PTLIN       0xA8	/* Partial display in         */
@@ -162,7 +254,12 @@ const uint8 `$INSTANCE_NAME`_FONT8x16[97][16];
 #define	`$INSTANCE_NAME`_NORON		0x13	/* Normal display mode on          */
 #define `$INSTANCE_NAME`_RGBSET	    0x2D	/* Color set                       */
 #define	`$INSTANCE_NAME`_MADCTL		0x36	/* Memory data access control      */
+#define `$INSTANCE_NAME`_MADCTL_MY   0x80	/*   mirror page addresses         */
+#define `$INSTANCE_NAME`_MADCTL_MX   0x40	/*   mirror column addresses       */
+#define `$INSTANCE_NAME`_MADCTL_V    0x20	/*   page address steps first      */
 #define	`$INSTANCE_NAME`_COLMOD		0x3A	/* Interface pixel format          */
+#define `$INSTANCE_NAME`_VSCRDEF     0x33	/* Vertical scrolling definition   */
+#define `$INSTANCE_NAME`_VSCRSADD    0x37	/* Vertical scrolling start address */
 #define `$INSTANCE_NAME`_DISCTR     0xB9	/* Super frame inversion           */
 #define	`$INSTANCE_NAME`_EC			0xC0	/* Internal or external oscillator */
 
@@ -198,6 +295,397 @@ const uint8 `$INSTANCE_NAME`_FONT8x16[97][16];
 #define `$INSTANCE_NAME`_YELLOW		0xFF0
 #define `$INSTANCE_NAME`_WHITE		0xFFF
 
+/*******************************************************
+*				Run-Length Encoded Images
+********************************************************/
+
+/* Words of an image for `$INSTANCE_NAME`_BlitRLE(), n from 1 to 32767 */
+#define `$INSTANCE_NAME`_RLE_RUN(n)     ((uint16)(0x8000u | (n)))   /* then one color, n times */
+#define `$INSTANCE_NAME`_RLE_COPY(n)    ((uint16)(n))               /* then n colors           */
+
+/*******************************************************
+*				Window Fill Order
+********************************************************/
+
+/* Window fill orders for `$INSTANCE_NAME`_SetScan() */
+#define `$INSTANCE_NAME`_SCAN_ROWS      0u  /* along a row (y), then the next row    */
+#define `$INSTANCE_NAME`_SCAN_COLUMNS   1u  /* down a column (x), then the next one  */
+
+/*******************************************************
+*				8-Bit Color Definitions
+********************************************************/
+
+/* Modes for `$INSTANCE_NAME`_SetColorMode(), in bits per pixel */
+#define `$INSTANCE_NAME`_COLOR_12BIT    12u
+#define `$INSTANCE_NAME`_COLOR_8BIT     8u
+
+/* Palette levels: 8 red, 8 green, 4 blue */
+#define `$INSTANCE_NAME`_PALETTE_SIZE   20u
+
+/* Linear ramps, loaded by Start */
+extern const uint8 `$INSTANCE_NAME`_DEFAULT_PALETTE[`$INSTANCE_NAME`_PALETTE_SIZE];
+
+/* A color argument with this bit set is an RRRGGGBB palette index. */
+/* Any drawing function accepts one, in either color mode.           */
+#define `$INSTANCE_NAME`_INDEXED        0x1000
+#define `$INSTANCE_NAME`_INDEX(index)   (`$INSTANCE_NAME`_INDEXED | ((int32)(index) & 0xFF))
+
+
+/*******************************************************
+*				Color Slot Animation
+********************************************************/
+
+/* Animated color slots (about 16 bytes of RAM each), at most 32 */
+#if !defined(`$INSTANCE_NAME`_ANIM_SLOTS)
+#define `$INSTANCE_NAME`_ANIM_SLOTS     8u
+#endif
+#define `$INSTANCE_NAME`_ANIM_CYCLES    2u      /* slot ranges that can cycle at once */
+
+/* A color argument with this bit set takes the current color of a slot. */
+#define `$INSTANCE_NAME`_SLOTTED        0x2000
+#define `$INSTANCE_NAME`_SLOT(slot)     (`$INSTANCE_NAME`_SLOTTED | ((int32)(slot) & 0xFF))
+
+/* What a slot does after its last key */
+#define `$INSTANCE_NAME`_ANIM_ONCE      0u      /* hold the last key       */
+#define `$INSTANCE_NAME`_ANIM_LOOP      1u      /* go on to the first key  */
+#define `$INSTANCE_NAME`_ANIM_PINGPONG  2u      /* play the keys backwards */
+
+/* How a slot moves between keys */
+#define `$INSTANCE_NAME`_CURVE_STEP     0u      /* jump at the next key    */
+#define `$INSTANCE_NAME`_CURVE_LINEAR   1u
+#define `$INSTANCE_NAME`_CURVE_EASE     2u      /* slow in, slow out       */
+
+typedef struct
+{
+    uint16 color;       /* 12-bit color                              */
+    uint16 ticks;       /* ticks taken to reach the following key    */
+} `$INSTANCE_NAME`_ANIM_KEY;
+
+/* Defined in `$INSTANCE_NAME`_Anim.c */
+void   `$INSTANCE_NAME`_AnimSetColor(uint32 slot, int32 color);
+void   `$INSTANCE_NAME`_AnimSetKeys(uint32 slot, const `$INSTANCE_NAME`_ANIM_KEY *keys, uint32 count, uint32 mode, uint32 curve);
+void   `$INSTANCE_NAME`_AnimCycle(uint32 range, uint32 first, uint32 count, uint32 ticks);
+uint32 `$INSTANCE_NAME`_AnimTick(void);
+int32  `$INSTANCE_NAME`_AnimColor(uint32 slot);
+
+
+/*******************************************************
+*				Tile Layer
+********************************************************/
+
+/* 8x8 tiles covering the screen; the last row and column are cut to 4    */
+/* pixels.  The map takes a byte per tile of RAM, the images are in flash. */
+#define `$INSTANCE_NAME`_TILE_SIZE      8u
+#define `$INSTANCE_NAME`_TILE_ROWS      17u     /* down the screen (x)     */
+#define `$INSTANCE_NAME`_TILE_COLS      17u     /* across the screen (y)   */
+#define `$INSTANCE_NAME`_TILE_BYTES     (`$INSTANCE_NAME`_TILE_SIZE * `$INSTANCE_NAME`_TILE_SIZE)
+
+/* Map entry for a place the layer leaves alone */
+#define `$INSTANCE_NAME`_TILE_NONE      0xFFu
+
+/* Defined in `$INSTANCE_NAME`_Tile.c */
+void   `$INSTANCE_NAME`_TileSetGraphics(const uint8 *graphics);
+void   `$INSTANCE_NAME`_TileSet(uint32 row, uint32 col, uint32 tile);
+uint32 `$INSTANCE_NAME`_TileGet(uint32 row, uint32 col);
+int32  `$INSTANCE_NAME`_TilePixel(int32 x, int32 y);
+void   `$INSTANCE_NAME`_TileFill(uint32 tile);
+void   `$INSTANCE_NAME`_TileInvalidate(int32 x0, int32 y0, int32 x1, int32 y1);
+uint32 `$INSTANCE_NAME`_TileFlush(void);
+
+
+/*******************************************************
+*				Sprite Layer
+********************************************************/
+
+/* Sprites over the background and tiles, about 20 bytes of RAM each */
+#if !defined(`$INSTANCE_NAME`_SPRITES)
+#define `$INSTANCE_NAME`_SPRITES        4u
+#endif
+
+/* Sprite flag: tiles are drawn in front of the sprite */
+#define `$INSTANCE_NAME`_SPRITE_BEHIND  0x01u
+
+/* Sprite image in flash: height rows of width RRRGGGBB indices, top row */
+/* first; pixels equal to key are see-through.                           */
+typedef struct
+{
+    uint8 width;                /* columns (y)             */
+    uint8 height;               /* rows (x)                */
+    uint8 key;
+    const uint8 *pixels;
+} `$INSTANCE_NAME`_SPRITE_IMAGE;
+
+/* What lies under the sprites: fills colors[0 .. y1 - y0] for row x */
+typedef void (*`$INSTANCE_NAME`_BACKGROUND_ROW)(int32 x, int32 y0, int32 y1, uint16 *colors);
+
+/* Defined in `$INSTANCE_NAME`_Sprite.c */
+void   `$INSTANCE_NAME`_SpriteSetBackground(`$INSTANCE_NAME`_BACKGROUND_ROW background);
+void   `$INSTANCE_NAME`_SpriteShow(uint32 n, const `$INSTANCE_NAME`_SPRITE_IMAGE *image, int32 x, int32 y, uint32 flags);
+void   `$INSTANCE_NAME`_SpriteMove(uint32 n, int32 x, int32 y);
+void   `$INSTANCE_NAME`_SpriteHide(uint32 n);
+void   `$INSTANCE_NAME`_SpriteInvalidate(int32 x0, int32 y0, int32 x1, int32 y1);
+uint32 `$INSTANCE_NAME`_SpriteFlush(void);
+void   `$INSTANCE_NAME`_ComposeBackground(int32 x, int32 y0, int32 y1, uint16 *colors);
+void   `$INSTANCE_NAME`_ComposeLayers(int32 x, int32 y0, int32 y1, uint16 *colors);
+
+
+/*******************************************************
+*				Band Renderer
+********************************************************/
+
+/* Rows of the RAM band, 2 bytes a pixel: 1 row of 132 takes 264 bytes.   */
+/* A narrower area fits more of its rows in the band, so a box up to 66   */
+/* wide still renders 2 rows at a time.  Raise it on parts with RAM spare. */
+#if !defined(`$INSTANCE_NAME`_BAND_ROWS)
+#define `$INSTANCE_NAME`_BAND_ROWS      1u
+#endif
+#define `$INSTANCE_NAME`_BAND_PIXELS    (`$INSTANCE_NAME`_BAND_ROWS * `$INSTANCE_NAME`_ROW_LENGTH)
+
+/* Shapes queued for one render, 12 bytes of RAM each */
+#if !defined(`$INSTANCE_NAME`_BAND_SHAPES)
+#define `$INSTANCE_NAME`_BAND_SHAPES    8u
+#endif
+
+/* Defined in `$INSTANCE_NAME`_Band.c */
+uint32 `$INSTANCE_NAME`_BandRect(int32 x0, int32 y0, int32 x1, int32 y1, int32 color);
+uint32 `$INSTANCE_NAME`_BandDisc(int32 x0, int32 y0, int32 radius, int32 color);
+uint32 `$INSTANCE_NAME`_BandRing(int32 x0, int32 y0, int32 radius, int32 width, int32 color);
+uint32 `$INSTANCE_NAME`_BandRender(int32 x0, int32 y0, int32 x1, int32 y1);
+
+
+/*******************************************************
+*				Display List
+********************************************************/
+
+/* Pixels and fills recorded per frame, 6 bytes of RAM each.  A full list */
+/* is played out early and recording goes on.                             */
+#if !defined(`$INSTANCE_NAME`_LIST_SIZE)
+#define `$INSTANCE_NAME`_LIST_SIZE      32u
+#endif
+
+/* What the last frame cost */
+typedef struct
+{
+    uint16 recorded;            /* pixels and fills recorded                */
+    uint16 culled;              /* hidden by a later one, never sent        */
+    uint16 merged;              /* sent through a window opened for another */
+    uint16 windows;             /* windows opened                           */
+    uint32 bytes;               /* bytes sent playing the list out          */
+} `$INSTANCE_NAME`_FRAME_STATS;
+
+/* Non-zero between `$INSTANCE_NAME`_BeginFrame() and `$INSTANCE_NAME`_EndFrame() */
+extern uint8 `$INSTANCE_NAME`_recording;
+
+/* Defined in `$INSTANCE_NAME`_List.c */
+void   `$INSTANCE_NAME`_BeginFrame(void);
+void   `$INSTANCE_NAME`_EndFrame(void);
+const `$INSTANCE_NAME`_FRAME_STATS *`$INSTANCE_NAME`_FrameStats(void);
+uint32 `$INSTANCE_NAME`_ListRecord(int32 x0, int32 y0, int32 x1, int32 y1, int32 color);
+void   `$INSTANCE_NAME`_ListPlay(void);
+
+
+/*******************************************************
+*				Game Loop
+********************************************************/
+
+/* SysTick callback slot the loop takes, of CY_SYS_SYST_NUM_OF_CALLBACKS */
+#if !defined(`$INSTANCE_NAME`_LOOP_SYSTICK_SLOT)
+#define `$INSTANCE_NAME`_LOOP_SYSTICK_SLOT  0u
+#endif
+
+/* Most updates run in one pass; ticks later than that are dropped */
+#if !defined(`$INSTANCE_NAME`_LOOP_MAX_UPDATES)
+#define `$INSTANCE_NAME`_LOOP_MAX_UPDATES   4u
+#endif
+
+/* Most renders skipped in a row to catch up */
+#if !defined(`$INSTANCE_NAME`_LOOP_MAX_SKIPS)
+#define `$INSTANCE_NAME`_LOOP_MAX_SKIPS     3u
+#endif
+
+/* The game.  render() gets how far time is from the last tick to the     */
+/* next, 0 to 255, to draw moving things between their tick positions.    */
+typedef struct
+{
+    void (*input)(void);        /* once a pass, before the updates */
+    void (*update)(void);       /* once a tick, or NULL            */
+    void (*render)(uint32 alpha);
+} `$INSTANCE_NAME`_GAME;
+
+/* Where the time of the last pass went, and totals */
+typedef struct
+{
+    uint32 updateUs;            /* input and updates                      */
+    uint32 renderUs;            /* render, 0 when skipped                 */
+    uint32 idleUs;              /* asleep waiting for a tick              */
+    uint16 updates;             /* updates run                            */
+    uint16 renders;             /* total renders                          */
+    uint16 skipped;             /* total renders skipped to catch up      */
+    uint16 dropped;             /* total ticks dropped, the game slowed   */
+} `$INSTANCE_NAME`_LOOP_STATS;
+
+/* Defined in `$INSTANCE_NAME`_Loop.c */
+void   `$INSTANCE_NAME`_LoopStart(uint32 hz);
+void   `$INSTANCE_NAME`_LoopStep(const `$INSTANCE_NAME`_GAME *game);
+const `$INSTANCE_NAME`_LOOP_STATS *`$INSTANCE_NAME`_LoopStats(void);
+uint32 `$INSTANCE_NAME`_LoopTicks(void);
+uint32 `$INSTANCE_NAME`_LoopMicros(void);
+
+
+/*******************************************************
+*				Cooperative Tasks
+********************************************************/
+
+/* Tasks that can run at once, 16 bytes of RAM each */
+#if !defined(`$INSTANCE_NAME`_TASK_MAX)
+#define `$INSTANCE_NAME`_TASK_MAX       4u
+#endif
+
+/* What a task function returns */
+#define `$INSTANCE_NAME`_TASK_WAITING   0u      /* run it again            */
+#define `$INSTANCE_NAME`_TASK_DONE      1u      /* remove it               */
+
+typedef struct `$INSTANCE_NAME`_TASK_S `$INSTANCE_NAME`_TASK;
+typedef uint32 (*`$INSTANCE_NAME`_TASK_FUNC)(`$INSTANCE_NAME`_TASK *task);
+
+/* A task table entry.  Locals of a task function are lost when it yields; */
+/* x, y and n are kept.                                                     */
+struct `$INSTANCE_NAME`_TASK_S
+{
+    `$INSTANCE_NAME`_TASK_FUNC run;     /* NULL for a free entry        */
+    uint32 wake;                        /* loop tick to sleep until     */
+    uint16 line;                        /* where to carry on            */
+    int16  x, y;                        /* start arguments              */
+    int16  n;                           /* the task's own counter       */
+};
+
+/* Protothread macros for the body of a task function.  The body goes      */
+/* between BEGIN and END and must not use switch itself round a yield.     */
+#define `$INSTANCE_NAME`_TASK_BEGIN(t)  switch((t)->line) { case 0u:
+
+#define `$INSTANCE_NAME`_TASK_YIELD(t)  \
+    do { (t)->line = (uint16)__LINE__; return (`$INSTANCE_NAME`_TASK_WAITING); case __LINE__: ; } while(0)
+
+/* Yield for ticks game loop ticks, at least one slice */
+#define `$INSTANCE_NAME`_TASK_SLEEP(t, ticks)   \
+    do { (t)->wake = `$INSTANCE_NAME`_LoopTicks() + (uint32)(ticks); `$INSTANCE_NAME`_TASK_YIELD(t); } while(0)
+
+/* Yield until cond holds */
+#define `$INSTANCE_NAME`_TASK_WAIT(t, cond)     \
+    do { while(!(cond)) { `$INSTANCE_NAME`_TASK_YIELD(t); } } while(0)
+
+#define `$INSTANCE_NAME`_TASK_END(t)    } (t)->line = 0u; return (`$INSTANCE_NAME`_TASK_DONE)
+
+/* Defined in `$INSTANCE_NAME`_Task.c */
+int32  `$INSTANCE_NAME`_TaskStart(`$INSTANCE_NAME`_TASK_FUNC run, int32 x, int32 y);
+void   `$INSTANCE_NAME`_TaskStop(int32 task);
+uint32 `$INSTANCE_NAME`_TaskRunning(`$INSTANCE_NAME`_TASK_FUNC run);
+uint32 `$INSTANCE_NAME`_TaskRun(void);
+
+
+/*******************************************************
+*				Timers
+********************************************************/
+
+/* SysTick callback slot the timers take */
+#if !defined(`$INSTANCE_NAME`_TIMER_SYSTICK_SLOT)
+#define `$INSTANCE_NAME`_TIMER_SYSTICK_SLOT 1u
+#endif
+
+/* Slots in the timer wheel, a power of 2, 4 bytes of RAM each.  Each   */
+/* millisecond looks through the timers of one slot.                    */
+#if !defined(`$INSTANCE_NAME`_TIMER_SLOTS)
+#define `$INSTANCE_NAME`_TIMER_SLOTS    8u
+#endif
+
+typedef struct `$INSTANCE_NAME`_TIMER_S `$INSTANCE_NAME`_TIMER;
+typedef void (*`$INSTANCE_NAME`_TIMER_FUNC)(`$INSTANCE_NAME`_TIMER *timer);
+
+/* A timer, owned by the caller; only the timer functions touch it */
+struct `$INSTANCE_NAME`_TIMER_S
+{
+    `$INSTANCE_NAME`_TIMER *next;       /* in a wheel slot or the due list */
+    `$INSTANCE_NAME`_TIMER *prev;
+    uint32 expires;                     /* `$INSTANCE_NAME`_TimerNow() to fire at */
+    uint32 period;                      /* ms, 0 for once only             */
+    `$INSTANCE_NAME`_TIMER_FUNC func;
+    uint8  list;                        /* the list it is on               */
+    uint8  state;
+};
+
+/* Defined in `$INSTANCE_NAME`_Timer.c */
+void   `$INSTANCE_NAME`_TimerStart(void);
+uint32 `$INSTANCE_NAME`_TimerNow(void);
+void   `$INSTANCE_NAME`_TimerArm(`$INSTANCE_NAME`_TIMER *timer, uint32 delay, uint32 period, `$INSTANCE_NAME`_TIMER_FUNC func);
+void   `$INSTANCE_NAME`_TimerCancel(`$INSTANCE_NAME`_TIMER *timer);
+uint32 `$INSTANCE_NAME`_TimerArmed(const `$INSTANCE_NAME`_TIMER *timer);
+uint32 `$INSTANCE_NAME`_TimerService(void);
+
+
+/*******************************************************
+*				Buttons
+********************************************************/
+
+/* SysTick callback slot the buttons take */
+#if !defined(`$INSTANCE_NAME`_INPUT_SYSTICK_SLOT)
+#define `$INSTANCE_NAME`_INPUT_SYSTICK_SLOT 2u
+#endif
+
+/* Most buttons, 8 bytes of RAM each, and events queued, a power of 2, */
+/* 4 bytes each                                                         */
+#if !defined(`$INSTANCE_NAME`_INPUT_MAX)
+#define `$INSTANCE_NAME`_INPUT_MAX        6u
+#endif
+#if !defined(`$INSTANCE_NAME`_INPUT_QUEUE)
+#define `$INSTANCE_NAME`_INPUT_QUEUE      8u
+#endif
+
+/* Milliseconds a pin must be quiet after an edge, a button down before */
+/* the held event, and between repeats after that                       */
+#if !defined(`$INSTANCE_NAME`_INPUT_DEBOUNCE_MS)
+#define `$INSTANCE_NAME`_INPUT_DEBOUNCE_MS    5u
+#endif
+#if !defined(`$INSTANCE_NAME`_INPUT_HOLD_MS)
+#define `$INSTANCE_NAME`_INPUT_HOLD_MS        500u
+#endif
+#if !defined(`$INSTANCE_NAME`_INPUT_REPEAT_MS)
+#define `$INSTANCE_NAME`_INPUT_REPEAT_MS      100u
+#endif
+
+/* Event types */
+#define `$INSTANCE_NAME`_INPUT_PRESSED    0u
+#define `$INSTANCE_NAME`_INPUT_RELEASED   1u
+#define `$INSTANCE_NAME`_INPUT_HELD       2u      /* down for the hold time        */
+#define `$INSTANCE_NAME`_INPUT_REPEAT     3u      /* still down, every repeat time */
+
+/* A button pin: its port registers, from cyfitter.h */
+typedef struct
+{
+    reg32 *ps;                  /* pin state              */
+    reg32 *intcfg;              /* interrupt edge select  */
+    reg32 *intstat;             /* interrupt status       */
+    uint8  shift;               /* pin number in the port */
+    uint8  irq;                 /* port interrupt number  */
+} `$INSTANCE_NAME`_INPUT_PIN;
+
+/* Table entry for a Pins component.  The GPIO port interrupts of the    */
+/* PSoC 4100/4200 are interrupts 0 to 4, one for each port.              */
+#define `$INSTANCE_NAME`_INPUT_PIN_INIT(pin)  \
+    { (reg32 *)(pin##__PS), (reg32 *)(pin##__INTCFG), (reg32 *)(pin##__INTSTAT), (uint8)(pin##__SHIFT), (uint8)(pin##__PORT) }
+
+typedef struct
+{
+    uint16 time;                /* ms: when pressed or released, at the first edge */
+    uint8  button;              /* place in the pin table                          */
+    uint8  type;
+} `$INSTANCE_NAME`_INPUT_EVENT;
+
+/* Defined in `$INSTANCE_NAME`_Input.c */
+void   `$INSTANCE_NAME`_InputStart(const `$INSTANCE_NAME`_INPUT_PIN *pins, uint32 count);
+uint32 `$INSTANCE_NAME`_InputRead(`$INSTANCE_NAME`_INPUT_EVENT *event);
+uint32 `$INSTANCE_NAME`_InputHeld(void);
+uint32 `$INSTANCE_NAME`_InputLost(void);
+
 
 
 /*******************************************************
@@ -0,0 +1,177 @@
+/*******************************************************************************
+* File Name: `$INSTANCE_NAME`_Effects.c
+* Version `$CY_MAJOR_VERSION`.`$CY_MINOR_VERSION`
+*
+*  Description:
+*    Whole-screen effects done by the controller instead of by repainting:
+*    an inversion flash, a contrast fade down and back up, and blanking.
+*    Each is started with a few bytes of commands and then timed by
+*    `$INSTANCE_NAME`_EffectTick(), called once per frame or from a periodic
+*    tick, so drawing can carry on while the effect runs.
+*
+********************************************************************************/
+
+#include "cytypes.h"
+#include "`$INSTANCE_NAME`.h"
+
+typedef struct
+{
+    uint16 invertLeft;          /* ticks until the inversion flash ends    */
+    uint16 blankLeft;           /* ticks until the display comes back on   */
+    uint32 fadePhase;           /* 0 idle, 1 towards target, 2 returning   */
+    int32  fadeFrom;
+    int32  fadeTo;
+    int32  fadeBase;            /* contrast to return to                    */
+    uint16 fadeTicks;           /* length of the current phase              */
+    uint16 fadeElapsed;
+    uint16 returnTicks;         /* length of the return phase, 0 for none   */
+} `$INSTANCE_NAME`_EFFECTS;
+
+static `$INSTANCE_NAME`_EFFECTS `$INSTANCE_NAME`_effects;
+
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_FlashInvert
+********************************************************************************
+*
+* Summary:
+*  Invert the whole display now and put it back after ticks ticks.
+*  Starting a flash while one is running just extends it.
+*
+* Parameters:
+*  ticks:  Length of the flash in `$INSTANCE_NAME`_EffectTick() calls
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_FlashInvert(uint32 ticks)
+{
+    if(`$INSTANCE_NAME`_effects.invertLeft == 0u)
+    {
+        `$INSTANCE_NAME`_Invert(1u);
+    }
+    `$INSTANCE_NAME`_effects.invertLeft = (uint16)((ticks != 0u) ? ticks : 1u);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_FadeContrast
+********************************************************************************
+*
+* Summary:
+*  Move the contrast in steps from its current setting to target over ticks
+*  ticks, then back again over returnTicks ticks.  Fading towards a low
+*  setting darkens the screen, towards a high one washes it out.  Only
+*  steps that change the setting are sent, a few bytes each.
+*
+* Parameters:
+*  target:       Contrast setting to fade to, as for `$INSTANCE_NAME`_Contrast()
+*  ticks:        Ticks to get there
+*  returnTicks:  Ticks to come back, or 0 to stay at target
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_FadeContrast(int32 target, uint32 ticks, uint32 returnTicks)
+{
+    `$INSTANCE_NAME`_EFFECTS *e = &`$INSTANCE_NAME`_effects;
+
+    if(e->fadePhase == 0u)
+    {
+        e->fadeBase = `$INSTANCE_NAME`_GetContrast();
+    }
+    e->fadeFrom = `$INSTANCE_NAME`_GetContrast();
+    e->fadeTo = target;
+    e->fadeTicks = (uint16)((ticks != 0u) ? ticks : 1u);
+    e->fadeElapsed = 0u;
+    e->returnTicks = (uint16)returnTicks;
+    e->fadePhase = 1u;
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_Blank
+********************************************************************************
+*
+* Summary:
+*  Turn the display off, keeping its contents, and back on after ticks
+*  ticks.  Drawing done meanwhile appears all at once when it comes back.
+*
+* Parameters:
+*  ticks:  Ticks to stay blank, or 0 to stay blank until `$INSTANCE_NAME`_On()
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_Blank(uint32 ticks)
+{
+    `$INSTANCE_NAME`_Off();
+    `$INSTANCE_NAME`_effects.blankLeft = (uint16)ticks;
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_EffectTick
+********************************************************************************
+*
+* Summary:
+*  Advance the running screen effects by one tick.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Non-zero while any effect is still running.
+*
+*******************************************************************************/
+uint32 `$INSTANCE_NAME`_EffectTick(void)
+{
+    `$INSTANCE_NAME`_EFFECTS *e = &`$INSTANCE_NAME`_effects;
+    int32 level;
+
+    if(e->invertLeft != 0u)
+    {
+        if(--e->invertLeft == 0u)
+        {
+            `$INSTANCE_NAME`_Invert(0u);
+        }
+    }
+
+    if(e->blankLeft != 0u)
+    {
+        if(--e->blankLeft == 0u)
+        {
+            `$INSTANCE_NAME`_On();
+        }
+    }
+
+    if(e->fadePhase != 0u)
+    {
+        e->fadeElapsed++;
+        level = e->fadeFrom + (((e->fadeTo - e->fadeFrom) * (int32)e->fadeElapsed) / (int32)e->fadeTicks);
+        if(level != `$INSTANCE_NAME`_GetContrast())
+        {
+            `$INSTANCE_NAME`_Contrast(level);
+        }
+
+        if(e->fadeElapsed >= e->fadeTicks)
+        {
+            if((e->fadePhase == 1u) && (e->returnTicks != 0u))
+            {
+                e->fadePhase = 2u;
+                e->fadeFrom = e->fadeTo;
+                e->fadeTo = e->fadeBase;
+                e->fadeTicks = e->returnTicks;
+                e->fadeElapsed = 0u;
+            }
+            else
+            {
+                e->fadePhase = 0u;
+            }
+        }
+    }
+
+    return (((e->invertLeft | e->blankLeft) != 0u) || (e->fadePhase != 0u)) ? 1u : 0u;
+}
+
+/* [] END OF FILE */
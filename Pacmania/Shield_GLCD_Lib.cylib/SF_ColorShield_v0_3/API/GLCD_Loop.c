@@ -0,0 +1,244 @@
+/*******************************************************************************
+* File Name: `$INSTANCE_NAME`_Loop.c
+* Version `$CY_MAJOR_VERSION`.`$CY_MINOR_VERSION`
+*
+*  Description:
+*    Fixed-timestep game loop on the SysTick timer.  A SysTick callback
+*    counts milliseconds and, with a rational accumulator so that 60 Hz is
+*    exact, the game ticks that have come due.  Each pass of
+*    `$INSTANCE_NAME`_LoopStep() sleeps until a tick is due, samples the
+*    input, runs the game's update once per tick and then renders with how
+*    far time has got towards the next tick, so motion can be drawn between
+*    ticks.  The game runs at the same speed however long a frame takes to
+*    draw; when drawing falls behind, renders are skipped, not updates.
+*
+********************************************************************************/
+
+#include <stddef.h>
+#include "cytypes.h"
+#include "CyLib.h"
+#include "cyPm.h"
+#include "`$INSTANCE_NAME`.h"
+
+static volatile uint32 `$INSTANCE_NAME`_loopMs = 0u;       /* SysTick interrupts  */
+static volatile uint32 `$INSTANCE_NAME`_loopDue = 0u;      /* ticks not yet run   */
+static volatile uint32 `$INSTANCE_NAME`_loopPhase = 0u;    /* ms * hz since the last tick, < 1000 */
+static uint32 `$INSTANCE_NAME`_loopHz = 50u;
+static uint32 `$INSTANCE_NAME`_loopReload = 1u;
+static uint32 `$INSTANCE_NAME`_loopTicks = 0u;
+static uint32 `$INSTANCE_NAME`_loopSkips = 0u;             /* renders skipped in a row */
+
+static `$INSTANCE_NAME`_LOOP_STATS `$INSTANCE_NAME`_loopStats;
+static const `$INSTANCE_NAME`_LOOP_STATS `$INSTANCE_NAME`_loopZero = {0u, 0u, 0u, 0u, 0u, 0u, 0u};
+
+static void `$INSTANCE_NAME`_LoopTick(void);
+
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_LoopStart
+********************************************************************************
+*
+* Summary:
+*  Start the SysTick timer at 1 ms, if it is not running already, and hook
+*  the loop onto it.  The first tick is due one period later.
+*
+* Parameters:
+*  hz:  Game ticks per second, 1 to 1000; 50 or 60 for most games
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_LoopStart(uint32 hz)
+{
+    uint8 intr;
+
+    CySysTickStart();
+    `$INSTANCE_NAME`_loopReload = CySysTickGetReload() + 1u;
+
+    intr = CyEnterCriticalSection();
+    `$INSTANCE_NAME`_loopHz = ((hz == 0u) || (hz > 1000u)) ? 50u : hz;
+    `$INSTANCE_NAME`_loopDue = 0u;
+    `$INSTANCE_NAME`_loopPhase = 0u;
+    CyExitCriticalSection(intr);
+
+    `$INSTANCE_NAME`_loopTicks = 0u;
+    `$INSTANCE_NAME`_loopSkips = 0u;
+    `$INSTANCE_NAME`_loopStats = `$INSTANCE_NAME`_loopZero;
+    (void)CySysTickSetCallback(`$INSTANCE_NAME`_LOOP_SYSTICK_SLOT, &`$INSTANCE_NAME`_LoopTick);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_LoopTick
+********************************************************************************
+*
+* Summary:
+*  SysTick callback, every millisecond.  A tick of 1/hz s is 1000 / hz ms,
+*  so the phase goes up by hz each millisecond and a tick is due each time
+*  it passes 1000.
+*
+*******************************************************************************/
+static void `$INSTANCE_NAME`_LoopTick(void)
+{
+    uint32 phase = `$INSTANCE_NAME`_loopPhase + `$INSTANCE_NAME`_loopHz;
+
+    `$INSTANCE_NAME`_loopMs++;
+    if(phase >= 1000u)
+    {
+        phase -= 1000u;
+        `$INSTANCE_NAME`_loopDue++;
+    }
+    `$INSTANCE_NAME`_loopPhase = phase;
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_LoopStep
+********************************************************************************
+*
+* Summary:
+*  One pass of the game loop; call it from the main loop.
+*
+*  Sleeps until a tick is due, calls input(), then update() once for each
+*  tick that has come due, at most `$INSTANCE_NAME`_LOOP_MAX_UPDATES times:
+*  ticks beyond that are dropped, so the game slows down rather than never
+*  catching up.  render() follows unless another tick came due while
+*  updating, in which case the pass ends so the next one can catch up; no
+*  more than `$INSTANCE_NAME`_LOOP_MAX_SKIPS renders in a row are skipped.
+*
+* Parameters:
+*  game:  The game's functions; input and update may be NULL
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_LoopStep(const `$INSTANCE_NAME`_GAME *game)
+{
+    uint32 start;
+    uint32 now;
+    uint32 due;
+    uint8 intr;
+
+    start = `$INSTANCE_NAME`_LoopMicros();
+    while(`$INSTANCE_NAME`_loopDue == 0u)
+    {
+        CySysPmSleep();
+    }
+    now = `$INSTANCE_NAME`_LoopMicros();
+    `$INSTANCE_NAME`_loopStats.idleUs = now - start;
+    start = now;
+
+    if(game->input != NULL)
+    {
+        game->input();
+    }
+
+    intr = CyEnterCriticalSection();
+    due = `$INSTANCE_NAME`_loopDue;
+    `$INSTANCE_NAME`_loopDue = 0u;
+    CyExitCriticalSection(intr);
+
+    if(due > `$INSTANCE_NAME`_LOOP_MAX_UPDATES)
+    {
+        `$INSTANCE_NAME`_loopStats.dropped += due - `$INSTANCE_NAME`_LOOP_MAX_UPDATES;
+        due = `$INSTANCE_NAME`_LOOP_MAX_UPDATES;
+    }
+    `$INSTANCE_NAME`_loopStats.updates = (uint16)due;
+    for( ; due != 0u; due--)
+    {
+        if(game->update != NULL)
+        {
+            game->update();
+        }
+        `$INSTANCE_NAME`_loopTicks++;
+    }
+    now = `$INSTANCE_NAME`_LoopMicros();
+    `$INSTANCE_NAME`_loopStats.updateUs = now - start;
+    start = now;
+
+    if((`$INSTANCE_NAME`_loopDue != 0u) && (`$INSTANCE_NAME`_loopSkips < `$INSTANCE_NAME`_LOOP_MAX_SKIPS))
+    {
+        /* Behind: catch up first */
+        `$INSTANCE_NAME`_loopSkips++;
+        `$INSTANCE_NAME`_loopStats.skipped++;
+        `$INSTANCE_NAME`_loopStats.renderUs = 0u;
+        return;
+    }
+    `$INSTANCE_NAME`_loopSkips = 0u;
+
+    game->render((`$INSTANCE_NAME`_loopPhase * 256u) / 1000u);
+    `$INSTANCE_NAME`_loopStats.renderUs = `$INSTANCE_NAME`_LoopMicros() - start;
+    `$INSTANCE_NAME`_loopStats.renders++;
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_LoopStats
+********************************************************************************
+*
+* Summary:
+*  Where the time of the last pass went, and counts since the loop started.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  The loop statistics
+*
+*******************************************************************************/
+const `$INSTANCE_NAME`_LOOP_STATS *`$INSTANCE_NAME`_LoopStats(void)
+{
+    return (&`$INSTANCE_NAME`_loopStats);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_LoopTicks
+********************************************************************************
+*
+* Summary:
+*  Game ticks run, that is update() calls, since the loop started.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Number of ticks
+*
+*******************************************************************************/
+uint32 `$INSTANCE_NAME`_LoopTicks(void)
+{
+    return (`$INSTANCE_NAME`_loopTicks);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_LoopMicros
+********************************************************************************
+*
+* Summary:
+*  Microseconds since the loop started, from the millisecond count and the
+*  SysTick counter.  Wraps after about 71 minutes; differences are still
+*  right across the wrap.  Must be called with interrupts enabled.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Time in microseconds
+*
+*******************************************************************************/
+uint32 `$INSTANCE_NAME`_LoopMicros(void)
+{
+    uint32 ms;
+    uint32 value;
+
+    do
+    {
+        ms = `$INSTANCE_NAME`_loopMs;
+        value = CySysTickGetValue();
+    }
+    while(ms != `$INSTANCE_NAME`_loopMs);
+
+    /* The counter runs down from the reload value once a millisecond */
+    return ((ms * 1000u) + (((`$INSTANCE_NAME`_loopReload - 1u - value) * 1000u) / `$INSTANCE_NAME`_loopReload));
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,153 @@
+/*******************************************************************************
+* File Name: `$INSTANCE_NAME`_Task.c
+* Version `$CY_MAJOR_VERSION`.`$CY_MINOR_VERSION`
+*
+*  Description:
+*    Cooperative tasks.  A task is a function that does a little drawing and
+*    returns, written as straight-line code with the protothread macros of
+*    `$INSTANCE_NAME`.h: `$INSTANCE_NAME`_TASK_YIELD() returns and the next
+*    run carries on from there.  `$INSTANCE_NAME`_TaskRun(), once a frame,
+*    gives every task one slice, so an explosion, the twinkling stars and the
+*    crosshair all move on together and no animation holds up the game.
+*
+*    Tasks live in a fixed table; local variables are lost at a yield, so
+*    what a task needs to keep is in its table entry.
+*
+********************************************************************************/
+
+#include <stddef.h>
+#include "cytypes.h"
+#include "`$INSTANCE_NAME`.h"
+
+static `$INSTANCE_NAME`_TASK `$INSTANCE_NAME`_tasks[`$INSTANCE_NAME`_TASK_MAX];
+
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_TaskStart
+********************************************************************************
+*
+* Summary:
+*  Add a task.  It runs from the top at the next `$INSTANCE_NAME`_TaskRun().
+*
+* Parameters:
+*  run:   The task function
+*  x, y:  Start arguments, kept in the task's x and y
+*
+* Return:
+*  The task's number, or -1 if the table is full
+*
+*******************************************************************************/
+int32 `$INSTANCE_NAME`_TaskStart(`$INSTANCE_NAME`_TASK_FUNC run, int32 x, int32 y)
+{
+    `$INSTANCE_NAME`_TASK *t;
+    uint32 i;
+
+    for(i = 0u; i < `$INSTANCE_NAME`_TASK_MAX; i++)
+    {
+        t = &`$INSTANCE_NAME`_tasks[i];
+        if(t->run == NULL)
+        {
+            t->run = run;
+            t->line = 0u;
+            t->wake = `$INSTANCE_NAME`_LoopTicks();
+            t->x = (int16)x;
+            t->y = (int16)y;
+            t->n = 0;
+            return ((int32)i);
+        }
+    }
+    return (-1);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_TaskStop
+********************************************************************************
+*
+* Summary:
+*  Remove a task where it stands; what it has drawn stays.
+*
+* Parameters:
+*  task:  Number returned by `$INSTANCE_NAME`_TaskStart()
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_TaskStop(int32 task)
+{
+    if((task >= 0) && (task < (int32)`$INSTANCE_NAME`_TASK_MAX))
+    {
+        `$INSTANCE_NAME`_tasks[task].run = NULL;
+    }
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_TaskRunning
+********************************************************************************
+*
+* Summary:
+*  Whether a task running a function is in the table.
+*
+* Parameters:
+*  run:  The task function
+*
+* Return:
+*  Number of tasks running it
+*
+*******************************************************************************/
+uint32 `$INSTANCE_NAME`_TaskRunning(`$INSTANCE_NAME`_TASK_FUNC run)
+{
+    uint32 i;
+    uint32 n = 0u;
+
+    for(i = 0u; i < `$INSTANCE_NAME`_TASK_MAX; i++)
+    {
+        n += (`$INSTANCE_NAME`_tasks[i].run == run) ? 1u : 0u;
+    }
+    return (n);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_TaskRun
+********************************************************************************
+*
+* Summary:
+*  Give each task that is not asleep one slice, in table order.  A task that
+*  returns `$INSTANCE_NAME`_TASK_DONE is removed.  Sleeps count game loop
+*  ticks, see `$INSTANCE_NAME`_LoopTicks().
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Number of tasks left
+*
+*******************************************************************************/
+uint32 `$INSTANCE_NAME`_TaskRun(void)
+{
+    `$INSTANCE_NAME`_TASK *t;
+    uint32 now = `$INSTANCE_NAME`_LoopTicks();
+    uint32 left = 0u;
+    uint32 i;
+
+    for(i = 0u; i < `$INSTANCE_NAME`_TASK_MAX; i++)
+    {
+        t = &`$INSTANCE_NAME`_tasks[i];
+        if(t->run == NULL)
+        {
+            continue;
+        }
+        if((int32)(now - t->wake) >= 0)
+        {
+            if(t->run(t) == `$INSTANCE_NAME`_TASK_DONE)
+            {
+                t->run = NULL;
+                continue;
+            }
+        }
+        left++;
+    }
+    return (left);
+}
+
+/* [] END OF FILE */
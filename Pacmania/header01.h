@@ -10,4 +10,16 @@
  * ========================================
 */
 #define CENTER 62
+
+// Analog joystick on the SAR ADC, driven from ADC_INT.c
+#define JOYSTICK_SYSTICK_SLOT 3u  // SysTick callback that starts each scan
+#define JOYSTICK_MAX 256          // reading at full deflection
+
+typedef struct {
+    int16 x, y;     // -JOYSTICK_MAX .. JOYSTICK_MAX, 0 in the dead zone
+    uint8 ready;    // 0 until the centre has been found
+} JOYSTICK;
+
+void Joystick_Start(void);
+void Joystick_Read(JOYSTICK *stick);
 /* [] END OF FILE */
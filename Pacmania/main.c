@@ -8,24 +8,132 @@
 
 #include <device.h>
 #include <header01.h>
-#include <math.h> 
- 
-void GLCD_Draw_Line_Polar(int centerX, int centerY, int angle, int length, int color) {
-    //draw a line from a center point to a point defined using a polar coordinate system
-    double pi = 3.14;
-    int x,y;
-    x=length*cos(angle*pi/180);
-    y=length*sin(angle*pi/180);
-    int x2 = centerX+x;
-    int y2 = centerY+y;
-    GLCD_DrawLine(centerX,centerY,y2,x2, color);
+
+#define RADIUS     49   // radius of the Pacman body
+#define MOUTH_MAX  35   // half-angle of the fully open mouth, in degrees
+#define MOUTH_SPEED 3   // degrees a tick the mouth opens or closes
+#define DOT_START  59   // how far from the center the dot comes in
+#define DOT_SPEED  2    // columns a tick the dot moves
+#define TICK_HZ    60   // game ticks a second
+
+int16 x = CENTER;  // x and y coordinates for center of circle
+int16 y = CENTER;
+int16 mouth = 0;   // half-angle the mouth is open now
+int16 dot = 0;     // where the dot is shown, from the center; 0 for none
+
+// The animation is a task: the mouth opens, a dot goes in and the mouth
+// closes, round and round. It draws a tick's worth and sleeps, so nothing
+// else waits for it. Its counter is t->n, kept while it sleeps
+uint32 pacman(GLCD_TASK *t)
+{
+    GLCD_TASK_BEGIN(t);
+    for (;;) {
+        //open the mouth: each step only paints the 1 degree wedges between
+        //the old and the new mouth edges
+        for (t->n = 0; t->n < MOUTH_MAX; t->n++) {
+            GLCD_FillSector(x,y,RADIUS,t->n,t->n+1,GLCD_BLACK);
+            GLCD_FillSector(x,y,RADIUS,-t->n-1,-t->n,GLCD_BLACK);
+            mouth = t->n+1;
+            if (t->n % MOUTH_SPEED == MOUTH_SPEED-1)
+                GLCD_TASK_SLEEP(t,1);
+        }
+        //a little moving dot, shown for a tick at each place
+        for (t->n = DOT_START; t->n > 20; t->n -= DOT_SPEED) {
+            GLCD_FillCircle(x,y+t->n,4,GLCD_PINK);
+            dot = t->n;
+            GLCD_TASK_SLEEP(t,1);
+            GLCD_FillCircle(x,y+t->n,4,GLCD_BLACK);
+            dot = 0;
+        }
+        //close the mouth
+        for (t->n = MOUTH_MAX; t->n > 0; t->n--) {
+            GLCD_FillSector(x,y,RADIUS,t->n-1,t->n,GLCD_YELLOW);
+            GLCD_FillSector(x,y,RADIUS,-t->n,-t->n+1,GLCD_YELLOW);
+            mouth = t->n-1;
+            if (t->n % MOUTH_SPEED == 1)
+                GLCD_TASK_SLEEP(t,1);
+        }
+    }
+    GLCD_TASK_END(t);
+}
+
+// Pushing the joystick in pauses the animation, and again carries it on
+static const GLCD_INPUT_PIN buttonPins[] = { GLCD_INPUT_PIN_INIT(Joy_Center) };
+uint8 paused = 0;
+
+// The pushes since the last pass, from the button events
+void input(void)
+{
+    GLCD_INPUT_EVENT e;
+
+    while (GLCD_InputRead(&e)) {
+        if (e.type == GLCD_INPUT_PRESSED)
+            paused = !paused;
+    }
+}
+
+#if defined(CY_ADC_SAR_SEQ_ADC_H)
+// With the analog joystick in the design it steers the Pacman, faster the
+// further it is pushed. The place is kept in 1/256 pixels so that slow
+// moves still get somewhere
+#define STICK_SPEED 3   // pixels a tick at full deflection
+
+int32 xPos = CENTER*256;
+int32 yPos = CENTER*256;
+
+// Stick X goes along y, the way the mouth faces, and stick Y along x
+void update(void)
+{
+    JOYSTICK stick;
+
+    Joystick_Read(&stick);
+    xPos += stick.y * STICK_SPEED;
+    yPos += stick.x * STICK_SPEED;
+    if (xPos < RADIUS*256) xPos = RADIUS*256;
+    if (xPos > (131-RADIUS)*256) xPos = (131-RADIUS)*256;
+    if (yPos < RADIUS*256) yPos = RADIUS*256;
+    if (yPos > (131-DOT_START-4)*256) yPos = (131-DOT_START-4)*256;
 }
+
+// Paint the Pacman out and draw it again at its new place, mouth and dot
+// as the task has them, in one frame so the overlap goes out once
+void move(int16 newX, int16 newY)
+{
+    GLCD_BeginFrame();
+    GLCD_FillCircle(x,y,RADIUS,GLCD_BLACK);
+    if (dot)
+        GLCD_FillCircle(x,y+dot,4,GLCD_BLACK);
+    x = newX;
+    y = newY;
+    GLCD_FillCircle(x,y,RADIUS,GLCD_YELLOW);
+    if (mouth)
+        GLCD_FillSector(x,y,RADIUS,-mouth,mouth,GLCD_BLACK);
+    if (dot)
+        GLCD_FillCircle(x,y+dot,4,GLCD_PINK);
+    GLCD_EndFrame();
+}
+#endif
+
+// Each frame the tasks draw their next slice
+void render(uint32 alpha)
+{
+    (void)alpha;
+#if defined(CY_ADC_SAR_SEQ_ADC_H)
+    if ((xPos >> 8) != x || (yPos >> 8) != y)
+        move(xPos >> 8, yPos >> 8);
+#endif
+    if (!paused)
+        GLCD_TaskRun();
+}
+
+#if defined(CY_ADC_SAR_SEQ_ADC_H)
+static const GLCD_GAME game = { input, update, render };
+#else
+static const GLCD_GAME game = { input, NULL, render };
+#endif
+
 int main()
 {
-    int16 i;       // counter variable -- int16 will take up less room than int32
-    int16 x = CENTER;  // x and y coordinates for center of circle
-    int16 y = CENTER;
-	
 	// Initialize LCD
     GLCD_Start();  
     Backlight_Write(1);       // turn on backlight
@@ -36,31 +144,16 @@ int main()
     // clear LCD to black
     GLCD_Clear(GLCD_BLACK);
         
-    // Draw a filled circle in yellow by drawing a series of circles of increasing radius 
-    for (i = 0; i<50; i++) {
-        GLCD_DrawCircle (x,y,i, GLCD_YELLOW);
-    }
-    //Loop for animation
+    // Draw the body as one filled circle in yellow
+    GLCD_FillCircle(x,y,RADIUS,GLCD_YELLOW);
+    //Loop for animation: sleep until the next tick, then the task draws
+    GLCD_TaskStart(pacman,x,y);
+    GLCD_InputStart(buttonPins,1);
+#if defined(CY_ADC_SAR_SEQ_ADC_H)
+    Joystick_Start();
+#endif
+    GLCD_LoopStart(TICK_HZ);
     while(1) {
-        //for loop to open the mouth
-        for (int i =0;i<35;i++) {   
-            GLCD_Draw_Line_Polar(x,y,i,50,GLCD_BLACK);                  
-            GLCD_Draw_Line_Polar(x,y,-i,50,GLCD_BLACK);
-        }
-        //for loop to make a little moving dot
-        for (int j = 121;j>y+20;j--) {
-            for (int i = 0; i<5; i++) {
-                GLCD_DrawCircle(x,j,i,GLCD_PINK);
-            }
-            for (int i = 0; i<5; i++) {
-                GLCD_DrawCircle(x,j,i,GLCD_BLACK);
-            }
-        }
-        //for loop to close the mouth
-        for (int i =325;i<360;i++) {   
-            GLCD_Draw_Line_Polar(x,y,i,50,GLCD_YELLOW);                  
-            GLCD_Draw_Line_Polar(x,y,-i,50,GLCD_YELLOW);
-        }
+        GLCD_LoopStep(&game);
     }	
 }
-
@@ -41,30 +41,283 @@ uint8 GLCD_driver;
 static int32 GLCD_x_offset = 0;
 static int32 GLCD_y_offset = 0;
 
+/* Last setting passed to GLCD_Contrast() */
+static int32 GLCD_contrast = 0;
+
+/* Hardware scroll: rows scrollTop .. scrollTop + scrollRows - 1 (driver x) */
+/* scroll, the content moved scrollOffset rows towards higher x.  No rows   */
+/* means scrolling is off.                                                  */
+static int32 GLCD_scrollTop = 0;
+static int32 GLCD_scrollRows = 0;
+static int32 GLCD_scrollOffset = 0;
+
+/* A 12-bit pixel stream packs two pixels into three bytes.  When an odd    */
+/* number of pixels has been written the low nibble of the last pixel is    */
+/* held here until the next pixel, the end of the window or the next       */
+/* command completes the byte.                                              */
+static uint32 GLCD_halfPixel = 0u;
+static uint32 GLCD_halfNibble = 0u;
+
+/* Pixels still to be written before the open window is full. */
+static uint32 GLCD_windowLeft = 0u;
+
+/* Bytes, commands and data, handed to the SPI master since Start. */
+static uint32 GLCD_bytesSent = 0u;
+
+/* What the controller's address registers hold, so that SetWindow can skip */
+/* a PAGEADDR or COLADDR that would not change anything and Pixel can keep */
+/* streaming into a window whose write pointer is already where it needs   */
+/* to be.  An empty range (x0 > x1) means the register is unknown.          */
+typedef struct
+{
+    int32 x0;           /* page range, driver coordinates                  */
+    int32 x1;
+    int32 y0;           /* column range                                     */
+    int32 y1;
+    uint32 scan;        /* fill order, SCAN_ROWS or SCAN_COLUMNS             */
+    uint32 open;        /* RAMWR in progress and the stream is byte aligned */
+    uint32 hits;        /* address commands skipped                          */
+    uint32 misses;      /* address commands sent                             */
+} GLCD_WINDOW_CACHE;
+
+static GLCD_WINDOW_CACHE GLCD_window = { 1, 0, 1, 0, GLCD_SCAN_ROWS, 0u, 0u, 0u };
+
+#if (GLCD_SHADOW != 0u)
+/* Shadow of the display memory, in pixel values as sent on the wire.  Each */
+/* 8x8 block has one ink value; a pixel's bit is set where it holds the ink */
+/* and clear where it is black (0).  A block that gets a second color is    */
+/* marked unknown until it is filled whole again.  The cursor follows the   */
+/* write pointer of the open window.                                         */
+#define GLCD_SHADOW_BLOCKS   17u
+#define GLCD_SHADOW_UNKNOWN  0x8000u
+
+static uint8 GLCD_shadowBits[GLCD_MAXX + 1u][GLCD_SHADOW_BLOCKS];
+static uint16 GLCD_shadowInk[GLCD_SHADOW_BLOCKS][GLCD_SHADOW_BLOCKS];
+static int32 GLCD_shadowX = 0;
+static int32 GLCD_shadowY = 0;
+static uint32 GLCD_shadowLeft = 0u;
+static uint32 GLCD_shadowSkipped = 0u;
+
+static void GLCD_ShadowReset(void);
+static int32 GLCD_ShadowGet(int32 x, int32 y);
+static void GLCD_ShadowPut(int32 x, int32 y, uint32 value);
+static void GLCD_ShadowNext(uint32 value);
+static void GLCD_ShadowRect(int32 x0, int32 y0, int32 x1, int32 y1, uint32 value);
+static uint32 GLCD_ShadowTrim(int32 *x0, int32 *y0, int32 *x1, int32 *y1, uint32 value);
+#endif
+
+/* Where the last pixel went, to guess which way a run of pixels is going. */
+static int32 GLCD_lastX = -1;
+static int32 GLCD_lastY = -1;
+
+/* Clip rectangle of the drawing functions, always on the screen, and the  */
+/* outcodes of a point against it for the line clipper.                     */
+#define GLCD_CLIP_ABOVE   0x01u   /* x < clipX0 */
+#define GLCD_CLIP_BELOW   0x02u   /* x > clipX1 */
+#define GLCD_CLIP_LEFT    0x04u   /* y < clipY0 */
+#define GLCD_CLIP_RIGHT   0x08u   /* y > clipY1 */
+
+#define GLCD_CLIP_OUT     0u      /* ClipBox(): no part inside */
+#define GLCD_CLIP_PART    1u      /*            cut by an edge */
+#define GLCD_CLIP_IN      2u      /*            all of it      */
+
+static int32 GLCD_clipX0 = (int32)GLCD_MINX;
+static int32 GLCD_clipY0 = (int32)GLCD_MINY;
+static int32 GLCD_clipX1 = (int32)GLCD_MAXX;
+static int32 GLCD_clipY1 = (int32)GLCD_MAXY;
+
+static uint32 GLCD_ClipCode(int32 x, int32 y);
+static uint32 GLCD_ClipBox(int32 x0, int32 y0, int32 x1, int32 y1);
+static void GLCD_StepRange(int32 from, int32 step, int32 lo, int32 hi, int32 *first, int32 *last);
+
+/* Pixel format on the wire, and the driver's copy of the controller LUT    */
+/* used in 8-bit mode: levels for red 0-7, green 0-7, then blue 0-3.        */
+static uint32 GLCD_colorMode = GLCD_COLOR_12BIT;
+static uint8 GLCD_palette[GLCD_PALETTE_SIZE];
+
+/* Linear ramps, so that a 12-bit color maps to the index made of the top   */
+/* bits of each channel.                                                     */
+const uint8 GLCD_DEFAULT_PALETTE[GLCD_PALETTE_SIZE] =
+{
+    0u, 2u, 4u, 6u, 8u, 10u, 12u, 15u,      /* red   */
+    0u, 2u, 4u, 6u, 8u, 10u, 12u, 15u,      /* green */
+    0u, 5u, 10u, 15u                        /* blue  */
+};
+
+/* The transmit path is interrupt driven when the SPIM has its TX interrupt */
+/* (UDB: "Enable TX Internal Interrupt", SCB: internal IRQ) and polled     */
+/* otherwise.                                                              */
+#if (GLCD_SPIM_TYPE == GLCD_SPIM_UDB_TYPE)
+#define GLCD_TX_ISR_ENABLED  (0u != GLCD_SPIM_UDB_INTERNAL_TX_INT_ENABLED)
+#else
+#define GLCD_TX_ISR_ENABLED  (GLCD_SPIM_UDB_SCB_IRQ_INTERNAL)
+#endif
+
+#if (GLCD_TX_ISR_ENABLED)
+/* Ring of 9-bit SPI words waiting for the TX FIFO.  Head and tail run     */
+/* freely; the main loop only advances the head and the ISR the tail.      */
+#define GLCD_TX_QUEUE_MASK   (GLCD_TX_QUEUE_SIZE - 1u)
+
+/* A queue entry with this bit set is a run: the three words after it, a   */
+/* pixel pair, are sent the number of times in its low bits.                */
+#define GLCD_TX_RUN          0x8000u
+#define GLCD_TX_RUN_MAX      0x7FFFu
+
+static uint16 GLCD_txQueue[GLCD_TX_QUEUE_SIZE];
+static volatile uint32 GLCD_txHead = 0u;
+static volatile uint32 GLCD_txTail = 0u;
+static uint32 GLCD_txHighWater = 0u;
+static uint32 GLCD_txRunLeft = 0u;       /* ISR only: words left in the run */
+static uint32 GLCD_txRunWord = 0u;       /*           and the next of the 3 */
+
+static CY_ISR_PROTO(GLCD_TxIsr);
+static void GLCD_TxKick(void);
+static uint32 GLCD_TxNext(void);
+#endif
+
+/* Runs of at least this many pixels of one color in a pixel stream are   */
+/* sent as a solid run.                                                   */
+#define GLCD_RUN_MIN         8u
+
+static void GLCD_Send(uint32 word);
+static void GLCD_SendRun(uint32 b0, uint32 b1, uint32 b2, uint32 count);
+static void GLCD_StreamSolid(uint32 c, uint32 n);
+static void GLCD_FlushHalfPixel(void);
+static void GLCD_CountPixels(uint32 n);
+static void GLCD_InvalidateWindow(void);
+static uint32 GLCD_PixelValue(int32 color);
+static void GLCD_UploadPalette(void);
+static void GLCD_WritePair(uint32 c0, uint32 c1);
+static void GLCD_SendAddressMode(void);
+static void GLCD_FillArea(int32 x0, int32 y0, int32 x1, int32 y1, int32 color);
+static void GLCD_FillSpan(int32 x, int32 y0, int32 y1, int32 color);
+
+/* Directions [a, a + 180 degrees) about a sector's apex, given by the unit */
+/* vector of a in Q1.15.  u runs along y (0 degrees), v along x (90).       */
+typedef struct
+{
+    int32 cs;
+    int32 sn;
+} GLCD_HALFPLANE;
+
+/* A sector split into at most two convex pieces.  Piece i covers from[i],  */
+/* less to[i] when hasTo[i] is set.  Only rows vMin..vMax can be touched.   */
+typedef struct
+{
+    uint32 pieces;
+    GLCD_HALFPLANE from[2];
+    GLCD_HALFPLANE to[2];
+    uint32 hasTo[2];
+    int32 vMin;
+    int32 vMax;
+} GLCD_SECTOR;
+
+static void GLCD_SetHalfPlane(GLCD_HALFPLANE *hp, int32 angle);
+static int32 GLCD_FloorDiv(int32 n, int32 d);
+static void GLCD_HalfPlaneRow(const GLCD_HALFPLANE *hp, int32 v, uint32 inside, int32 *lo, int32 *hi);
+static void GLCD_DiscRow(int32 x0, int32 y0, int32 v, int32 h, int32 color, const GLCD_SECTOR *sector);
+static void GLCD_FillDisc(int32 x0, int32 y0, int32 radius, int32 color, const GLCD_SECTOR *sector);
+
+/*******************************************************************************
+* Function Name: GLCD_FlushHalfPixel
+********************************************************************************
+*
+* Summary:
+*  Send the held low nibble of an odd trailing pixel, padded to a full byte.
+*  The padding leaves the controller part way into the next pixel, so the
+*  open window cannot be continued afterwards.
+*
+*******************************************************************************/
+static void GLCD_FlushHalfPixel(void)
+{
+    if(GLCD_halfPixel != 0u)
+    {
+        GLCD_halfPixel = 0u;
+        GLCD_window.open = 0u;
+        GLCD_Data(GLCD_halfNibble);
+    }
+}
+
+/*******************************************************************************
+* Function Name: GLCD_CountPixels
+********************************************************************************
+*
+* Summary:
+*  Account for n pixels written to the open window.  Once the window is full
+*  an odd trailing pixel is completed straight away rather than waiting for
+*  the next command, and the window is closed to further Pixel calls.
+*
+*******************************************************************************/
+static void GLCD_CountPixels(uint32 n)
+{
+    if(n >= GLCD_windowLeft)
+    {
+        GLCD_windowLeft = 0u;
+        GLCD_window.open = 0u;
+        GLCD_FlushHalfPixel();
+    }
+    else
+    {
+        GLCD_windowLeft -= n;
+    }
+}
+
 /*******************************************************************************
 * Function Name: GLCD_Command
 ********************************************************************************
 *
 * Summary:
-*  This function sends a command to the LCD controller.  
+*  This function sends a command to the LCD controller.  Any half-written
+*  pixel left over from a pixel stream is completed first, since a command
+*  terminates the current memory write.  Address commands sent from outside
+*  GLCD_SetWindow() make the window cache forget that register.
 *
-* Parameters:  
-*  cmdData:  This is the command to be sent to the LCD controller  
+* Parameters:
+*  cmdData:  This is the command to be sent to the LCD controller
+*
+* Return:
+*  None
 *
-* Return: 
-*  None 
-*  
 *******************************************************************************/
 void GLCD_Command(uint32 cmdData)
 {
-#if (GLCD_SPIM_TYPE == GLCD_SPIM_UDB_TYPE)
-  while((GLCD_SPIM_UDB_ReadTxStatus() & (GLCD_SPIM_UDB_STS_SPI_DONE | GLCD_SPIM_UDB_STS_SPI_IDLE) )== 0);
-  GLCD_SPIM_UDB_WriteTxData((uint16)cmdData);
-#endif
+    GLCD_FlushHalfPixel();
+    GLCD_window.open = 0u;
 
-#if (GLCD_SPIM_TYPE == GLCD_SPIM_SCB_TYPE)
-    GLCD_SPIM_UDB_SpiUartWriteTxData(cmdData);
-#endif
+    if(cmdData == GLCD_PAGEADDR)
+    {
+        GLCD_window.x0 = 1;
+        GLCD_window.x1 = 0;
+    }
+    else if(cmdData == GLCD_COLADDR)
+    {
+        GLCD_window.y0 = 1;
+        GLCD_window.y1 = 0;
+    }
+    else
+    {
+        /* Address registers unaffected */
+    }
+
+    GLCD_Send(cmdData);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_InvalidateWindow
+********************************************************************************
+*
+* Summary:
+*  Forget the cached address window, e.g. after a controller reset.
+*
+*******************************************************************************/
+static void GLCD_InvalidateWindow(void)
+{
+    GLCD_window.x0 = 1;
+    GLCD_window.x1 = 0;
+    GLCD_window.y0 = 1;
+    GLCD_window.y1 = 0;
+    GLCD_window.open = 0u;
+    GLCD_windowLeft = 0u;
 }
 
 /*******************************************************************************
@@ -84,20 +337,360 @@ void GLCD_Command(uint32 cmdData)
 *******************************************************************************/
 void GLCD_Data(uint32 rawData)
 {	
+    GLCD_Send(rawData | 0x0100u);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_Send
+********************************************************************************
+*
+* Summary:
+*  Hand one 9-bit word to the SPI master.  With the TX interrupt available the
+*  word is queued and the function returns at once unless the queue is full;
+*  without it the word goes straight into the TX FIFO, waiting only for FIFO
+*  space rather than for the previous word to finish shifting out.
+*
+* Parameters:  
+*  word:  D/C bit and data byte. 
+*
+* Return: 
+*  None 
+*  
+*******************************************************************************/
+static void GLCD_Send(uint32 word)
+{
+    GLCD_bytesSent++;
+
+#if (GLCD_TX_ISR_ENABLED)
+
+    while((GLCD_txHead - GLCD_txTail) >= GLCD_TX_QUEUE_SIZE)
+    {
+        /* Queue full: wait for the ISR to make room */
+    }
+
+    GLCD_txQueue[GLCD_txHead & GLCD_TX_QUEUE_MASK] = (uint16)word;
+    GLCD_txHead++;
+    GLCD_TxKick();
+
+#else
+
 #if (GLCD_SPIM_TYPE == GLCD_SPIM_UDB_TYPE)
-    uint16 data16;
-    data16 = (uint16)rawData | 0x0100;
-	
-    while((GLCD_SPIM_UDB_ReadTxStatus() & (GLCD_SPIM_UDB_STS_SPI_DONE | GLCD_SPIM_UDB_STS_SPI_IDLE) )== 0);
-    GLCD_SPIM_UDB_WriteTxData(data16);
+    GLCD_SPIM_UDB_WriteTxData((uint16)word);
+#else
+    GLCD_SPIM_UDB_SpiUartWriteTxData(word);
 #endif
 
-#if (GLCD_SPIM_TYPE == GLCD_SPIM_SCB_TYPE)
+#endif /* (GLCD_TX_ISR_ENABLED) */
+}
+
+/*******************************************************************************
+* Function Name: GLCD_SendRun
+********************************************************************************
+*
+* Summary:
+*  Send three data bytes, a 12-bit pixel pair or three 8-bit pixels, count
+*  times over.  With the TX interrupt the run takes four queue entries
+*  however long it is, and the ISR expands it straight into the FIFO;
+*  without it the bytes go into the FIFO from one loop, with no per-byte
+*  call through GLCD_Send().
+*
+* Parameters:
+*  b0, b1, b2:  The bytes, as sent
+*  count:       Number of times
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void GLCD_SendRun(uint32 b0, uint32 b1, uint32 b2, uint32 count)
+{
+#if (GLCD_TX_ISR_ENABLED)
+    uint32 n;
+#endif
+
+    b0 |= 0x0100u;
+    b1 |= 0x0100u;
+    b2 |= 0x0100u;
+    GLCD_bytesSent += 3u * count;
+
+#if (GLCD_TX_ISR_ENABLED)
+
+    while(count != 0u)
+    {
+        n = (count > GLCD_TX_RUN_MAX) ? GLCD_TX_RUN_MAX : count;
+        count -= n;
+        while((GLCD_txHead - GLCD_txTail) > (GLCD_TX_QUEUE_SIZE - 4u))
+        {
+            /* Wait for the ISR to make room */
+        }
+
+        /* The pattern first: the ISR may start on the run once the head moves */
+        GLCD_txQueue[(GLCD_txHead + 1u) & GLCD_TX_QUEUE_MASK] = (uint16)b0;
+        GLCD_txQueue[(GLCD_txHead + 2u) & GLCD_TX_QUEUE_MASK] = (uint16)b1;
+        GLCD_txQueue[(GLCD_txHead + 3u) & GLCD_TX_QUEUE_MASK] = (uint16)b2;
+        GLCD_txQueue[GLCD_txHead & GLCD_TX_QUEUE_MASK] = (uint16)(GLCD_TX_RUN | n);
+        GLCD_txHead += 4u;
+        GLCD_TxKick();
+    }
+
+#else
+
+    for( ; count != 0u; count--)
+    {
+#if (GLCD_SPIM_TYPE == GLCD_SPIM_UDB_TYPE)
+        GLCD_SPIM_UDB_WriteTxData((uint16)b0);
+        GLCD_SPIM_UDB_WriteTxData((uint16)b1);
+        GLCD_SPIM_UDB_WriteTxData((uint16)b2);
+#else
+        GLCD_SPIM_UDB_SpiUartWriteTxData(b0);
+        GLCD_SPIM_UDB_SpiUartWriteTxData(b1);
+        GLCD_SPIM_UDB_SpiUartWriteTxData(b2);
+#endif
+    }
+
+#endif /* (GLCD_TX_ISR_ENABLED) */
+}
+
+#if (GLCD_TX_ISR_ENABLED)
+/*******************************************************************************
+* Function Name: GLCD_TxKick
+********************************************************************************
+*
+* Summary:
+*  Note the queue depth and (re)arm the FIFO-not-full interrupt after words
+*  were queued; the ISR disarms it when drained.
+*
+*******************************************************************************/
+static void GLCD_TxKick(void)
+{
+    uint32 depth = GLCD_txHead - GLCD_txTail;
+
+    if(depth > GLCD_txHighWater)
+    {
+        GLCD_txHighWater = depth;
+    }
+
+#if (GLCD_SPIM_TYPE == GLCD_SPIM_UDB_TYPE)
+    GLCD_SPIM_UDB_SetTxInterruptMode(GLCD_SPIM_UDB_STS_TX_FIFO_NOT_FULL);
+#else
+    GLCD_SPIM_UDB_SetTxInterruptMode(GLCD_SPIM_UDB_INTR_TX_NOT_FULL);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: GLCD_TxNext
+********************************************************************************
+*
+* Summary:
+*  Take the next word for the FIFO off the queue, which must not be empty.
+*  A run stays at the tail until its last word has been taken.
+*
+*******************************************************************************/
+static uint32 GLCD_TxNext(void)
+{
+    uint32 word = GLCD_txQueue[GLCD_txTail & GLCD_TX_QUEUE_MASK];
+
+    if((word & GLCD_TX_RUN) == 0u)
+    {
+        GLCD_txTail++;
+        return (word);
+    }
+
+    if(GLCD_txRunLeft == 0u)
+    {
+        GLCD_txRunLeft = (word & GLCD_TX_RUN_MAX) * 3u;
+        GLCD_txRunWord = 0u;
+    }
+    word = GLCD_txQueue[(GLCD_txTail + 1u + GLCD_txRunWord) & GLCD_TX_QUEUE_MASK];
+    GLCD_txRunWord = (GLCD_txRunWord == 2u) ? 0u : (GLCD_txRunWord + 1u);
+    GLCD_txRunLeft--;
+    if(GLCD_txRunLeft == 0u)
+    {
+        GLCD_txTail += 4u;
+    }
+    return (word);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_TxIsr
+********************************************************************************
+*
+* Summary:
+*  TX FIFO not full interrupt.  Moves queued words into the FIFO until it is
+*  full or the queue is empty, and disarms itself once the queue is drained.
+*
+*******************************************************************************/
+static CY_ISR(GLCD_TxIsr)
+{
+#if (GLCD_SPIM_TYPE == GLCD_SPIM_UDB_TYPE)
+    while(GLCD_txTail != GLCD_txHead)
+    {
+        if(0u == (GLCD_SPIM_UDB_ReadTxStatus() & GLCD_SPIM_UDB_STS_TX_FIFO_NOT_FULL))
+        {
+            break;
+        }
+        CY_SET_REG16(GLCD_SPIM_UDB_TXDATA_PTR, (uint16)GLCD_TxNext());
+    }
+#else
+    while((GLCD_txTail != GLCD_txHead) && (GLCD_SPIM_UDB_GET_TX_FIFO_ENTRIES < GLCD_SPIM_UDB_FIFO_SIZE))
+    {
+        GLCD_SPIM_UDB_TX_FIFO_WR_REG = GLCD_TxNext();
+    }
+    GLCD_SPIM_UDB_ClearTxInterruptSource(GLCD_SPIM_UDB_INTR_TX_NOT_FULL);
+#endif
+
+    if(GLCD_txTail == GLCD_txHead)
+    {
+        GLCD_SPIM_UDB_SetTxInterruptMode(0u);
+    }
+}
+#endif /* (GLCD_TX_ISR_ENABLED) */
+
+/*******************************************************************************
+* Function Name: GLCD_Flush
+********************************************************************************
+*
+* Summary:
+*  Complete any half-written pixel and wait until every queued word has been
+*  shifted out to the LCD.  Call this before a delay that must follow a
+*  command or a pixel, or before stopping the SPIM.
+*
+* Parameters:  
+*  None
+*
+* Return: 
+*  None 
+*  
+*******************************************************************************/
+void GLCD_Flush(void)
+{
+    GLCD_FlushHalfPixel();
+
+#if (GLCD_TX_ISR_ENABLED)
+    while(GLCD_txTail != GLCD_txHead)
+    {
+        /* Wait for the ISR to empty the queue */
+    }
+#endif
+
+#if (GLCD_SPIM_TYPE == GLCD_SPIM_UDB_TYPE)
+    while((GLCD_SPIM_UDB_ReadTxStatus() & GLCD_SPIM_UDB_STS_TX_FIFO_EMPTY) == 0u);
+    while((GLCD_SPIM_UDB_ReadTxStatus() & (GLCD_SPIM_UDB_STS_SPI_DONE | GLCD_SPIM_UDB_STS_SPI_IDLE)) == 0u);
+#else
+    while(GLCD_SPIM_UDB_SpiUartGetTxBufferSize() != 0u);
+    while(GLCD_SPIM_UDB_SpiIsBusBusy() != 0u);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: GLCD_TxQueueDepth
+********************************************************************************
+*
+* Summary:
+*  Number of words currently waiting in the transmit queue.  Always zero
+*  when the SPIM has no TX interrupt and words are written directly.
+*
+*******************************************************************************/
+uint32 GLCD_TxQueueDepth(void)
+{
+#if (GLCD_TX_ISR_ENABLED)
+    return (GLCD_txHead - GLCD_txTail);
+#else
+    return (0u);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: GLCD_TxQueueHighWater
+********************************************************************************
+*
+* Summary:
+*  Deepest the transmit queue has been since Start or the last reset.  A
+*  value equal to GLCD_TX_QUEUE_SIZE means the main loop had to wait.
+*
+*******************************************************************************/
+uint32 GLCD_TxQueueHighWater(void)
+{
+#if (GLCD_TX_ISR_ENABLED)
+    return (GLCD_txHighWater);
+#else
+    return (0u);
+#endif
+}
 
-    rawData = rawData | 0x00000100;
-    GLCD_SPIM_UDB_SpiUartWriteTxData(rawData);
+/*******************************************************************************
+* Function Name: GLCD_TxQueueResetHighWater
+********************************************************************************
+*
+* Summary:
+*  Restart high-water measurement, e.g. at the start of a frame.
+*
+*******************************************************************************/
+void GLCD_TxQueueResetHighWater(void)
+{
+#if (GLCD_TX_ISR_ENABLED)
+    GLCD_txHighWater = GLCD_txHead - GLCD_txTail;
 #endif
+}
+
+/*******************************************************************************
+* Function Name: GLCD_WindowCacheHits
+********************************************************************************
+*
+* Summary:
+*  Number of PAGEADDR/COLADDR commands the window cache has saved since
+*  Start or the last reset.  A pixel streamed into an already open window
+*  counts as two.
+*
+*******************************************************************************/
+uint32 GLCD_WindowCacheHits(void)
+{
+    return (GLCD_window.hits);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_WindowCacheMisses
+********************************************************************************
+*
+* Summary:
+*  Number of PAGEADDR/COLADDR commands actually sent since Start or the last
+*  reset.
+*
+*******************************************************************************/
+uint32 GLCD_WindowCacheMisses(void)
+{
+    return (GLCD_window.misses);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_WindowCacheResetStats
+********************************************************************************
+*
+* Summary:
+*  Zero the window cache counters, e.g. at the start of a frame.
+*
+*******************************************************************************/
+void GLCD_WindowCacheResetStats(void)
+{
+    GLCD_window.hits = 0u;
+    GLCD_window.misses = 0u;
+}
 
+/*******************************************************************************
+* Function Name: GLCD_BytesSent
+********************************************************************************
+*
+* Summary:
+*  Bytes handed to the SPI master since GLCD_Start(), commands
+*  and data together.
+*
+* Return:
+*  Byte count
+*
+*******************************************************************************/
+uint32 GLCD_BytesSent(void)
+{
+    return (GLCD_bytesSent);
 }
 
 /*******************************************************************************
@@ -122,6 +715,34 @@ void GLCD_Start(void)
     GLCD_SPIM_UDB_SpiSetActiveSlaveSelect(3u);
 #endif
 
+#if (GLCD_TX_ISR_ENABLED)
+    /* Take over the TX interrupt to feed the FIFO from the driver queue */
+    GLCD_txHead = 0u;
+    GLCD_txTail = 0u;
+    GLCD_txHighWater = 0u;
+    GLCD_txRunLeft = 0u;
+    GLCD_SPIM_UDB_SetTxInterruptMode(0u);
+#if (GLCD_SPIM_TYPE == GLCD_SPIM_UDB_TYPE)
+    (void) CyIntSetVector(GLCD_SPIM_UDB_TX_ISR_NUMBER, &GLCD_TxIsr);
+    CyIntEnable(GLCD_SPIM_UDB_TX_ISR_NUMBER);
+#else
+    GLCD_SPIM_UDB_SetCustomInterruptHandler(&GLCD_TxIsr);
+#endif
+#endif
+
+	GLCD_InvalidateWindow();
+	GLCD_WindowCacheResetStats();
+	GLCD_bytesSent = 0u;
+	GLCD_ClearClip();
+#if (GLCD_SHADOW != 0u)
+	GLCD_ShadowReset();
+#endif
+	GLCD_colorMode = GLCD_COLOR_12BIT;
+	GLCD_window.scan = GLCD_SCAN_ROWS;
+	GLCD_SetPalette(GLCD_DEFAULT_PALETTE);
+	GLCD_scrollRows = 0;
+	GLCD_scrollOffset = 0;
+
 	CyDelayUs(20);			            /* 20us delay    */
 	GLCD_Reset_Write(0x00);	/* Display Reset */
 	CyDelay(200);			            /* 200ms delay   */
@@ -145,10 +766,7 @@ void GLCD_Start(void)
 	
 	GLCD_Command(GLCD_DINVON);	  /* invert display mode           */
 	
-	GLCD_Command(GLCD_DATCTL);	  /* data control                  */
-	GLCD_Data(0x03);		/* Inverse page address, reverse rotation column address, column scan-direction	*/
-	GLCD_Data(0x00);		                  /* normal RGB arrangement                 */
-	GLCD_Data(0x02);		                  /* 16-bit Grayscale Type A (12-bit color) */
+	GLCD_SendAddressMode();	                  /* orientation, scan, 12-bit color */
 	
 	GLCD_Command(GLCD_SETCONST);	/* Electronic volume, this is the contrast/brightness        */
 	GLCD_Data(GLCD_CONST_DEFAULT);  /* Volume (contrast) setting - fine tuning, original (0-63)  */
@@ -156,6 +774,7 @@ void GLCD_Start(void)
 	
 	GLCD_Command(GLCD_NOP);	        /* nop */
 
+	GLCD_Flush();
 	CyDelay(100);
 
 	GLCD_Command(GLCD_DISPON);	     /*  Display on */
@@ -171,224 +790,2125 @@ void GLCD_Start(void)
 	GLCD_Command(GLCD_COLMOD);		 /* Color interface format     */
 	GLCD_Data(0x03);			                 /* 0b011 is 12-bit/pixel mode */
 	
-	GLCD_Command(GLCD_MADCTL);		 /* Memory Access Control      */
+	GLCD_SendAddressMode();	                 /* Memory Access Control      */
 	GLCD_Command(GLCD_SETCONST);     /* Set Contrast               */          
 	GLCD_Data(GLCD_CONST_DEFAULT);
 	
 	GLCD_Command(GLCD_NOP);	
 #endif
 
-  	GLCD_Contrast(60);                           /* Set default contrast  */
-  	GLCD_Clear(GLCD_BLACK);          /* Clear screen to black */
+  	GLCD_Contrast(60);                           /* Set default contrast  */
+  	GLCD_Clear(GLCD_BLACK);          /* Clear screen to black */
+}
+
+/*******************************************************************************
+* Function Name: GLCD_Stop
+********************************************************************************
+*
+* Summary:
+*  This function clears the LCD to black and turns off the display.  
+*
+* Parameters:  
+*   None:   
+*
+* Return: 
+*  None 
+*  
+*******************************************************************************/
+void GLCD_Stop(void)
+{
+   GLCD_Clear(GLCD_BLACK);
+   GLCD_Command(GLCD_DISPOFF);
+   GLCD_Flush();
+}
+
+/*******************************************************************************
+* Function Name: GLCD_Clear
+********************************************************************************
+*
+* Summary:
+*  Clear the display, all of it whatever the clip rectangle.  
+*
+* Parameters:  
+*  color: Color to clear display with. 
+*
+* Return: 
+*  None 
+*  
+*******************************************************************************/
+void GLCD_Clear(int32 color)
+{
+	GLCD_SetWindow(GLCD_MINX, GLCD_MINY, GLCD_MAXX, GLCD_MAXY);
+	GLCD_FillWindow(color, (uint32)GLCD_ROW_LENGTH * GLCD_COL_HEIGHT);
+
+	GLCD_x_offset = 0;
+	GLCD_y_offset = 0;
+}
+
+
+/*******************************************************************************
+* Function Name: GLCD_Contrast
+********************************************************************************
+*
+* Summary:
+*  Set color contrast  
+*
+* Parameters:  
+*  setting: Contrast value.  
+*
+* Return: 
+*  None 
+*  
+*******************************************************************************/
+void GLCD_Contrast(int32 setting)
+{
+    GLCD_contrast = setting;
+    setting &= GLCD_CONST_MASK;	                /* Mask off contrast value */
+    GLCD_Command(GLCD_SETCONST);	/* Set Contrast            */
+    GLCD_Data(setting);	                    
+
+#if(GLCD_Controller == GLCD_EPSON)  /* Only required for Epson */
+    GLCD_Data(3);			
+#endif
+
+}
+
+/*******************************************************************************
+* Function Name: GLCD_GetContrast
+********************************************************************************
+*
+* Summary:
+*  Contrast setting last passed to GLCD_Contrast().
+*
+*******************************************************************************/
+int32 GLCD_GetContrast(void)
+{
+    return (GLCD_contrast);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_Invert
+********************************************************************************
+*
+* Summary:
+*  Show the display inverted, or normally again.  Only a command is sent;
+*  display memory is not touched.
+*
+* Parameters:
+*  on:  Non-zero to invert
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_Invert(uint32 on)
+{
+#if(GLCD_Controller == GLCD_EPSON)
+    on = (on == 0u) ? 1u : 0u;      /* Start runs the Epson panel inverted */
+#endif
+    GLCD_Command((on != 0u) ? GLCD_DINVON : GLCD_DINVOFF);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_ScrollSetArea
+********************************************************************************
+*
+* Summary:
+*  Choose the rows that hardware scrolling moves; the rows above and below
+*  stay put.  The scroll position is reset to 0.  Use rows
+*  GLCD_MINX .. GLCD_MAXX to scroll the whole screen.
+*
+*  The Epson controller scrolls in blocks of four rows, so there the area
+*  is widened to whole blocks.
+*
+* Parameters:
+*  x0, x1:  First and last row of the scrolling area, either order
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_ScrollSetArea(int32 x0, int32 x1)
+{
+    int32 tmp;
+    int32 p0;
+    int32 p1;
+
+    if(x0 > x1)
+    {
+        tmp = x0; x0 = x1; x1 = tmp;
+    }
+    if(x0 < (int32)GLCD_MINX)
+    {
+        x0 = (int32)GLCD_MINX;
+    }
+    if(x1 > (int32)GLCD_MAXX)
+    {
+        x1 = (int32)GLCD_MAXX;
+    }
+
+    /* Controller lines run the other way up */
+    p0 = (GLCD_ROW_LENGTH - 1) - x1;
+    p1 = (GLCD_ROW_LENGTH - 1) - x0;
+
+#if(GLCD_Controller == GLCD_EPSON)
+    p0 &= ~3;
+    p1 |= 3;
+    if(p1 > (GLCD_ROW_LENGTH - 1))
+    {
+        p1 = GLCD_ROW_LENGTH - 1;
+    }
+    GLCD_Command(GLCD_ASCSET);
+    GLCD_Data((uint32)p0 >> 2);                     /* top block            */
+    GLCD_Data((uint32)p1 >> 2);                     /* bottom block         */
+    GLCD_Data((uint32)(GLCD_ROW_LENGTH - 1) >> 2); /* last block */
+    GLCD_Data(((p0 == 0) && (p1 == (GLCD_ROW_LENGTH - 1))) ? 3u : 0u); /* whole screen or centre */
+#else
+    GLCD_Command(GLCD_VSCRDEF);
+    GLCD_Data((uint32)p0);                          /* top fixed area       */
+    GLCD_Data((uint32)((p1 - p0) + 1));             /* scroll area          */
+    GLCD_Data((uint32)((GLCD_ROW_LENGTH - 1) - p1)); /* bottom fixed area */
+#endif
+
+    GLCD_scrollTop = (GLCD_ROW_LENGTH - 1) - p1;
+    GLCD_scrollRows = (p1 - p0) + 1;
+    GLCD_ScrollTo(0);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_ScrollTo
+********************************************************************************
+*
+* Summary:
+*  Scroll the area set with GLCD_ScrollSetArea() so that what
+*  was drawn at row x shows at row x + offset, wrapping round within the
+*  area.  Only a scroll address is sent, display memory is not rewritten;
+*  drawing goes on in memory rows, see GLCD_ScrollRamRow().
+*
+*  The Epson controller scrolls in blocks of four rows, so there the offset
+*  is rounded down to a multiple of four.  Rows that come into view at the
+*  top of the area are the ones between the old and new offsets returned.
+*
+* Parameters:
+*  offset:  Rows to scroll by, any value
+*
+* Return:
+*  The offset now in effect, 0 to the area height - 1
+*
+*******************************************************************************/
+int32 GLCD_ScrollTo(int32 offset)
+{
+    int32 start;
+
+    if(GLCD_scrollRows == 0)
+    {
+        return 0;
+    }
+
+    offset %= GLCD_scrollRows;
+    if(offset < 0)
+    {
+        offset += GLCD_scrollRows;
+    }
+
+#if(GLCD_Controller == GLCD_EPSON)
+    offset &= ~3;
+#endif
+
+    /* Controller line shown at the top of the area */
+    start = ((GLCD_ROW_LENGTH - 1) - ((GLCD_scrollTop + GLCD_scrollRows) - 1)) + offset;
+
+#if(GLCD_Controller == GLCD_EPSON)
+    GLCD_Command(GLCD_SCSTART);
+    GLCD_Data((uint32)start >> 2);
+#else
+    GLCD_Command(GLCD_VSCRSADD);
+    GLCD_Data((uint32)start);
+#endif
+
+    GLCD_scrollOffset = offset;
+
+    return offset;
+}
+
+/*******************************************************************************
+* Function Name: GLCD_ScrollRamRow
+********************************************************************************
+*
+* Summary:
+*  The memory row that currently shows at screen row x.  Drawing at that row
+*  puts pixels at row x on the screen; rows outside the scrolling area map
+*  to themselves.
+*
+* Parameters:
+*  x:  Screen row
+*
+* Return:
+*  Row to draw at
+*
+*******************************************************************************/
+int32 GLCD_ScrollRamRow(int32 x)
+{
+    int32 row = x;
+
+    if((GLCD_scrollRows != 0) && (x >= GLCD_scrollTop) &&
+       (x < (GLCD_scrollTop + GLCD_scrollRows)))
+    {
+        row = (x - GLCD_scrollTop) - GLCD_scrollOffset;
+        if(row < 0)
+        {
+            row += GLCD_scrollRows;
+        }
+        row += GLCD_scrollTop;
+    }
+    return (row);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_SwapColors
+********************************************************************************
+*
+* Summary:
+*   Swaps colors between Epson and Philips mode.  
+*
+* Parameters:  
+*  prtValue:  The value  
+*
+* Return: 
+*  None 
+*  Added by Steve Sparks @ Big Nerd Ranch.
+*  This swaps the Epson RGB order into the Philips RGB order. (Or, vice versa, I suppose.)
+*******************************************************************************/
+int32 GLCD_SwapColors(int32 in)
+{
+    return ((in & 0x000F)<<8)|(in & 0x00F0)|((in & 0x0F00)>>8);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_SendAddressMode
+********************************************************************************
+*
+* Summary:
+*  Tell the controller how driver coordinates map onto its memory.  The
+*  panel is mounted upside down, so both page and column addresses are
+*  mirrored here once instead of in every drawing call; the scan order
+*  picks which address steps first while a window fills.  On the Epson
+*  controller the same command also holds the pixel format.
+*
+*******************************************************************************/
+static void GLCD_SendAddressMode(void)
+{
+#if (GLCD_Controller == GLCD_EPSON)
+    GLCD_Command(GLCD_DATCTL);
+    GLCD_Data(GLCD_DATCTL_PINV | GLCD_DATCTL_CINV |
+        ((GLCD_window.scan == GLCD_SCAN_COLUMNS) ? GLCD_DATCTL_PSCAN : 0u));
+    GLCD_Data(0x00);                        /* normal RGB arrangement */
+    GLCD_Data((GLCD_colorMode == GLCD_COLOR_8BIT) ? 0x01u : 0x02u); /* 8-bit or 12-bit type A */
+#else
+    GLCD_Command(GLCD_MADCTL);
+    GLCD_Data(GLCD_MADCTL_MY | GLCD_MADCTL_MX |
+        ((GLCD_window.scan == GLCD_SCAN_COLUMNS) ? GLCD_MADCTL_V : 0u));
+#endif
+}
+
+/*******************************************************************************
+* Function Name: GLCD_SetScan
+********************************************************************************
+*
+* Summary:
+*  Choose the order in which the next windows fill: along each row, y
+*  first, or down each column, x first.  Data laid out column by column,
+*  such as a bitmap stored in columns, can then be streamed into one window
+*  instead of being addressed a column at a time.  The setting stays until
+*  changed; a few bytes are sent only when it does change.
+*
+*  Windows one row or one column wide fill the same way in either order.
+*
+* Parameters:
+*  order:  GLCD_SCAN_ROWS (the default) or
+*          GLCD_SCAN_COLUMNS
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_SetScan(uint32 order)
+{
+    order = (order == GLCD_SCAN_COLUMNS) ? GLCD_SCAN_COLUMNS : GLCD_SCAN_ROWS;
+    if(order != GLCD_window.scan)
+    {
+        GLCD_window.scan = order;
+        GLCD_SendAddressMode();
+    }
+}
+
+/*******************************************************************************
+* Function Name: GLCD_GetScan
+********************************************************************************
+*
+* Summary:
+*  Window fill order currently in use.
+*
+* Return:
+*  GLCD_SCAN_ROWS or GLCD_SCAN_COLUMNS
+*
+*******************************************************************************/
+uint32 GLCD_GetScan(void)
+{
+    return (GLCD_window.scan);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_SetColorMode
+********************************************************************************
+*
+* Summary:
+*  Select the pixel format used on the SPI bus.  In 8-bit mode every pixel
+*  is one byte, RRRGGGBB, shown through the palette set with
+*  GLCD_SetPalette(); 12-bit colors passed to the drawing
+*  functions are reduced to the top bits of each channel.  12-bit mode, the
+*  default after Start, sends two pixels in three bytes.
+*
+*  What is already on the display is not affected.
+*
+* Parameters:
+*  mode:  GLCD_COLOR_12BIT or GLCD_COLOR_8BIT
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_SetColorMode(uint32 mode)
+{
+    GLCD_colorMode = (mode == GLCD_COLOR_8BIT) ? GLCD_COLOR_8BIT : GLCD_COLOR_12BIT;
+
+#if (GLCD_Controller == GLCD_EPSON)
+    GLCD_SendAddressMode();                 /* DATCTL holds the pixel format */
+#endif
+
+#if (GLCD_Controller == GLCD_PHILIPS)
+    GLCD_Command(GLCD_COLMOD);
+    GLCD_Data((GLCD_colorMode == GLCD_COLOR_8BIT) ? 0x02u : 0x03u); /* 8 or 12 bits/pixel */
+#endif
+
+    if(GLCD_colorMode == GLCD_COLOR_8BIT)
+    {
+        GLCD_UploadPalette();
+    }
+
+#if (GLCD_SHADOW != 0u)
+    /* The values in the shadow no longer mean the same colors */
+    GLCD_ShadowReset();
+#endif
+}
+
+/*******************************************************************************
+* Function Name: GLCD_GetColorMode
+********************************************************************************
+*
+* Summary:
+*  Pixel format currently in use.
+*
+* Return:
+*  GLCD_COLOR_12BIT or GLCD_COLOR_8BIT
+*
+*******************************************************************************/
+uint32 GLCD_GetColorMode(void)
+{
+    return (GLCD_colorMode);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_SetPalette
+********************************************************************************
+*
+* Summary:
+*  Set the levels the controller uses for 8-bit pixels: eight 4-bit red
+*  levels, eight green and four blue, in that order.  The table is sent to
+*  the controller straight away in 8-bit mode and on the next switch to it
+*  otherwise.  Indexed colors drawn in 12-bit mode are looked up in it too.
+*
+* Parameters:
+*  palette:  GLCD_PALETTE_SIZE levels, 0-15
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_SetPalette(const uint8 *palette)
+{
+    uint32 i;
+
+    for(i = 0u; i < GLCD_PALETTE_SIZE; i++)
+    {
+        GLCD_palette[i] = palette[i] & 0x0Fu;
+    }
+
+    if(GLCD_colorMode == GLCD_COLOR_8BIT)
+    {
+        GLCD_UploadPalette();
+    }
+}
+
+/*******************************************************************************
+* Function Name: GLCD_PaletteColor
+********************************************************************************
+*
+* Summary:
+*  The 12-bit color an 8-bit index is shown as with the current palette.
+*
+* Parameters:
+*  index:  RRRGGGBB
+*
+* Return:
+*  12-bit color
+*
+*******************************************************************************/
+int32 GLCD_PaletteColor(uint32 index)
+{
+    return (int32)(((uint32)GLCD_palette[(index >> 5) & 0x07u] << 8) |
+                   ((uint32)GLCD_palette[8u + ((index >> 2) & 0x07u)] << 4) |
+                    (uint32)GLCD_palette[16u + (index & 0x03u)]);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_UploadPalette
+********************************************************************************
+*
+* Summary:
+*  Send the palette to the controller's 8-bit color lookup table.
+*
+*******************************************************************************/
+static void GLCD_UploadPalette(void)
+{
+    uint32 i;
+
+#if (GLCD_Controller == GLCD_EPSON)
+    GLCD_Command(GLCD_RGBSET8);
+#else
+    GLCD_Command(GLCD_RGBSET);
+#endif
+    for(i = 0u; i < GLCD_PALETTE_SIZE; i++)
+    {
+        GLCD_Data(GLCD_palette[i]);
+    }
+#if (GLCD_Controller == GLCD_EPSON)
+    GLCD_Command(GLCD_NOP);     /* ends RGBSET8 */
+#endif
+}
+
+/*******************************************************************************
+* Function Name: GLCD_PixelValue
+********************************************************************************
+*
+* Summary:
+*  Turn a color argument, 12-bit, GLCD_INDEX() or
+*  GLCD_SLOT(), into what goes on the wire in the current mode:
+*  a 12-bit color or an RRRGGGBB index.
+*
+*******************************************************************************/
+static uint32 GLCD_PixelValue(int32 color)
+{
+    uint32 c = (uint32)color;
+
+    if((c & GLCD_SLOTTED) != 0u)
+    {
+        c = (uint32)GLCD_AnimColor(c & 0xFFu);
+    }
+
+    if(GLCD_colorMode == GLCD_COLOR_8BIT)
+    {
+        if((c & GLCD_INDEXED) == 0u)
+        {
+            c = ((c >> 4) & 0xE0u) | ((c >> 3) & 0x1Cu) | ((c >> 2) & 0x03u);
+        }
+        c &= 0xFFu;
+    }
+    else
+    {
+        if((c & GLCD_INDEXED) != 0u)
+        {
+            c = (uint32)GLCD_PaletteColor(c);
+        }
+        c &= 0x0FFFu;
+    }
+    return (c);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_WritePair
+********************************************************************************
+*
+* Summary:
+*  Send two pixel values, as returned by GLCD_PixelValue(), to
+*  an open memory write that holds no half pixel.
+*
+*******************************************************************************/
+static void GLCD_WritePair(uint32 c0, uint32 c1)
+{
+#if (GLCD_SHADOW != 0u)
+    GLCD_ShadowNext(c0);
+    GLCD_ShadowNext(c1);
+#endif
+
+    if(GLCD_colorMode == GLCD_COLOR_8BIT)
+    {
+        GLCD_Data(c0);
+        GLCD_Data(c1);
+    }
+    else
+    {
+        GLCD_Data((c0 >> 4) & 0xFFu);
+        GLCD_Data(((c0 & 0x0Fu) << 4) | ((c1 >> 8) & 0x0Fu));
+        GLCD_Data(c1 & 0xFFu);
+    }
+}
+
+/*******************************************************************************
+* Function Name: GLCD_SetWindow
+********************************************************************************
+*
+* Summary:
+*  Open a rectangular write window on the display and start a memory write.
+*  Pixels sent afterwards with GLCD_WritePixels() or
+*  GLCD_FillWindow() fill the window without any further
+*  addressing.
+*
+*  The window fills from (x0, y0): y counts up to y1, then x steps on to the
+*  next row; or, after GLCD_SetScan(GLCD_SCAN_COLUMNS),
+*  x counts up to x1 and then y steps on to the next column.
+*
+*  A page or column range that the controller already holds is not sent
+*  again; RAMWR alone moves the write pointer back to the window start.
+*
+* Parameters:
+*  x0, y0:  One corner of the window
+*  x1, y1:  The opposite corner of the window (inclusive)
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_SetWindow(int32 x0, int32 y0, int32 x1, int32 y1)
+{
+    int32 tmp;
+
+    if(GLCD_recording != 0u)
+    {
+        /* Streams cannot be recorded: send what was recorded before it */
+        GLCD_ListPlay();
+    }
+
+    if(x0 > x1)
+    {
+        tmp = x0; x0 = x1; x1 = tmp;
+    }
+    if(y0 > y1)
+    {
+        tmp = y0; y0 = y1; y1 = tmp;
+    }
+
+    if((x0 == GLCD_window.x0) && (x1 == GLCD_window.x1))
+    {
+        GLCD_window.hits++;
+    }
+    else
+    {
+        GLCD_Command(GLCD_PAGEADDR); /* Set page range   */
+        GLCD_Data((uint8)x0);
+        GLCD_Data((uint8)x1);
+        GLCD_window.x0 = x0;
+        GLCD_window.x1 = x1;
+        GLCD_window.misses++;
+    }
+
+    if((y0 == GLCD_window.y0) && (y1 == GLCD_window.y1))
+    {
+        GLCD_window.hits++;
+    }
+    else
+    {
+        GLCD_Command(GLCD_COLADDR);  /* Set column range */
+        GLCD_Data((uint8)y0);
+        GLCD_Data((uint8)y1);
+        GLCD_window.y0 = y0;
+        GLCD_window.y1 = y1;
+        GLCD_window.misses++;
+    }
+
+    GLCD_Command(GLCD_RAMWR);        /* Write color data */
+
+    GLCD_windowLeft = (uint32)((x1 - x0) + 1) * (uint32)((y1 - y0) + 1);
+    GLCD_window.open = 1u;
+
+#if (GLCD_SHADOW != 0u)
+    GLCD_shadowX = x0;
+    GLCD_shadowY = y0;
+    GLCD_shadowLeft = GLCD_windowLeft;
+#endif
+}
+
+/*******************************************************************************
+* Function Name: GLCD_WritePixels
+********************************************************************************
+*
+* Summary:
+*  Stream pixels into the window opened by GLCD_SetWindow().
+*  In 12-bit mode pixels are packed two to three bytes.  Calls may be
+*  chained; an odd pixel at the end of one call is completed by the next
+*  call, or as soon as the window is full.  Runs of one color are sent as
+*  by GLCD_FillWindow().
+*
+* Parameters:
+*  colors:  Array of 12-bit or GLCD_INDEX() colors, in window
+*           fill order
+*  n:       Number of pixels to send
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_WritePixels(const uint16 *colors, uint32 n)
+{
+    uint32 c0;
+    uint32 c1;
+    uint32 run;
+    uint32 count = n;
+
+    if(GLCD_colorMode == GLCD_COLOR_8BIT)
+    {
+        for( ; n != 0u; n--)
+        {
+            c0 = GLCD_PixelValue((int32)*colors++);
+#if (GLCD_SHADOW != 0u)
+            GLCD_ShadowNext(c0);
+#endif
+            GLCD_Data(c0);
+        }
+    }
+
+    if((n != 0u) && (GLCD_halfPixel != 0u))
+    {
+        c1 = GLCD_PixelValue((int32)*colors++);
+#if (GLCD_SHADOW != 0u)
+        GLCD_ShadowNext(c1);
+#endif
+        GLCD_halfPixel = 0u;
+        GLCD_Data(GLCD_halfNibble | ((c1 >> 8) & 0x0Fu));
+        GLCD_Data(c1 & 0xFFu);
+        n--;
+    }
+
+    while(n >= 2u)
+    {
+        if(colors[0] == colors[1])
+        {
+            for(run = 2u; (run < n) && (colors[run] == colors[0]); run++)
+            {
+                /* Length of the run */
+            }
+            if(run < n)
+            {
+                /* Whole pairs, so the pixels after it still start a pair */
+                run &= ~1u;
+            }
+            if(run >= GLCD_RUN_MIN)
+            {
+                c0 = GLCD_PixelValue((int32)*colors);
+#if (GLCD_SHADOW != 0u)
+                for(c1 = 0u; c1 < run; c1++)
+                {
+                    GLCD_ShadowNext(c0);
+                }
+#endif
+                GLCD_StreamSolid(c0, run);
+                colors += run;
+                n -= run;
+                continue;
+            }
+        }
+        c0 = GLCD_PixelValue((int32)*colors++);
+        c1 = GLCD_PixelValue((int32)*colors++);
+        GLCD_WritePair(c0, c1);
+        n -= 2u;
+    }
+
+    if(n != 0u)
+    {
+        c0 = GLCD_PixelValue((int32)*colors);
+#if (GLCD_SHADOW != 0u)
+        GLCD_ShadowNext(c0);
+#endif
+        GLCD_Data((c0 >> 4) & 0xFFu);
+        GLCD_halfNibble = (c0 & 0x0Fu) << 4;
+        GLCD_halfPixel = 1u;
+    }
+    GLCD_CountPixels(count);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_WriteIndexed
+********************************************************************************
+*
+* Summary:
+*  Stream RRRGGGBB palette indices into the window opened by
+*  GLCD_SetWindow(), one byte per pixel in 8-bit mode.  In 12-bit
+*  mode each index is sent as its palette color.  Half the RAM of a 12-bit
+*  buffer for the same image.
+*
+* Parameters:
+*  indices:  Array of palette indices, in window fill order
+*  n:        Number of pixels to send
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_WriteIndexed(const uint8 *indices, uint32 n)
+{
+    uint16 color;
+    uint32 count = n;
+
+    if(GLCD_colorMode == GLCD_COLOR_8BIT)
+    {
+        for( ; n != 0u; n--)
+        {
+#if (GLCD_SHADOW != 0u)
+            GLCD_ShadowNext(*indices);
+#endif
+            GLCD_Data(*indices++);
+        }
+        GLCD_CountPixels(count);
+    }
+    else
+    {
+        for( ; n != 0u; n--)
+        {
+            color = (uint16)GLCD_INDEX(*indices++);
+            GLCD_WritePixels(&color, 1u);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: GLCD_FillWindow
+********************************************************************************
+*
+* Summary:
+*  Stream n pixels of one color into the window opened by
+*  GLCD_SetWindow().  The two-pixel byte pattern is packed once
+*  and sent as a run; in 8-bit mode each pixel is the same single byte.
+*
+* Parameters:
+*  color:  12-bit or GLCD_INDEX() fill color
+*  n:      Number of pixels to send
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_FillWindow(int32 color, uint32 n)
+{
+    uint32 c = GLCD_PixelValue(color);
+    uint32 i;
+
+#if (GLCD_SHADOW != 0u)
+    if((n >= GLCD_windowLeft) && (GLCD_shadowLeft == GLCD_windowLeft) &&
+       (GLCD_shadowX == GLCD_window.x0) && (GLCD_shadowY == GLCD_window.y0))
+    {
+        /* The whole window in one color */
+        GLCD_ShadowRect(GLCD_window.x0, GLCD_window.y0,
+                                    GLCD_window.x1, GLCD_window.y1, c);
+        GLCD_shadowLeft = 0u;
+    }
+    else
+    {
+        for(i = 0u; i < n; i++)
+        {
+            GLCD_ShadowNext(c);
+        }
+    }
+#endif
+
+    if(GLCD_colorMode == GLCD_COLOR_8BIT)
+    {
+        /* One byte a pixel: three pixels make a run's pattern */
+        GLCD_SendRun(c, c, c, n / 3u);
+        for(i = n % 3u; i != 0u; i--)
+        {
+            GLCD_Data(c);
+        }
+    }
+    else
+    {
+        GLCD_StreamSolid(c, n);
+    }
+    GLCD_CountPixels(n);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_StreamSolid
+********************************************************************************
+*
+* Summary:
+*  Send n 12-bit pixels of one value, as bytes only: the pixel count and the
+*  shadow are left to the caller.  A half pixel held from before is
+*  completed first, the pairs go out as one run, and an odd last pixel is
+*  held back.
+*
+*******************************************************************************/
+static void GLCD_StreamSolid(uint32 c, uint32 n)
+{
+    uint32 b0 = (c >> 4) & 0xFFu;
+    uint32 b1 = ((c & 0x0Fu) << 4) | ((c >> 8) & 0x0Fu);
+    uint32 b2 = c & 0xFFu;
+
+    if((n != 0u) && (GLCD_halfPixel != 0u))
+    {
+        GLCD_halfPixel = 0u;
+        GLCD_Data(GLCD_halfNibble | (b1 & 0x0Fu));
+        GLCD_Data(b2);
+        n--;
+    }
+
+    GLCD_SendRun(b0, b1, b2, n >> 1);
+
+    if((n & 1u) != 0u)
+    {
+        GLCD_Data(b0);
+        GLCD_halfNibble = b1 & 0xF0u;
+        GLCD_halfPixel = 1u;
+    }
+}
+
+/*******************************************************************************
+* Function Name: GLCD_BlitRLE
+********************************************************************************
+*
+* Summary:
+*  Draw a run-length encoded image, e.g. one kept in flash, into a
+*  rectangle of the screen, a row at a time.  Runs are sent as by
+*  GLCD_FillWindow() and copied pixels as by GLCD_WritePixels(), through one
+*  window.  An image cut by the clip rectangle is drawn pixel by pixel, one
+*  outside it not at all.
+*
+*  The image is a list of words: GLCD_RLE_RUN(n) and one color repeat the
+*  color n times, GLCD_RLE_COPY(n) and n colors send the colors as they are.
+*  Colors are 12-bit, GLCD_INDEX() or GLCD_SLOT().
+*
+* Parameters:
+*  x0, y0:  Top left corner
+*  x1, y1:  Bottom right corner (inclusive)
+*  rle:     The image, (x1 - x0 + 1) * (y1 - y0 + 1) pixels
+*
+* Return:
+*  The word after the image, where the next one starts when several are
+*  stored one after another
+*
+*******************************************************************************/
+const uint16 *GLCD_BlitRLE(int32 x0, int32 y0, int32 x1, int32 y1, const uint16 *rle)
+{
+    uint32 w = (uint32)((y1 - y0) + 1);
+    uint32 total = (uint32)((x1 - x0) + 1) * w;
+    uint32 clip = GLCD_ClipBox(x0, y0, x1, y1);
+    uint32 done;
+    uint32 word;
+    uint32 n;
+    uint32 i;
+
+    if(clip == GLCD_CLIP_IN)
+    {
+        GLCD_SetScan(GLCD_SCAN_ROWS);
+        GLCD_SetWindow(x0, y0, x1, y1);
+    }
+
+    for(done = 0u; done < total; done += n)
+    {
+        word = *rle++;
+        n = word & 0x7FFFu;
+        n = (n > (total - done)) ? (total - done) : n;
+
+        if(clip == GLCD_CLIP_IN)
+        {
+            if((word & 0x8000u) != 0u)
+            {
+                GLCD_FillWindow((int32)*rle, n);
+            }
+            else
+            {
+                GLCD_WritePixels(rle, n);
+            }
+        }
+        else if(clip == GLCD_CLIP_PART)
+        {
+            for(i = 0u; i < n; i++)
+            {
+                GLCD_Pixel(x0 + (int32)((done + i) / w), y0 + (int32)((done + i) % w),
+                         (int32)(((word & 0x8000u) != 0u) ? rle[0] : rle[i]));
+            }
+        }
+        else
+        {
+            /* Off the clip: only skip over it */
+        }
+        rle += ((word & 0x8000u) != 0u) ? 1u : (word & 0x7FFFu);
+    }
+    return (rle);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_Pixel
+********************************************************************************
+*
+* Summary:
+*  Draw Pixel
+*
+*  If the open window's write pointer is already at (x, y) the pixel is just
+*  streamed, with no addressing at all.  Otherwise a window is opened from
+*  (x, y) to the end of the row, so that a following pixel at (x, y + 1)
+*  can continue it, or to the bottom of the column when the last pixel was
+*  just above this one.  The last pixel of such a run may be held back until the
+*  next drawing call; use GLCD_Flush() if it must appear sooner.
+*  Pixels outside the clip rectangle are skipped, and with the shadow so are
+*  pixels that already have the color.
+*
+* Parameters:
+*  x,y:    Location to draw the pixel
+*  color:  Color of the pixel
+*
+* Return:
+*  None
+*******************************************************************************/
+void GLCD_Pixel(int32 x, int32 y, int32 color)
+{
+    uint32 done;
+    uint32 w;
+    uint32 h;
+    uint32 next = 0u;
+
+    if((x < GLCD_clipX0) || (x > GLCD_clipX1) || (y < GLCD_clipY0) || (y > GLCD_clipY1))
+    {
+        return;
+    }
+
+    if((GLCD_recording != 0u) && (GLCD_ListRecord(x, y, x, y, color) != 0u))
+    {
+        return;
+    }
+
+#if (GLCD_SHADOW != 0u)
+    if(GLCD_ShadowGet(x, y) == (int32)GLCD_PixelValue(color))
+    {
+        GLCD_shadowSkipped++;
+        return;
+    }
+#endif
+
+    if((GLCD_window.open != 0u) && (GLCD_windowLeft != 0u))
+    {
+        /* Where the write pointer is: pixels so far, in fill order */
+        w = (uint32)((GLCD_window.y1 - GLCD_window.y0) + 1);
+        h = (uint32)((GLCD_window.x1 - GLCD_window.x0) + 1);
+        done = (w * h) - GLCD_windowLeft;
+
+        if(GLCD_window.scan == GLCD_SCAN_ROWS)
+        {
+            next = ((x == (GLCD_window.x0 + (int32)(done / w))) &&
+                    (y == (GLCD_window.y0 + (int32)(done % w)))) ? 1u : 0u;
+        }
+        else
+        {
+            next = ((x == (GLCD_window.x0 + (int32)(done % h))) &&
+                    (y == (GLCD_window.y0 + (int32)(done / h)))) ? 1u : 0u;
+        }
+    }
+
+    if(next != 0u)
+    {
+        GLCD_window.hits += 2u;
+    }
+    else if((x == (GLCD_lastX + 1)) && (y == GLCD_lastY))
+    {
+        GLCD_SetWindow(x, y, (int32)GLCD_MAXX, y);
+    }
+    else
+    {
+        GLCD_SetWindow(x, y, x, (int32)GLCD_MAXY);
+    }
+    GLCD_FillWindow(color, 1u);
+    GLCD_lastX = x;
+    GLCD_lastY = y;
+}
+
+/*******************************************************************************
+* Function Name: GLCD_FillArea
+********************************************************************************
+*
+* Summary:
+*  Fill a rectangle with one color using a single address window.  Only the
+*  part inside the clip rectangle is sent, and with the shadow only the part
+*  of that which holds pixels of another color.
+*
+* Parameters:
+*  x0, y0:  One corner of the area
+*  x1, y1:  The opposite corner of the area (inclusive)
+*  color:   Fill color
+*
+* Return:
+*  None
+*******************************************************************************/
+static void GLCD_FillArea(int32 x0, int32 y0, int32 x1, int32 y1, int32 color)
+{
+    int32 tmp;
+
+    if(x0 > x1)
+    {
+        tmp = x0; x0 = x1; x1 = tmp;
+    }
+    if(y0 > y1)
+    {
+        tmp = y0; y0 = y1; y1 = tmp;
+    }
+    x0 = (x0 < GLCD_clipX0) ? GLCD_clipX0 : x0;
+    y0 = (y0 < GLCD_clipY0) ? GLCD_clipY0 : y0;
+    x1 = (x1 > GLCD_clipX1) ? GLCD_clipX1 : x1;
+    y1 = (y1 > GLCD_clipY1) ? GLCD_clipY1 : y1;
+    if((x0 > x1) || (y0 > y1))
+    {
+        return;
+    }
+
+    if((GLCD_recording != 0u) && (GLCD_ListRecord(x0, y0, x1, y1, color) != 0u))
+    {
+        return;
+    }
+
+#if (GLCD_SHADOW != 0u)
+    if(GLCD_ShadowTrim(&x0, &y0, &x1, &y1, GLCD_PixelValue(color)) == 0u)
+    {
+        return;
+    }
+#endif
+
+    GLCD_SetWindow(x0, y0, x1, y1);
+    GLCD_FillWindow(color, (uint32)((x1 - x0) + 1) * (uint32)((y1 - y0) + 1));
+}
+
+/*******************************************************************************
+* Function Name: GLCD_SetClip
+********************************************************************************
+*
+* Summary:
+*  Limit the drawing functions to a rectangle of the screen: pixels, lines,
+*  rectangles, circles, sectors, text and the band renderer.  What falls
+*  outside is dropped before anything is sent.  Window streams, the tile
+*  and sprite layers and GLCD_Clear() are not clipped.
+*
+* Parameters:
+*  x0, y0:  One corner
+*  x1, y1:  The opposite corner (inclusive)
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_SetClip(int32 x0, int32 y0, int32 x1, int32 y1)
+{
+    int32 tmp;
+
+    if(x0 > x1)
+    {
+        tmp = x0; x0 = x1; x1 = tmp;
+    }
+    if(y0 > y1)
+    {
+        tmp = y0; y0 = y1; y1 = tmp;
+    }
+    GLCD_clipX0 = (x0 < (int32)GLCD_MINX) ? (int32)GLCD_MINX : x0;
+    GLCD_clipY0 = (y0 < (int32)GLCD_MINY) ? (int32)GLCD_MINY : y0;
+    GLCD_clipX1 = (x1 > (int32)GLCD_MAXX) ? (int32)GLCD_MAXX : x1;
+    GLCD_clipY1 = (y1 > (int32)GLCD_MAXY) ? (int32)GLCD_MAXY : y1;
+}
+
+/*******************************************************************************
+* Function Name: GLCD_ClearClip
+********************************************************************************
+*
+* Summary:
+*  Let the drawing functions use the whole screen again.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_ClearClip(void)
+{
+    GLCD_SetClip((int32)GLCD_MINX, (int32)GLCD_MINY, (int32)GLCD_MAXX, (int32)GLCD_MAXY);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_GetClip
+********************************************************************************
+*
+* Summary:
+*  Read the clip rectangle.  It is empty (x0 > x1 or y0 > y1) when the one
+*  set was all off the screen.
+*
+* Parameters:
+*  x0, y0:  Get the top left corner
+*  x1, y1:  Get the bottom right corner (inclusive)
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_GetClip(int32 *x0, int32 *y0, int32 *x1, int32 *y1)
+{
+    *x0 = GLCD_clipX0;
+    *y0 = GLCD_clipY0;
+    *x1 = GLCD_clipX1;
+    *y1 = GLCD_clipY1;
+}
+
+/*******************************************************************************
+* Function Name: GLCD_ClipCode
+********************************************************************************
+*
+* Summary:
+*  Outcode of a point: the CLIP_ bits of the edges it is beyond.
+*
+*******************************************************************************/
+static uint32 GLCD_ClipCode(int32 x, int32 y)
+{
+    uint32 code = 0u;
+
+    if(x < GLCD_clipX0)
+    {
+        code |= GLCD_CLIP_ABOVE;
+    }
+    else if(x > GLCD_clipX1)
+    {
+        code |= GLCD_CLIP_BELOW;
+    }
+    else
+    {
+        /* Between the rows */
+    }
+    if(y < GLCD_clipY0)
+    {
+        code |= GLCD_CLIP_LEFT;
+    }
+    else if(y > GLCD_clipY1)
+    {
+        code |= GLCD_CLIP_RIGHT;
+    }
+    else
+    {
+        /* Between the columns */
+    }
+    return (code);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_ClipBox
+********************************************************************************
+*
+* Summary:
+*  How a bounding box (x0 <= x1, y0 <= y1) lies against the clip rectangle:
+*  CLIP_OUT, CLIP_PART or CLIP_IN.
+*
+*******************************************************************************/
+static uint32 GLCD_ClipBox(int32 x0, int32 y0, int32 x1, int32 y1)
+{
+    if((x1 < GLCD_clipX0) || (x0 > GLCD_clipX1) || (y1 < GLCD_clipY0) || (y0 > GLCD_clipY1))
+    {
+        return (GLCD_CLIP_OUT);
+    }
+    if((x0 >= GLCD_clipX0) && (x1 <= GLCD_clipX1) && (y0 >= GLCD_clipY0) && (y1 <= GLCD_clipY1))
+    {
+        return (GLCD_CLIP_IN);
+    }
+    return (GLCD_CLIP_PART);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_StepRange
+********************************************************************************
+*
+* Summary:
+*  Narrow first .. last to the steps n for which from + step * n is within
+*  lo .. hi, step being 1 or -1.
+*
+*******************************************************************************/
+static void GLCD_StepRange(int32 from, int32 step, int32 lo, int32 hi, int32 *first, int32 *last)
+{
+    int32 a = (step > 0) ? (lo - from) : (from - hi);
+    int32 b = (step > 0) ? (hi - from) : (from - lo);
+
+    *first = (a > *first) ? a : *first;
+    *last = (b < *last) ? b : *last;
+}
+
+#if (GLCD_SHADOW != 0u)
+/*******************************************************************************
+* Function Name: GLCD_GetPixel
+********************************************************************************
+*
+* Summary:
+*  Read a pixel back from the shadow of the display memory.
+*
+* Parameters:
+*  x, y:  Location of the pixel
+*
+* Return:
+*  Its color, 12-bit or as GLCD_INDEX() in 8-bit mode; -1 when
+*  off the screen or not known, e.g. in a block that holds more than one
+*  color other than black.
+*
+*******************************************************************************/
+int32 GLCD_GetPixel(int32 x, int32 y)
+{
+    int32 value;
+
+    if((x < (int32)GLCD_MINX) || (x > (int32)GLCD_MAXX) ||
+       (y < (int32)GLCD_MINY) || (y > (int32)GLCD_MAXY))
+    {
+        return (-1);
+    }
+    value = GLCD_ShadowGet(x, y);
+    if((value >= 0) && (GLCD_colorMode == GLCD_COLOR_8BIT))
+    {
+        value = GLCD_INDEX(value);
+    }
+    return (value);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_ShadowSkipped
+********************************************************************************
+*
+* Summary:
+*  Pixels not sent since GLCD_Start() because the shadow showed
+*  they already had their color.
+*
+* Return:
+*  Pixel count
+*
+*******************************************************************************/
+uint32 GLCD_ShadowSkipped(void)
+{
+    return (GLCD_shadowSkipped);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_ShadowReset
+********************************************************************************
+*
+* Summary:
+*  Forget what is on the screen: every block unknown.
+*
+*******************************************************************************/
+static void GLCD_ShadowReset(void)
+{
+    uint32 i;
+    uint32 j;
+
+    for(i = 0u; i < GLCD_SHADOW_BLOCKS; i++)
+    {
+        for(j = 0u; j < GLCD_SHADOW_BLOCKS; j++)
+        {
+            GLCD_shadowInk[i][j] = GLCD_SHADOW_UNKNOWN;
+        }
+    }
+    GLCD_shadowLeft = 0u;
+}
+
+/*******************************************************************************
+* Function Name: GLCD_ShadowGet
+********************************************************************************
+*
+* Summary:
+*  Pixel value at (x, y), on the screen, or -1 if its block is unknown.
+*
+*******************************************************************************/
+static int32 GLCD_ShadowGet(int32 x, int32 y)
+{
+    uint32 ink = GLCD_shadowInk[(uint32)x >> 3][(uint32)y >> 3];
+
+    if((ink & GLCD_SHADOW_UNKNOWN) != 0u)
+    {
+        return (-1);
+    }
+    return (((GLCD_shadowBits[x][(uint32)y >> 3] & (1u << ((uint32)y & 7u))) != 0u) ? (int32)ink : 0);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_ShadowPut
+********************************************************************************
+*
+* Summary:
+*  Record a pixel value written at (x, y), on the screen.  A color that is
+*  neither black nor the block's ink becomes the ink if the block has none
+*  left, otherwise the block becomes unknown.
+*
+*******************************************************************************/
+static void GLCD_ShadowPut(int32 x, int32 y, uint32 value)
+{
+    uint16 *ink = &GLCD_shadowInk[(uint32)x >> 3][(uint32)y >> 3];
+    uint8 *bits = &GLCD_shadowBits[x][(uint32)y >> 3];
+    uint32 col = (uint32)y >> 3;
+    uint32 mask = 1u << ((uint32)y & 7u);
+    int32 row;
+    int32 last;
+
+    if((*ink & GLCD_SHADOW_UNKNOWN) != 0u)
+    {
+        return;
+    }
+    *bits &= (uint8)~mask;
+    if(value == 0u)
+    {
+        return;
+    }
+    if(value != *ink)
+    {
+        row = x & ~7;
+        last = ((row + 7) > (int32)GLCD_MAXX) ? (int32)GLCD_MAXX : (row + 7);
+        for( ; row <= last; row++)
+        {
+            if(GLCD_shadowBits[row][col] != 0u)
+            {
+                *ink = GLCD_SHADOW_UNKNOWN;
+                return;
+            }
+        }
+        *ink = (uint16)value;
+    }
+    *bits |= (uint8)mask;
+}
+
+/*******************************************************************************
+* Function Name: GLCD_ShadowNext
+********************************************************************************
+*
+* Summary:
+*  Record a pixel value streamed into the open window and move the cursor
+*  on in the window's fill order.
+*
+*******************************************************************************/
+static void GLCD_ShadowNext(uint32 value)
+{
+    if(GLCD_shadowLeft == 0u)
+    {
+        return;
+    }
+    GLCD_shadowLeft--;
+    if((GLCD_shadowX >= (int32)GLCD_MINX) && (GLCD_shadowX <= (int32)GLCD_MAXX) &&
+       (GLCD_shadowY >= (int32)GLCD_MINY) && (GLCD_shadowY <= (int32)GLCD_MAXY))
+    {
+        GLCD_ShadowPut(GLCD_shadowX, GLCD_shadowY, value);
+    }
+
+    if(GLCD_window.scan == GLCD_SCAN_ROWS)
+    {
+        if(++GLCD_shadowY > GLCD_window.y1)
+        {
+            GLCD_shadowY = GLCD_window.y0;
+            GLCD_shadowX++;
+        }
+    }
+    else
+    {
+        if(++GLCD_shadowX > GLCD_window.x1)
+        {
+            GLCD_shadowX = GLCD_window.x0;
+            GLCD_shadowY++;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: GLCD_ShadowRect
+********************************************************************************
+*
+* Summary:
+*  Record a rectangle filled with one pixel value; the part off the screen
+*  is left out.  Blocks it covers whole take the value as their ink, even
+*  unknown ones.
+*
+*******************************************************************************/
+static void GLCD_ShadowRect(int32 x0, int32 y0, int32 x1, int32 y1, uint32 value)
+{
+    int32 bx, by;
+    int32 bx0, by0, bx1, by1;
+    int32 x, y;
+    uint32 full;
+
+    x0 = (x0 < (int32)GLCD_MINX) ? (int32)GLCD_MINX : x0;
+    y0 = (y0 < (int32)GLCD_MINY) ? (int32)GLCD_MINY : y0;
+    x1 = (x1 > (int32)GLCD_MAXX) ? (int32)GLCD_MAXX : x1;
+    y1 = (y1 > (int32)GLCD_MAXY) ? (int32)GLCD_MAXY : y1;
+
+    for(bx = x0 & ~7; bx <= x1; bx += 8)
+    {
+        bx0 = (bx > x0) ? bx : x0;
+        bx1 = ((bx + 7) < x1) ? (bx + 7) : x1;
+        for(by = y0 & ~7; by <= y1; by += 8)
+        {
+            by0 = (by > y0) ? by : y0;
+            by1 = ((by + 7) < y1) ? (by + 7) : y1;
+
+            if((bx0 == bx) && (by0 == by) &&
+               ((bx1 == (bx + 7)) || (bx1 == (int32)GLCD_MAXX)) &&
+               ((by1 == (by + 7)) || (by1 == (int32)GLCD_MAXY)))
+            {
+                /* Whole block */
+                full = (value != 0u) ? ((1u << ((by1 - by) + 1)) - 1u) : 0u;
+                GLCD_shadowInk[(uint32)bx >> 3][(uint32)by >> 3] = (uint16)value;
+                for(x = bx0; x <= bx1; x++)
+                {
+                    GLCD_shadowBits[x][(uint32)by >> 3] = (uint8)full;
+                }
+            }
+            else
+            {
+                for(x = bx0; x <= bx1; x++)
+                {
+                    for(y = by0; y <= by1; y++)
+                    {
+                        GLCD_ShadowPut(x, y, value);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: GLCD_ShadowTrim
+********************************************************************************
+*
+* Summary:
+*  Shrink a rectangle to be filled with one pixel value to the box round its
+*  pixels that have another value or are unknown.  The pixels outside it
+*  are counted as skipped.  A rectangle that is not all on the screen is
+*  left as it is.
+*
+* Return:
+*  0 if no pixel would change
+*
+*******************************************************************************/
+static uint32 GLCD_ShadowTrim(int32 *x0, int32 *y0, int32 *x1, int32 *y1, uint32 value)
+{
+    int32 x, col;
+    int32 lo, hi;
+    int32 nx0 = 0x7FFF, ny0 = 0x7FFF, nx1 = -1, ny1 = -1;
+    uint32 bits, ink, changed;
+    uint32 area;
+    int32 tmp;
+
+    if(*x0 > *x1)
+    {
+        tmp = *x0; *x0 = *x1; *x1 = tmp;
+    }
+    if(*y0 > *y1)
+    {
+        tmp = *y0; *y0 = *y1; *y1 = tmp;
+    }
+    if((*x0 < (int32)GLCD_MINX) || (*x1 > (int32)GLCD_MAXX) ||
+       (*y0 < (int32)GLCD_MINY) || (*y1 > (int32)GLCD_MAXY))
+    {
+        return (1u);
+    }
+    area = (uint32)((*x1 - *x0) + 1) * (uint32)((*y1 - *y0) + 1);
+
+    for(x = *x0; x <= *x1; x++)
+    {
+        for(col = *y0 >> 3; col <= (*y1 >> 3); col++)
+        {
+            /* Pixels of this byte inside the rectangle */
+            lo = (*y0 > (col * 8)) ? (*y0 - (col * 8)) : 0;
+            hi = (*y1 < ((col * 8) + 7)) ? (*y1 - (col * 8)) : 7;
+            changed = ((1u << (hi + 1)) - 1u) & ~((1u << lo) - 1u);
+
+            ink = GLCD_shadowInk[(uint32)x >> 3][col];
+            bits = GLCD_shadowBits[x][col];
+            if((ink & GLCD_SHADOW_UNKNOWN) == 0u)
+            {
+                if(value == 0u)
+                {
+                    changed &= bits;
+                }
+                else if(value == ink)
+                {
+                    changed &= ~bits;
+                }
+                else
+                {
+                    /* Every pixel has another color */
+                }
+            }
+            if(changed == 0u)
+            {
+                continue;
+            }
+
+            for(lo = 0; (changed & (1u << lo)) == 0u; lo++)
+            {
+            }
+            for(hi = 7; (changed & (1u << hi)) == 0u; hi--)
+            {
+            }
+            nx0 = (x < nx0) ? x : nx0;
+            nx1 = x;
+            ny0 = (((col * 8) + lo) < ny0) ? ((col * 8) + lo) : ny0;
+            ny1 = (((col * 8) + hi) > ny1) ? ((col * 8) + hi) : ny1;
+        }
+    }
+
+    if(nx1 < 0)
+    {
+        GLCD_shadowSkipped += area;
+        return (0u);
+    }
+    *x0 = nx0;
+    *y0 = ny0;
+    *x1 = nx1;
+    *y1 = ny1;
+    GLCD_shadowSkipped += area - ((uint32)((nx1 - nx0) + 1) * (uint32)((ny1 - ny0) + 1));
+    return (1u);
+}
+#endif
+
+/*******************************************************************************
+* Function Name: GLCD_DrawCircle
+********************************************************************************
+*
+* Summary:
+*  Draw a circle on the display given a start point and radius.  
+*
+*  This code uses Bresenham's Circle Algorithm.  A circle that misses the
+*  clip rectangle is not walked at all.
+*
+* Parameters:  
+*  x0, y0: Center of circle
+*  radius: Radius of circle
+*  color:  Color of circle
+*
+* Return: 
+*  None 
+*  
+*******************************************************************************/
+void GLCD_DrawCircle (int32 x0, int32 y0, int32 radius, int32 color)
+{
+	int32 f = 1 - radius;
+	int32 ddF_x = 0;
+	int32 ddF_y = -2 * radius;
+	int32 x = 0;
+	int32 y = radius;
+
+	if ((radius < 0) || (GLCD_ClipBox(x0 - radius, y0 - radius, x0 + radius, y0 + radius) == GLCD_CLIP_OUT))
+	{
+		return;
+	}
+
+	GLCD_Pixel(x0, y0 + radius, color);
+	GLCD_Pixel(x0, y0 - radius, color);
+	GLCD_Pixel( x0 + radius, y0, color);
+	GLCD_Pixel( x0 - radius, y0, color);
+
+	while(x < y)
+	{
+		if(f >= 0)
+		{
+			y--;
+			ddF_y += 2;
+			f += ddF_y;
+		}
+		x++;
+		ddF_x += 2;
+		f += ddF_x + 1;
+
+		GLCD_Pixel(x0 + x, y0 + y, color);
+		GLCD_Pixel(x0 - x, y0 + y, color);
+		GLCD_Pixel( x0 + x, y0 - y, color);
+		GLCD_Pixel( x0 - x, y0 - y, color);
+		GLCD_Pixel( x0 + y, y0 + x, color);
+		GLCD_Pixel( x0 - y, y0 + x, color);
+		GLCD_Pixel( x0 + y, y0 - x, color);
+		GLCD_Pixel( x0 - y, y0 - x, color);
+	}
+}
+
+/*******************************************************************************
+* Function Name: GLCD_SinQ15
+********************************************************************************
+*
+* Summary:
+*  Sine from the quarter-wave table, no floating point.
+*
+* Parameters:  
+*  angle:  Angle in 1/GLCD_TRIG_STEPS degree steps, any sign or size
+*
+* Return: 
+*  sin(angle) in Q1.15 
+*  
+*******************************************************************************/
+int32 GLCD_SinQ15(int32 angle)
+{
+    uint32 a;
+    uint32 quadrant;
+
+    angle %= (int32)GLCD_TRIG_CIRCLE;
+    if(angle < 0)
+    {
+        angle += (int32)GLCD_TRIG_CIRCLE;
+    }
+    a = (uint32)angle % GLCD_TRIG_QUADRANT;
+    quadrant = (uint32)angle / GLCD_TRIG_QUADRANT;
+
+    if((quadrant & 1u) != 0u)
+    {
+        a = GLCD_TRIG_QUADRANT - a;     /* falling half of the hump */
+    }
+    return ((quadrant < 2u) ? (int32)GLCD_SIN_TABLE[a] : -(int32)GLCD_SIN_TABLE[a]);
 }
 
 /*******************************************************************************
-* Function Name: GLCD_Stop
+* Function Name: GLCD_CosQ15
 ********************************************************************************
 *
 * Summary:
-*  This function clears the LCD to black and turns off the display.  
+*  Cosine from the quarter-wave table, no floating point.
 *
 * Parameters:  
-*   None:   
+*  angle:  Angle in 1/GLCD_TRIG_STEPS degree steps
 *
 * Return: 
-*  None 
+*  cos(angle) in Q1.15 
 *  
 *******************************************************************************/
-void GLCD_Stop(void)
+int32 GLCD_CosQ15(int32 angle)
 {
-   GLCD_Clear(GLCD_BLACK);
-   GLCD_Command(GLCD_DISPOFF);
+    return GLCD_SinQ15((angle % (int32)GLCD_TRIG_CIRCLE) + (int32)GLCD_TRIG_QUADRANT);
 }
 
 /*******************************************************************************
-* Function Name: GLCD_Clear
+* Function Name: GLCD_PolarToXY
 ********************************************************************************
 *
 * Summary:
-*  Clear the display.  
+*  Convert a polar offset from (x0, y0) into display coordinates, rounded to
+*  the nearest pixel: x = x0 + r sin(angle), y = y0 + r cos(angle).
 *
 * Parameters:  
-*  color: Color to clear display with. 
+*  x0, y0:  Origin
+*  radius:  Distance from the origin, |radius| < 32768
+*  angle:   Angle in 1/GLCD_TRIG_STEPS degree steps
+*  x, y:    Receive the point
 *
 * Return: 
 *  None 
 *  
 *******************************************************************************/
-void GLCD_Clear(int32 color)
+void GLCD_PolarToXY(int32 x0, int32 y0, int32 radius, int32 angle, int32 *x, int32 *y)
 {
-    int32 i;
+    *x = x0 + (GLCD_FloorDiv((radius * GLCD_SinQ15(angle)) + 16384, 32768));
+    *y = y0 + (GLCD_FloorDiv((radius * GLCD_CosQ15(angle)) + 16384, 32768));
+}
 
-	GLCD_Command(GLCD_PAGEADDR);
-	GLCD_Data(GLCD_MINX);
-	GLCD_Data(GLCD_MAXX);
+/*******************************************************************************
+* Function Name: GLCD_FillSpan
+********************************************************************************
+*
+* Summary:
+*  Fill the pixels y0..y1 of row x, clipped.  A one pixel wide window is
+*  contiguous, so the span costs a single address setup.
+*
+* Parameters:
+*  x:       Row of the span
+*  y0, y1:  First and last pixel of the span (y0 <= y1)
+*  color:   Fill color
+*
+* Return:
+*  None
+*******************************************************************************/
+static void GLCD_FillSpan(int32 x, int32 y0, int32 y1, int32 color)
+{
+    if(y0 <= y1)
+    {
+        GLCD_FillArea(x, y0, x, y1, color);
+    }
+}
 
-	GLCD_Command(GLCD_COLADDR);
-	GLCD_Data(GLCD_MINY);
-	GLCD_Data(GLCD_MAXY);
+/*******************************************************************************
+* Function Name: GLCD_FillDisc
+********************************************************************************
+*
+* Summary:
+*  Walk a filled circle row by row.  The same Bresenham walk as
+*  GLCD_DrawCircle() gives the edge, so a filled circle and its outline
+*  line up exactly.  Each row of the disc is visited once.
+*
+* Parameters:  
+*  x0, y0: Center of circle
+*  radius: Radius of circle
+*  color:  Fill color
+*  sector: Part of the disc to fill, NULL for all of it
+*
+* Return: 
+*  None 
+*  
+*******************************************************************************/
+static void GLCD_FillDisc(int32 x0, int32 y0, int32 radius, int32 color, const GLCD_SECTOR *sector)
+{
+	int32 f = 1 - radius;
+	int32 ddF_x = 0;
+	int32 ddF_y = -2 * radius;
+	int32 x = 0;
+	int32 y = radius;
 
-	GLCD_Command(GLCD_RAMWR);
+	if (GLCD_ClipBox(x0 - radius, y0 - radius, x0 + radius, y0 + radius) == GLCD_CLIP_OUT)
+	{
+		return;
+	}
 
+	GLCD_DiscRow(x0, y0, 0, radius, color, sector);
 
-	for( i=0; i < (GLCD_MAXX*GLCD_MAXY)/2; i++)
+	while(x < y)
 	{
-		GLCD_Data((color>>4)&0x00FF);
-		GLCD_Data(((color&0x0F)<<4)|(color>>8));
-		GLCD_Data(color&0x0FF);
-	}
+		if(f >= 0)
+		{
+			/* Last step on rows +/-y: they are now complete */
+			GLCD_DiscRow(x0, y0, y, x, color, sector);
+			GLCD_DiscRow(x0, y0, -y, x, color, sector);
+			y--;
+			ddF_y += 2;
+			f += ddF_y;
+		}
+		x++;
+		ddF_x += 2;
+		f += ddF_x + 1;
 
-	GLCD_x_offset = 0;
-	GLCD_y_offset = 0;
+		if(x <= y)
+		{
+			GLCD_DiscRow(x0, y0, x, y, color, sector);
+			GLCD_DiscRow(x0, y0, -x, y, color, sector);
+		}
+	}
 }
 
-
 /*******************************************************************************
-* Function Name: GLCD_Contrast
+* Function Name: GLCD_FillCircle
 ********************************************************************************
 *
 * Summary:
-*  Set color contrast  
+*  Draw a filled circle.  Each row is written once as a single span, no pixel
+*  is written twice, and rows outside the clip rectangle are dropped.
 *
 * Parameters:  
-*  setting: Contrast value.  
+*  x0, y0: Center of circle
+*  radius: Radius of circle
+*  color:  Fill color
 *
 * Return: 
 *  None 
 *  
 *******************************************************************************/
-void GLCD_Contrast(int32 setting)
+void GLCD_FillCircle(int32 x0, int32 y0, int32 radius, int32 color)
 {
-    setting &= GLCD_CONST_MASK;	                /* Mask off contrast value */
-    GLCD_Command(GLCD_SETCONST);	/* Set Contrast            */
-    GLCD_Data(setting);	                    
+	if(radius >= 0)
+	{
+		GLCD_FillDisc(x0, y0, radius, color, NULL);
+	}
+}
 
-#if(GLCD_Controller == GLCD_EPSON)  /* Only required for Epson */
-    GLCD_Data(3);			
-#endif
+/*******************************************************************************
+* Function Name: GLCD_SetHalfPlane
+********************************************************************************
+*
+* Summary:
+*  Set up the half plane of directions [angle, angle + 180) degrees.
+*
+*******************************************************************************/
+static void GLCD_SetHalfPlane(GLCD_HALFPLANE *hp, int32 angle)
+{
+    hp->cs = GLCD_CosQ15(GLCD_DEG(angle));
+    hp->sn = GLCD_SinQ15(GLCD_DEG(angle));
+}
+
+/*******************************************************************************
+* Function Name: GLCD_FloorDiv
+********************************************************************************
+*
+* Summary:
+*  n / d rounded towards minus infinity, for d > 0.
+*
+*******************************************************************************/
+static int32 GLCD_FloorDiv(int32 n, int32 d)
+{
+    int32 q = n / d;
 
+    if(((q * d) != n) && (n < 0))
+    {
+        q--;
+    }
+    return q;
 }
 
 /*******************************************************************************
-* Function Name: GLCD_SwapColors
+* Function Name: GLCD_HalfPlaneRow
 ********************************************************************************
 *
 * Summary:
-*   Swaps colors between Epson and Philips mode.  
+*  Narrow the span [lo, hi] on row v to the pixels inside (or, with inside
+*  zero, outside) a half plane.  A pixel p is inside when cross(a, p) > 0,
+*  or when it lies on the ray at a itself; the apex is never inside.  The
+*  edge function is linear along the row, so the boundary is one division.
 *
 * Parameters:  
-*  prtValue:  The value  
+*  hp:      Half plane
+*  v:       Row offset from the apex
+*  inside:  Nonzero to keep the inside, zero to keep the outside
+*  lo, hi:  Span of column offsets, narrowed in place (lo > hi when empty)
 *
-* Return: 
-*  None 
-*  Added by Steve Sparks @ Big Nerd Ranch.
-*  This swaps the Epson RGB order into the Philips RGB order. (Or, vice versa, I suppose.)
 *******************************************************************************/
-int32 GLCD_SwapColors(int32 in)
+static void GLCD_HalfPlaneRow(const GLCD_HALFPLANE *hp, int32 v, uint32 inside, int32 *lo, int32 *hi)
 {
-    return ((in & 0x000F)<<8)|(in & 0x00F0)|((in & 0x0F00)>>8);
+    int32 q = hp->cs * v;
+    int32 edge;
+
+    if(hp->sn > 0)
+    {
+        /* Inside is u <= edge */
+        edge = GLCD_FloorDiv(q - ((v > 0) ? 0 : 1), hp->sn);
+        if(inside != 0u)
+        {
+            if(*hi > edge) { *hi = edge; }
+        }
+        else
+        {
+            if(*lo <= edge) { *lo = edge + 1; }
+        }
+    }
+    else if(hp->sn < 0)
+    {
+        /* Inside is u >= edge */
+        edge = -GLCD_FloorDiv(q - ((v < 0) ? 0 : 1), -hp->sn);
+        if(inside != 0u)
+        {
+            if(*lo < edge) { *lo = edge; }
+        }
+        else
+        {
+            if(*hi >= edge) { *hi = edge - 1; }
+        }
+    }
+    else if(v != 0)
+    {
+        /* Edge along the row: the whole row is in or out */
+        if(((hp->cs > 0) == (v > 0)) != (inside != 0u))
+        {
+            *hi = *lo - 1;
+        }
+    }
+    else
+    {
+        /* The row through the apex, along the edge itself: inside is */
+        /* u > 0 when cs > 0 and u < 0 otherwise                      */
+        edge = (hp->cs > 0) ? 1 : 0;
+        if((hp->cs > 0) == (inside != 0u))
+        {
+            if(*lo < edge) { *lo = edge; }
+        }
+        else
+        {
+            if(*hi >= edge) { *hi = edge - 1; }
+        }
+    }
 }
+
 /*******************************************************************************
-* Function Name: GLCD_Pixel
+* Function Name: GLCD_DiscRow
 ********************************************************************************
 *
 * Summary:
-*  Draw Pixel  
+*  Fill one row of a disc, or the part of it inside a sector.  A sector row
+*  is at most two spans, which are merged when they touch.  The apex pixel
+*  belongs to every non-empty sector.
 *
 * Parameters:  
-*  x,y:    Location to draw the pixel
-*  color:  Color of the pixel
+*  x0, y0:  Center of the disc
+*  v:       Row offset from the center
+*  h:       Half width of the disc on this row
+*  color:   Fill color
+*  sector:  Sector to fill, NULL for the whole row
 *
-* Return: 
-*  None 
 *******************************************************************************/
-void GLCD_Pixel(int32 x, int32 y, int32 color)
+static void GLCD_DiscRow(int32 x0, int32 y0, int32 v, int32 h, int32 color, const GLCD_SECTOR *sector)
 {
-    y =	(GLCD_COL_HEIGHT - 1) - y;
-    x = (GLCD_ROW_LENGTH - 1) - x;
-
-#if (GLCD_Controller == GLCD_EPSON) /* EPSON     */
-	GLCD_Command(GLCD_PAGEADDR);    /* Set page  */
-	GLCD_Data(x);
-	GLCD_Data(GLCD_ENDPAGE);
+    int32 lo[2] = {1, 1};
+    int32 hi[2] = {0, 0};
+    uint32 i;
 
-	GLCD_Command(GLCD_COLADDR);     /* Set column */
-	GLCD_Data(y);
-	GLCD_Data(GLCD_ENDCOL);
+    if(sector == NULL)
+    {
+        GLCD_FillSpan(x0 + v, y0 - h, y0 + h, color);
+        return;
+    }
+    if((v < sector->vMin) || (v > sector->vMax))
+    {
+        return;
+    }
 
-	GLCD_Command(GLCD_RAMWR);       /* Write color data */
-	GLCD_Data((color>>4)&0x00FF);
-	GLCD_Data(((color&0x0F)<<4)|(color>>8));
-	GLCD_Data(color&0x0FF);
-#endif
+    for(i = 0u; i < sector->pieces; i++)
+    {
+        lo[i] = -h;
+        hi[i] = h;
+        GLCD_HalfPlaneRow(&sector->from[i], v, 1u, &lo[i], &hi[i]);
+        if(sector->hasTo[i] != 0u)
+        {
+            GLCD_HalfPlaneRow(&sector->to[i], v, 0u, &lo[i], &hi[i]);
+        }
+    }
 
-#if (GLCD_Controller == GLCD_PHILIPS) /* PHILIPS   */
-	GLCD_Command(GLCD_PAGEADDR);      /* Set page  */
-	GLCD_Data((uint8)x);
-	GLCD_Data((uint8)x);
+    if(v == 0)
+    {
+        /* Add the apex to the first piece */
+        if(lo[0] > hi[0])
+        {
+            lo[0] = 0;
+            hi[0] = 0;
+        }
+        else if(hi[0] == -1)
+        {
+            hi[0] = 0;
+        }
+        else if(lo[0] == 1)
+        {
+            lo[0] = 0;
+        }
+    }
 
-	GLCD_Command(GLCD_COLADDR);       /* Set column */
-	GLCD_Data((uint8)y);
-	GLCD_Data((uint8)y);
+    if((sector->pieces == 2u) && (lo[0] <= hi[0]) && (lo[1] <= hi[1]))
+    {
+        if((hi[0] + 1) == lo[1])
+        {
+            hi[0] = hi[1];
+            lo[1] = 1;
+            hi[1] = 0;
+        }
+        else if((hi[1] + 1) == lo[0])
+        {
+            lo[0] = lo[1];
+            lo[1] = 1;
+            hi[1] = 0;
+        }
+        else
+        {
+            /* Two separate spans */
+        }
+    }
 
-	GLCD_Command(GLCD_RAMWR);         /* Write color data */
-	GLCD_Data((uint8)((color>>4)&0x00FF));
-	GLCD_Data((uint8)(((color&0x0F)<<4)|0x00));
-#endif
+    for(i = 0u; i < sector->pieces; i++)
+    {
+        if(lo[i] <= hi[i])
+        {
+            GLCD_FillSpan(x0 + v, y0 + lo[i], y0 + hi[i], color);
+        }
+    }
 }
 
 /*******************************************************************************
-* Function Name: GLCD_DrawCircle
+* Function Name: GLCD_FillSector
 ********************************************************************************
 *
 * Summary:
-*  Draw a circle on the display given a start point and radius.  
+*  Fill the sector (wedge) of a disc between two angles.  Angles are in
+*  degrees, 0 pointing along +y and 90 along +x, and the sector covers
+*  startAngle up to but not including endAngle.  Sectors that share an edge
+*  therefore never overlap (apart from the apex), so an opening or closing
+*  wedge can be animated by filling just the thin sector between the old
+*  and new angle.  The disc edge is the same as GLCD_FillCircle().
 *
-*  This code uses Bresenham's Circle Algorithm. 
+*  The sector is cut into convex pieces of up to 180 degrees, each the
+*  intersection of two half planes.  Per row the edge functions are solved
+*  with integer arithmetic and the result streamed as at most two spans.
 *
 * Parameters:  
-*  x0, y0: Center of circle
-*  radius: Radius of circle
-*  color:  Color of circle
+*  x0, y0:      Center of the disc
+*  radius:      Radius of the disc
+*  startAngle:  First angle of the sector, degrees
+*  endAngle:    End angle of the sector (exclusive), degrees; a sweep of
+*               360 or more fills the whole disc
+*  color:       Fill color
 *
 * Return: 
 *  None 
 *  
 *******************************************************************************/
-void GLCD_DrawCircle (int32 x0, int32 y0, int32 radius, int32 color)
+void GLCD_FillSector(int32 x0, int32 y0, int32 radius, int32 startAngle, int32 endAngle, int32 color)
 {
-	int32 f = 1 - radius;
-	int32 ddF_x = 0;
-	int32 ddF_y = -2 * radius;
-	int32 x = 0;
-	int32 y = radius;
+    GLCD_SECTOR sector;
+    GLCD_HALFPLANE end;
+    int32 sweep = endAngle - startAngle;
+    int32 start;
 
-	GLCD_Pixel(x0, y0 + radius, color);
-	GLCD_Pixel(x0, y0 - radius, color);
-	GLCD_Pixel( x0 + radius, y0, color);
-	GLCD_Pixel( x0 - radius, y0, color);
+    if((radius < 0) || (sweep <= 0))
+    {
+        return;
+    }
+    if(sweep >= 360)
+    {
+        GLCD_FillDisc(x0, y0, radius, color, NULL);
+        return;
+    }
 
-	while(x < y)
-	{
-		if(f >= 0)
-		{
-			y--;
-			ddF_y += 2;
-			f += ddF_y;
-		}
-		x++;
-		ddF_x += 2;
-		f += ddF_x + 1;
+    start = startAngle % 360;
+    if(start < 0)
+    {
+        start += 360;
+    }
 
-		GLCD_Pixel(x0 + x, y0 + y, color);
-		GLCD_Pixel(x0 - x, y0 + y, color);
-		GLCD_Pixel( x0 + x, y0 - y, color);
-		GLCD_Pixel( x0 - x, y0 - y, color);
-		GLCD_Pixel( x0 + y, y0 + x, color);
-		GLCD_Pixel( x0 - y, y0 + x, color);
-		GLCD_Pixel( x0 + y, y0 - x, color);
-		GLCD_Pixel( x0 - y, y0 - x, color);
-	}
+    GLCD_SetHalfPlane(&sector.from[0], start);
+    GLCD_SetHalfPlane(&end, start + sweep);
+    sector.pieces = 1u;
+    sector.hasTo[0] = (sweep < 180) ? 1u : 0u;
+    sector.to[0] = end;
+    if(sweep > 180)
+    {
+        sector.pieces = 2u;
+        GLCD_SetHalfPlane(&sector.from[1], start + 180);
+        sector.to[1] = end;
+        sector.hasTo[1] = 1u;
+    }
+
+    /* Rows spanned by the apex and both end points, widened by one for    */
+    /* rounding, or the top/bottom of the disc if the sector reaches 90 or */
+    /* 270 degrees.                                                        */
+    sector.vMin = GLCD_FloorDiv(radius * ((sector.from[0].sn < end.sn) ? sector.from[0].sn : end.sn), 32768) - 1;
+    sector.vMax = GLCD_FloorDiv(radius * ((sector.from[0].sn > end.sn) ? sector.from[0].sn : end.sn), 32768) + 1;
+    if(sector.vMin > 0)
+    {
+        sector.vMin = 0;
+    }
+    if(sector.vMax < 0)
+    {
+        sector.vMax = 0;
+    }
+    if(((450 - start) % 360) < sweep)
+    {
+        sector.vMax = radius;
+    }
+    if(((630 - start) % 360) < sweep)
+    {
+        sector.vMin = -radius;
+    }
+
+    GLCD_FillDisc(x0, y0, radius, color, &sector);
 }
 
 /*******************************************************************************
@@ -396,7 +2916,8 @@ void GLCD_DrawCircle (int32 x0, int32 y0, int32 radius, int32 color)
 ********************************************************************************
 *
 * Summary:
-*  Print a character on the display.  
+*  Print a character on the display.  A character cut by the clip rectangle
+*  is drawn pixel by pixel, one outside it not at all.
 *
 * Parameters:  
 *  c:       ASCII character to be printed
@@ -410,9 +2931,6 @@ void GLCD_DrawCircle (int32 x0, int32 y0, int32 radius, int32 color)
 *******************************************************************************/
 void GLCD_PrintChar(uint8 c, int32 x, int32 y, int32 fColor, int32 bColor)
 {
-	y	=	(GLCD_COL_HEIGHT - 1) - y; /* make display "right" side up */
-	x	=	(GLCD_ROW_LENGTH - 2) - x;
-
 	int32             i,j;
 	int32    nCols;
 	int32    nRows;
@@ -423,6 +2941,7 @@ void GLCD_PrintChar(uint8 c, int32 x, int32 y, int32 fColor, int32 bColor)
 	int32    Word1;
 	uint8   *pFont;
 	uint8   *pChar;
+	uint32   clip;
 
 	/* Get pointer to the beginning of the selected font table  */
 	pFont = (uint8 *)GLCD_FONT8x16;
@@ -432,24 +2951,38 @@ void GLCD_PrintChar(uint8 c, int32 x, int32 y, int32 fColor, int32 bColor)
 	nRows = *(pFont + 1);
 	nBytes = *(pFont + 2);
 	
-	/* Get pointer to the last byte of the desired character    */
+	/* Get pointer to the byte just before the desired character; the cell  */
+	/* starts one blank row above the glyph                                 */
 	pChar = pFont + (nBytes * (c - 0x1F)) + nBytes - 1;
 
-#if (GLCD_Controller == GLCD_EPSON)
-	/* Row address set */
-	GLCD_Command(GLCD_PAGEADDR);
-	GLCD_Data(x);
-	GLCD_Data((x + nRows - 1));
-	/* Column address set */
-	GLCD_Command(GLCD_COLADDR);
-	GLCD_Data(y);
-	GLCD_Data((y + nCols - 1));
-
-	/* Write Memory */
-	GLCD_Command(GLCD_RAMWR);
-	/* Loop on each row, working backwards from the bottom to the top  */
-	for (i = nRows - 1; i >= 0; i--) {
-		/* Copy pixel row from font table and then decrement row       */
+	clip = GLCD_ClipBox(x - (nRows - 2), y - (nCols - 1), x + 1, y);
+	if (clip == GLCD_CLIP_OUT)
+	{
+		return;
+	}
+	if (clip == GLCD_CLIP_PART)
+	{
+		for (i = 0; i < nRows; i++) {
+			PixelRow = *pChar++;
+			for (j = 0; j < nCols; j++) {
+				GLCD_Pixel(x - (nRows - 2) + i, y - (nCols - 1) + j,
+				         ((PixelRow & (0x80u >> j)) != 0u) ? fColor : bColor);
+			}
+		}
+		return;
+	}
+
+	/* Colors as sent in the current color mode                 */
+	fColor = (int32)GLCD_PixelValue(fColor);
+	bColor = (int32)GLCD_PixelValue(bColor);
+
+	/* The cell ends at row x + 1 and column y, and fills a row at a time   */
+	GLCD_SetScan(GLCD_SCAN_ROWS);
+	GLCD_SetWindow(x - (nRows - 2), y - (nCols - 1), x + 1, y);
+
+	/* Loop on each row, from the top down */
+	for (i = 0; i < nRows; i++) {
+		/* Copy pixel row from font table and then move to the next row */
 		PixelRow = *pChar++;
 		/* Loop on each pixel in the row (left to right)               */
 		/* Note: we do two pixels each loop                            */
@@ -477,56 +3010,11 @@ void GLCD_PrintChar(uint8 c, int32 x, int32 y, int32 fColor, int32 bColor)
 				Word1 = fColor;
 			}
 			Mask = Mask >> 1;
-			/* Use this information to output three data bytes  */
-			GLCD_Data((uint8)((Word0 >> 4) & 0xFF));
-			GLCD_Data((uint8)(((Word0 & 0xF) << 4) | ((Word1 >> 8) & 0xF)));
-			GLCD_Data((uint8)(Word1 & 0xFF));
-		}
-	}
-#endif
-
-#if (GLCD_Controller == GLCD_PHILIPS)
-
-	/* Set row address     */
-	GLCD_Command(GLCD_PAGEADDR);
-	GLCD_Data((uint8)x);
-	GLCD_Data((uint8)(x + nRows - 1));
-    /* Set column address  */
-	GLCD_Command(GLCD_COLADDR);
-	GLCD_Data((uint8)y);
-	GLCD_Data((uint8)(y + nCols - 1));
-
-	/* Write to display memory */
-	GLCD_Command(GLCD_RAMWR);
-	/* loop on each row, working backwards from the bottom to the top.  */
-	pChar+=nBytes-1;  /* Stick pChar at the end of the row, need to reverse print on phillips */
-	for (i = nRows - 1; i >= 0; i--) {
-		/* copy pixel row from font table and then decrement row.  */
-		PixelRow = *pChar--;
-		/* Loop on each pixel in the row (left to right)  */
-		/* Note: we do two pixels each loop               */
-		Mask = 0x01;  
-		for (j = 0; j < nCols; j += 2) 
-		{
-			/* If pixel bit set, use foreground color; else use the background color  */
-			/* Get the pixel color for two successive pixels                          */
-			if ((PixelRow & Mask) == 0)
-				Word0 = bColor;
-			else
-				Word0 = fColor;
-			Mask = Mask << 1; 
-			if ((PixelRow & Mask) == 0)
-				Word1 = bColor;
-			else
-				Word1 = fColor;
-			Mask = Mask << 1; 
-			/* use this information to output three data bytes */
-			GLCD_Data((Word0 >> 4) & 0xFF);
-			GLCD_Data(((Word0 & 0xF) << 4) | ((Word1 >> 8) & 0xF));
-			GLCD_Data(Word1 & 0xFF);
+			/* Use this information to output the two pixels    */
+			GLCD_WritePair((uint32)Word0, (uint32)Word1);
 		}
 	}
-#endif
+	GLCD_CountPixels((uint32)(nRows * nCols));
 }
 
 /*******************************************************************************
@@ -574,7 +3062,15 @@ void GLCD_PrintString(char *pString, int32 x, int32 y, int32 fColor, int32 bColo
 ********************************************************************************
 *
 * Summary:
-*  Draw a line on the display.  
+*  Draw a line on the display.  Horizontal and vertical lines go to
+*  GLCD_DrawHLine() / GLCD_DrawVLine(); other lines are sent as one
+*  window per run of pixels on the major axis.
+*
+*  The outcodes of the endpoints (Cohen-Sutherland) drop a line that is all
+*  on the far side of one edge of the clip rectangle.  A line that crosses
+*  an edge is not cut at the crossing, which would light different pixels
+*  near it: the steps whose pixels are inside are solved for instead, and
+*  the walk starts at the first of them.
 *
 * Parameters:  
 *  x0, y0:  The beginning endpoint
@@ -590,6 +3086,29 @@ void GLCD_DrawLine(int32 x0, int32 y0, int32 x1, int32 y1, int32 color)
 	int32 dy = y1 - y0; /* Difference between y0 and y1 */
 	int32 dx = x1 - x0; /* Difference between x0 and x1 */
 	int32 stepx, stepy;
+	int32 first, last;  /* Steps of the major axis inside the clip    */
+	int32 minFirst;     /* and the same for the minor axis            */
+	int32 minLast;
+	int32 minor;
+	uint32 code0 = GLCD_ClipCode(x0, y0);
+	uint32 code1 = GLCD_ClipCode(x1, y1);
+
+	if ((code0 & code1) != 0u)
+	{
+		return;
+	}
+
+	/* Axis-aligned lines are a single window */
+	if (dx == 0)
+	{
+		GLCD_DrawHLine(x0, y0, y1, color);
+		return;
+	}
+	if (dy == 0)
+	{
+		GLCD_DrawVLine(x0, x1, y0, color);
+		return;
+	}
 
 	if (dy < 0)
 	{
@@ -611,42 +3130,149 @@ void GLCD_DrawLine(int32 x0, int32 y0, int32 x1, int32 y1, int32 color)
 		stepx = 1;
 	}
 
+	/* After k steps the minor axis has moved (2*k*minor + major) / (2*major) */
+	/* pixels.  For a line that crosses an edge, find the steps whose pixels */
+	/* are inside on both axes.                                               */
+	first = 0;
+	if (dx > dy)
+	{
+		last = dx;
+		if ((code0 | code1) != 0u)
+		{
+			minFirst = 0;
+			minLast = dy;
+			GLCD_StepRange(x0, stepx, GLCD_clipX0, GLCD_clipX1, &first, &last);
+			GLCD_StepRange(y0, stepy, GLCD_clipY0, GLCD_clipY1, &minFirst, &minLast);
+			minFirst = -GLCD_FloorDiv(dx - (2 * dx * minFirst), 2 * dy);
+			minLast = GLCD_FloorDiv((2 * dx * minLast) + dx - 1, 2 * dy);
+			first = (minFirst > first) ? minFirst : first;
+			last = (minLast < last) ? minLast : last;
+		}
+		minor = ((2 * dy * first) + dx) / (2 * dx);
+	}
+	else
+	{
+		last = dy;
+		if ((code0 | code1) != 0u)
+		{
+			minFirst = 0;
+			minLast = dx;
+			GLCD_StepRange(y0, stepy, GLCD_clipY0, GLCD_clipY1, &first, &last);
+			GLCD_StepRange(x0, stepx, GLCD_clipX0, GLCD_clipX1, &minFirst, &minLast);
+			minFirst = -GLCD_FloorDiv(dy - (2 * dy * minFirst), 2 * dx);
+			minLast = GLCD_FloorDiv((2 * dy * minLast) + dy - 1, 2 * dx);
+			first = (minFirst > first) ? minFirst : first;
+			last = (minLast < last) ? minLast : last;
+		}
+		minor = ((2 * dx * first) + dy) / (2 * dy);
+	}
+	if (first > last)
+	{
+		return;
+	}
+
 	dy <<= 1; /* dy is now 2*dy  */
 	dx <<= 1; /* dx is now 2*dx  */
-	GLCD_Pixel(x0, y0, color);
 
+	/* Pixels that share a row or column are sent as one run, so only the  */
+	/* steps of the minor axis cost a new address window.                  */
 	if (dx > dy) 
 	{
-		int fraction = dy - (dx >> 1);
+		int fraction = (dy - (dx >> 1)) + (dy * first) - (dx * minor);
+		int32 runStart;
+		x1 = x0 + (stepx * last);
+		x0 += stepx * first;
+		y0 += stepy * minor;
+		runStart = x0;
 		while (x0 != x1)
 		{
 			if (fraction >= 0)
 			{
+				GLCD_FillArea(runStart, y0, x0, y0, color);
+				runStart = x0 + stepx;
 				y0 += stepy;
 				fraction -= dx;
 			}
 			x0 += stepx;
 			fraction += dy;
-			GLCD_Pixel(x0, y0, color);
 		}
+		GLCD_FillArea(runStart, y0, x0, y0, color);
 	}
 	else
 	{
-		int fraction = dx - (dy >> 1);
+		int fraction = (dx - (dy >> 1)) + (dx * first) - (dy * minor);
+		int32 runStart;
+		y1 = y0 + (stepy * last);
+		y0 += stepy * first;
+		x0 += stepx * minor;
+		runStart = y0;
 		while (y0 != y1)
 		{
 			if (fraction >= 0)
 			{
+				GLCD_FillArea(x0, runStart, x0, y0, color);
+				runStart = y0 + stepy;
 				x0 += stepx;
 				fraction -= dy;
 			}
 			y0 += stepy;
 			fraction += dx;
-			GLCD_Pixel( x0, y0, color);
 		}
+		GLCD_FillArea(x0, runStart, x0, y0, color);
+	}
+}
+
+/*******************************************************************************
+* Function Name: GLCD_DrawHLine
+********************************************************************************
+*
+* Summary:
+*  Draw a horizontal line along row x: one address window and a run of
+*  color data.  The line is clipped.
+*
+* Parameters:  
+*  x:       Row of the line
+*  y0, y1:  The two endpoints, in either order
+*  color:   Color of the line.
+*
+* Return: 
+*  None 
+*  
+*******************************************************************************/
+void GLCD_DrawHLine(int32 x, int32 y0, int32 y1, int32 color)
+{
+	if (y0 > y1)
+	{
+		GLCD_FillSpan(x, y1, y0, color);
+	}
+	else
+	{
+		GLCD_FillSpan(x, y0, y1, color);
 	}
 }
 
+/*******************************************************************************
+* Function Name: GLCD_DrawVLine
+********************************************************************************
+*
+* Summary:
+*  Draw a vertical line down column y: one address window and a run of
+*  color data.  The line is clipped.
+*
+* Parameters:  
+*  x0, x1:  The two endpoints, in either order
+*  y:       Column of the line
+*  color:   Color of the line.
+*
+* Return: 
+*  None 
+*  
+*******************************************************************************/
+void GLCD_DrawVLine(int32 x0, int32 x1, int32 y, int32 color)
+{
+	GLCD_FillArea(x0, y, x1, y, color);
+}
+
 /*******************************************************************************
 * Function Name: GLCD_DrawRect
 ********************************************************************************
@@ -666,41 +3292,19 @@ void GLCD_DrawLine(int32 x0, int32 y0, int32 x1, int32 y1, int32 color)
 *******************************************************************************/
 void GLCD_DrawRect(int32 x0, int32 y0, int32 x1, int32 y1, int32 fill, int32 color)
 {	
-     int xDiff;
 	/* Check if the rectangle is to be filled    */
 	if (fill != 0)
 	{	
-        /* Find the difference between the x vars */
-		if(x0 > x1)
-		{
-			xDiff = x0 - x1; 
-		}
-		else
-		{
-			xDiff = x1 - x0;
-		}
-	
-	    /* Fill it with lines  */
-		while(xDiff >= 0)
-		{
-			GLCD_DrawLine(x0, y0, x0, y1, color);
-		
-			if(x0 > x1)
-				x0--;
-			else
-				x0++;
-		
-			xDiff--;
-		}
-
+	    /* Fill it as a single window  */
+		GLCD_FillArea(x0, y0, x1, y1, color);
 	}
 	else 
 	{
 		/* Draw the four sides of the rectangle */
-		GLCD_DrawLine(x0, y0, x1, y0, color);
-		GLCD_DrawLine(x0, y1, x1, y1, color);
-		GLCD_DrawLine(x0, y0, x0, y1, color);
-		GLCD_DrawLine(x1, y0, x1, y1, color);
+		GLCD_DrawVLine(x0, x1, y0, color);
+		GLCD_DrawVLine(x0, x1, y1, color);
+		GLCD_DrawHLine(x0, y0, y1, color);
+		GLCD_DrawHLine(x1, y0, y1, color);
 	}
 }
 
@@ -0,0 +1,377 @@
+/*******************************************************************************
+* File Name: GLCD_Anim.c
+* Version 0.3
+*
+*  Description:
+*    Animated color slots.  A shape drawn with GLCD_SLOT(n) takes
+*    the slot's current color.  Each slot can play a list of color keys with
+*    a fade curve between them, and a range of slots can be rotated to cycle
+*    colors along a row of shapes.  GLCD_AnimTick() advances
+*    every slot by one tick and returns which slots changed color, so only
+*    the shapes using those slots need to be drawn again.
+*
+*    The controller applies its RGBSET table as pixels are written, not when
+*    they are displayed, so animating the table itself would not recolor
+*    anything already on the screen.
+*
+********************************************************************************/
+
+#include <stddef.h>
+#include "cytypes.h"
+#include "GLCD.h"
+
+#if (GLCD_ANIM_SLOTS > 32u)
+    #error "GLCD_AnimTick() reports changes in a 32-bit mask"
+#endif
+
+typedef struct
+{
+    const GLCD_ANIM_KEY *keys;  /* NULL: the color is fixed       */
+    uint8 count;                            /* number of keys                 */
+    uint8 key;                              /* key the slot is moving away from */
+    uint8 mode;                             /* GLCD_ANIM_ONCE etc. */
+    uint8 curve;                            /* GLCD_CURVE_LINEAR etc. */
+    int8  dir;                              /* +1 or -1, for ping-pong        */
+    uint16 elapsed;                         /* ticks since leaving key        */
+    uint16 color;                           /* current 12-bit color           */
+} GLCD_ANIM_SLOT;
+
+typedef struct
+{
+    uint8 first;                            /* first slot in the range        */
+    uint8 count;                            /* 0: range not in use            */
+    uint8 offset;                           /* current rotation               */
+    uint16 ticks;                           /* ticks per step                 */
+    uint16 elapsed;
+} GLCD_ANIM_CYCLE;
+
+static GLCD_ANIM_SLOT GLCD_slots[GLCD_ANIM_SLOTS];
+static GLCD_ANIM_CYCLE GLCD_cycles[GLCD_ANIM_CYCLES];
+
+/* Colors as last reported by GLCD_AnimTick() */
+static uint16 GLCD_shown[GLCD_ANIM_SLOTS];
+
+static uint32 GLCD_Blend(uint32 from, uint32 to, uint32 elapsed, uint32 ticks, uint32 curve);
+static uint32 GLCD_NextKey(const GLCD_ANIM_SLOT *s);
+static void GLCD_StepSlot(GLCD_ANIM_SLOT *s);
+
+
+/*******************************************************************************
+* Function Name: GLCD_AnimSetColor
+********************************************************************************
+*
+* Summary:
+*  Give a slot a fixed color, stopping any keys it was playing.
+*
+* Parameters:
+*  slot:   0 .. GLCD_ANIM_SLOTS - 1
+*  color:  12-bit color
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_AnimSetColor(uint32 slot, int32 color)
+{
+    if(slot < GLCD_ANIM_SLOTS)
+    {
+        GLCD_slots[slot].keys = NULL;
+        GLCD_slots[slot].color = (uint16)((uint32)color & 0x0FFFu);
+    }
+}
+
+/*******************************************************************************
+* Function Name: GLCD_AnimSetKeys
+********************************************************************************
+*
+* Summary:
+*  Start a slot playing a list of keys from the first one.  keys[i].ticks is
+*  how long the slot takes to get from keys[i] to the key after it, following
+*  the fade curve; a key with the same color as the next one is a hold.  The
+*  table is not copied and must stay in place while it plays.
+*
+* Parameters:
+*  slot:   0 .. GLCD_ANIM_SLOTS - 1
+*  keys:   Key table
+*  count:  Number of keys, 1 to 255
+*  mode:   GLCD_ANIM_ONCE, _LOOP or _PINGPONG
+*  curve:  GLCD_CURVE_STEP, _LINEAR or _EASE
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_AnimSetKeys(uint32 slot, const GLCD_ANIM_KEY *keys, uint32 count, uint32 mode, uint32 curve)
+{
+    GLCD_ANIM_SLOT *s;
+
+    if((slot < GLCD_ANIM_SLOTS) && (keys != NULL) && (count != 0u) && (count <= 255u))
+    {
+        s = &GLCD_slots[slot];
+        s->keys = keys;
+        s->count = (uint8)count;
+        s->key = 0u;
+        s->mode = (uint8)mode;
+        s->curve = (uint8)curve;
+        s->dir = 1;
+        s->elapsed = 0u;
+        s->color = (uint16)(keys[0].color & 0x0FFFu);
+    }
+}
+
+/*******************************************************************************
+* Function Name: GLCD_AnimCycle
+********************************************************************************
+*
+* Summary:
+*  Rotate the colors of slots first .. first + count - 1 by one slot every
+*  ticks ticks: slot first shows what slot first + 1 would, and so on, the
+*  last wrapping round to the first.  The slots keep animating underneath.
+*  A count of 0 stops the range and puts the colors back in place.
+*
+* Parameters:
+*  range:  0 .. GLCD_ANIM_CYCLES - 1
+*  first:  First slot
+*  count:  Number of slots
+*  ticks:  Ticks per step
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_AnimCycle(uint32 range, uint32 first, uint32 count, uint32 ticks)
+{
+    GLCD_ANIM_CYCLE *c;
+
+    if(range < GLCD_ANIM_CYCLES)
+    {
+        c = &GLCD_cycles[range];
+        if((first + count) > GLCD_ANIM_SLOTS)
+        {
+            count = 0u;
+        }
+        c->first = (uint8)first;
+        c->count = (uint8)count;
+        c->offset = 0u;
+        c->ticks = (uint16)((ticks != 0u) ? ticks : 1u);
+        c->elapsed = 0u;
+    }
+}
+
+/*******************************************************************************
+* Function Name: GLCD_AnimColor
+********************************************************************************
+*
+* Summary:
+*  Color a slot shows now, with any cycling applied.  This is what the
+*  drawing functions use for a GLCD_SLOT() color.
+*
+* Parameters:
+*  slot:  0 .. GLCD_ANIM_SLOTS - 1
+*
+* Return:
+*  12-bit color, black for a slot out of range
+*
+*******************************************************************************/
+int32 GLCD_AnimColor(uint32 slot)
+{
+    const GLCD_ANIM_CYCLE *c;
+    uint32 i;
+
+    if(slot >= GLCD_ANIM_SLOTS)
+    {
+        return (GLCD_BLACK);
+    }
+
+    for(i = 0u; i < GLCD_ANIM_CYCLES; i++)
+    {
+        c = &GLCD_cycles[i];
+        if((c->count != 0u) && (slot >= c->first) && (slot < ((uint32)c->first + c->count)))
+        {
+            slot = c->first + (((slot - c->first) + c->offset) % c->count);
+            break;
+        }
+    }
+    return ((int32)GLCD_slots[slot].color);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_AnimTick
+********************************************************************************
+*
+* Summary:
+*  Advance every slot and cycle range by one tick.  Call it from a periodic
+*  tick or once per frame.  The cost depends on the number of slots, not on
+*  how many pixels use them.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Bit n set if slot n shows a different color than at the previous call;
+*  redraw the shapes that use those slots.
+*
+*******************************************************************************/
+uint32 GLCD_AnimTick(void)
+{
+    GLCD_ANIM_CYCLE *c;
+    uint32 changed = 0u;
+    uint32 color;
+    uint32 i;
+
+    for(i = 0u; i < GLCD_ANIM_SLOTS; i++)
+    {
+        GLCD_StepSlot(&GLCD_slots[i]);
+    }
+
+    for(i = 0u; i < GLCD_ANIM_CYCLES; i++)
+    {
+        c = &GLCD_cycles[i];
+        if(c->count != 0u)
+        {
+            if(++c->elapsed >= c->ticks)
+            {
+                c->elapsed = 0u;
+                c->offset = (uint8)((c->offset + 1u) % c->count);
+            }
+        }
+    }
+
+    for(i = 0u; i < GLCD_ANIM_SLOTS; i++)
+    {
+        color = (uint32)GLCD_AnimColor(i);
+        if(color != GLCD_shown[i])
+        {
+            GLCD_shown[i] = (uint16)color;
+            changed |= (1uL << i);
+        }
+    }
+    return (changed);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_StepSlot
+********************************************************************************
+*
+* Summary:
+*  Move one slot a tick along its keys.
+*
+*******************************************************************************/
+static void GLCD_StepSlot(GLCD_ANIM_SLOT *s)
+{
+    uint32 ticks;
+    uint32 next;
+
+    if((s->keys == NULL) || (s->count < 2u))
+    {
+        return;
+    }
+
+    ticks = s->keys[s->key].ticks;
+    if(++s->elapsed >= ticks)
+    {
+        /* Arrived at the next key */
+        s->key = (uint8)GLCD_NextKey(s);
+        s->elapsed = 0u;
+
+        if(s->mode == GLCD_ANIM_PINGPONG)
+        {
+            if(s->key == (s->count - 1u))
+            {
+                s->dir = -1;
+            }
+            else if(s->key == 0u)
+            {
+                s->dir = 1;
+            }
+            else
+            {
+                /* keep going */
+            }
+        }
+        else if((s->mode == GLCD_ANIM_ONCE) && (s->key == (s->count - 1u)))
+        {
+            /* Finished: hold the last key */
+            s->color = (uint16)(s->keys[s->key].color & 0x0FFFu);
+            s->keys = NULL;
+            return;
+        }
+        else
+        {
+            /* looping */
+        }
+        ticks = s->keys[s->key].ticks;
+    }
+
+    next = GLCD_NextKey(s);
+    s->color = (uint16)GLCD_Blend(s->keys[s->key].color, s->keys[next].color, s->elapsed, ticks, s->curve);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_NextKey
+********************************************************************************
+*
+* Summary:
+*  Key a slot is moving towards.
+*
+*******************************************************************************/
+static uint32 GLCD_NextKey(const GLCD_ANIM_SLOT *s)
+{
+    uint32 next;
+
+    if(s->mode == GLCD_ANIM_PINGPONG)
+    {
+        next = (uint32)((int32)s->key + s->dir);
+    }
+    else if((uint32)s->key + 1u < s->count)
+    {
+        next = (uint32)s->key + 1u;
+    }
+    else
+    {
+        next = 0u;
+    }
+    return (next);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_Blend
+********************************************************************************
+*
+* Summary:
+*  Color elapsed/ticks of the way from one 12-bit color to another, each
+*  channel separately, shaped by the fade curve.
+*
+*******************************************************************************/
+static uint32 GLCD_Blend(uint32 from, uint32 to, uint32 elapsed, uint32 ticks, uint32 curve)
+{
+    uint32 t;
+    uint32 color = 0u;
+    uint32 shift;
+    int32 a;
+    int32 b;
+
+    if((curve == GLCD_CURVE_STEP) || (ticks == 0u))
+    {
+        return (from & 0x0FFFu);
+    }
+
+    /* Position in Q8 */
+    t = (elapsed << 8) / ticks;
+    if(curve == GLCD_CURVE_EASE)
+    {
+        /* smoothstep: 3t^2 - 2t^3 */
+        t = (t * t * (768u - (2u * t))) >> 16;
+    }
+
+    for(shift = 0u; shift <= 8u; shift += 4u)
+    {
+        a = (int32)((from >> shift) & 0x0Fu);
+        b = (int32)((to >> shift) & 0x0Fu);
+        a += (((b - a) * (int32)t) + 128) >> 8;
+        color |= (uint32)a << shift;
+    }
+    return (color);
+}
+
+/* [] END OF FILE */
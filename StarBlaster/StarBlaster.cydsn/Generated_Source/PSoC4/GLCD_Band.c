@@ -0,0 +1,321 @@
+/*******************************************************************************
+* File Name: GLCD_Band.c
+* Version 0.3
+*
+*  Description:
+*    Band renderer.  Shapes are queued instead of drawn, then
+*    GLCD_BandRender() makes an area of the screen a few rows at
+*    a time in a RAM band: the background, the shapes in the order they
+*    were queued, the tiles and the sprites.  Each band goes out through
+*    one window, so every pixel of the area is sent exactly once however
+*    many shapes cover it, and overdraw costs CPU time instead of SPI time.
+*
+********************************************************************************/
+
+#include "cytypes.h"
+#include "GLCD.h"
+
+#define GLCD_SHAPE_RECT     0u
+#define GLCD_SHAPE_DISC     1u
+
+typedef struct
+{
+    int16  x0, y0;              /* corner, or center of a disc              */
+    int16  x1, y1;              /* opposite corner, or radius and the inner */
+                                /* radius of a ring (-1 for a full disc)   */
+    uint16 color;
+    uint8  type;
+} GLCD_SHAPE;
+
+static GLCD_SHAPE GLCD_shapes[GLCD_BAND_SHAPES];
+static uint32 GLCD_shapeCount = 0u;
+
+static uint16 GLCD_band[GLCD_BAND_PIXELS];
+
+static uint32 GLCD_BandQueue(uint32 type, int32 x0, int32 y0, int32 x1, int32 y1, int32 color);
+static int32 GLCD_DiscHalfWidth(int32 radius, int32 v);
+static void GLCD_BandSpan(uint16 *row, int32 y0, int32 y1, int32 from, int32 to, uint16 color);
+
+
+/*******************************************************************************
+* Function Name: GLCD_BandRect
+********************************************************************************
+*
+* Summary:
+*  Queue a filled rectangle for the next GLCD_BandRender().
+*
+* Parameters:
+*  x0, y0:  One corner
+*  x1, y1:  The opposite corner (inclusive)
+*  color:   Fill color
+*
+* Return:
+*  1 if queued, 0 if the queue was full
+*
+*******************************************************************************/
+uint32 GLCD_BandRect(int32 x0, int32 y0, int32 x1, int32 y1, int32 color)
+{
+    int32 tmp;
+
+    if(x0 > x1)
+    {
+        tmp = x0; x0 = x1; x1 = tmp;
+    }
+    if(y0 > y1)
+    {
+        tmp = y0; y0 = y1; y1 = tmp;
+    }
+    return (GLCD_BandQueue(GLCD_SHAPE_RECT, x0, y0, x1, y1, color));
+}
+
+/*******************************************************************************
+* Function Name: GLCD_BandDisc
+********************************************************************************
+*
+* Summary:
+*  Queue a filled circle, the same shape as GLCD_FillCircle().
+*
+* Parameters:
+*  x0, y0:  Center
+*  radius:  Radius
+*  color:   Fill color
+*
+* Return:
+*  1 if queued, 0 if the queue was full
+*
+*******************************************************************************/
+uint32 GLCD_BandDisc(int32 x0, int32 y0, int32 radius, int32 color)
+{
+    return (GLCD_BandQueue(GLCD_SHAPE_DISC, x0, y0, radius, -1, color));
+}
+
+/*******************************************************************************
+* Function Name: GLCD_BandRing
+********************************************************************************
+*
+* Summary:
+*  Queue a ring: the filled circle of radius less the one of radius - width.
+*
+* Parameters:
+*  x0, y0:  Center
+*  radius:  Outer radius
+*  width:   Thickness in pixels, at least 1
+*  color:   Color
+*
+* Return:
+*  1 if queued, 0 if the queue was full
+*
+*******************************************************************************/
+uint32 GLCD_BandRing(int32 x0, int32 y0, int32 radius, int32 width, int32 color)
+{
+    return (GLCD_BandQueue(GLCD_SHAPE_DISC, x0, y0, radius, radius - width, color));
+}
+
+/*******************************************************************************
+* Function Name: GLCD_BandQueue
+********************************************************************************
+*
+* Summary:
+*  Add a shape to the queue.
+*
+*******************************************************************************/
+static uint32 GLCD_BandQueue(uint32 type, int32 x0, int32 y0, int32 x1, int32 y1, int32 color)
+{
+    GLCD_SHAPE *sh;
+
+    if(GLCD_shapeCount >= GLCD_BAND_SHAPES)
+    {
+        return (0u);
+    }
+    sh = &GLCD_shapes[GLCD_shapeCount++];
+    sh->type = (uint8)type;
+    sh->x0 = (int16)x0;
+    sh->y0 = (int16)y0;
+    sh->x1 = (int16)x1;
+    sh->y1 = (int16)y1;
+    sh->color = (uint16)color;
+    return (1u);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_BandRender
+********************************************************************************
+*
+* Summary:
+*  Draw a rectangle of the screen, cut to the clip rectangle, from the
+*  background, the queued shapes, the tiles and the sprites, then empty the
+*  queue.  As many rows as fit are made in the band and sent, all through
+*  one window.
+*
+*  Nothing is marked as drawn: tiles or sprites that were waiting for a
+*  flush still get it.
+*
+* Parameters:
+*  x0, y0:  One corner
+*  x1, y1:  The opposite corner (inclusive)
+*
+* Return:
+*  Number of pixels sent
+*
+*******************************************************************************/
+uint32 GLCD_BandRender(int32 x0, int32 y0, int32 x1, int32 y1)
+{
+    const GLCD_SHAPE *sh;
+    uint16 *row;
+    int32 tmp;
+    int32 x, xEnd;
+    int32 width, rowsPerBand;
+    int32 h, inner;
+    int32 cx0, cy0, cx1, cy1;
+    uint32 n;
+
+    if(x0 > x1)
+    {
+        tmp = x0; x0 = x1; x1 = tmp;
+    }
+    if(y0 > y1)
+    {
+        tmp = y0; y0 = y1; y1 = tmp;
+    }
+    GLCD_GetClip(&cx0, &cy0, &cx1, &cy1);
+    x0 = (x0 < cx0) ? cx0 : x0;
+    y0 = (y0 < cy0) ? cy0 : y0;
+    x1 = (x1 > cx1) ? cx1 : x1;
+    y1 = (y1 > cy1) ? cy1 : y1;
+    if((x0 > x1) || (y0 > y1))
+    {
+        GLCD_shapeCount = 0u;
+        return (0u);
+    }
+
+    width = (y1 - y0) + 1;
+    rowsPerBand = (int32)GLCD_BAND_PIXELS / width;
+
+    GLCD_SetScan(GLCD_SCAN_ROWS);
+    GLCD_SetWindow(x0, y0, x1, y1);
+
+    for(x = x0; x <= x1; x = xEnd)
+    {
+        xEnd = x + rowsPerBand;
+        xEnd = (xEnd > (x1 + 1)) ? (x1 + 1) : xEnd;
+
+        for(row = GLCD_band, tmp = x; tmp < xEnd; tmp++, row += width)
+        {
+            GLCD_ComposeBackground(tmp, y0, y1, row);
+
+            for(n = 0u; n < GLCD_shapeCount; n++)
+            {
+                sh = &GLCD_shapes[n];
+                if(sh->type == GLCD_SHAPE_RECT)
+                {
+                    if((tmp >= sh->x0) && (tmp <= sh->x1))
+                    {
+                        GLCD_BandSpan(row, y0, y1, sh->y0, sh->y1, sh->color);
+                    }
+                    continue;
+                }
+
+                h = GLCD_DiscHalfWidth(sh->x1, tmp - sh->x0);
+                if(h < 0)
+                {
+                    continue;
+                }
+                inner = GLCD_DiscHalfWidth(sh->y1, tmp - sh->x0);
+                if(inner < 0)
+                {
+                    GLCD_BandSpan(row, y0, y1, sh->y0 - h, sh->y0 + h, sh->color);
+                }
+                else
+                {
+                    GLCD_BandSpan(row, y0, y1, sh->y0 - h, (sh->y0 - inner) - 1, sh->color);
+                    GLCD_BandSpan(row, y0, y1, (sh->y0 + inner) + 1, sh->y0 + h, sh->color);
+                }
+            }
+
+            GLCD_ComposeLayers(tmp, y0, y1, row);
+        }
+
+        GLCD_WritePixels(GLCD_band, (uint32)((xEnd - x) * width));
+    }
+
+    GLCD_shapeCount = 0u;
+    return ((uint32)(((x1 - x0) + 1) * width));
+}
+
+/*******************************************************************************
+* Function Name: GLCD_DiscHalfWidth
+********************************************************************************
+*
+* Summary:
+*  Half the width of row v of a filled circle, found with the same
+*  Bresenham walk as GLCD_FillCircle() so the shapes match.
+*
+* Parameters:
+*  radius:  Radius, negative for no circle
+*  v:       Row relative to the center
+*
+* Return:
+*  The row covers -h .. h about the center, or -1 if the row is not in it
+*
+*******************************************************************************/
+static int32 GLCD_DiscHalfWidth(int32 radius, int32 v)
+{
+    int32 f = 1 - radius;
+    int32 ddF_x = 0;
+    int32 ddF_y = -2 * radius;
+    int32 x = 0;
+    int32 y = radius;
+
+    v = (v < 0) ? -v : v;
+    if((radius < 0) || (v > radius))
+    {
+        return (-1);
+    }
+    if(v == 0)
+    {
+        return (radius);
+    }
+
+    while(x < y)
+    {
+        if(f >= 0)
+        {
+            if(y == v)
+            {
+                return (x);
+            }
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x + 1;
+
+        if((x <= y) && (x == v))
+        {
+            return (y);
+        }
+    }
+    return (-1);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_BandSpan
+********************************************************************************
+*
+* Summary:
+*  Set columns from .. to of a band row that holds columns y0 .. y1.
+*
+*******************************************************************************/
+static void GLCD_BandSpan(uint16 *row, int32 y0, int32 y1, int32 from, int32 to, uint16 color)
+{
+    from = (from < y0) ? y0 : from;
+    to = (to > y1) ? y1 : to;
+    for( ; from <= to; from++)
+    {
+        row[from - y0] = color;
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,244 @@
+/*******************************************************************************
+* File Name: GLCD_Loop.c
+* Version 0.3
+*
+*  Description:
+*    Fixed-timestep game loop on the SysTick timer.  A SysTick callback
+*    counts milliseconds and, with a rational accumulator so that 60 Hz is
+*    exact, the game ticks that have come due.  Each pass of
+*    GLCD_LoopStep() sleeps until a tick is due, samples the
+*    input, runs the game's update once per tick and then renders with how
+*    far time has got towards the next tick, so motion can be drawn between
+*    ticks.  The game runs at the same speed however long a frame takes to
+*    draw; when drawing falls behind, renders are skipped, not updates.
+*
+********************************************************************************/
+
+#include <stddef.h>
+#include "cytypes.h"
+#include "CyLib.h"
+#include "cyPm.h"
+#include "GLCD.h"
+
+static volatile uint32 GLCD_loopMs = 0u;       /* SysTick interrupts  */
+static volatile uint32 GLCD_loopDue = 0u;      /* ticks not yet run   */
+static volatile uint32 GLCD_loopPhase = 0u;    /* ms * hz since the last tick, < 1000 */
+static uint32 GLCD_loopHz = 50u;
+static uint32 GLCD_loopReload = 1u;
+static uint32 GLCD_loopTicks = 0u;
+static uint32 GLCD_loopSkips = 0u;             /* renders skipped in a row */
+
+static GLCD_LOOP_STATS GLCD_loopStats;
+static const GLCD_LOOP_STATS GLCD_loopZero = {0u, 0u, 0u, 0u, 0u, 0u, 0u};
+
+static void GLCD_LoopTick(void);
+
+
+/*******************************************************************************
+* Function Name: GLCD_LoopStart
+********************************************************************************
+*
+* Summary:
+*  Start the SysTick timer at 1 ms, if it is not running already, and hook
+*  the loop onto it.  The first tick is due one period later.
+*
+* Parameters:
+*  hz:  Game ticks per second, 1 to 1000; 50 or 60 for most games
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_LoopStart(uint32 hz)
+{
+    uint8 intr;
+
+    CySysTickStart();
+    GLCD_loopReload = CySysTickGetReload() + 1u;
+
+    intr = CyEnterCriticalSection();
+    GLCD_loopHz = ((hz == 0u) || (hz > 1000u)) ? 50u : hz;
+    GLCD_loopDue = 0u;
+    GLCD_loopPhase = 0u;
+    CyExitCriticalSection(intr);
+
+    GLCD_loopTicks = 0u;
+    GLCD_loopSkips = 0u;
+    GLCD_loopStats = GLCD_loopZero;
+    (void)CySysTickSetCallback(GLCD_LOOP_SYSTICK_SLOT, &GLCD_LoopTick);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_LoopTick
+********************************************************************************
+*
+* Summary:
+*  SysTick callback, every millisecond.  A tick of 1/hz s is 1000 / hz ms,
+*  so the phase goes up by hz each millisecond and a tick is due each time
+*  it passes 1000.
+*
+*******************************************************************************/
+static void GLCD_LoopTick(void)
+{
+    uint32 phase = GLCD_loopPhase + GLCD_loopHz;
+
+    GLCD_loopMs++;
+    if(phase >= 1000u)
+    {
+        phase -= 1000u;
+        GLCD_loopDue++;
+    }
+    GLCD_loopPhase = phase;
+}
+
+/*******************************************************************************
+* Function Name: GLCD_LoopStep
+********************************************************************************
+*
+* Summary:
+*  One pass of the game loop; call it from the main loop.
+*
+*  Sleeps until a tick is due, calls input(), then update() once for each
+*  tick that has come due, at most GLCD_LOOP_MAX_UPDATES times:
+*  ticks beyond that are dropped, so the game slows down rather than never
+*  catching up.  render() follows unless another tick came due while
+*  updating, in which case the pass ends so the next one can catch up; no
+*  more than GLCD_LOOP_MAX_SKIPS renders in a row are skipped.
+*
+* Parameters:
+*  game:  The game's functions; input and update may be NULL
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_LoopStep(const GLCD_GAME *game)
+{
+    uint32 start;
+    uint32 now;
+    uint32 due;
+    uint8 intr;
+
+    start = GLCD_LoopMicros();
+    while(GLCD_loopDue == 0u)
+    {
+        CySysPmSleep();
+    }
+    now = GLCD_LoopMicros();
+    GLCD_loopStats.idleUs = now - start;
+    start = now;
+
+    if(game->input != NULL)
+    {
+        game->input();
+    }
+
+    intr = CyEnterCriticalSection();
+    due = GLCD_loopDue;
+    GLCD_loopDue = 0u;
+    CyExitCriticalSection(intr);
+
+    if(due > GLCD_LOOP_MAX_UPDATES)
+    {
+        GLCD_loopStats.dropped += due - GLCD_LOOP_MAX_UPDATES;
+        due = GLCD_LOOP_MAX_UPDATES;
+    }
+    GLCD_loopStats.updates = (uint16)due;
+    for( ; due != 0u; due--)
+    {
+        if(game->update != NULL)
+        {
+            game->update();
+        }
+        GLCD_loopTicks++;
+    }
+    now = GLCD_LoopMicros();
+    GLCD_loopStats.updateUs = now - start;
+    start = now;
+
+    if((GLCD_loopDue != 0u) && (GLCD_loopSkips < GLCD_LOOP_MAX_SKIPS))
+    {
+        /* Behind: catch up first */
+        GLCD_loopSkips++;
+        GLCD_loopStats.skipped++;
+        GLCD_loopStats.renderUs = 0u;
+        return;
+    }
+    GLCD_loopSkips = 0u;
+
+    game->render((GLCD_loopPhase * 256u) / 1000u);
+    GLCD_loopStats.renderUs = GLCD_LoopMicros() - start;
+    GLCD_loopStats.renders++;
+}
+
+/*******************************************************************************
+* Function Name: GLCD_LoopStats
+********************************************************************************
+*
+* Summary:
+*  Where the time of the last pass went, and counts since the loop started.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  The loop statistics
+*
+*******************************************************************************/
+const GLCD_LOOP_STATS *GLCD_LoopStats(void)
+{
+    return (&GLCD_loopStats);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_LoopTicks
+********************************************************************************
+*
+* Summary:
+*  Game ticks run, that is update() calls, since the loop started.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Number of ticks
+*
+*******************************************************************************/
+uint32 GLCD_LoopTicks(void)
+{
+    return (GLCD_loopTicks);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_LoopMicros
+********************************************************************************
+*
+* Summary:
+*  Microseconds since the loop started, from the millisecond count and the
+*  SysTick counter.  Wraps after about 71 minutes; differences are still
+*  right across the wrap.  Must be called with interrupts enabled.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Time in microseconds
+*
+*******************************************************************************/
+uint32 GLCD_LoopMicros(void)
+{
+    uint32 ms;
+    uint32 value;
+
+    do
+    {
+        ms = GLCD_loopMs;
+        value = CySysTickGetValue();
+    }
+    while(ms != GLCD_loopMs);
+
+    /* The counter runs down from the reload value once a millisecond */
+    return ((ms * 1000u) + (((GLCD_loopReload - 1u - value) * 1000u) / GLCD_loopReload));
+}
+
+/* [] END OF FILE */
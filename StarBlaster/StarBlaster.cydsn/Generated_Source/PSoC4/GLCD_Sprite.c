@@ -0,0 +1,398 @@
+/*******************************************************************************
+* File Name: GLCD_Sprite.c
+* Version 0.3
+*
+*  Description:
+*    Sprite layer.  A few sprites, each a flash image of RRRGGGBB indices
+*    with one index that is see-through, are laid over the background.
+*    Moving a sprite only marks it; GLCD_SpriteFlush() then
+*    redraws the area it left and the area it moved to, usually as one
+*    window, composing every pixel in RAM from the background, the tile
+*    layer and all the sprites there before it is sent once.
+*
+*    The controller's memory cannot be read back, so what lies under a
+*    sprite is not saved but made again: tiles come from the tile layer
+*    and anything else from a background function given by the program,
+*    or black without one.
+*
+********************************************************************************/
+
+#include <stddef.h>
+#include "cytypes.h"
+#include "GLCD.h"
+
+typedef struct
+{
+    const GLCD_SPRITE_IMAGE *image;     /* NULL: hidden          */
+    int16 x;                                        /* top left corner       */
+    int16 y;
+    int16 shownX0, shownY0, shownX1, shownY1;       /* area drawn last flush */
+    uint8 shown;                                    /* anything drawn there  */
+    uint8 dirty;                                    /* to be drawn again     */
+    uint8 flags;
+} GLCD_SPRITE;
+
+static GLCD_SPRITE GLCD_sprites[GLCD_SPRITES];
+static GLCD_BACKGROUND_ROW GLCD_background = NULL;
+
+/* One composed row on its way to the display */
+static uint16 GLCD_spriteRow[GLCD_COL_HEIGHT];
+
+static void GLCD_SpriteCompose(int32 x0, int32 y0, int32 x1, int32 y1);
+
+
+/*******************************************************************************
+* Function Name: GLCD_SpriteSetBackground
+********************************************************************************
+*
+* Summary:
+*  Give the function that says what is under the sprites where there is no
+*  tile.  It is asked for part of a row at a time.
+*
+* Parameters:
+*  background:  Function filling colors[0 .. y1 - y0] for row x, columns y0
+*               to y1, with any color arguments; NULL for black
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_SpriteSetBackground(GLCD_BACKGROUND_ROW background)
+{
+    GLCD_background = background;
+}
+
+/*******************************************************************************
+* Function Name: GLCD_SpriteShow
+********************************************************************************
+*
+* Summary:
+*  Show a sprite, or change its image, at the next flush.
+*
+* Parameters:
+*  n:      Sprite, 0 .. GLCD_SPRITES - 1; lower numbers are in
+*          front of higher ones
+*  image:  Image in flash
+*  x, y:   Top left corner
+*  flags:  0, or GLCD_SPRITE_BEHIND to pass behind the tiles
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_SpriteShow(uint32 n, const GLCD_SPRITE_IMAGE *image, int32 x, int32 y, uint32 flags)
+{
+    GLCD_SPRITE *s;
+
+    if(n < GLCD_SPRITES)
+    {
+        s = &GLCD_sprites[n];
+        s->image = image;
+        s->x = (int16)x;
+        s->y = (int16)y;
+        s->flags = (uint8)flags;
+        s->dirty = 1u;
+    }
+}
+
+/*******************************************************************************
+* Function Name: GLCD_SpriteMove
+********************************************************************************
+*
+* Summary:
+*  Move a sprite at the next flush.  Nothing is sent now.
+*
+* Parameters:
+*  n:     Sprite
+*  x, y:  New top left corner
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_SpriteMove(uint32 n, int32 x, int32 y)
+{
+    GLCD_SPRITE *s;
+
+    if(n < GLCD_SPRITES)
+    {
+        s = &GLCD_sprites[n];
+        if((s->x != x) || (s->y != y))
+        {
+            s->dirty = 1u;
+        }
+        s->x = (int16)x;
+        s->y = (int16)y;
+    }
+}
+
+/*******************************************************************************
+* Function Name: GLCD_SpriteHide
+********************************************************************************
+*
+* Summary:
+*  Take a sprite off the screen at the next flush.
+*
+* Parameters:
+*  n:  Sprite
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_SpriteHide(uint32 n)
+{
+    if((n < GLCD_SPRITES) && (GLCD_sprites[n].image != NULL))
+    {
+        GLCD_sprites[n].image = NULL;
+        GLCD_sprites[n].dirty = 1u;
+    }
+}
+
+/*******************************************************************************
+* Function Name: GLCD_SpriteInvalidate
+********************************************************************************
+*
+* Summary:
+*  Say that something was drawn over a rectangle of the screen, so that any
+*  sprite there is drawn again at the next flush.
+*
+* Parameters:
+*  x0, y0:  One corner of the rectangle
+*  x1, y1:  The opposite corner (inclusive)
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_SpriteInvalidate(int32 x0, int32 y0, int32 x1, int32 y1)
+{
+    GLCD_SPRITE *s;
+    int32 tmp;
+    uint32 n;
+
+    if(x0 > x1)
+    {
+        tmp = x0; x0 = x1; x1 = tmp;
+    }
+    if(y0 > y1)
+    {
+        tmp = y0; y0 = y1; y1 = tmp;
+    }
+    for(n = 0u; n < GLCD_SPRITES; n++)
+    {
+        s = &GLCD_sprites[n];
+        if((s->shown != 0u) && (x0 <= s->shownX1) && (x1 >= s->shownX0) &&
+           (y0 <= s->shownY1) && (y1 >= s->shownY0))
+        {
+            s->dirty = 1u;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: GLCD_SpriteFlush
+********************************************************************************
+*
+* Summary:
+*  Draw the sprites that moved or changed.  For each, the area it was drawn
+*  in last time and the area it covers now are drawn again from the layers,
+*  as one window when their bounding box costs no more than the two apart.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Number of pixels sent
+*
+*******************************************************************************/
+uint32 GLCD_SpriteFlush(void)
+{
+    GLCD_SPRITE *s;
+    uint32 n;
+    uint32 sent = 0u;
+    int32 nx0, ny0, nx1, ny1;
+    int32 ux0, uy0, ux1, uy1;
+    int32 areaOld, areaNew, areaBoth;
+
+    for(n = 0u; n < GLCD_SPRITES; n++)
+    {
+        s = &GLCD_sprites[n];
+        if(s->dirty == 0u)
+        {
+            continue;
+        }
+        s->dirty = 0u;
+
+        /* Where it goes now, on the screen */
+        nx0 = 1;
+        nx1 = 0;
+        ny0 = 0;
+        ny1 = 0;
+        if(s->image != NULL)
+        {
+            nx0 = (s->x < (int32)GLCD_MINX) ? (int32)GLCD_MINX : s->x;
+            ny0 = (s->y < (int32)GLCD_MINY) ? (int32)GLCD_MINY : s->y;
+            nx1 = (int32)s->x + (int32)s->image->height - 1;
+            ny1 = (int32)s->y + (int32)s->image->width - 1;
+            nx1 = (nx1 > (int32)GLCD_MAXX) ? (int32)GLCD_MAXX : nx1;
+            ny1 = (ny1 > (int32)GLCD_MAXY) ? (int32)GLCD_MAXY : ny1;
+        }
+        areaNew = ((nx0 <= nx1) && (ny0 <= ny1)) ? (((nx1 - nx0) + 1) * ((ny1 - ny0) + 1)) : 0;
+        areaOld = (s->shown != 0u) ? (((s->shownX1 - s->shownX0) + 1) * ((s->shownY1 - s->shownY0) + 1)) : 0;
+
+        if((areaOld != 0) && (areaNew != 0))
+        {
+            ux0 = (s->shownX0 < nx0) ? s->shownX0 : nx0;
+            uy0 = (s->shownY0 < ny0) ? s->shownY0 : ny0;
+            ux1 = (s->shownX1 > nx1) ? s->shownX1 : nx1;
+            uy1 = (s->shownY1 > ny1) ? s->shownY1 : ny1;
+            areaBoth = ((ux1 - ux0) + 1) * ((uy1 - uy0) + 1);
+            if(areaBoth <= (areaOld + areaNew))
+            {
+                GLCD_SpriteCompose(ux0, uy0, ux1, uy1);
+                sent += (uint32)areaBoth;
+                areaOld = 0;
+                areaNew = 0;
+            }
+        }
+        if(areaOld != 0)
+        {
+            GLCD_SpriteCompose(s->shownX0, s->shownY0, s->shownX1, s->shownY1);
+            sent += (uint32)areaOld;
+        }
+        if(areaNew != 0)
+        {
+            GLCD_SpriteCompose(nx0, ny0, nx1, ny1);
+            sent += (uint32)areaNew;
+        }
+
+        s->shown = ((nx0 <= nx1) && (ny0 <= ny1)) ? 1u : 0u;
+        s->shownX0 = (int16)nx0;
+        s->shownY0 = (int16)ny0;
+        s->shownX1 = (int16)nx1;
+        s->shownY1 = (int16)ny1;
+    }
+    return (sent);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_SpriteCompose
+********************************************************************************
+*
+* Summary:
+*  Draw a rectangle of the screen, inside it, from all the layers: the
+*  background, then tiles, then sprites from the back to the front.  Each
+*  row is made in RAM and sent through one window.
+*
+*******************************************************************************/
+static void GLCD_SpriteCompose(int32 x0, int32 y0, int32 x1, int32 y1)
+{
+    uint16 *row = GLCD_spriteRow;
+    int32 x;
+
+    GLCD_SetScan(GLCD_SCAN_ROWS);
+    GLCD_SetWindow(x0, y0, x1, y1);
+
+    for(x = x0; x <= x1; x++)
+    {
+        GLCD_ComposeBackground(x, y0, y1, row);
+        GLCD_ComposeLayers(x, y0, y1, row);
+        GLCD_WritePixels(row, (uint32)(y1 - y0) + 1u);
+    }
+}
+
+/*******************************************************************************
+* Function Name: GLCD_ComposeBackground
+********************************************************************************
+*
+* Summary:
+*  Fill part of a row with what lies under the tiles and sprites, from the
+*  background function or black.
+*
+* Parameters:
+*  x:       Row
+*  y0, y1:  First and last column, y0 <= y1
+*  colors:  Filled with y1 - y0 + 1 color arguments
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_ComposeBackground(int32 x, int32 y0, int32 y1, uint16 *colors)
+{
+    int32 y;
+
+    if(GLCD_background != NULL)
+    {
+        GLCD_background(x, y0, y1, colors);
+    }
+    else
+    {
+        for(y = y0; y <= y1; y++)
+        {
+            colors[y - y0] = GLCD_BLACK;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: GLCD_ComposeLayers
+********************************************************************************
+*
+* Summary:
+*  Lay the tiles and then the sprites, back to front, over part of a row
+*  that already holds the background.
+*
+* Parameters:
+*  x:       Row
+*  y0, y1:  First and last column, y0 <= y1
+*  colors:  y1 - y0 + 1 color arguments to draw over
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_ComposeLayers(int32 x, int32 y0, int32 y1, uint16 *colors)
+{
+    const GLCD_SPRITE *s;
+    const uint8 *pixels;
+    int32 y;
+    int32 from, to;
+    int32 tile;
+    uint32 n;
+    uint32 index;
+
+    for(y = y0; y <= y1; y++)
+    {
+        tile = GLCD_TilePixel(x, y);
+        if(tile >= 0)
+        {
+            colors[y - y0] = (uint16)tile;
+        }
+    }
+
+    for(n = GLCD_SPRITES; n-- != 0u; )
+    {
+        s = &GLCD_sprites[n];
+        if((s->image == NULL) || (x < s->x) || (x >= ((int32)s->x + (int32)s->image->height)))
+        {
+            continue;
+        }
+        from = (s->y > y0) ? s->y : y0;
+        to = (int32)s->y + (int32)s->image->width - 1;
+        to = (to < y1) ? to : y1;
+        pixels = s->image->pixels + ((uint32)(x - s->x) * s->image->width);
+        for(y = from; y <= to; y++)
+        {
+            index = pixels[y - s->y];
+            if((index != s->image->key) &&
+               (((s->flags & GLCD_SPRITE_BEHIND) == 0u) || (GLCD_TilePixel(x, y) < 0)))
+            {
+                colors[y - y0] = (uint16)GLCD_INDEX(index);
+            }
+        }
+    }
+}
+
+/* [] END OF FILE */
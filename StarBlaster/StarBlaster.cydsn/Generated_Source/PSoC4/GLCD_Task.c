@@ -0,0 +1,153 @@
+/*******************************************************************************
+* File Name: GLCD_Task.c
+* Version 0.3
+*
+*  Description:
+*    Cooperative tasks.  A task is a function that does a little drawing and
+*    returns, written as straight-line code with the protothread macros of
+*    GLCD.h: GLCD_TASK_YIELD() returns and the next
+*    run carries on from there.  GLCD_TaskRun(), once a frame,
+*    gives every task one slice, so an explosion, the twinkling stars and the
+*    crosshair all move on together and no animation holds up the game.
+*
+*    Tasks live in a fixed table; local variables are lost at a yield, so
+*    what a task needs to keep is in its table entry.
+*
+********************************************************************************/
+
+#include <stddef.h>
+#include "cytypes.h"
+#include "GLCD.h"
+
+static GLCD_TASK GLCD_tasks[GLCD_TASK_MAX];
+
+
+/*******************************************************************************
+* Function Name: GLCD_TaskStart
+********************************************************************************
+*
+* Summary:
+*  Add a task.  It runs from the top at the next GLCD_TaskRun().
+*
+* Parameters:
+*  run:   The task function
+*  x, y:  Start arguments, kept in the task's x and y
+*
+* Return:
+*  The task's number, or -1 if the table is full
+*
+*******************************************************************************/
+int32 GLCD_TaskStart(GLCD_TASK_FUNC run, int32 x, int32 y)
+{
+    GLCD_TASK *t;
+    uint32 i;
+
+    for(i = 0u; i < GLCD_TASK_MAX; i++)
+    {
+        t = &GLCD_tasks[i];
+        if(t->run == NULL)
+        {
+            t->run = run;
+            t->line = 0u;
+            t->wake = GLCD_LoopTicks();
+            t->x = (int16)x;
+            t->y = (int16)y;
+            t->n = 0;
+            return ((int32)i);
+        }
+    }
+    return (-1);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_TaskStop
+********************************************************************************
+*
+* Summary:
+*  Remove a task where it stands; what it has drawn stays.
+*
+* Parameters:
+*  task:  Number returned by GLCD_TaskStart()
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void GLCD_TaskStop(int32 task)
+{
+    if((task >= 0) && (task < (int32)GLCD_TASK_MAX))
+    {
+        GLCD_tasks[task].run = NULL;
+    }
+}
+
+/*******************************************************************************
+* Function Name: GLCD_TaskRunning
+********************************************************************************
+*
+* Summary:
+*  Whether a task running a function is in the table.
+*
+* Parameters:
+*  run:  The task function
+*
+* Return:
+*  Number of tasks running it
+*
+*******************************************************************************/
+uint32 GLCD_TaskRunning(GLCD_TASK_FUNC run)
+{
+    uint32 i;
+    uint32 n = 0u;
+
+    for(i = 0u; i < GLCD_TASK_MAX; i++)
+    {
+        n += (GLCD_tasks[i].run == run) ? 1u : 0u;
+    }
+    return (n);
+}
+
+/*******************************************************************************
+* Function Name: GLCD_TaskRun
+********************************************************************************
+*
+* Summary:
+*  Give each task that is not asleep one slice, in table order.  A task that
+*  returns GLCD_TASK_DONE is removed.  Sleeps count game loop
+*  ticks, see GLCD_LoopTicks().
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Number of tasks left
+*
+*******************************************************************************/
+uint32 GLCD_TaskRun(void)
+{
+    GLCD_TASK *t;
+    uint32 now = GLCD_LoopTicks();
+    uint32 left = 0u;
+    uint32 i;
+
+    for(i = 0u; i < GLCD_TASK_MAX; i++)
+    {
+        t = &GLCD_tasks[i];
+        if(t->run == NULL)
+        {
+            continue;
+        }
+        if((int32)(now - t->wake) >= 0)
+        {
+            if(t->run(t) == GLCD_TASK_DONE)
+            {
+                t->run = NULL;
+                continue;
+            }
+        }
+        left++;
+    }
+    return (left);
+}
+
+/* [] END OF FILE */
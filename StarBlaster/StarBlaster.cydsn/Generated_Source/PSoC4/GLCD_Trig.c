@@ -0,0 +1,69 @@
+/*******************************************************************************
+* File Name: GLCD_Trig.c  
+* Version 0.3
+*
+*  Description:
+*    Quarter-wave sine table used by the fixed-point trig helpers.
+*    sin(k / 4 degrees) for k = 0..360, in Q1.15.
+*
+*    Generated by tools/glcd_emu/gen_trig.c, do not edit.
+*
+********************************************************************************/
+
+#include "cytypes.h"
+#include "GLCD.h"
+
+#if (GLCD_TRIG_STEPS != 4u)
+    #error "GLCD_Trig.c was generated for 4 steps per degree"
+#endif
+
+const int16 GLCD_SIN_TABLE[GLCD_TRIG_QUADRANT + 1u] = {
+        0,   143,   286,   429,   572,   715,   858,  1001,
+     1144,  1286,  1429,  1572,  1715,  1858,  2000,  2143,
+     2286,  2428,  2571,  2713,  2856,  2998,  3141,  3283,
+     3425,  3567,  3709,  3851,  3993,  4135,  4277,  4419,
+     4560,  4702,  4843,  4985,  5126,  5267,  5408,  5549,
+     5690,  5831,  5971,  6112,  6252,  6393,  6533,  6673,
+     6813,  6952,  7092,  7232,  7371,  7510,  7649,  7788,
+     7927,  8066,  8204,  8343,  8481,  8619,  8757,  8894,
+     9032,  9169,  9306,  9443,  9580,  9717,  9853,  9989,
+    10126, 10261, 10397, 10533, 10668, 10803, 10938, 11073,
+    11207, 11341, 11475, 11609, 11743, 11876, 12009, 12142,
+    12275, 12407, 12539, 12671, 12803, 12935, 13066, 13197,
+    13328, 13458, 13588, 13718, 13848, 13977, 14107, 14235,
+    14364, 14492, 14621, 14748, 14876, 15003, 15130, 15257,
+    15383, 15509, 15635, 15761, 15886, 16011, 16135, 16260,
+    16383, 16507, 16631, 16754, 16876, 16999, 17121, 17242,
+    17364, 17485, 17606, 17726, 17846, 17966, 18085, 18204,
+    18323, 18441, 18559, 18677, 18794, 18911, 19028, 19144,
+    19260, 19375, 19491, 19605, 19720, 19834, 19947, 20061,
+    20173, 20286, 20398, 20510, 20621, 20732, 20842, 20952,
+    21062, 21172, 21280, 21389, 21497, 21605, 21712, 21819,
+    21925, 22031, 22137, 22242, 22347, 22451, 22555, 22659,
+    22762, 22864, 22967, 23068, 23170, 23271, 23371, 23471,
+    23571, 23670, 23768, 23867, 23964, 24062, 24158, 24255,
+    24351, 24446, 24541, 24636, 24730, 24823, 24916, 25009,
+    25101, 25193, 25284, 25375, 25465, 25554, 25644, 25732,
+    25821, 25909, 25996, 26083, 26169, 26255, 26340, 26425,
+    26509, 26593, 26676, 26759, 26841, 26923, 27004, 27085,
+    27165, 27245, 27324, 27403, 27481, 27558, 27635, 27712,
+    27788, 27863, 27938, 28013, 28087, 28160, 28233, 28305,
+    28377, 28448, 28519, 28589, 28659, 28728, 28796, 28864,
+    28932, 28998, 29065, 29130, 29196, 29260, 29324, 29388,
+    29451, 29513, 29575, 29636, 29697, 29757, 29817, 29876,
+    29934, 29992, 30049, 30106, 30162, 30218, 30273, 30327,
+    30381, 30434, 30487, 30539, 30591, 30642, 30692, 30742,
+    30791, 30840, 30888, 30935, 30982, 31028, 31074, 31119,
+    31163, 31207, 31250, 31293, 31335, 31377, 31418, 31458,
+    31498, 31537, 31575, 31613, 31650, 31687, 31723, 31759,
+    31794, 31828, 31862, 31895, 31927, 31959, 31990, 32021,
+    32051, 32080, 32109, 32137, 32165, 32192, 32218, 32244,
+    32269, 32294, 32318, 32341, 32364, 32386, 32407, 32428,
+    32448, 32468, 32487, 32505, 32523, 32540, 32556, 32572,
+    32587, 32602, 32616, 32630, 32642, 32654, 32666, 32677,
+    32687, 32697, 32706, 32714, 32722, 32729, 32736, 32742,
+    32747, 32752, 32756, 32759, 32762, 32764, 32766, 32767,
+    32767
+};
+
+/* [] END OF FILE */
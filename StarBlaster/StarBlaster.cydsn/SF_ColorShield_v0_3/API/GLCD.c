@@ -41,30 +41,283 @@ uint8 `$INSTANCE_NAME`_driver;
 static int32 `$INSTANCE_NAME`_x_offset = 0;
 static int32 `$INSTANCE_NAME`_y_offset = 0;
 
+/* Last setting passed to `$INSTANCE_NAME`_Contrast() */
+static int32 `$INSTANCE_NAME`_contrast = 0;
+
+/* Hardware scroll: rows scrollTop .. scrollTop + scrollRows - 1 (driver x) */
+/* scroll, the content moved scrollOffset rows towards higher x.  No rows   */
+/* means scrolling is off.                                                  */
+static int32 `$INSTANCE_NAME`_scrollTop = 0;
+static int32 `$INSTANCE_NAME`_scrollRows = 0;
+static int32 `$INSTANCE_NAME`_scrollOffset = 0;
+
+/* A 12-bit pixel stream packs two pixels into three bytes.  When an odd    */
+/* number of pixels has been written the low nibble of the last pixel is    */
+/* held here until the next pixel, the end of the window or the next       */
+/* command completes the byte.                                              */
+static uint32 `$INSTANCE_NAME`_halfPixel = 0u;
+static uint32 `$INSTANCE_NAME`_halfNibble = 0u;
+
+/* Pixels still to be written before the open window is full. */
+static uint32 `$INSTANCE_NAME`_windowLeft = 0u;
+
+/* Bytes, commands and data, handed to the SPI master since Start. */
+static uint32 `$INSTANCE_NAME`_bytesSent = 0u;
+
+/* What the controller's address registers hold, so that SetWindow can skip */
+/* a PAGEADDR or COLADDR that would not change anything and Pixel can keep */
+/* streaming into a window whose write pointer is already where it needs   */
+/* to be.  An empty range (x0 > x1) means the register is unknown.          */
+typedef struct
+{
+    int32 x0;           /* page range, driver coordinates                  */
+    int32 x1;
+    int32 y0;           /* column range                                     */
+    int32 y1;
+    uint32 scan;        /* fill order, SCAN_ROWS or SCAN_COLUMNS             */
+    uint32 open;        /* RAMWR in progress and the stream is byte aligned */
+    uint32 hits;        /* address commands skipped                          */
+    uint32 misses;      /* address commands sent                             */
+} `$INSTANCE_NAME`_WINDOW_CACHE;
+
+static `$INSTANCE_NAME`_WINDOW_CACHE `$INSTANCE_NAME`_window = { 1, 0, 1, 0, `$INSTANCE_NAME`_SCAN_ROWS, 0u, 0u, 0u };
+
+#if (`$INSTANCE_NAME`_SHADOW != 0u)
+/* Shadow of the display memory, in pixel values as sent on the wire.  Each */
+/* 8x8 block has one ink value; a pixel's bit is set where it holds the ink */
+/* and clear where it is black (0).  A block that gets a second color is    */
+/* marked unknown until it is filled whole again.  The cursor follows the   */
+/* write pointer of the open window.                                         */
+#define `$INSTANCE_NAME`_SHADOW_BLOCKS   17u
+#define `$INSTANCE_NAME`_SHADOW_UNKNOWN  0x8000u
+
+static uint8 `$INSTANCE_NAME`_shadowBits[`$INSTANCE_NAME`_MAXX + 1u][`$INSTANCE_NAME`_SHADOW_BLOCKS];
+static uint16 `$INSTANCE_NAME`_shadowInk[`$INSTANCE_NAME`_SHADOW_BLOCKS][`$INSTANCE_NAME`_SHADOW_BLOCKS];
+static int32 `$INSTANCE_NAME`_shadowX = 0;
+static int32 `$INSTANCE_NAME`_shadowY = 0;
+static uint32 `$INSTANCE_NAME`_shadowLeft = 0u;
+static uint32 `$INSTANCE_NAME`_shadowSkipped = 0u;
+
+static void `$INSTANCE_NAME`_ShadowReset(void);
+static int32 `$INSTANCE_NAME`_ShadowGet(int32 x, int32 y);
+static void `$INSTANCE_NAME`_ShadowPut(int32 x, int32 y, uint32 value);
+static void `$INSTANCE_NAME`_ShadowNext(uint32 value);
+static void `$INSTANCE_NAME`_ShadowRect(int32 x0, int32 y0, int32 x1, int32 y1, uint32 value);
+static uint32 `$INSTANCE_NAME`_ShadowTrim(int32 *x0, int32 *y0, int32 *x1, int32 *y1, uint32 value);
+#endif
+
+/* Where the last pixel went, to guess which way a run of pixels is going. */
+static int32 `$INSTANCE_NAME`_lastX = -1;
+static int32 `$INSTANCE_NAME`_lastY = -1;
+
+/* Clip rectangle of the drawing functions, always on the screen, and the  */
+/* outcodes of a point against it for the line clipper.                     */
+#define `$INSTANCE_NAME`_CLIP_ABOVE   0x01u   /* x < clipX0 */
+#define `$INSTANCE_NAME`_CLIP_BELOW   0x02u   /* x > clipX1 */
+#define `$INSTANCE_NAME`_CLIP_LEFT    0x04u   /* y < clipY0 */
+#define `$INSTANCE_NAME`_CLIP_RIGHT   0x08u   /* y > clipY1 */
+
+#define `$INSTANCE_NAME`_CLIP_OUT     0u      /* ClipBox(): no part inside */
+#define `$INSTANCE_NAME`_CLIP_PART    1u      /*            cut by an edge */
+#define `$INSTANCE_NAME`_CLIP_IN      2u      /*            all of it      */
+
+static int32 `$INSTANCE_NAME`_clipX0 = (int32)`$INSTANCE_NAME`_MINX;
+static int32 `$INSTANCE_NAME`_clipY0 = (int32)`$INSTANCE_NAME`_MINY;
+static int32 `$INSTANCE_NAME`_clipX1 = (int32)`$INSTANCE_NAME`_MAXX;
+static int32 `$INSTANCE_NAME`_clipY1 = (int32)`$INSTANCE_NAME`_MAXY;
+
+static uint32 `$INSTANCE_NAME`_ClipCode(int32 x, int32 y);
+static uint32 `$INSTANCE_NAME`_ClipBox(int32 x0, int32 y0, int32 x1, int32 y1);
+static void `$INSTANCE_NAME`_StepRange(int32 from, int32 step, int32 lo, int32 hi, int32 *first, int32 *last);
+
+/* Pixel format on the wire, and the driver's copy of the controller LUT    */
+/* used in 8-bit mode: levels for red 0-7, green 0-7, then blue 0-3.        */
+static uint32 `$INSTANCE_NAME`_colorMode = `$INSTANCE_NAME`_COLOR_12BIT;
+static uint8 `$INSTANCE_NAME`_palette[`$INSTANCE_NAME`_PALETTE_SIZE];
+
+/* Linear ramps, so that a 12-bit color maps to the index made of the top   */
+/* bits of each channel.                                                     */
+const uint8 `$INSTANCE_NAME`_DEFAULT_PALETTE[`$INSTANCE_NAME`_PALETTE_SIZE] =
+{
+    0u, 2u, 4u, 6u, 8u, 10u, 12u, 15u,      /* red   */
+    0u, 2u, 4u, 6u, 8u, 10u, 12u, 15u,      /* green */
+    0u, 5u, 10u, 15u                        /* blue  */
+};
+
+/* The transmit path is interrupt driven when the SPIM has its TX interrupt */
+/* (UDB: "Enable TX Internal Interrupt", SCB: internal IRQ) and polled     */
+/* otherwise.                                                              */
+#if (`$INSTANCE_NAME`_SPIM_TYPE == `$INSTANCE_NAME`_SPIM_UDB_TYPE)
+#define `$INSTANCE_NAME`_TX_ISR_ENABLED  (0u != `$INSTANCE_NAME`_`$SPIM_Name`_INTERNAL_TX_INT_ENABLED)
+#else
+#define `$INSTANCE_NAME`_TX_ISR_ENABLED  (`$INSTANCE_NAME`_`$SPIM_Name`_SCB_IRQ_INTERNAL)
+#endif
+
+#if (`$INSTANCE_NAME`_TX_ISR_ENABLED)
+/* Ring of 9-bit SPI words waiting for the TX FIFO.  Head and tail run     */
+/* freely; the main loop only advances the head and the ISR the tail.      */
+#define `$INSTANCE_NAME`_TX_QUEUE_MASK   (`$INSTANCE_NAME`_TX_QUEUE_SIZE - 1u)
+
+/* A queue entry with this bit set is a run: the three words after it, a   */
+/* pixel pair, are sent the number of times in its low bits.                */
+#define `$INSTANCE_NAME`_TX_RUN          0x8000u
+#define `$INSTANCE_NAME`_TX_RUN_MAX      0x7FFFu
+
+static uint16 `$INSTANCE_NAME`_txQueue[`$INSTANCE_NAME`_TX_QUEUE_SIZE];
+static volatile uint32 `$INSTANCE_NAME`_txHead = 0u;
+static volatile uint32 `$INSTANCE_NAME`_txTail = 0u;
+static uint32 `$INSTANCE_NAME`_txHighWater = 0u;
+static uint32 `$INSTANCE_NAME`_txRunLeft = 0u;       /* ISR only: words left in the run */
+static uint32 `$INSTANCE_NAME`_txRunWord = 0u;       /*           and the next of the 3 */
+
+static CY_ISR_PROTO(`$INSTANCE_NAME`_TxIsr);
+static void `$INSTANCE_NAME`_TxKick(void);
+static uint32 `$INSTANCE_NAME`_TxNext(void);
+#endif
+
+/* Runs of at least this many pixels of one color in a pixel stream are   */
+/* sent as a solid run.                                                   */
+#define `$INSTANCE_NAME`_RUN_MIN         8u
+
+static void `$INSTANCE_NAME`_Send(uint32 word);
+static void `$INSTANCE_NAME`_SendRun(uint32 b0, uint32 b1, uint32 b2, uint32 count);
+static void `$INSTANCE_NAME`_StreamSolid(uint32 c, uint32 n);
+static void `$INSTANCE_NAME`_FlushHalfPixel(void);
+static void `$INSTANCE_NAME`_CountPixels(uint32 n);
+static void `$INSTANCE_NAME`_InvalidateWindow(void);
+static uint32 `$INSTANCE_NAME`_PixelValue(int32 color);
+static void `$INSTANCE_NAME`_UploadPalette(void);
+static void `$INSTANCE_NAME`_WritePair(uint32 c0, uint32 c1);
+static void `$INSTANCE_NAME`_SendAddressMode(void);
+static void `$INSTANCE_NAME`_FillArea(int32 x0, int32 y0, int32 x1, int32 y1, int32 color);
+static void `$INSTANCE_NAME`_FillSpan(int32 x, int32 y0, int32 y1, int32 color);
+
+/* Directions [a, a + 180 degrees) about a sector's apex, given by the unit */
+/* vector of a in Q1.15.  u runs along y (0 degrees), v along x (90).       */
+typedef struct
+{
+    int32 cs;
+    int32 sn;
+} `$INSTANCE_NAME`_HALFPLANE;
+
+/* A sector split into at most two convex pieces.  Piece i covers from[i],  */
+/* less to[i] when hasTo[i] is set.  Only rows vMin..vMax can be touched.   */
+typedef struct
+{
+    uint32 pieces;
+    `$INSTANCE_NAME`_HALFPLANE from[2];
+    `$INSTANCE_NAME`_HALFPLANE to[2];
+    uint32 hasTo[2];
+    int32 vMin;
+    int32 vMax;
+} `$INSTANCE_NAME`_SECTOR;
+
+static void `$INSTANCE_NAME`_SetHalfPlane(`$INSTANCE_NAME`_HALFPLANE *hp, int32 angle);
+static int32 `$INSTANCE_NAME`_FloorDiv(int32 n, int32 d);
+static void `$INSTANCE_NAME`_HalfPlaneRow(const `$INSTANCE_NAME`_HALFPLANE *hp, int32 v, uint32 inside, int32 *lo, int32 *hi);
+static void `$INSTANCE_NAME`_DiscRow(int32 x0, int32 y0, int32 v, int32 h, int32 color, const `$INSTANCE_NAME`_SECTOR *sector);
+static void `$INSTANCE_NAME`_FillDisc(int32 x0, int32 y0, int32 radius, int32 color, const `$INSTANCE_NAME`_SECTOR *sector);
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_FlushHalfPixel
+********************************************************************************
+*
+* Summary:
+*  Send the held low nibble of an odd trailing pixel, padded to a full byte.
+*  The padding leaves the controller part way into the next pixel, so the
+*  open window cannot be continued afterwards.
+*
+*******************************************************************************/
+static void `$INSTANCE_NAME`_FlushHalfPixel(void)
+{
+    if(`$INSTANCE_NAME`_halfPixel != 0u)
+    {
+        `$INSTANCE_NAME`_halfPixel = 0u;
+        `$INSTANCE_NAME`_window.open = 0u;
+        `$INSTANCE_NAME`_Data(`$INSTANCE_NAME`_halfNibble);
+    }
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_CountPixels
+********************************************************************************
+*
+* Summary:
+*  Account for n pixels written to the open window.  Once the window is full
+*  an odd trailing pixel is completed straight away rather than waiting for
+*  the next command, and the window is closed to further Pixel calls.
+*
+*******************************************************************************/
+static void `$INSTANCE_NAME`_CountPixels(uint32 n)
+{
+    if(n >= `$INSTANCE_NAME`_windowLeft)
+    {
+        `$INSTANCE_NAME`_windowLeft = 0u;
+        `$INSTANCE_NAME`_window.open = 0u;
+        `$INSTANCE_NAME`_FlushHalfPixel();
+    }
+    else
+    {
+        `$INSTANCE_NAME`_windowLeft -= n;
+    }
+}
+
 /*******************************************************************************
 * Function Name: `$INSTANCE_NAME`_Command
 ********************************************************************************
 *
 * Summary:
-*  This function sends a command to the LCD controller.  
+*  This function sends a command to the LCD controller.  Any half-written
+*  pixel left over from a pixel stream is completed first, since a command
+*  terminates the current memory write.  Address commands sent from outside
+*  `$INSTANCE_NAME`_SetWindow() make the window cache forget that register.
 *
-* Parameters:  
-*  cmdData:  This is the command to be sent to the LCD controller  
+* Parameters:
+*  cmdData:  This is the command to be sent to the LCD controller
+*
+* Return:
+*  None
 *
-* Return: 
-*  None 
-*  
 *******************************************************************************/
 void `$INSTANCE_NAME`_Command(uint32 cmdData)
 {
-#if (`$INSTANCE_NAME`_SPIM_TYPE == `$INSTANCE_NAME`_SPIM_UDB_TYPE)
-  while((`$INSTANCE_NAME`_`$SPIM_Name`_ReadTxStatus() & (`$INSTANCE_NAME`_`$SPIM_Name`_STS_SPI_DONE | `$INSTANCE_NAME`_`$SPIM_Name`_STS_SPI_IDLE) )== 0);
-  `$INSTANCE_NAME`_`$SPIM_Name`_WriteTxData((uint16)cmdData);
-#endif
+    `$INSTANCE_NAME`_FlushHalfPixel();
+    `$INSTANCE_NAME`_window.open = 0u;
 
-#if (`$INSTANCE_NAME`_SPIM_TYPE == `$INSTANCE_NAME`_SPIM_SCB_TYPE)
-    `$INSTANCE_NAME`_`$SPIM_Name`_SpiUartWriteTxData(cmdData);
-#endif
+    if(cmdData == `$INSTANCE_NAME`_PAGEADDR)
+    {
+        `$INSTANCE_NAME`_window.x0 = 1;
+        `$INSTANCE_NAME`_window.x1 = 0;
+    }
+    else if(cmdData == `$INSTANCE_NAME`_COLADDR)
+    {
+        `$INSTANCE_NAME`_window.y0 = 1;
+        `$INSTANCE_NAME`_window.y1 = 0;
+    }
+    else
+    {
+        /* Address registers unaffected */
+    }
+
+    `$INSTANCE_NAME`_Send(cmdData);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_InvalidateWindow
+********************************************************************************
+*
+* Summary:
+*  Forget the cached address window, e.g. after a controller reset.
+*
+*******************************************************************************/
+static void `$INSTANCE_NAME`_InvalidateWindow(void)
+{
+    `$INSTANCE_NAME`_window.x0 = 1;
+    `$INSTANCE_NAME`_window.x1 = 0;
+    `$INSTANCE_NAME`_window.y0 = 1;
+    `$INSTANCE_NAME`_window.y1 = 0;
+    `$INSTANCE_NAME`_window.open = 0u;
+    `$INSTANCE_NAME`_windowLeft = 0u;
 }
 
 /*******************************************************************************
@@ -84,20 +337,360 @@ void `$INSTANCE_NAME`_Command(uint32 cmdData)
 *******************************************************************************/
 void `$INSTANCE_NAME`_Data(uint32 rawData)
 {	
+    `$INSTANCE_NAME`_Send(rawData | 0x0100u);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_Send
+********************************************************************************
+*
+* Summary:
+*  Hand one 9-bit word to the SPI master.  With the TX interrupt available the
+*  word is queued and the function returns at once unless the queue is full;
+*  without it the word goes straight into the TX FIFO, waiting only for FIFO
+*  space rather than for the previous word to finish shifting out.
+*
+* Parameters:  
+*  word:  D/C bit and data byte. 
+*
+* Return: 
+*  None 
+*  
+*******************************************************************************/
+static void `$INSTANCE_NAME`_Send(uint32 word)
+{
+    `$INSTANCE_NAME`_bytesSent++;
+
+#if (`$INSTANCE_NAME`_TX_ISR_ENABLED)
+
+    while((`$INSTANCE_NAME`_txHead - `$INSTANCE_NAME`_txTail) >= `$INSTANCE_NAME`_TX_QUEUE_SIZE)
+    {
+        /* Queue full: wait for the ISR to make room */
+    }
+
+    `$INSTANCE_NAME`_txQueue[`$INSTANCE_NAME`_txHead & `$INSTANCE_NAME`_TX_QUEUE_MASK] = (uint16)word;
+    `$INSTANCE_NAME`_txHead++;
+    `$INSTANCE_NAME`_TxKick();
+
+#else
+
 #if (`$INSTANCE_NAME`_SPIM_TYPE == `$INSTANCE_NAME`_SPIM_UDB_TYPE)
-    uint16 data16;
-    data16 = (uint16)rawData | 0x0100;
-	
-    while((`$INSTANCE_NAME`_`$SPIM_Name`_ReadTxStatus() & (`$INSTANCE_NAME`_`$SPIM_Name`_STS_SPI_DONE | `$INSTANCE_NAME`_`$SPIM_Name`_STS_SPI_IDLE) )== 0);
-    `$INSTANCE_NAME`_`$SPIM_Name`_WriteTxData(data16);
+    `$INSTANCE_NAME`_`$SPIM_Name`_WriteTxData((uint16)word);
+#else
+    `$INSTANCE_NAME`_`$SPIM_Name`_SpiUartWriteTxData(word);
 #endif
 
-#if (`$INSTANCE_NAME`_SPIM_TYPE == `$INSTANCE_NAME`_SPIM_SCB_TYPE)
+#endif /* (`$INSTANCE_NAME`_TX_ISR_ENABLED) */
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_SendRun
+********************************************************************************
+*
+* Summary:
+*  Send three data bytes, a 12-bit pixel pair or three 8-bit pixels, count
+*  times over.  With the TX interrupt the run takes four queue entries
+*  however long it is, and the ISR expands it straight into the FIFO;
+*  without it the bytes go into the FIFO from one loop, with no per-byte
+*  call through `$INSTANCE_NAME`_Send().
+*
+* Parameters:
+*  b0, b1, b2:  The bytes, as sent
+*  count:       Number of times
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void `$INSTANCE_NAME`_SendRun(uint32 b0, uint32 b1, uint32 b2, uint32 count)
+{
+#if (`$INSTANCE_NAME`_TX_ISR_ENABLED)
+    uint32 n;
+#endif
+
+    b0 |= 0x0100u;
+    b1 |= 0x0100u;
+    b2 |= 0x0100u;
+    `$INSTANCE_NAME`_bytesSent += 3u * count;
+
+#if (`$INSTANCE_NAME`_TX_ISR_ENABLED)
+
+    while(count != 0u)
+    {
+        n = (count > `$INSTANCE_NAME`_TX_RUN_MAX) ? `$INSTANCE_NAME`_TX_RUN_MAX : count;
+        count -= n;
+        while((`$INSTANCE_NAME`_txHead - `$INSTANCE_NAME`_txTail) > (`$INSTANCE_NAME`_TX_QUEUE_SIZE - 4u))
+        {
+            /* Wait for the ISR to make room */
+        }
+
+        /* The pattern first: the ISR may start on the run once the head moves */
+        `$INSTANCE_NAME`_txQueue[(`$INSTANCE_NAME`_txHead + 1u) & `$INSTANCE_NAME`_TX_QUEUE_MASK] = (uint16)b0;
+        `$INSTANCE_NAME`_txQueue[(`$INSTANCE_NAME`_txHead + 2u) & `$INSTANCE_NAME`_TX_QUEUE_MASK] = (uint16)b1;
+        `$INSTANCE_NAME`_txQueue[(`$INSTANCE_NAME`_txHead + 3u) & `$INSTANCE_NAME`_TX_QUEUE_MASK] = (uint16)b2;
+        `$INSTANCE_NAME`_txQueue[`$INSTANCE_NAME`_txHead & `$INSTANCE_NAME`_TX_QUEUE_MASK] = (uint16)(`$INSTANCE_NAME`_TX_RUN | n);
+        `$INSTANCE_NAME`_txHead += 4u;
+        `$INSTANCE_NAME`_TxKick();
+    }
+
+#else
+
+    for( ; count != 0u; count--)
+    {
+#if (`$INSTANCE_NAME`_SPIM_TYPE == `$INSTANCE_NAME`_SPIM_UDB_TYPE)
+        `$INSTANCE_NAME`_`$SPIM_Name`_WriteTxData((uint16)b0);
+        `$INSTANCE_NAME`_`$SPIM_Name`_WriteTxData((uint16)b1);
+        `$INSTANCE_NAME`_`$SPIM_Name`_WriteTxData((uint16)b2);
+#else
+        `$INSTANCE_NAME`_`$SPIM_Name`_SpiUartWriteTxData(b0);
+        `$INSTANCE_NAME`_`$SPIM_Name`_SpiUartWriteTxData(b1);
+        `$INSTANCE_NAME`_`$SPIM_Name`_SpiUartWriteTxData(b2);
+#endif
+    }
+
+#endif /* (`$INSTANCE_NAME`_TX_ISR_ENABLED) */
+}
+
+#if (`$INSTANCE_NAME`_TX_ISR_ENABLED)
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_TxKick
+********************************************************************************
+*
+* Summary:
+*  Note the queue depth and (re)arm the FIFO-not-full interrupt after words
+*  were queued; the ISR disarms it when drained.
+*
+*******************************************************************************/
+static void `$INSTANCE_NAME`_TxKick(void)
+{
+    uint32 depth = `$INSTANCE_NAME`_txHead - `$INSTANCE_NAME`_txTail;
+
+    if(depth > `$INSTANCE_NAME`_txHighWater)
+    {
+        `$INSTANCE_NAME`_txHighWater = depth;
+    }
+
+#if (`$INSTANCE_NAME`_SPIM_TYPE == `$INSTANCE_NAME`_SPIM_UDB_TYPE)
+    `$INSTANCE_NAME`_`$SPIM_Name`_SetTxInterruptMode(`$INSTANCE_NAME`_`$SPIM_Name`_STS_TX_FIFO_NOT_FULL);
+#else
+    `$INSTANCE_NAME`_`$SPIM_Name`_SetTxInterruptMode(`$INSTANCE_NAME`_`$SPIM_Name`_INTR_TX_NOT_FULL);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_TxNext
+********************************************************************************
+*
+* Summary:
+*  Take the next word for the FIFO off the queue, which must not be empty.
+*  A run stays at the tail until its last word has been taken.
+*
+*******************************************************************************/
+static uint32 `$INSTANCE_NAME`_TxNext(void)
+{
+    uint32 word = `$INSTANCE_NAME`_txQueue[`$INSTANCE_NAME`_txTail & `$INSTANCE_NAME`_TX_QUEUE_MASK];
+
+    if((word & `$INSTANCE_NAME`_TX_RUN) == 0u)
+    {
+        `$INSTANCE_NAME`_txTail++;
+        return (word);
+    }
+
+    if(`$INSTANCE_NAME`_txRunLeft == 0u)
+    {
+        `$INSTANCE_NAME`_txRunLeft = (word & `$INSTANCE_NAME`_TX_RUN_MAX) * 3u;
+        `$INSTANCE_NAME`_txRunWord = 0u;
+    }
+    word = `$INSTANCE_NAME`_txQueue[(`$INSTANCE_NAME`_txTail + 1u + `$INSTANCE_NAME`_txRunWord) & `$INSTANCE_NAME`_TX_QUEUE_MASK];
+    `$INSTANCE_NAME`_txRunWord = (`$INSTANCE_NAME`_txRunWord == 2u) ? 0u : (`$INSTANCE_NAME`_txRunWord + 1u);
+    `$INSTANCE_NAME`_txRunLeft--;
+    if(`$INSTANCE_NAME`_txRunLeft == 0u)
+    {
+        `$INSTANCE_NAME`_txTail += 4u;
+    }
+    return (word);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_TxIsr
+********************************************************************************
+*
+* Summary:
+*  TX FIFO not full interrupt.  Moves queued words into the FIFO until it is
+*  full or the queue is empty, and disarms itself once the queue is drained.
+*
+*******************************************************************************/
+static CY_ISR(`$INSTANCE_NAME`_TxIsr)
+{
+#if (`$INSTANCE_NAME`_SPIM_TYPE == `$INSTANCE_NAME`_SPIM_UDB_TYPE)
+    while(`$INSTANCE_NAME`_txTail != `$INSTANCE_NAME`_txHead)
+    {
+        if(0u == (`$INSTANCE_NAME`_`$SPIM_Name`_ReadTxStatus() & `$INSTANCE_NAME`_`$SPIM_Name`_STS_TX_FIFO_NOT_FULL))
+        {
+            break;
+        }
+        CY_SET_REG16(`$INSTANCE_NAME`_`$SPIM_Name`_TXDATA_PTR, (uint16)`$INSTANCE_NAME`_TxNext());
+    }
+#else
+    while((`$INSTANCE_NAME`_txTail != `$INSTANCE_NAME`_txHead) && (`$INSTANCE_NAME`_`$SPIM_Name`_GET_TX_FIFO_ENTRIES < `$INSTANCE_NAME`_`$SPIM_Name`_FIFO_SIZE))
+    {
+        `$INSTANCE_NAME`_`$SPIM_Name`_TX_FIFO_WR_REG = `$INSTANCE_NAME`_TxNext();
+    }
+    `$INSTANCE_NAME`_`$SPIM_Name`_ClearTxInterruptSource(`$INSTANCE_NAME`_`$SPIM_Name`_INTR_TX_NOT_FULL);
+#endif
+
+    if(`$INSTANCE_NAME`_txTail == `$INSTANCE_NAME`_txHead)
+    {
+        `$INSTANCE_NAME`_`$SPIM_Name`_SetTxInterruptMode(0u);
+    }
+}
+#endif /* (`$INSTANCE_NAME`_TX_ISR_ENABLED) */
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_Flush
+********************************************************************************
+*
+* Summary:
+*  Complete any half-written pixel and wait until every queued word has been
+*  shifted out to the LCD.  Call this before a delay that must follow a
+*  command or a pixel, or before stopping the SPIM.
+*
+* Parameters:  
+*  None
+*
+* Return: 
+*  None 
+*  
+*******************************************************************************/
+void `$INSTANCE_NAME`_Flush(void)
+{
+    `$INSTANCE_NAME`_FlushHalfPixel();
+
+#if (`$INSTANCE_NAME`_TX_ISR_ENABLED)
+    while(`$INSTANCE_NAME`_txTail != `$INSTANCE_NAME`_txHead)
+    {
+        /* Wait for the ISR to empty the queue */
+    }
+#endif
+
+#if (`$INSTANCE_NAME`_SPIM_TYPE == `$INSTANCE_NAME`_SPIM_UDB_TYPE)
+    while((`$INSTANCE_NAME`_`$SPIM_Name`_ReadTxStatus() & `$INSTANCE_NAME`_`$SPIM_Name`_STS_TX_FIFO_EMPTY) == 0u);
+    while((`$INSTANCE_NAME`_`$SPIM_Name`_ReadTxStatus() & (`$INSTANCE_NAME`_`$SPIM_Name`_STS_SPI_DONE | `$INSTANCE_NAME`_`$SPIM_Name`_STS_SPI_IDLE)) == 0u);
+#else
+    while(`$INSTANCE_NAME`_`$SPIM_Name`_SpiUartGetTxBufferSize() != 0u);
+    while(`$INSTANCE_NAME`_`$SPIM_Name`_SpiIsBusBusy() != 0u);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_TxQueueDepth
+********************************************************************************
+*
+* Summary:
+*  Number of words currently waiting in the transmit queue.  Always zero
+*  when the SPIM has no TX interrupt and words are written directly.
+*
+*******************************************************************************/
+uint32 `$INSTANCE_NAME`_TxQueueDepth(void)
+{
+#if (`$INSTANCE_NAME`_TX_ISR_ENABLED)
+    return (`$INSTANCE_NAME`_txHead - `$INSTANCE_NAME`_txTail);
+#else
+    return (0u);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_TxQueueHighWater
+********************************************************************************
+*
+* Summary:
+*  Deepest the transmit queue has been since Start or the last reset.  A
+*  value equal to `$INSTANCE_NAME`_TX_QUEUE_SIZE means the main loop had to wait.
+*
+*******************************************************************************/
+uint32 `$INSTANCE_NAME`_TxQueueHighWater(void)
+{
+#if (`$INSTANCE_NAME`_TX_ISR_ENABLED)
+    return (`$INSTANCE_NAME`_txHighWater);
+#else
+    return (0u);
+#endif
+}
 
-    rawData = rawData | 0x00000100;
-    `$INSTANCE_NAME`_`$SPIM_Name`_SpiUartWriteTxData(rawData);
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_TxQueueResetHighWater
+********************************************************************************
+*
+* Summary:
+*  Restart high-water measurement, e.g. at the start of a frame.
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_TxQueueResetHighWater(void)
+{
+#if (`$INSTANCE_NAME`_TX_ISR_ENABLED)
+    `$INSTANCE_NAME`_txHighWater = `$INSTANCE_NAME`_txHead - `$INSTANCE_NAME`_txTail;
 #endif
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_WindowCacheHits
+********************************************************************************
+*
+* Summary:
+*  Number of PAGEADDR/COLADDR commands the window cache has saved since
+*  Start or the last reset.  A pixel streamed into an already open window
+*  counts as two.
+*
+*******************************************************************************/
+uint32 `$INSTANCE_NAME`_WindowCacheHits(void)
+{
+    return (`$INSTANCE_NAME`_window.hits);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_WindowCacheMisses
+********************************************************************************
+*
+* Summary:
+*  Number of PAGEADDR/COLADDR commands actually sent since Start or the last
+*  reset.
+*
+*******************************************************************************/
+uint32 `$INSTANCE_NAME`_WindowCacheMisses(void)
+{
+    return (`$INSTANCE_NAME`_window.misses);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_WindowCacheResetStats
+********************************************************************************
+*
+* Summary:
+*  Zero the window cache counters, e.g. at the start of a frame.
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_WindowCacheResetStats(void)
+{
+    `$INSTANCE_NAME`_window.hits = 0u;
+    `$INSTANCE_NAME`_window.misses = 0u;
+}
 
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_BytesSent
+********************************************************************************
+*
+* Summary:
+*  Bytes handed to the SPI master since `$INSTANCE_NAME`_Start(), commands
+*  and data together.
+*
+* Return:
+*  Byte count
+*
+*******************************************************************************/
+uint32 `$INSTANCE_NAME`_BytesSent(void)
+{
+    return (`$INSTANCE_NAME`_bytesSent);
 }
 
 /*******************************************************************************
@@ -122,6 +715,34 @@ void `$INSTANCE_NAME`_Start(void)
     `$INSTANCE_NAME`_`$SPIM_Name`_SpiSetActiveSlaveSelect(3u);
 #endif
 
+#if (`$INSTANCE_NAME`_TX_ISR_ENABLED)
+    /* Take over the TX interrupt to feed the FIFO from the driver queue */
+    `$INSTANCE_NAME`_txHead = 0u;
+    `$INSTANCE_NAME`_txTail = 0u;
+    `$INSTANCE_NAME`_txHighWater = 0u;
+    `$INSTANCE_NAME`_txRunLeft = 0u;
+    `$INSTANCE_NAME`_`$SPIM_Name`_SetTxInterruptMode(0u);
+#if (`$INSTANCE_NAME`_SPIM_TYPE == `$INSTANCE_NAME`_SPIM_UDB_TYPE)
+    (void) CyIntSetVector(`$INSTANCE_NAME`_`$SPIM_Name`_TX_ISR_NUMBER, &`$INSTANCE_NAME`_TxIsr);
+    CyIntEnable(`$INSTANCE_NAME`_`$SPIM_Name`_TX_ISR_NUMBER);
+#else
+    `$INSTANCE_NAME`_`$SPIM_Name`_SetCustomInterruptHandler(&`$INSTANCE_NAME`_TxIsr);
+#endif
+#endif
+
+	`$INSTANCE_NAME`_InvalidateWindow();
+	`$INSTANCE_NAME`_WindowCacheResetStats();
+	`$INSTANCE_NAME`_bytesSent = 0u;
+	`$INSTANCE_NAME`_ClearClip();
+#if (`$INSTANCE_NAME`_SHADOW != 0u)
+	`$INSTANCE_NAME`_ShadowReset();
+#endif
+	`$INSTANCE_NAME`_colorMode = `$INSTANCE_NAME`_COLOR_12BIT;
+	`$INSTANCE_NAME`_window.scan = `$INSTANCE_NAME`_SCAN_ROWS;
+	`$INSTANCE_NAME`_SetPalette(`$INSTANCE_NAME`_DEFAULT_PALETTE);
+	`$INSTANCE_NAME`_scrollRows = 0;
+	`$INSTANCE_NAME`_scrollOffset = 0;
+
 	CyDelayUs(20);			            /* 20us delay    */
 	`$INSTANCE_NAME`_Reset_Write(0x00);	/* Display Reset */
 	CyDelay(200);			            /* 200ms delay   */
@@ -145,10 +766,7 @@ void `$INSTANCE_NAME`_Start(void)
 	
 	`$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_DINVON);	  /* invert display mode           */
 	
-	`$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_DATCTL);	  /* data control                  */
-	`$INSTANCE_NAME`_Data(0x03);		/* Inverse page address, reverse rotation column address, column scan-direction	*/
-	`$INSTANCE_NAME`_Data(0x00);		                  /* normal RGB arrangement                 */
-	`$INSTANCE_NAME`_Data(0x02);		                  /* 16-bit Grayscale Type A (12-bit color) */
+	`$INSTANCE_NAME`_SendAddressMode();	                  /* orientation, scan, 12-bit color */
 	
 	`$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_SETCONST);	/* Electronic volume, this is the contrast/brightness        */
 	`$INSTANCE_NAME`_Data(`$INSTANCE_NAME`_CONST_DEFAULT);  /* Volume (contrast) setting - fine tuning, original (0-63)  */
@@ -156,6 +774,7 @@ void `$INSTANCE_NAME`_Start(void)
 	
 	`$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_NOP);	        /* nop */
 
+	`$INSTANCE_NAME`_Flush();
 	CyDelay(100);
 
 	`$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_DISPON);	     /*  Display on */
@@ -171,224 +790,2125 @@ void `$INSTANCE_NAME`_Start(void)
 	`$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_COLMOD);		 /* Color interface format     */
 	`$INSTANCE_NAME`_Data(0x03);			                 /* 0b011 is 12-bit/pixel mode */
 	
-	`$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_MADCTL);		 /* Memory Access Control      */
+	`$INSTANCE_NAME`_SendAddressMode();	                 /* Memory Access Control      */
 	`$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_SETCONST);     /* Set Contrast               */          
 	`$INSTANCE_NAME`_Data(`$INSTANCE_NAME`_CONST_DEFAULT);
 	
 	`$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_NOP);	
 #endif
 
-  	`$INSTANCE_NAME`_Contrast(60);                           /* Set default contrast  */
-  	`$INSTANCE_NAME`_Clear(`$INSTANCE_NAME`_BLACK);          /* Clear screen to black */
+  	`$INSTANCE_NAME`_Contrast(60);                           /* Set default contrast  */
+  	`$INSTANCE_NAME`_Clear(`$INSTANCE_NAME`_BLACK);          /* Clear screen to black */
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_Stop
+********************************************************************************
+*
+* Summary:
+*  This function clears the LCD to black and turns off the display.  
+*
+* Parameters:  
+*   None:   
+*
+* Return: 
+*  None 
+*  
+*******************************************************************************/
+void `$INSTANCE_NAME`_Stop(void)
+{
+   `$INSTANCE_NAME`_Clear(`$INSTANCE_NAME`_BLACK);
+   `$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_DISPOFF);
+   `$INSTANCE_NAME`_Flush();
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_Clear
+********************************************************************************
+*
+* Summary:
+*  Clear the display, all of it whatever the clip rectangle.  
+*
+* Parameters:  
+*  color: Color to clear display with. 
+*
+* Return: 
+*  None 
+*  
+*******************************************************************************/
+void `$INSTANCE_NAME`_Clear(int32 color)
+{
+	`$INSTANCE_NAME`_SetWindow(`$INSTANCE_NAME`_MINX, `$INSTANCE_NAME`_MINY, `$INSTANCE_NAME`_MAXX, `$INSTANCE_NAME`_MAXY);
+	`$INSTANCE_NAME`_FillWindow(color, (uint32)`$INSTANCE_NAME`_ROW_LENGTH * `$INSTANCE_NAME`_COL_HEIGHT);
+
+	`$INSTANCE_NAME`_x_offset = 0;
+	`$INSTANCE_NAME`_y_offset = 0;
+}
+
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_Contrast
+********************************************************************************
+*
+* Summary:
+*  Set color contrast  
+*
+* Parameters:  
+*  setting: Contrast value.  
+*
+* Return: 
+*  None 
+*  
+*******************************************************************************/
+void `$INSTANCE_NAME`_Contrast(int32 setting)
+{
+    `$INSTANCE_NAME`_contrast = setting;
+    setting &= `$INSTANCE_NAME`_CONST_MASK;	                /* Mask off contrast value */
+    `$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_SETCONST);	/* Set Contrast            */
+    `$INSTANCE_NAME`_Data(setting);	                    
+
+#if(`$INSTANCE_NAME`_Controller == `$INSTANCE_NAME`_EPSON)  /* Only required for Epson */
+    `$INSTANCE_NAME`_Data(3);			
+#endif
+
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_GetContrast
+********************************************************************************
+*
+* Summary:
+*  Contrast setting last passed to `$INSTANCE_NAME`_Contrast().
+*
+*******************************************************************************/
+int32 `$INSTANCE_NAME`_GetContrast(void)
+{
+    return (`$INSTANCE_NAME`_contrast);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_Invert
+********************************************************************************
+*
+* Summary:
+*  Show the display inverted, or normally again.  Only a command is sent;
+*  display memory is not touched.
+*
+* Parameters:
+*  on:  Non-zero to invert
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_Invert(uint32 on)
+{
+#if(`$INSTANCE_NAME`_Controller == `$INSTANCE_NAME`_EPSON)
+    on = (on == 0u) ? 1u : 0u;      /* Start runs the Epson panel inverted */
+#endif
+    `$INSTANCE_NAME`_Command((on != 0u) ? `$INSTANCE_NAME`_DINVON : `$INSTANCE_NAME`_DINVOFF);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_ScrollSetArea
+********************************************************************************
+*
+* Summary:
+*  Choose the rows that hardware scrolling moves; the rows above and below
+*  stay put.  The scroll position is reset to 0.  Use rows
+*  `$INSTANCE_NAME`_MINX .. `$INSTANCE_NAME`_MAXX to scroll the whole screen.
+*
+*  The Epson controller scrolls in blocks of four rows, so there the area
+*  is widened to whole blocks.
+*
+* Parameters:
+*  x0, x1:  First and last row of the scrolling area, either order
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_ScrollSetArea(int32 x0, int32 x1)
+{
+    int32 tmp;
+    int32 p0;
+    int32 p1;
+
+    if(x0 > x1)
+    {
+        tmp = x0; x0 = x1; x1 = tmp;
+    }
+    if(x0 < (int32)`$INSTANCE_NAME`_MINX)
+    {
+        x0 = (int32)`$INSTANCE_NAME`_MINX;
+    }
+    if(x1 > (int32)`$INSTANCE_NAME`_MAXX)
+    {
+        x1 = (int32)`$INSTANCE_NAME`_MAXX;
+    }
+
+    /* Controller lines run the other way up */
+    p0 = (`$INSTANCE_NAME`_ROW_LENGTH - 1) - x1;
+    p1 = (`$INSTANCE_NAME`_ROW_LENGTH - 1) - x0;
+
+#if(`$INSTANCE_NAME`_Controller == `$INSTANCE_NAME`_EPSON)
+    p0 &= ~3;
+    p1 |= 3;
+    if(p1 > (`$INSTANCE_NAME`_ROW_LENGTH - 1))
+    {
+        p1 = `$INSTANCE_NAME`_ROW_LENGTH - 1;
+    }
+    `$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_ASCSET);
+    `$INSTANCE_NAME`_Data((uint32)p0 >> 2);                     /* top block            */
+    `$INSTANCE_NAME`_Data((uint32)p1 >> 2);                     /* bottom block         */
+    `$INSTANCE_NAME`_Data((uint32)(`$INSTANCE_NAME`_ROW_LENGTH - 1) >> 2); /* last block */
+    `$INSTANCE_NAME`_Data(((p0 == 0) && (p1 == (`$INSTANCE_NAME`_ROW_LENGTH - 1))) ? 3u : 0u); /* whole screen or centre */
+#else
+    `$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_VSCRDEF);
+    `$INSTANCE_NAME`_Data((uint32)p0);                          /* top fixed area       */
+    `$INSTANCE_NAME`_Data((uint32)((p1 - p0) + 1));             /* scroll area          */
+    `$INSTANCE_NAME`_Data((uint32)((`$INSTANCE_NAME`_ROW_LENGTH - 1) - p1)); /* bottom fixed area */
+#endif
+
+    `$INSTANCE_NAME`_scrollTop = (`$INSTANCE_NAME`_ROW_LENGTH - 1) - p1;
+    `$INSTANCE_NAME`_scrollRows = (p1 - p0) + 1;
+    `$INSTANCE_NAME`_ScrollTo(0);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_ScrollTo
+********************************************************************************
+*
+* Summary:
+*  Scroll the area set with `$INSTANCE_NAME`_ScrollSetArea() so that what
+*  was drawn at row x shows at row x + offset, wrapping round within the
+*  area.  Only a scroll address is sent, display memory is not rewritten;
+*  drawing goes on in memory rows, see `$INSTANCE_NAME`_ScrollRamRow().
+*
+*  The Epson controller scrolls in blocks of four rows, so there the offset
+*  is rounded down to a multiple of four.  Rows that come into view at the
+*  top of the area are the ones between the old and new offsets returned.
+*
+* Parameters:
+*  offset:  Rows to scroll by, any value
+*
+* Return:
+*  The offset now in effect, 0 to the area height - 1
+*
+*******************************************************************************/
+int32 `$INSTANCE_NAME`_ScrollTo(int32 offset)
+{
+    int32 start;
+
+    if(`$INSTANCE_NAME`_scrollRows == 0)
+    {
+        return 0;
+    }
+
+    offset %= `$INSTANCE_NAME`_scrollRows;
+    if(offset < 0)
+    {
+        offset += `$INSTANCE_NAME`_scrollRows;
+    }
+
+#if(`$INSTANCE_NAME`_Controller == `$INSTANCE_NAME`_EPSON)
+    offset &= ~3;
+#endif
+
+    /* Controller line shown at the top of the area */
+    start = ((`$INSTANCE_NAME`_ROW_LENGTH - 1) - ((`$INSTANCE_NAME`_scrollTop + `$INSTANCE_NAME`_scrollRows) - 1)) + offset;
+
+#if(`$INSTANCE_NAME`_Controller == `$INSTANCE_NAME`_EPSON)
+    `$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_SCSTART);
+    `$INSTANCE_NAME`_Data((uint32)start >> 2);
+#else
+    `$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_VSCRSADD);
+    `$INSTANCE_NAME`_Data((uint32)start);
+#endif
+
+    `$INSTANCE_NAME`_scrollOffset = offset;
+
+    return offset;
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_ScrollRamRow
+********************************************************************************
+*
+* Summary:
+*  The memory row that currently shows at screen row x.  Drawing at that row
+*  puts pixels at row x on the screen; rows outside the scrolling area map
+*  to themselves.
+*
+* Parameters:
+*  x:  Screen row
+*
+* Return:
+*  Row to draw at
+*
+*******************************************************************************/
+int32 `$INSTANCE_NAME`_ScrollRamRow(int32 x)
+{
+    int32 row = x;
+
+    if((`$INSTANCE_NAME`_scrollRows != 0) && (x >= `$INSTANCE_NAME`_scrollTop) &&
+       (x < (`$INSTANCE_NAME`_scrollTop + `$INSTANCE_NAME`_scrollRows)))
+    {
+        row = (x - `$INSTANCE_NAME`_scrollTop) - `$INSTANCE_NAME`_scrollOffset;
+        if(row < 0)
+        {
+            row += `$INSTANCE_NAME`_scrollRows;
+        }
+        row += `$INSTANCE_NAME`_scrollTop;
+    }
+    return (row);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_SwapColors
+********************************************************************************
+*
+* Summary:
+*   Swaps colors between Epson and Philips mode.  
+*
+* Parameters:  
+*  prtValue:  The value  
+*
+* Return: 
+*  None 
+*  Added by Steve Sparks @ Big Nerd Ranch.
+*  This swaps the Epson RGB order into the Philips RGB order. (Or, vice versa, I suppose.)
+*******************************************************************************/
+int32 `$INSTANCE_NAME`_SwapColors(int32 in)
+{
+    return ((in & 0x000F)<<8)|(in & 0x00F0)|((in & 0x0F00)>>8);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_SendAddressMode
+********************************************************************************
+*
+* Summary:
+*  Tell the controller how driver coordinates map onto its memory.  The
+*  panel is mounted upside down, so both page and column addresses are
+*  mirrored here once instead of in every drawing call; the scan order
+*  picks which address steps first while a window fills.  On the Epson
+*  controller the same command also holds the pixel format.
+*
+*******************************************************************************/
+static void `$INSTANCE_NAME`_SendAddressMode(void)
+{
+#if (`$INSTANCE_NAME`_Controller == `$INSTANCE_NAME`_EPSON)
+    `$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_DATCTL);
+    `$INSTANCE_NAME`_Data(`$INSTANCE_NAME`_DATCTL_PINV | `$INSTANCE_NAME`_DATCTL_CINV |
+        ((`$INSTANCE_NAME`_window.scan == `$INSTANCE_NAME`_SCAN_COLUMNS) ? `$INSTANCE_NAME`_DATCTL_PSCAN : 0u));
+    `$INSTANCE_NAME`_Data(0x00);                        /* normal RGB arrangement */
+    `$INSTANCE_NAME`_Data((`$INSTANCE_NAME`_colorMode == `$INSTANCE_NAME`_COLOR_8BIT) ? 0x01u : 0x02u); /* 8-bit or 12-bit type A */
+#else
+    `$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_MADCTL);
+    `$INSTANCE_NAME`_Data(`$INSTANCE_NAME`_MADCTL_MY | `$INSTANCE_NAME`_MADCTL_MX |
+        ((`$INSTANCE_NAME`_window.scan == `$INSTANCE_NAME`_SCAN_COLUMNS) ? `$INSTANCE_NAME`_MADCTL_V : 0u));
+#endif
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_SetScan
+********************************************************************************
+*
+* Summary:
+*  Choose the order in which the next windows fill: along each row, y
+*  first, or down each column, x first.  Data laid out column by column,
+*  such as a bitmap stored in columns, can then be streamed into one window
+*  instead of being addressed a column at a time.  The setting stays until
+*  changed; a few bytes are sent only when it does change.
+*
+*  Windows one row or one column wide fill the same way in either order.
+*
+* Parameters:
+*  order:  `$INSTANCE_NAME`_SCAN_ROWS (the default) or
+*          `$INSTANCE_NAME`_SCAN_COLUMNS
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_SetScan(uint32 order)
+{
+    order = (order == `$INSTANCE_NAME`_SCAN_COLUMNS) ? `$INSTANCE_NAME`_SCAN_COLUMNS : `$INSTANCE_NAME`_SCAN_ROWS;
+    if(order != `$INSTANCE_NAME`_window.scan)
+    {
+        `$INSTANCE_NAME`_window.scan = order;
+        `$INSTANCE_NAME`_SendAddressMode();
+    }
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_GetScan
+********************************************************************************
+*
+* Summary:
+*  Window fill order currently in use.
+*
+* Return:
+*  `$INSTANCE_NAME`_SCAN_ROWS or `$INSTANCE_NAME`_SCAN_COLUMNS
+*
+*******************************************************************************/
+uint32 `$INSTANCE_NAME`_GetScan(void)
+{
+    return (`$INSTANCE_NAME`_window.scan);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_SetColorMode
+********************************************************************************
+*
+* Summary:
+*  Select the pixel format used on the SPI bus.  In 8-bit mode every pixel
+*  is one byte, RRRGGGBB, shown through the palette set with
+*  `$INSTANCE_NAME`_SetPalette(); 12-bit colors passed to the drawing
+*  functions are reduced to the top bits of each channel.  12-bit mode, the
+*  default after Start, sends two pixels in three bytes.
+*
+*  What is already on the display is not affected.
+*
+* Parameters:
+*  mode:  `$INSTANCE_NAME`_COLOR_12BIT or `$INSTANCE_NAME`_COLOR_8BIT
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_SetColorMode(uint32 mode)
+{
+    `$INSTANCE_NAME`_colorMode = (mode == `$INSTANCE_NAME`_COLOR_8BIT) ? `$INSTANCE_NAME`_COLOR_8BIT : `$INSTANCE_NAME`_COLOR_12BIT;
+
+#if (`$INSTANCE_NAME`_Controller == `$INSTANCE_NAME`_EPSON)
+    `$INSTANCE_NAME`_SendAddressMode();                 /* DATCTL holds the pixel format */
+#endif
+
+#if (`$INSTANCE_NAME`_Controller == `$INSTANCE_NAME`_PHILIPS)
+    `$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_COLMOD);
+    `$INSTANCE_NAME`_Data((`$INSTANCE_NAME`_colorMode == `$INSTANCE_NAME`_COLOR_8BIT) ? 0x02u : 0x03u); /* 8 or 12 bits/pixel */
+#endif
+
+    if(`$INSTANCE_NAME`_colorMode == `$INSTANCE_NAME`_COLOR_8BIT)
+    {
+        `$INSTANCE_NAME`_UploadPalette();
+    }
+
+#if (`$INSTANCE_NAME`_SHADOW != 0u)
+    /* The values in the shadow no longer mean the same colors */
+    `$INSTANCE_NAME`_ShadowReset();
+#endif
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_GetColorMode
+********************************************************************************
+*
+* Summary:
+*  Pixel format currently in use.
+*
+* Return:
+*  `$INSTANCE_NAME`_COLOR_12BIT or `$INSTANCE_NAME`_COLOR_8BIT
+*
+*******************************************************************************/
+uint32 `$INSTANCE_NAME`_GetColorMode(void)
+{
+    return (`$INSTANCE_NAME`_colorMode);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_SetPalette
+********************************************************************************
+*
+* Summary:
+*  Set the levels the controller uses for 8-bit pixels: eight 4-bit red
+*  levels, eight green and four blue, in that order.  The table is sent to
+*  the controller straight away in 8-bit mode and on the next switch to it
+*  otherwise.  Indexed colors drawn in 12-bit mode are looked up in it too.
+*
+* Parameters:
+*  palette:  `$INSTANCE_NAME`_PALETTE_SIZE levels, 0-15
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_SetPalette(const uint8 *palette)
+{
+    uint32 i;
+
+    for(i = 0u; i < `$INSTANCE_NAME`_PALETTE_SIZE; i++)
+    {
+        `$INSTANCE_NAME`_palette[i] = palette[i] & 0x0Fu;
+    }
+
+    if(`$INSTANCE_NAME`_colorMode == `$INSTANCE_NAME`_COLOR_8BIT)
+    {
+        `$INSTANCE_NAME`_UploadPalette();
+    }
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_PaletteColor
+********************************************************************************
+*
+* Summary:
+*  The 12-bit color an 8-bit index is shown as with the current palette.
+*
+* Parameters:
+*  index:  RRRGGGBB
+*
+* Return:
+*  12-bit color
+*
+*******************************************************************************/
+int32 `$INSTANCE_NAME`_PaletteColor(uint32 index)
+{
+    return (int32)(((uint32)`$INSTANCE_NAME`_palette[(index >> 5) & 0x07u] << 8) |
+                   ((uint32)`$INSTANCE_NAME`_palette[8u + ((index >> 2) & 0x07u)] << 4) |
+                    (uint32)`$INSTANCE_NAME`_palette[16u + (index & 0x03u)]);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_UploadPalette
+********************************************************************************
+*
+* Summary:
+*  Send the palette to the controller's 8-bit color lookup table.
+*
+*******************************************************************************/
+static void `$INSTANCE_NAME`_UploadPalette(void)
+{
+    uint32 i;
+
+#if (`$INSTANCE_NAME`_Controller == `$INSTANCE_NAME`_EPSON)
+    `$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_RGBSET8);
+#else
+    `$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_RGBSET);
+#endif
+    for(i = 0u; i < `$INSTANCE_NAME`_PALETTE_SIZE; i++)
+    {
+        `$INSTANCE_NAME`_Data(`$INSTANCE_NAME`_palette[i]);
+    }
+#if (`$INSTANCE_NAME`_Controller == `$INSTANCE_NAME`_EPSON)
+    `$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_NOP);     /* ends RGBSET8 */
+#endif
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_PixelValue
+********************************************************************************
+*
+* Summary:
+*  Turn a color argument, 12-bit, `$INSTANCE_NAME`_INDEX() or
+*  `$INSTANCE_NAME`_SLOT(), into what goes on the wire in the current mode:
+*  a 12-bit color or an RRRGGGBB index.
+*
+*******************************************************************************/
+static uint32 `$INSTANCE_NAME`_PixelValue(int32 color)
+{
+    uint32 c = (uint32)color;
+
+    if((c & `$INSTANCE_NAME`_SLOTTED) != 0u)
+    {
+        c = (uint32)`$INSTANCE_NAME`_AnimColor(c & 0xFFu);
+    }
+
+    if(`$INSTANCE_NAME`_colorMode == `$INSTANCE_NAME`_COLOR_8BIT)
+    {
+        if((c & `$INSTANCE_NAME`_INDEXED) == 0u)
+        {
+            c = ((c >> 4) & 0xE0u) | ((c >> 3) & 0x1Cu) | ((c >> 2) & 0x03u);
+        }
+        c &= 0xFFu;
+    }
+    else
+    {
+        if((c & `$INSTANCE_NAME`_INDEXED) != 0u)
+        {
+            c = (uint32)`$INSTANCE_NAME`_PaletteColor(c);
+        }
+        c &= 0x0FFFu;
+    }
+    return (c);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_WritePair
+********************************************************************************
+*
+* Summary:
+*  Send two pixel values, as returned by `$INSTANCE_NAME`_PixelValue(), to
+*  an open memory write that holds no half pixel.
+*
+*******************************************************************************/
+static void `$INSTANCE_NAME`_WritePair(uint32 c0, uint32 c1)
+{
+#if (`$INSTANCE_NAME`_SHADOW != 0u)
+    `$INSTANCE_NAME`_ShadowNext(c0);
+    `$INSTANCE_NAME`_ShadowNext(c1);
+#endif
+
+    if(`$INSTANCE_NAME`_colorMode == `$INSTANCE_NAME`_COLOR_8BIT)
+    {
+        `$INSTANCE_NAME`_Data(c0);
+        `$INSTANCE_NAME`_Data(c1);
+    }
+    else
+    {
+        `$INSTANCE_NAME`_Data((c0 >> 4) & 0xFFu);
+        `$INSTANCE_NAME`_Data(((c0 & 0x0Fu) << 4) | ((c1 >> 8) & 0x0Fu));
+        `$INSTANCE_NAME`_Data(c1 & 0xFFu);
+    }
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_SetWindow
+********************************************************************************
+*
+* Summary:
+*  Open a rectangular write window on the display and start a memory write.
+*  Pixels sent afterwards with `$INSTANCE_NAME`_WritePixels() or
+*  `$INSTANCE_NAME`_FillWindow() fill the window without any further
+*  addressing.
+*
+*  The window fills from (x0, y0): y counts up to y1, then x steps on to the
+*  next row; or, after `$INSTANCE_NAME`_SetScan(`$INSTANCE_NAME`_SCAN_COLUMNS),
+*  x counts up to x1 and then y steps on to the next column.
+*
+*  A page or column range that the controller already holds is not sent
+*  again; RAMWR alone moves the write pointer back to the window start.
+*
+* Parameters:
+*  x0, y0:  One corner of the window
+*  x1, y1:  The opposite corner of the window (inclusive)
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_SetWindow(int32 x0, int32 y0, int32 x1, int32 y1)
+{
+    int32 tmp;
+
+    if(`$INSTANCE_NAME`_recording != 0u)
+    {
+        /* Streams cannot be recorded: send what was recorded before it */
+        `$INSTANCE_NAME`_ListPlay();
+    }
+
+    if(x0 > x1)
+    {
+        tmp = x0; x0 = x1; x1 = tmp;
+    }
+    if(y0 > y1)
+    {
+        tmp = y0; y0 = y1; y1 = tmp;
+    }
+
+    if((x0 == `$INSTANCE_NAME`_window.x0) && (x1 == `$INSTANCE_NAME`_window.x1))
+    {
+        `$INSTANCE_NAME`_window.hits++;
+    }
+    else
+    {
+        `$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_PAGEADDR); /* Set page range   */
+        `$INSTANCE_NAME`_Data((uint8)x0);
+        `$INSTANCE_NAME`_Data((uint8)x1);
+        `$INSTANCE_NAME`_window.x0 = x0;
+        `$INSTANCE_NAME`_window.x1 = x1;
+        `$INSTANCE_NAME`_window.misses++;
+    }
+
+    if((y0 == `$INSTANCE_NAME`_window.y0) && (y1 == `$INSTANCE_NAME`_window.y1))
+    {
+        `$INSTANCE_NAME`_window.hits++;
+    }
+    else
+    {
+        `$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_COLADDR);  /* Set column range */
+        `$INSTANCE_NAME`_Data((uint8)y0);
+        `$INSTANCE_NAME`_Data((uint8)y1);
+        `$INSTANCE_NAME`_window.y0 = y0;
+        `$INSTANCE_NAME`_window.y1 = y1;
+        `$INSTANCE_NAME`_window.misses++;
+    }
+
+    `$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_RAMWR);        /* Write color data */
+
+    `$INSTANCE_NAME`_windowLeft = (uint32)((x1 - x0) + 1) * (uint32)((y1 - y0) + 1);
+    `$INSTANCE_NAME`_window.open = 1u;
+
+#if (`$INSTANCE_NAME`_SHADOW != 0u)
+    `$INSTANCE_NAME`_shadowX = x0;
+    `$INSTANCE_NAME`_shadowY = y0;
+    `$INSTANCE_NAME`_shadowLeft = `$INSTANCE_NAME`_windowLeft;
+#endif
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_WritePixels
+********************************************************************************
+*
+* Summary:
+*  Stream pixels into the window opened by `$INSTANCE_NAME`_SetWindow().
+*  In 12-bit mode pixels are packed two to three bytes.  Calls may be
+*  chained; an odd pixel at the end of one call is completed by the next
+*  call, or as soon as the window is full.  Runs of one color are sent as
+*  by `$INSTANCE_NAME`_FillWindow().
+*
+* Parameters:
+*  colors:  Array of 12-bit or `$INSTANCE_NAME`_INDEX() colors, in window
+*           fill order
+*  n:       Number of pixels to send
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_WritePixels(const uint16 *colors, uint32 n)
+{
+    uint32 c0;
+    uint32 c1;
+    uint32 run;
+    uint32 count = n;
+
+    if(`$INSTANCE_NAME`_colorMode == `$INSTANCE_NAME`_COLOR_8BIT)
+    {
+        for( ; n != 0u; n--)
+        {
+            c0 = `$INSTANCE_NAME`_PixelValue((int32)*colors++);
+#if (`$INSTANCE_NAME`_SHADOW != 0u)
+            `$INSTANCE_NAME`_ShadowNext(c0);
+#endif
+            `$INSTANCE_NAME`_Data(c0);
+        }
+    }
+
+    if((n != 0u) && (`$INSTANCE_NAME`_halfPixel != 0u))
+    {
+        c1 = `$INSTANCE_NAME`_PixelValue((int32)*colors++);
+#if (`$INSTANCE_NAME`_SHADOW != 0u)
+        `$INSTANCE_NAME`_ShadowNext(c1);
+#endif
+        `$INSTANCE_NAME`_halfPixel = 0u;
+        `$INSTANCE_NAME`_Data(`$INSTANCE_NAME`_halfNibble | ((c1 >> 8) & 0x0Fu));
+        `$INSTANCE_NAME`_Data(c1 & 0xFFu);
+        n--;
+    }
+
+    while(n >= 2u)
+    {
+        if(colors[0] == colors[1])
+        {
+            for(run = 2u; (run < n) && (colors[run] == colors[0]); run++)
+            {
+                /* Length of the run */
+            }
+            if(run < n)
+            {
+                /* Whole pairs, so the pixels after it still start a pair */
+                run &= ~1u;
+            }
+            if(run >= `$INSTANCE_NAME`_RUN_MIN)
+            {
+                c0 = `$INSTANCE_NAME`_PixelValue((int32)*colors);
+#if (`$INSTANCE_NAME`_SHADOW != 0u)
+                for(c1 = 0u; c1 < run; c1++)
+                {
+                    `$INSTANCE_NAME`_ShadowNext(c0);
+                }
+#endif
+                `$INSTANCE_NAME`_StreamSolid(c0, run);
+                colors += run;
+                n -= run;
+                continue;
+            }
+        }
+        c0 = `$INSTANCE_NAME`_PixelValue((int32)*colors++);
+        c1 = `$INSTANCE_NAME`_PixelValue((int32)*colors++);
+        `$INSTANCE_NAME`_WritePair(c0, c1);
+        n -= 2u;
+    }
+
+    if(n != 0u)
+    {
+        c0 = `$INSTANCE_NAME`_PixelValue((int32)*colors);
+#if (`$INSTANCE_NAME`_SHADOW != 0u)
+        `$INSTANCE_NAME`_ShadowNext(c0);
+#endif
+        `$INSTANCE_NAME`_Data((c0 >> 4) & 0xFFu);
+        `$INSTANCE_NAME`_halfNibble = (c0 & 0x0Fu) << 4;
+        `$INSTANCE_NAME`_halfPixel = 1u;
+    }
+    `$INSTANCE_NAME`_CountPixels(count);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_WriteIndexed
+********************************************************************************
+*
+* Summary:
+*  Stream RRRGGGBB palette indices into the window opened by
+*  `$INSTANCE_NAME`_SetWindow(), one byte per pixel in 8-bit mode.  In 12-bit
+*  mode each index is sent as its palette color.  Half the RAM of a 12-bit
+*  buffer for the same image.
+*
+* Parameters:
+*  indices:  Array of palette indices, in window fill order
+*  n:        Number of pixels to send
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_WriteIndexed(const uint8 *indices, uint32 n)
+{
+    uint16 color;
+    uint32 count = n;
+
+    if(`$INSTANCE_NAME`_colorMode == `$INSTANCE_NAME`_COLOR_8BIT)
+    {
+        for( ; n != 0u; n--)
+        {
+#if (`$INSTANCE_NAME`_SHADOW != 0u)
+            `$INSTANCE_NAME`_ShadowNext(*indices);
+#endif
+            `$INSTANCE_NAME`_Data(*indices++);
+        }
+        `$INSTANCE_NAME`_CountPixels(count);
+    }
+    else
+    {
+        for( ; n != 0u; n--)
+        {
+            color = (uint16)`$INSTANCE_NAME`_INDEX(*indices++);
+            `$INSTANCE_NAME`_WritePixels(&color, 1u);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_FillWindow
+********************************************************************************
+*
+* Summary:
+*  Stream n pixels of one color into the window opened by
+*  `$INSTANCE_NAME`_SetWindow().  The two-pixel byte pattern is packed once
+*  and sent as a run; in 8-bit mode each pixel is the same single byte.
+*
+* Parameters:
+*  color:  12-bit or `$INSTANCE_NAME`_INDEX() fill color
+*  n:      Number of pixels to send
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_FillWindow(int32 color, uint32 n)
+{
+    uint32 c = `$INSTANCE_NAME`_PixelValue(color);
+    uint32 i;
+
+#if (`$INSTANCE_NAME`_SHADOW != 0u)
+    if((n >= `$INSTANCE_NAME`_windowLeft) && (`$INSTANCE_NAME`_shadowLeft == `$INSTANCE_NAME`_windowLeft) &&
+       (`$INSTANCE_NAME`_shadowX == `$INSTANCE_NAME`_window.x0) && (`$INSTANCE_NAME`_shadowY == `$INSTANCE_NAME`_window.y0))
+    {
+        /* The whole window in one color */
+        `$INSTANCE_NAME`_ShadowRect(`$INSTANCE_NAME`_window.x0, `$INSTANCE_NAME`_window.y0,
+                                    `$INSTANCE_NAME`_window.x1, `$INSTANCE_NAME`_window.y1, c);
+        `$INSTANCE_NAME`_shadowLeft = 0u;
+    }
+    else
+    {
+        for(i = 0u; i < n; i++)
+        {
+            `$INSTANCE_NAME`_ShadowNext(c);
+        }
+    }
+#endif
+
+    if(`$INSTANCE_NAME`_colorMode == `$INSTANCE_NAME`_COLOR_8BIT)
+    {
+        /* One byte a pixel: three pixels make a run's pattern */
+        `$INSTANCE_NAME`_SendRun(c, c, c, n / 3u);
+        for(i = n % 3u; i != 0u; i--)
+        {
+            `$INSTANCE_NAME`_Data(c);
+        }
+    }
+    else
+    {
+        `$INSTANCE_NAME`_StreamSolid(c, n);
+    }
+    `$INSTANCE_NAME`_CountPixels(n);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_StreamSolid
+********************************************************************************
+*
+* Summary:
+*  Send n 12-bit pixels of one value, as bytes only: the pixel count and the
+*  shadow are left to the caller.  A half pixel held from before is
+*  completed first, the pairs go out as one run, and an odd last pixel is
+*  held back.
+*
+*******************************************************************************/
+static void `$INSTANCE_NAME`_StreamSolid(uint32 c, uint32 n)
+{
+    uint32 b0 = (c >> 4) & 0xFFu;
+    uint32 b1 = ((c & 0x0Fu) << 4) | ((c >> 8) & 0x0Fu);
+    uint32 b2 = c & 0xFFu;
+
+    if((n != 0u) && (`$INSTANCE_NAME`_halfPixel != 0u))
+    {
+        `$INSTANCE_NAME`_halfPixel = 0u;
+        `$INSTANCE_NAME`_Data(`$INSTANCE_NAME`_halfNibble | (b1 & 0x0Fu));
+        `$INSTANCE_NAME`_Data(b2);
+        n--;
+    }
+
+    `$INSTANCE_NAME`_SendRun(b0, b1, b2, n >> 1);
+
+    if((n & 1u) != 0u)
+    {
+        `$INSTANCE_NAME`_Data(b0);
+        `$INSTANCE_NAME`_halfNibble = b1 & 0xF0u;
+        `$INSTANCE_NAME`_halfPixel = 1u;
+    }
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_BlitRLE
+********************************************************************************
+*
+* Summary:
+*  Draw a run-length encoded image, e.g. one kept in flash, into a
+*  rectangle of the screen, a row at a time.  Runs are sent as by
+*  `$INSTANCE_NAME`_FillWindow() and copied pixels as by `$INSTANCE_NAME`_WritePixels(), through one
+*  window.  An image cut by the clip rectangle is drawn pixel by pixel, one
+*  outside it not at all.
+*
+*  The image is a list of words: `$INSTANCE_NAME`_RLE_RUN(n) and one color repeat the
+*  color n times, `$INSTANCE_NAME`_RLE_COPY(n) and n colors send the colors as they are.
+*  Colors are 12-bit, `$INSTANCE_NAME`_INDEX() or `$INSTANCE_NAME`_SLOT().
+*
+* Parameters:
+*  x0, y0:  Top left corner
+*  x1, y1:  Bottom right corner (inclusive)
+*  rle:     The image, (x1 - x0 + 1) * (y1 - y0 + 1) pixels
+*
+* Return:
+*  The word after the image, where the next one starts when several are
+*  stored one after another
+*
+*******************************************************************************/
+const uint16 *`$INSTANCE_NAME`_BlitRLE(int32 x0, int32 y0, int32 x1, int32 y1, const uint16 *rle)
+{
+    uint32 w = (uint32)((y1 - y0) + 1);
+    uint32 total = (uint32)((x1 - x0) + 1) * w;
+    uint32 clip = `$INSTANCE_NAME`_ClipBox(x0, y0, x1, y1);
+    uint32 done;
+    uint32 word;
+    uint32 n;
+    uint32 i;
+
+    if(clip == `$INSTANCE_NAME`_CLIP_IN)
+    {
+        `$INSTANCE_NAME`_SetScan(`$INSTANCE_NAME`_SCAN_ROWS);
+        `$INSTANCE_NAME`_SetWindow(x0, y0, x1, y1);
+    }
+
+    for(done = 0u; done < total; done += n)
+    {
+        word = *rle++;
+        n = word & 0x7FFFu;
+        n = (n > (total - done)) ? (total - done) : n;
+
+        if(clip == `$INSTANCE_NAME`_CLIP_IN)
+        {
+            if((word & 0x8000u) != 0u)
+            {
+                `$INSTANCE_NAME`_FillWindow((int32)*rle, n);
+            }
+            else
+            {
+                `$INSTANCE_NAME`_WritePixels(rle, n);
+            }
+        }
+        else if(clip == `$INSTANCE_NAME`_CLIP_PART)
+        {
+            for(i = 0u; i < n; i++)
+            {
+                `$INSTANCE_NAME`_Pixel(x0 + (int32)((done + i) / w), y0 + (int32)((done + i) % w),
+                         (int32)(((word & 0x8000u) != 0u) ? rle[0] : rle[i]));
+            }
+        }
+        else
+        {
+            /* Off the clip: only skip over it */
+        }
+        rle += ((word & 0x8000u) != 0u) ? 1u : (word & 0x7FFFu);
+    }
+    return (rle);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_Pixel
+********************************************************************************
+*
+* Summary:
+*  Draw Pixel
+*
+*  If the open window's write pointer is already at (x, y) the pixel is just
+*  streamed, with no addressing at all.  Otherwise a window is opened from
+*  (x, y) to the end of the row, so that a following pixel at (x, y + 1)
+*  can continue it, or to the bottom of the column when the last pixel was
+*  just above this one.  The last pixel of such a run may be held back until the
+*  next drawing call; use `$INSTANCE_NAME`_Flush() if it must appear sooner.
+*  Pixels outside the clip rectangle are skipped, and with the shadow so are
+*  pixels that already have the color.
+*
+* Parameters:
+*  x,y:    Location to draw the pixel
+*  color:  Color of the pixel
+*
+* Return:
+*  None
+*******************************************************************************/
+void `$INSTANCE_NAME`_Pixel(int32 x, int32 y, int32 color)
+{
+    uint32 done;
+    uint32 w;
+    uint32 h;
+    uint32 next = 0u;
+
+    if((x < `$INSTANCE_NAME`_clipX0) || (x > `$INSTANCE_NAME`_clipX1) || (y < `$INSTANCE_NAME`_clipY0) || (y > `$INSTANCE_NAME`_clipY1))
+    {
+        return;
+    }
+
+    if((`$INSTANCE_NAME`_recording != 0u) && (`$INSTANCE_NAME`_ListRecord(x, y, x, y, color) != 0u))
+    {
+        return;
+    }
+
+#if (`$INSTANCE_NAME`_SHADOW != 0u)
+    if(`$INSTANCE_NAME`_ShadowGet(x, y) == (int32)`$INSTANCE_NAME`_PixelValue(color))
+    {
+        `$INSTANCE_NAME`_shadowSkipped++;
+        return;
+    }
+#endif
+
+    if((`$INSTANCE_NAME`_window.open != 0u) && (`$INSTANCE_NAME`_windowLeft != 0u))
+    {
+        /* Where the write pointer is: pixels so far, in fill order */
+        w = (uint32)((`$INSTANCE_NAME`_window.y1 - `$INSTANCE_NAME`_window.y0) + 1);
+        h = (uint32)((`$INSTANCE_NAME`_window.x1 - `$INSTANCE_NAME`_window.x0) + 1);
+        done = (w * h) - `$INSTANCE_NAME`_windowLeft;
+
+        if(`$INSTANCE_NAME`_window.scan == `$INSTANCE_NAME`_SCAN_ROWS)
+        {
+            next = ((x == (`$INSTANCE_NAME`_window.x0 + (int32)(done / w))) &&
+                    (y == (`$INSTANCE_NAME`_window.y0 + (int32)(done % w)))) ? 1u : 0u;
+        }
+        else
+        {
+            next = ((x == (`$INSTANCE_NAME`_window.x0 + (int32)(done % h))) &&
+                    (y == (`$INSTANCE_NAME`_window.y0 + (int32)(done / h)))) ? 1u : 0u;
+        }
+    }
+
+    if(next != 0u)
+    {
+        `$INSTANCE_NAME`_window.hits += 2u;
+    }
+    else if((x == (`$INSTANCE_NAME`_lastX + 1)) && (y == `$INSTANCE_NAME`_lastY))
+    {
+        `$INSTANCE_NAME`_SetWindow(x, y, (int32)`$INSTANCE_NAME`_MAXX, y);
+    }
+    else
+    {
+        `$INSTANCE_NAME`_SetWindow(x, y, x, (int32)`$INSTANCE_NAME`_MAXY);
+    }
+    `$INSTANCE_NAME`_FillWindow(color, 1u);
+    `$INSTANCE_NAME`_lastX = x;
+    `$INSTANCE_NAME`_lastY = y;
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_FillArea
+********************************************************************************
+*
+* Summary:
+*  Fill a rectangle with one color using a single address window.  Only the
+*  part inside the clip rectangle is sent, and with the shadow only the part
+*  of that which holds pixels of another color.
+*
+* Parameters:
+*  x0, y0:  One corner of the area
+*  x1, y1:  The opposite corner of the area (inclusive)
+*  color:   Fill color
+*
+* Return:
+*  None
+*******************************************************************************/
+static void `$INSTANCE_NAME`_FillArea(int32 x0, int32 y0, int32 x1, int32 y1, int32 color)
+{
+    int32 tmp;
+
+    if(x0 > x1)
+    {
+        tmp = x0; x0 = x1; x1 = tmp;
+    }
+    if(y0 > y1)
+    {
+        tmp = y0; y0 = y1; y1 = tmp;
+    }
+    x0 = (x0 < `$INSTANCE_NAME`_clipX0) ? `$INSTANCE_NAME`_clipX0 : x0;
+    y0 = (y0 < `$INSTANCE_NAME`_clipY0) ? `$INSTANCE_NAME`_clipY0 : y0;
+    x1 = (x1 > `$INSTANCE_NAME`_clipX1) ? `$INSTANCE_NAME`_clipX1 : x1;
+    y1 = (y1 > `$INSTANCE_NAME`_clipY1) ? `$INSTANCE_NAME`_clipY1 : y1;
+    if((x0 > x1) || (y0 > y1))
+    {
+        return;
+    }
+
+    if((`$INSTANCE_NAME`_recording != 0u) && (`$INSTANCE_NAME`_ListRecord(x0, y0, x1, y1, color) != 0u))
+    {
+        return;
+    }
+
+#if (`$INSTANCE_NAME`_SHADOW != 0u)
+    if(`$INSTANCE_NAME`_ShadowTrim(&x0, &y0, &x1, &y1, `$INSTANCE_NAME`_PixelValue(color)) == 0u)
+    {
+        return;
+    }
+#endif
+
+    `$INSTANCE_NAME`_SetWindow(x0, y0, x1, y1);
+    `$INSTANCE_NAME`_FillWindow(color, (uint32)((x1 - x0) + 1) * (uint32)((y1 - y0) + 1));
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_SetClip
+********************************************************************************
+*
+* Summary:
+*  Limit the drawing functions to a rectangle of the screen: pixels, lines,
+*  rectangles, circles, sectors, text and the band renderer.  What falls
+*  outside is dropped before anything is sent.  Window streams, the tile
+*  and sprite layers and `$INSTANCE_NAME`_Clear() are not clipped.
+*
+* Parameters:
+*  x0, y0:  One corner
+*  x1, y1:  The opposite corner (inclusive)
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_SetClip(int32 x0, int32 y0, int32 x1, int32 y1)
+{
+    int32 tmp;
+
+    if(x0 > x1)
+    {
+        tmp = x0; x0 = x1; x1 = tmp;
+    }
+    if(y0 > y1)
+    {
+        tmp = y0; y0 = y1; y1 = tmp;
+    }
+    `$INSTANCE_NAME`_clipX0 = (x0 < (int32)`$INSTANCE_NAME`_MINX) ? (int32)`$INSTANCE_NAME`_MINX : x0;
+    `$INSTANCE_NAME`_clipY0 = (y0 < (int32)`$INSTANCE_NAME`_MINY) ? (int32)`$INSTANCE_NAME`_MINY : y0;
+    `$INSTANCE_NAME`_clipX1 = (x1 > (int32)`$INSTANCE_NAME`_MAXX) ? (int32)`$INSTANCE_NAME`_MAXX : x1;
+    `$INSTANCE_NAME`_clipY1 = (y1 > (int32)`$INSTANCE_NAME`_MAXY) ? (int32)`$INSTANCE_NAME`_MAXY : y1;
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_ClearClip
+********************************************************************************
+*
+* Summary:
+*  Let the drawing functions use the whole screen again.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_ClearClip(void)
+{
+    `$INSTANCE_NAME`_SetClip((int32)`$INSTANCE_NAME`_MINX, (int32)`$INSTANCE_NAME`_MINY, (int32)`$INSTANCE_NAME`_MAXX, (int32)`$INSTANCE_NAME`_MAXY);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_GetClip
+********************************************************************************
+*
+* Summary:
+*  Read the clip rectangle.  It is empty (x0 > x1 or y0 > y1) when the one
+*  set was all off the screen.
+*
+* Parameters:
+*  x0, y0:  Get the top left corner
+*  x1, y1:  Get the bottom right corner (inclusive)
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_GetClip(int32 *x0, int32 *y0, int32 *x1, int32 *y1)
+{
+    *x0 = `$INSTANCE_NAME`_clipX0;
+    *y0 = `$INSTANCE_NAME`_clipY0;
+    *x1 = `$INSTANCE_NAME`_clipX1;
+    *y1 = `$INSTANCE_NAME`_clipY1;
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_ClipCode
+********************************************************************************
+*
+* Summary:
+*  Outcode of a point: the CLIP_ bits of the edges it is beyond.
+*
+*******************************************************************************/
+static uint32 `$INSTANCE_NAME`_ClipCode(int32 x, int32 y)
+{
+    uint32 code = 0u;
+
+    if(x < `$INSTANCE_NAME`_clipX0)
+    {
+        code |= `$INSTANCE_NAME`_CLIP_ABOVE;
+    }
+    else if(x > `$INSTANCE_NAME`_clipX1)
+    {
+        code |= `$INSTANCE_NAME`_CLIP_BELOW;
+    }
+    else
+    {
+        /* Between the rows */
+    }
+    if(y < `$INSTANCE_NAME`_clipY0)
+    {
+        code |= `$INSTANCE_NAME`_CLIP_LEFT;
+    }
+    else if(y > `$INSTANCE_NAME`_clipY1)
+    {
+        code |= `$INSTANCE_NAME`_CLIP_RIGHT;
+    }
+    else
+    {
+        /* Between the columns */
+    }
+    return (code);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_ClipBox
+********************************************************************************
+*
+* Summary:
+*  How a bounding box (x0 <= x1, y0 <= y1) lies against the clip rectangle:
+*  CLIP_OUT, CLIP_PART or CLIP_IN.
+*
+*******************************************************************************/
+static uint32 `$INSTANCE_NAME`_ClipBox(int32 x0, int32 y0, int32 x1, int32 y1)
+{
+    if((x1 < `$INSTANCE_NAME`_clipX0) || (x0 > `$INSTANCE_NAME`_clipX1) || (y1 < `$INSTANCE_NAME`_clipY0) || (y0 > `$INSTANCE_NAME`_clipY1))
+    {
+        return (`$INSTANCE_NAME`_CLIP_OUT);
+    }
+    if((x0 >= `$INSTANCE_NAME`_clipX0) && (x1 <= `$INSTANCE_NAME`_clipX1) && (y0 >= `$INSTANCE_NAME`_clipY0) && (y1 <= `$INSTANCE_NAME`_clipY1))
+    {
+        return (`$INSTANCE_NAME`_CLIP_IN);
+    }
+    return (`$INSTANCE_NAME`_CLIP_PART);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_StepRange
+********************************************************************************
+*
+* Summary:
+*  Narrow first .. last to the steps n for which from + step * n is within
+*  lo .. hi, step being 1 or -1.
+*
+*******************************************************************************/
+static void `$INSTANCE_NAME`_StepRange(int32 from, int32 step, int32 lo, int32 hi, int32 *first, int32 *last)
+{
+    int32 a = (step > 0) ? (lo - from) : (from - hi);
+    int32 b = (step > 0) ? (hi - from) : (from - lo);
+
+    *first = (a > *first) ? a : *first;
+    *last = (b < *last) ? b : *last;
+}
+
+#if (`$INSTANCE_NAME`_SHADOW != 0u)
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_GetPixel
+********************************************************************************
+*
+* Summary:
+*  Read a pixel back from the shadow of the display memory.
+*
+* Parameters:
+*  x, y:  Location of the pixel
+*
+* Return:
+*  Its color, 12-bit or as `$INSTANCE_NAME`_INDEX() in 8-bit mode; -1 when
+*  off the screen or not known, e.g. in a block that holds more than one
+*  color other than black.
+*
+*******************************************************************************/
+int32 `$INSTANCE_NAME`_GetPixel(int32 x, int32 y)
+{
+    int32 value;
+
+    if((x < (int32)`$INSTANCE_NAME`_MINX) || (x > (int32)`$INSTANCE_NAME`_MAXX) ||
+       (y < (int32)`$INSTANCE_NAME`_MINY) || (y > (int32)`$INSTANCE_NAME`_MAXY))
+    {
+        return (-1);
+    }
+    value = `$INSTANCE_NAME`_ShadowGet(x, y);
+    if((value >= 0) && (`$INSTANCE_NAME`_colorMode == `$INSTANCE_NAME`_COLOR_8BIT))
+    {
+        value = `$INSTANCE_NAME`_INDEX(value);
+    }
+    return (value);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_ShadowSkipped
+********************************************************************************
+*
+* Summary:
+*  Pixels not sent since `$INSTANCE_NAME`_Start() because the shadow showed
+*  they already had their color.
+*
+* Return:
+*  Pixel count
+*
+*******************************************************************************/
+uint32 `$INSTANCE_NAME`_ShadowSkipped(void)
+{
+    return (`$INSTANCE_NAME`_shadowSkipped);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_ShadowReset
+********************************************************************************
+*
+* Summary:
+*  Forget what is on the screen: every block unknown.
+*
+*******************************************************************************/
+static void `$INSTANCE_NAME`_ShadowReset(void)
+{
+    uint32 i;
+    uint32 j;
+
+    for(i = 0u; i < `$INSTANCE_NAME`_SHADOW_BLOCKS; i++)
+    {
+        for(j = 0u; j < `$INSTANCE_NAME`_SHADOW_BLOCKS; j++)
+        {
+            `$INSTANCE_NAME`_shadowInk[i][j] = `$INSTANCE_NAME`_SHADOW_UNKNOWN;
+        }
+    }
+    `$INSTANCE_NAME`_shadowLeft = 0u;
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_ShadowGet
+********************************************************************************
+*
+* Summary:
+*  Pixel value at (x, y), on the screen, or -1 if its block is unknown.
+*
+*******************************************************************************/
+static int32 `$INSTANCE_NAME`_ShadowGet(int32 x, int32 y)
+{
+    uint32 ink = `$INSTANCE_NAME`_shadowInk[(uint32)x >> 3][(uint32)y >> 3];
+
+    if((ink & `$INSTANCE_NAME`_SHADOW_UNKNOWN) != 0u)
+    {
+        return (-1);
+    }
+    return (((`$INSTANCE_NAME`_shadowBits[x][(uint32)y >> 3] & (1u << ((uint32)y & 7u))) != 0u) ? (int32)ink : 0);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_ShadowPut
+********************************************************************************
+*
+* Summary:
+*  Record a pixel value written at (x, y), on the screen.  A color that is
+*  neither black nor the block's ink becomes the ink if the block has none
+*  left, otherwise the block becomes unknown.
+*
+*******************************************************************************/
+static void `$INSTANCE_NAME`_ShadowPut(int32 x, int32 y, uint32 value)
+{
+    uint16 *ink = &`$INSTANCE_NAME`_shadowInk[(uint32)x >> 3][(uint32)y >> 3];
+    uint8 *bits = &`$INSTANCE_NAME`_shadowBits[x][(uint32)y >> 3];
+    uint32 col = (uint32)y >> 3;
+    uint32 mask = 1u << ((uint32)y & 7u);
+    int32 row;
+    int32 last;
+
+    if((*ink & `$INSTANCE_NAME`_SHADOW_UNKNOWN) != 0u)
+    {
+        return;
+    }
+    *bits &= (uint8)~mask;
+    if(value == 0u)
+    {
+        return;
+    }
+    if(value != *ink)
+    {
+        row = x & ~7;
+        last = ((row + 7) > (int32)`$INSTANCE_NAME`_MAXX) ? (int32)`$INSTANCE_NAME`_MAXX : (row + 7);
+        for( ; row <= last; row++)
+        {
+            if(`$INSTANCE_NAME`_shadowBits[row][col] != 0u)
+            {
+                *ink = `$INSTANCE_NAME`_SHADOW_UNKNOWN;
+                return;
+            }
+        }
+        *ink = (uint16)value;
+    }
+    *bits |= (uint8)mask;
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_ShadowNext
+********************************************************************************
+*
+* Summary:
+*  Record a pixel value streamed into the open window and move the cursor
+*  on in the window's fill order.
+*
+*******************************************************************************/
+static void `$INSTANCE_NAME`_ShadowNext(uint32 value)
+{
+    if(`$INSTANCE_NAME`_shadowLeft == 0u)
+    {
+        return;
+    }
+    `$INSTANCE_NAME`_shadowLeft--;
+    if((`$INSTANCE_NAME`_shadowX >= (int32)`$INSTANCE_NAME`_MINX) && (`$INSTANCE_NAME`_shadowX <= (int32)`$INSTANCE_NAME`_MAXX) &&
+       (`$INSTANCE_NAME`_shadowY >= (int32)`$INSTANCE_NAME`_MINY) && (`$INSTANCE_NAME`_shadowY <= (int32)`$INSTANCE_NAME`_MAXY))
+    {
+        `$INSTANCE_NAME`_ShadowPut(`$INSTANCE_NAME`_shadowX, `$INSTANCE_NAME`_shadowY, value);
+    }
+
+    if(`$INSTANCE_NAME`_window.scan == `$INSTANCE_NAME`_SCAN_ROWS)
+    {
+        if(++`$INSTANCE_NAME`_shadowY > `$INSTANCE_NAME`_window.y1)
+        {
+            `$INSTANCE_NAME`_shadowY = `$INSTANCE_NAME`_window.y0;
+            `$INSTANCE_NAME`_shadowX++;
+        }
+    }
+    else
+    {
+        if(++`$INSTANCE_NAME`_shadowX > `$INSTANCE_NAME`_window.x1)
+        {
+            `$INSTANCE_NAME`_shadowX = `$INSTANCE_NAME`_window.x0;
+            `$INSTANCE_NAME`_shadowY++;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_ShadowRect
+********************************************************************************
+*
+* Summary:
+*  Record a rectangle filled with one pixel value; the part off the screen
+*  is left out.  Blocks it covers whole take the value as their ink, even
+*  unknown ones.
+*
+*******************************************************************************/
+static void `$INSTANCE_NAME`_ShadowRect(int32 x0, int32 y0, int32 x1, int32 y1, uint32 value)
+{
+    int32 bx, by;
+    int32 bx0, by0, bx1, by1;
+    int32 x, y;
+    uint32 full;
+
+    x0 = (x0 < (int32)`$INSTANCE_NAME`_MINX) ? (int32)`$INSTANCE_NAME`_MINX : x0;
+    y0 = (y0 < (int32)`$INSTANCE_NAME`_MINY) ? (int32)`$INSTANCE_NAME`_MINY : y0;
+    x1 = (x1 > (int32)`$INSTANCE_NAME`_MAXX) ? (int32)`$INSTANCE_NAME`_MAXX : x1;
+    y1 = (y1 > (int32)`$INSTANCE_NAME`_MAXY) ? (int32)`$INSTANCE_NAME`_MAXY : y1;
+
+    for(bx = x0 & ~7; bx <= x1; bx += 8)
+    {
+        bx0 = (bx > x0) ? bx : x0;
+        bx1 = ((bx + 7) < x1) ? (bx + 7) : x1;
+        for(by = y0 & ~7; by <= y1; by += 8)
+        {
+            by0 = (by > y0) ? by : y0;
+            by1 = ((by + 7) < y1) ? (by + 7) : y1;
+
+            if((bx0 == bx) && (by0 == by) &&
+               ((bx1 == (bx + 7)) || (bx1 == (int32)`$INSTANCE_NAME`_MAXX)) &&
+               ((by1 == (by + 7)) || (by1 == (int32)`$INSTANCE_NAME`_MAXY)))
+            {
+                /* Whole block */
+                full = (value != 0u) ? ((1u << ((by1 - by) + 1)) - 1u) : 0u;
+                `$INSTANCE_NAME`_shadowInk[(uint32)bx >> 3][(uint32)by >> 3] = (uint16)value;
+                for(x = bx0; x <= bx1; x++)
+                {
+                    `$INSTANCE_NAME`_shadowBits[x][(uint32)by >> 3] = (uint8)full;
+                }
+            }
+            else
+            {
+                for(x = bx0; x <= bx1; x++)
+                {
+                    for(y = by0; y <= by1; y++)
+                    {
+                        `$INSTANCE_NAME`_ShadowPut(x, y, value);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_ShadowTrim
+********************************************************************************
+*
+* Summary:
+*  Shrink a rectangle to be filled with one pixel value to the box round its
+*  pixels that have another value or are unknown.  The pixels outside it
+*  are counted as skipped.  A rectangle that is not all on the screen is
+*  left as it is.
+*
+* Return:
+*  0 if no pixel would change
+*
+*******************************************************************************/
+static uint32 `$INSTANCE_NAME`_ShadowTrim(int32 *x0, int32 *y0, int32 *x1, int32 *y1, uint32 value)
+{
+    int32 x, col;
+    int32 lo, hi;
+    int32 nx0 = 0x7FFF, ny0 = 0x7FFF, nx1 = -1, ny1 = -1;
+    uint32 bits, ink, changed;
+    uint32 area;
+    int32 tmp;
+
+    if(*x0 > *x1)
+    {
+        tmp = *x0; *x0 = *x1; *x1 = tmp;
+    }
+    if(*y0 > *y1)
+    {
+        tmp = *y0; *y0 = *y1; *y1 = tmp;
+    }
+    if((*x0 < (int32)`$INSTANCE_NAME`_MINX) || (*x1 > (int32)`$INSTANCE_NAME`_MAXX) ||
+       (*y0 < (int32)`$INSTANCE_NAME`_MINY) || (*y1 > (int32)`$INSTANCE_NAME`_MAXY))
+    {
+        return (1u);
+    }
+    area = (uint32)((*x1 - *x0) + 1) * (uint32)((*y1 - *y0) + 1);
+
+    for(x = *x0; x <= *x1; x++)
+    {
+        for(col = *y0 >> 3; col <= (*y1 >> 3); col++)
+        {
+            /* Pixels of this byte inside the rectangle */
+            lo = (*y0 > (col * 8)) ? (*y0 - (col * 8)) : 0;
+            hi = (*y1 < ((col * 8) + 7)) ? (*y1 - (col * 8)) : 7;
+            changed = ((1u << (hi + 1)) - 1u) & ~((1u << lo) - 1u);
+
+            ink = `$INSTANCE_NAME`_shadowInk[(uint32)x >> 3][col];
+            bits = `$INSTANCE_NAME`_shadowBits[x][col];
+            if((ink & `$INSTANCE_NAME`_SHADOW_UNKNOWN) == 0u)
+            {
+                if(value == 0u)
+                {
+                    changed &= bits;
+                }
+                else if(value == ink)
+                {
+                    changed &= ~bits;
+                }
+                else
+                {
+                    /* Every pixel has another color */
+                }
+            }
+            if(changed == 0u)
+            {
+                continue;
+            }
+
+            for(lo = 0; (changed & (1u << lo)) == 0u; lo++)
+            {
+            }
+            for(hi = 7; (changed & (1u << hi)) == 0u; hi--)
+            {
+            }
+            nx0 = (x < nx0) ? x : nx0;
+            nx1 = x;
+            ny0 = (((col * 8) + lo) < ny0) ? ((col * 8) + lo) : ny0;
+            ny1 = (((col * 8) + hi) > ny1) ? ((col * 8) + hi) : ny1;
+        }
+    }
+
+    if(nx1 < 0)
+    {
+        `$INSTANCE_NAME`_shadowSkipped += area;
+        return (0u);
+    }
+    *x0 = nx0;
+    *y0 = ny0;
+    *x1 = nx1;
+    *y1 = ny1;
+    `$INSTANCE_NAME`_shadowSkipped += area - ((uint32)((nx1 - nx0) + 1) * (uint32)((ny1 - ny0) + 1));
+    return (1u);
+}
+#endif
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_DrawCircle
+********************************************************************************
+*
+* Summary:
+*  Draw a circle on the display given a start point and radius.  
+*
+*  This code uses Bresenham's Circle Algorithm.  A circle that misses the
+*  clip rectangle is not walked at all.
+*
+* Parameters:  
+*  x0, y0: Center of circle
+*  radius: Radius of circle
+*  color:  Color of circle
+*
+* Return: 
+*  None 
+*  
+*******************************************************************************/
+void `$INSTANCE_NAME`_DrawCircle (int32 x0, int32 y0, int32 radius, int32 color)
+{
+	int32 f = 1 - radius;
+	int32 ddF_x = 0;
+	int32 ddF_y = -2 * radius;
+	int32 x = 0;
+	int32 y = radius;
+
+	if ((radius < 0) || (`$INSTANCE_NAME`_ClipBox(x0 - radius, y0 - radius, x0 + radius, y0 + radius) == `$INSTANCE_NAME`_CLIP_OUT))
+	{
+		return;
+	}
+
+	`$INSTANCE_NAME`_Pixel(x0, y0 + radius, color);
+	`$INSTANCE_NAME`_Pixel(x0, y0 - radius, color);
+	`$INSTANCE_NAME`_Pixel( x0 + radius, y0, color);
+	`$INSTANCE_NAME`_Pixel( x0 - radius, y0, color);
+
+	while(x < y)
+	{
+		if(f >= 0)
+		{
+			y--;
+			ddF_y += 2;
+			f += ddF_y;
+		}
+		x++;
+		ddF_x += 2;
+		f += ddF_x + 1;
+
+		`$INSTANCE_NAME`_Pixel(x0 + x, y0 + y, color);
+		`$INSTANCE_NAME`_Pixel(x0 - x, y0 + y, color);
+		`$INSTANCE_NAME`_Pixel( x0 + x, y0 - y, color);
+		`$INSTANCE_NAME`_Pixel( x0 - x, y0 - y, color);
+		`$INSTANCE_NAME`_Pixel( x0 + y, y0 + x, color);
+		`$INSTANCE_NAME`_Pixel( x0 - y, y0 + x, color);
+		`$INSTANCE_NAME`_Pixel( x0 + y, y0 - x, color);
+		`$INSTANCE_NAME`_Pixel( x0 - y, y0 - x, color);
+	}
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_SinQ15
+********************************************************************************
+*
+* Summary:
+*  Sine from the quarter-wave table, no floating point.
+*
+* Parameters:  
+*  angle:  Angle in 1/`$INSTANCE_NAME`_TRIG_STEPS degree steps, any sign or size
+*
+* Return: 
+*  sin(angle) in Q1.15 
+*  
+*******************************************************************************/
+int32 `$INSTANCE_NAME`_SinQ15(int32 angle)
+{
+    uint32 a;
+    uint32 quadrant;
+
+    angle %= (int32)`$INSTANCE_NAME`_TRIG_CIRCLE;
+    if(angle < 0)
+    {
+        angle += (int32)`$INSTANCE_NAME`_TRIG_CIRCLE;
+    }
+    a = (uint32)angle % `$INSTANCE_NAME`_TRIG_QUADRANT;
+    quadrant = (uint32)angle / `$INSTANCE_NAME`_TRIG_QUADRANT;
+
+    if((quadrant & 1u) != 0u)
+    {
+        a = `$INSTANCE_NAME`_TRIG_QUADRANT - a;     /* falling half of the hump */
+    }
+    return ((quadrant < 2u) ? (int32)`$INSTANCE_NAME`_SIN_TABLE[a] : -(int32)`$INSTANCE_NAME`_SIN_TABLE[a]);
 }
 
 /*******************************************************************************
-* Function Name: `$INSTANCE_NAME`_Stop
+* Function Name: `$INSTANCE_NAME`_CosQ15
 ********************************************************************************
 *
 * Summary:
-*  This function clears the LCD to black and turns off the display.  
+*  Cosine from the quarter-wave table, no floating point.
 *
 * Parameters:  
-*   None:   
+*  angle:  Angle in 1/`$INSTANCE_NAME`_TRIG_STEPS degree steps
 *
 * Return: 
-*  None 
+*  cos(angle) in Q1.15 
 *  
 *******************************************************************************/
-void `$INSTANCE_NAME`_Stop(void)
+int32 `$INSTANCE_NAME`_CosQ15(int32 angle)
 {
-   `$INSTANCE_NAME`_Clear(`$INSTANCE_NAME`_BLACK);
-   `$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_DISPOFF);
+    return `$INSTANCE_NAME`_SinQ15((angle % (int32)`$INSTANCE_NAME`_TRIG_CIRCLE) + (int32)`$INSTANCE_NAME`_TRIG_QUADRANT);
 }
 
 /*******************************************************************************
-* Function Name: `$INSTANCE_NAME`_Clear
+* Function Name: `$INSTANCE_NAME`_PolarToXY
 ********************************************************************************
 *
 * Summary:
-*  Clear the display.  
+*  Convert a polar offset from (x0, y0) into display coordinates, rounded to
+*  the nearest pixel: x = x0 + r sin(angle), y = y0 + r cos(angle).
 *
 * Parameters:  
-*  color: Color to clear display with. 
+*  x0, y0:  Origin
+*  radius:  Distance from the origin, |radius| < 32768
+*  angle:   Angle in 1/`$INSTANCE_NAME`_TRIG_STEPS degree steps
+*  x, y:    Receive the point
 *
 * Return: 
 *  None 
 *  
 *******************************************************************************/
-void `$INSTANCE_NAME`_Clear(int32 color)
+void `$INSTANCE_NAME`_PolarToXY(int32 x0, int32 y0, int32 radius, int32 angle, int32 *x, int32 *y)
 {
-    int32 i;
+    *x = x0 + (`$INSTANCE_NAME`_FloorDiv((radius * `$INSTANCE_NAME`_SinQ15(angle)) + 16384, 32768));
+    *y = y0 + (`$INSTANCE_NAME`_FloorDiv((radius * `$INSTANCE_NAME`_CosQ15(angle)) + 16384, 32768));
+}
 
-	`$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_PAGEADDR);
-	`$INSTANCE_NAME`_Data(`$INSTANCE_NAME`_MINX);
-	`$INSTANCE_NAME`_Data(`$INSTANCE_NAME`_MAXX);
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_FillSpan
+********************************************************************************
+*
+* Summary:
+*  Fill the pixels y0..y1 of row x, clipped.  A one pixel wide window is
+*  contiguous, so the span costs a single address setup.
+*
+* Parameters:
+*  x:       Row of the span
+*  y0, y1:  First and last pixel of the span (y0 <= y1)
+*  color:   Fill color
+*
+* Return:
+*  None
+*******************************************************************************/
+static void `$INSTANCE_NAME`_FillSpan(int32 x, int32 y0, int32 y1, int32 color)
+{
+    if(y0 <= y1)
+    {
+        `$INSTANCE_NAME`_FillArea(x, y0, x, y1, color);
+    }
+}
 
-	`$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_COLADDR);
-	`$INSTANCE_NAME`_Data(`$INSTANCE_NAME`_MINY);
-	`$INSTANCE_NAME`_Data(`$INSTANCE_NAME`_MAXY);
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_FillDisc
+********************************************************************************
+*
+* Summary:
+*  Walk a filled circle row by row.  The same Bresenham walk as
+*  `$INSTANCE_NAME`_DrawCircle() gives the edge, so a filled circle and its outline
+*  line up exactly.  Each row of the disc is visited once.
+*
+* Parameters:  
+*  x0, y0: Center of circle
+*  radius: Radius of circle
+*  color:  Fill color
+*  sector: Part of the disc to fill, NULL for all of it
+*
+* Return: 
+*  None 
+*  
+*******************************************************************************/
+static void `$INSTANCE_NAME`_FillDisc(int32 x0, int32 y0, int32 radius, int32 color, const `$INSTANCE_NAME`_SECTOR *sector)
+{
+	int32 f = 1 - radius;
+	int32 ddF_x = 0;
+	int32 ddF_y = -2 * radius;
+	int32 x = 0;
+	int32 y = radius;
 
-	`$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_RAMWR);
+	if (`$INSTANCE_NAME`_ClipBox(x0 - radius, y0 - radius, x0 + radius, y0 + radius) == `$INSTANCE_NAME`_CLIP_OUT)
+	{
+		return;
+	}
 
+	`$INSTANCE_NAME`_DiscRow(x0, y0, 0, radius, color, sector);
 
-	for( i=0; i < (`$INSTANCE_NAME`_MAXX*`$INSTANCE_NAME`_MAXY)/2; i++)
+	while(x < y)
 	{
-		`$INSTANCE_NAME`_Data((color>>4)&0x00FF);
-		`$INSTANCE_NAME`_Data(((color&0x0F)<<4)|(color>>8));
-		`$INSTANCE_NAME`_Data(color&0x0FF);
-	}
+		if(f >= 0)
+		{
+			/* Last step on rows +/-y: they are now complete */
+			`$INSTANCE_NAME`_DiscRow(x0, y0, y, x, color, sector);
+			`$INSTANCE_NAME`_DiscRow(x0, y0, -y, x, color, sector);
+			y--;
+			ddF_y += 2;
+			f += ddF_y;
+		}
+		x++;
+		ddF_x += 2;
+		f += ddF_x + 1;
 
-	`$INSTANCE_NAME`_x_offset = 0;
-	`$INSTANCE_NAME`_y_offset = 0;
+		if(x <= y)
+		{
+			`$INSTANCE_NAME`_DiscRow(x0, y0, x, y, color, sector);
+			`$INSTANCE_NAME`_DiscRow(x0, y0, -x, y, color, sector);
+		}
+	}
 }
 
-
 /*******************************************************************************
-* Function Name: `$INSTANCE_NAME`_Contrast
+* Function Name: `$INSTANCE_NAME`_FillCircle
 ********************************************************************************
 *
 * Summary:
-*  Set color contrast  
+*  Draw a filled circle.  Each row is written once as a single span, no pixel
+*  is written twice, and rows outside the clip rectangle are dropped.
 *
 * Parameters:  
-*  setting: Contrast value.  
+*  x0, y0: Center of circle
+*  radius: Radius of circle
+*  color:  Fill color
 *
 * Return: 
 *  None 
 *  
 *******************************************************************************/
-void `$INSTANCE_NAME`_Contrast(int32 setting)
+void `$INSTANCE_NAME`_FillCircle(int32 x0, int32 y0, int32 radius, int32 color)
 {
-    setting &= `$INSTANCE_NAME`_CONST_MASK;	                /* Mask off contrast value */
-    `$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_SETCONST);	/* Set Contrast            */
-    `$INSTANCE_NAME`_Data(setting);	                    
+	if(radius >= 0)
+	{
+		`$INSTANCE_NAME`_FillDisc(x0, y0, radius, color, NULL);
+	}
+}
 
-#if(`$INSTANCE_NAME`_Controller == `$INSTANCE_NAME`_EPSON)  /* Only required for Epson */
-    `$INSTANCE_NAME`_Data(3);			
-#endif
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_SetHalfPlane
+********************************************************************************
+*
+* Summary:
+*  Set up the half plane of directions [angle, angle + 180) degrees.
+*
+*******************************************************************************/
+static void `$INSTANCE_NAME`_SetHalfPlane(`$INSTANCE_NAME`_HALFPLANE *hp, int32 angle)
+{
+    hp->cs = `$INSTANCE_NAME`_CosQ15(`$INSTANCE_NAME`_DEG(angle));
+    hp->sn = `$INSTANCE_NAME`_SinQ15(`$INSTANCE_NAME`_DEG(angle));
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_FloorDiv
+********************************************************************************
+*
+* Summary:
+*  n / d rounded towards minus infinity, for d > 0.
+*
+*******************************************************************************/
+static int32 `$INSTANCE_NAME`_FloorDiv(int32 n, int32 d)
+{
+    int32 q = n / d;
 
+    if(((q * d) != n) && (n < 0))
+    {
+        q--;
+    }
+    return q;
 }
 
 /*******************************************************************************
-* Function Name: `$INSTANCE_NAME`_SwapColors
+* Function Name: `$INSTANCE_NAME`_HalfPlaneRow
 ********************************************************************************
 *
 * Summary:
-*   Swaps colors between Epson and Philips mode.  
+*  Narrow the span [lo, hi] on row v to the pixels inside (or, with inside
+*  zero, outside) a half plane.  A pixel p is inside when cross(a, p) > 0,
+*  or when it lies on the ray at a itself; the apex is never inside.  The
+*  edge function is linear along the row, so the boundary is one division.
 *
 * Parameters:  
-*  prtValue:  The value  
+*  hp:      Half plane
+*  v:       Row offset from the apex
+*  inside:  Nonzero to keep the inside, zero to keep the outside
+*  lo, hi:  Span of column offsets, narrowed in place (lo > hi when empty)
 *
-* Return: 
-*  None 
-*  Added by Steve Sparks @ Big Nerd Ranch.
-*  This swaps the Epson RGB order into the Philips RGB order. (Or, vice versa, I suppose.)
 *******************************************************************************/
-int32 `$INSTANCE_NAME`_SwapColors(int32 in)
+static void `$INSTANCE_NAME`_HalfPlaneRow(const `$INSTANCE_NAME`_HALFPLANE *hp, int32 v, uint32 inside, int32 *lo, int32 *hi)
 {
-    return ((in & 0x000F)<<8)|(in & 0x00F0)|((in & 0x0F00)>>8);
+    int32 q = hp->cs * v;
+    int32 edge;
+
+    if(hp->sn > 0)
+    {
+        /* Inside is u <= edge */
+        edge = `$INSTANCE_NAME`_FloorDiv(q - ((v > 0) ? 0 : 1), hp->sn);
+        if(inside != 0u)
+        {
+            if(*hi > edge) { *hi = edge; }
+        }
+        else
+        {
+            if(*lo <= edge) { *lo = edge + 1; }
+        }
+    }
+    else if(hp->sn < 0)
+    {
+        /* Inside is u >= edge */
+        edge = -`$INSTANCE_NAME`_FloorDiv(q - ((v < 0) ? 0 : 1), -hp->sn);
+        if(inside != 0u)
+        {
+            if(*lo < edge) { *lo = edge; }
+        }
+        else
+        {
+            if(*hi >= edge) { *hi = edge - 1; }
+        }
+    }
+    else if(v != 0)
+    {
+        /* Edge along the row: the whole row is in or out */
+        if(((hp->cs > 0) == (v > 0)) != (inside != 0u))
+        {
+            *hi = *lo - 1;
+        }
+    }
+    else
+    {
+        /* The row through the apex, along the edge itself: inside is */
+        /* u > 0 when cs > 0 and u < 0 otherwise                      */
+        edge = (hp->cs > 0) ? 1 : 0;
+        if((hp->cs > 0) == (inside != 0u))
+        {
+            if(*lo < edge) { *lo = edge; }
+        }
+        else
+        {
+            if(*hi >= edge) { *hi = edge - 1; }
+        }
+    }
 }
+
 /*******************************************************************************
-* Function Name: `$INSTANCE_NAME`_Pixel
+* Function Name: `$INSTANCE_NAME`_DiscRow
 ********************************************************************************
 *
 * Summary:
-*  Draw Pixel  
+*  Fill one row of a disc, or the part of it inside a sector.  A sector row
+*  is at most two spans, which are merged when they touch.  The apex pixel
+*  belongs to every non-empty sector.
 *
 * Parameters:  
-*  x,y:    Location to draw the pixel
-*  color:  Color of the pixel
+*  x0, y0:  Center of the disc
+*  v:       Row offset from the center
+*  h:       Half width of the disc on this row
+*  color:   Fill color
+*  sector:  Sector to fill, NULL for the whole row
 *
-* Return: 
-*  None 
 *******************************************************************************/
-void `$INSTANCE_NAME`_Pixel(int32 x, int32 y, int32 color)
+static void `$INSTANCE_NAME`_DiscRow(int32 x0, int32 y0, int32 v, int32 h, int32 color, const `$INSTANCE_NAME`_SECTOR *sector)
 {
-    y =	(`$INSTANCE_NAME`_COL_HEIGHT - 1) - y;
-    x = (`$INSTANCE_NAME`_ROW_LENGTH - 1) - x;
-
-#if (`$INSTANCE_NAME`_Controller == `$INSTANCE_NAME`_EPSON) /* EPSON     */
-	`$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_PAGEADDR);    /* Set page  */
-	`$INSTANCE_NAME`_Data(x);
-	`$INSTANCE_NAME`_Data(`$INSTANCE_NAME`_ENDPAGE);
+    int32 lo[2] = {1, 1};
+    int32 hi[2] = {0, 0};
+    uint32 i;
 
-	`$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_COLADDR);     /* Set column */
-	`$INSTANCE_NAME`_Data(y);
-	`$INSTANCE_NAME`_Data(`$INSTANCE_NAME`_ENDCOL);
+    if(sector == NULL)
+    {
+        `$INSTANCE_NAME`_FillSpan(x0 + v, y0 - h, y0 + h, color);
+        return;
+    }
+    if((v < sector->vMin) || (v > sector->vMax))
+    {
+        return;
+    }
 
-	`$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_RAMWR);       /* Write color data */
-	`$INSTANCE_NAME`_Data((color>>4)&0x00FF);
-	`$INSTANCE_NAME`_Data(((color&0x0F)<<4)|(color>>8));
-	`$INSTANCE_NAME`_Data(color&0x0FF);
-#endif
+    for(i = 0u; i < sector->pieces; i++)
+    {
+        lo[i] = -h;
+        hi[i] = h;
+        `$INSTANCE_NAME`_HalfPlaneRow(&sector->from[i], v, 1u, &lo[i], &hi[i]);
+        if(sector->hasTo[i] != 0u)
+        {
+            `$INSTANCE_NAME`_HalfPlaneRow(&sector->to[i], v, 0u, &lo[i], &hi[i]);
+        }
+    }
 
-#if (`$INSTANCE_NAME`_Controller == `$INSTANCE_NAME`_PHILIPS) /* PHILIPS   */
-	`$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_PAGEADDR);      /* Set page  */
-	`$INSTANCE_NAME`_Data((uint8)x);
-	`$INSTANCE_NAME`_Data((uint8)x);
+    if(v == 0)
+    {
+        /* Add the apex to the first piece */
+        if(lo[0] > hi[0])
+        {
+            lo[0] = 0;
+            hi[0] = 0;
+        }
+        else if(hi[0] == -1)
+        {
+            hi[0] = 0;
+        }
+        else if(lo[0] == 1)
+        {
+            lo[0] = 0;
+        }
+    }
 
-	`$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_COLADDR);       /* Set column */
-	`$INSTANCE_NAME`_Data((uint8)y);
-	`$INSTANCE_NAME`_Data((uint8)y);
+    if((sector->pieces == 2u) && (lo[0] <= hi[0]) && (lo[1] <= hi[1]))
+    {
+        if((hi[0] + 1) == lo[1])
+        {
+            hi[0] = hi[1];
+            lo[1] = 1;
+            hi[1] = 0;
+        }
+        else if((hi[1] + 1) == lo[0])
+        {
+            lo[0] = lo[1];
+            lo[1] = 1;
+            hi[1] = 0;
+        }
+        else
+        {
+            /* Two separate spans */
+        }
+    }
 
-	`$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_RAMWR);         /* Write color data */
-	`$INSTANCE_NAME`_Data((uint8)((color>>4)&0x00FF));
-	`$INSTANCE_NAME`_Data((uint8)(((color&0x0F)<<4)|0x00));
-#endif
+    for(i = 0u; i < sector->pieces; i++)
+    {
+        if(lo[i] <= hi[i])
+        {
+            `$INSTANCE_NAME`_FillSpan(x0 + v, y0 + lo[i], y0 + hi[i], color);
+        }
+    }
 }
 
 /*******************************************************************************
-* Function Name: `$INSTANCE_NAME`_DrawCircle
+* Function Name: `$INSTANCE_NAME`_FillSector
 ********************************************************************************
 *
 * Summary:
-*  Draw a circle on the display given a start point and radius.  
+*  Fill the sector (wedge) of a disc between two angles.  Angles are in
+*  degrees, 0 pointing along +y and 90 along +x, and the sector covers
+*  startAngle up to but not including endAngle.  Sectors that share an edge
+*  therefore never overlap (apart from the apex), so an opening or closing
+*  wedge can be animated by filling just the thin sector between the old
+*  and new angle.  The disc edge is the same as `$INSTANCE_NAME`_FillCircle().
 *
-*  This code uses Bresenham's Circle Algorithm. 
+*  The sector is cut into convex pieces of up to 180 degrees, each the
+*  intersection of two half planes.  Per row the edge functions are solved
+*  with integer arithmetic and the result streamed as at most two spans.
 *
 * Parameters:  
-*  x0, y0: Center of circle
-*  radius: Radius of circle
-*  color:  Color of circle
+*  x0, y0:      Center of the disc
+*  radius:      Radius of the disc
+*  startAngle:  First angle of the sector, degrees
+*  endAngle:    End angle of the sector (exclusive), degrees; a sweep of
+*               360 or more fills the whole disc
+*  color:       Fill color
 *
 * Return: 
 *  None 
 *  
 *******************************************************************************/
-void `$INSTANCE_NAME`_DrawCircle (int32 x0, int32 y0, int32 radius, int32 color)
+void `$INSTANCE_NAME`_FillSector(int32 x0, int32 y0, int32 radius, int32 startAngle, int32 endAngle, int32 color)
 {
-	int32 f = 1 - radius;
-	int32 ddF_x = 0;
-	int32 ddF_y = -2 * radius;
-	int32 x = 0;
-	int32 y = radius;
+    `$INSTANCE_NAME`_SECTOR sector;
+    `$INSTANCE_NAME`_HALFPLANE end;
+    int32 sweep = endAngle - startAngle;
+    int32 start;
 
-	`$INSTANCE_NAME`_Pixel(x0, y0 + radius, color);
-	`$INSTANCE_NAME`_Pixel(x0, y0 - radius, color);
-	`$INSTANCE_NAME`_Pixel( x0 + radius, y0, color);
-	`$INSTANCE_NAME`_Pixel( x0 - radius, y0, color);
+    if((radius < 0) || (sweep <= 0))
+    {
+        return;
+    }
+    if(sweep >= 360)
+    {
+        `$INSTANCE_NAME`_FillDisc(x0, y0, radius, color, NULL);
+        return;
+    }
 
-	while(x < y)
-	{
-		if(f >= 0)
-		{
-			y--;
-			ddF_y += 2;
-			f += ddF_y;
-		}
-		x++;
-		ddF_x += 2;
-		f += ddF_x + 1;
+    start = startAngle % 360;
+    if(start < 0)
+    {
+        start += 360;
+    }
 
-		`$INSTANCE_NAME`_Pixel(x0 + x, y0 + y, color);
-		`$INSTANCE_NAME`_Pixel(x0 - x, y0 + y, color);
-		`$INSTANCE_NAME`_Pixel( x0 + x, y0 - y, color);
-		`$INSTANCE_NAME`_Pixel( x0 - x, y0 - y, color);
-		`$INSTANCE_NAME`_Pixel( x0 + y, y0 + x, color);
-		`$INSTANCE_NAME`_Pixel( x0 - y, y0 + x, color);
-		`$INSTANCE_NAME`_Pixel( x0 + y, y0 - x, color);
-		`$INSTANCE_NAME`_Pixel( x0 - y, y0 - x, color);
-	}
+    `$INSTANCE_NAME`_SetHalfPlane(&sector.from[0], start);
+    `$INSTANCE_NAME`_SetHalfPlane(&end, start + sweep);
+    sector.pieces = 1u;
+    sector.hasTo[0] = (sweep < 180) ? 1u : 0u;
+    sector.to[0] = end;
+    if(sweep > 180)
+    {
+        sector.pieces = 2u;
+        `$INSTANCE_NAME`_SetHalfPlane(&sector.from[1], start + 180);
+        sector.to[1] = end;
+        sector.hasTo[1] = 1u;
+    }
+
+    /* Rows spanned by the apex and both end points, widened by one for    */
+    /* rounding, or the top/bottom of the disc if the sector reaches 90 or */
+    /* 270 degrees.                                                        */
+    sector.vMin = `$INSTANCE_NAME`_FloorDiv(radius * ((sector.from[0].sn < end.sn) ? sector.from[0].sn : end.sn), 32768) - 1;
+    sector.vMax = `$INSTANCE_NAME`_FloorDiv(radius * ((sector.from[0].sn > end.sn) ? sector.from[0].sn : end.sn), 32768) + 1;
+    if(sector.vMin > 0)
+    {
+        sector.vMin = 0;
+    }
+    if(sector.vMax < 0)
+    {
+        sector.vMax = 0;
+    }
+    if(((450 - start) % 360) < sweep)
+    {
+        sector.vMax = radius;
+    }
+    if(((630 - start) % 360) < sweep)
+    {
+        sector.vMin = -radius;
+    }
+
+    `$INSTANCE_NAME`_FillDisc(x0, y0, radius, color, &sector);
 }
 
 /*******************************************************************************
@@ -396,7 +2916,8 @@ void `$INSTANCE_NAME`_DrawCircle (int32 x0, int32 y0, int32 radius, int32 color)
 ********************************************************************************
 *
 * Summary:
-*  Print a character on the display.  
+*  Print a character on the display.  A character cut by the clip rectangle
+*  is drawn pixel by pixel, one outside it not at all.
 *
 * Parameters:  
 *  c:       ASCII character to be printed
@@ -410,9 +2931,6 @@ void `$INSTANCE_NAME`_DrawCircle (int32 x0, int32 y0, int32 radius, int32 color)
 *******************************************************************************/
 void `$INSTANCE_NAME`_PrintChar(uint8 c, int32 x, int32 y, int32 fColor, int32 bColor)
 {
-	y	=	(`$INSTANCE_NAME`_COL_HEIGHT - 1) - y; /* make display "right" side up */
-	x	=	(`$INSTANCE_NAME`_ROW_LENGTH - 2) - x;
-
 	int32             i,j;
 	int32    nCols;
 	int32    nRows;
@@ -423,6 +2941,7 @@ void `$INSTANCE_NAME`_PrintChar(uint8 c, int32 x, int32 y, int32 fColor, int32 b
 	int32    Word1;
 	uint8   *pFont;
 	uint8   *pChar;
+	uint32   clip;
 
 	/* Get pointer to the beginning of the selected font table  */
 	pFont = (uint8 *)`$INSTANCE_NAME`_FONT8x16;
@@ -432,24 +2951,38 @@ void `$INSTANCE_NAME`_PrintChar(uint8 c, int32 x, int32 y, int32 fColor, int32 b
 	nRows = *(pFont + 1);
 	nBytes = *(pFont + 2);
 	
-	/* Get pointer to the last byte of the desired character    */
+	/* Get pointer to the byte just before the desired character; the cell  */
+	/* starts one blank row above the glyph                                 */
 	pChar = pFont + (nBytes * (c - 0x1F)) + nBytes - 1;
 
-#if (`$INSTANCE_NAME`_Controller == `$INSTANCE_NAME`_EPSON)
-	/* Row address set */
-	`$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_PAGEADDR);
-	`$INSTANCE_NAME`_Data(x);
-	`$INSTANCE_NAME`_Data((x + nRows - 1));
-	/* Column address set */
-	`$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_COLADDR);
-	`$INSTANCE_NAME`_Data(y);
-	`$INSTANCE_NAME`_Data((y + nCols - 1));
-
-	/* Write Memory */
-	`$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_RAMWR);
-	/* Loop on each row, working backwards from the bottom to the top  */
-	for (i = nRows - 1; i >= 0; i--) {
-		/* Copy pixel row from font table and then decrement row       */
+	clip = `$INSTANCE_NAME`_ClipBox(x - (nRows - 2), y - (nCols - 1), x + 1, y);
+	if (clip == `$INSTANCE_NAME`_CLIP_OUT)
+	{
+		return;
+	}
+	if (clip == `$INSTANCE_NAME`_CLIP_PART)
+	{
+		for (i = 0; i < nRows; i++) {
+			PixelRow = *pChar++;
+			for (j = 0; j < nCols; j++) {
+				`$INSTANCE_NAME`_Pixel(x - (nRows - 2) + i, y - (nCols - 1) + j,
+				         ((PixelRow & (0x80u >> j)) != 0u) ? fColor : bColor);
+			}
+		}
+		return;
+	}
+
+	/* Colors as sent in the current color mode                 */
+	fColor = (int32)`$INSTANCE_NAME`_PixelValue(fColor);
+	bColor = (int32)`$INSTANCE_NAME`_PixelValue(bColor);
+
+	/* The cell ends at row x + 1 and column y, and fills a row at a time   */
+	`$INSTANCE_NAME`_SetScan(`$INSTANCE_NAME`_SCAN_ROWS);
+	`$INSTANCE_NAME`_SetWindow(x - (nRows - 2), y - (nCols - 1), x + 1, y);
+
+	/* Loop on each row, from the top down */
+	for (i = 0; i < nRows; i++) {
+		/* Copy pixel row from font table and then move to the next row */
 		PixelRow = *pChar++;
 		/* Loop on each pixel in the row (left to right)               */
 		/* Note: we do two pixels each loop                            */
@@ -477,56 +3010,11 @@ void `$INSTANCE_NAME`_PrintChar(uint8 c, int32 x, int32 y, int32 fColor, int32 b
 				Word1 = fColor;
 			}
 			Mask = Mask >> 1;
-			/* Use this information to output three data bytes  */
-			`$INSTANCE_NAME`_Data((uint8)((Word0 >> 4) & 0xFF));
-			`$INSTANCE_NAME`_Data((uint8)(((Word0 & 0xF) << 4) | ((Word1 >> 8) & 0xF)));
-			`$INSTANCE_NAME`_Data((uint8)(Word1 & 0xFF));
-		}
-	}
-#endif
-
-#if (`$INSTANCE_NAME`_Controller == `$INSTANCE_NAME`_PHILIPS)
-
-	/* Set row address     */
-	`$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_PAGEADDR);
-	`$INSTANCE_NAME`_Data((uint8)x);
-	`$INSTANCE_NAME`_Data((uint8)(x + nRows - 1));
-    /* Set column address  */
-	`$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_COLADDR);
-	`$INSTANCE_NAME`_Data((uint8)y);
-	`$INSTANCE_NAME`_Data((uint8)(y + nCols - 1));
-
-	/* Write to display memory */
-	`$INSTANCE_NAME`_Command(`$INSTANCE_NAME`_RAMWR);
-	/* loop on each row, working backwards from the bottom to the top.  */
-	pChar+=nBytes-1;  /* Stick pChar at the end of the row, need to reverse print on phillips */
-	for (i = nRows - 1; i >= 0; i--) {
-		/* copy pixel row from font table and then decrement row.  */
-		PixelRow = *pChar--;
-		/* Loop on each pixel in the row (left to right)  */
-		/* Note: we do two pixels each loop               */
-		Mask = 0x01;  
-		for (j = 0; j < nCols; j += 2) 
-		{
-			/* If pixel bit set, use foreground color; else use the background color  */
-			/* Get the pixel color for two successive pixels                          */
-			if ((PixelRow & Mask) == 0)
-				Word0 = bColor;
-			else
-				Word0 = fColor;
-			Mask = Mask << 1; 
-			if ((PixelRow & Mask) == 0)
-				Word1 = bColor;
-			else
-				Word1 = fColor;
-			Mask = Mask << 1; 
-			/* use this information to output three data bytes */
-			`$INSTANCE_NAME`_Data((Word0 >> 4) & 0xFF);
-			`$INSTANCE_NAME`_Data(((Word0 & 0xF) << 4) | ((Word1 >> 8) & 0xF));
-			`$INSTANCE_NAME`_Data(Word1 & 0xFF);
+			/* Use this information to output the two pixels    */
+			`$INSTANCE_NAME`_WritePair((uint32)Word0, (uint32)Word1);
 		}
 	}
-#endif
+	`$INSTANCE_NAME`_CountPixels((uint32)(nRows * nCols));
 }
 
 /*******************************************************************************
@@ -574,7 +3062,15 @@ void `$INSTANCE_NAME`_PrintString(char *pString, int32 x, int32 y, int32 fColor,
 ********************************************************************************
 *
 * Summary:
-*  Draw a line on the display.  
+*  Draw a line on the display.  Horizontal and vertical lines go to
+*  `$INSTANCE_NAME`_DrawHLine() / `$INSTANCE_NAME`_DrawVLine(); other lines are sent as one
+*  window per run of pixels on the major axis.
+*
+*  The outcodes of the endpoints (Cohen-Sutherland) drop a line that is all
+*  on the far side of one edge of the clip rectangle.  A line that crosses
+*  an edge is not cut at the crossing, which would light different pixels
+*  near it: the steps whose pixels are inside are solved for instead, and
+*  the walk starts at the first of them.
 *
 * Parameters:  
 *  x0, y0:  The beginning endpoint
@@ -590,6 +3086,29 @@ void `$INSTANCE_NAME`_DrawLine(int32 x0, int32 y0, int32 x1, int32 y1, int32 col
 	int32 dy = y1 - y0; /* Difference between y0 and y1 */
 	int32 dx = x1 - x0; /* Difference between x0 and x1 */
 	int32 stepx, stepy;
+	int32 first, last;  /* Steps of the major axis inside the clip    */
+	int32 minFirst;     /* and the same for the minor axis            */
+	int32 minLast;
+	int32 minor;
+	uint32 code0 = `$INSTANCE_NAME`_ClipCode(x0, y0);
+	uint32 code1 = `$INSTANCE_NAME`_ClipCode(x1, y1);
+
+	if ((code0 & code1) != 0u)
+	{
+		return;
+	}
+
+	/* Axis-aligned lines are a single window */
+	if (dx == 0)
+	{
+		`$INSTANCE_NAME`_DrawHLine(x0, y0, y1, color);
+		return;
+	}
+	if (dy == 0)
+	{
+		`$INSTANCE_NAME`_DrawVLine(x0, x1, y0, color);
+		return;
+	}
 
 	if (dy < 0)
 	{
@@ -611,42 +3130,149 @@ void `$INSTANCE_NAME`_DrawLine(int32 x0, int32 y0, int32 x1, int32 y1, int32 col
 		stepx = 1;
 	}
 
+	/* After k steps the minor axis has moved (2*k*minor + major) / (2*major) */
+	/* pixels.  For a line that crosses an edge, find the steps whose pixels */
+	/* are inside on both axes.                                               */
+	first = 0;
+	if (dx > dy)
+	{
+		last = dx;
+		if ((code0 | code1) != 0u)
+		{
+			minFirst = 0;
+			minLast = dy;
+			`$INSTANCE_NAME`_StepRange(x0, stepx, `$INSTANCE_NAME`_clipX0, `$INSTANCE_NAME`_clipX1, &first, &last);
+			`$INSTANCE_NAME`_StepRange(y0, stepy, `$INSTANCE_NAME`_clipY0, `$INSTANCE_NAME`_clipY1, &minFirst, &minLast);
+			minFirst = -`$INSTANCE_NAME`_FloorDiv(dx - (2 * dx * minFirst), 2 * dy);
+			minLast = `$INSTANCE_NAME`_FloorDiv((2 * dx * minLast) + dx - 1, 2 * dy);
+			first = (minFirst > first) ? minFirst : first;
+			last = (minLast < last) ? minLast : last;
+		}
+		minor = ((2 * dy * first) + dx) / (2 * dx);
+	}
+	else
+	{
+		last = dy;
+		if ((code0 | code1) != 0u)
+		{
+			minFirst = 0;
+			minLast = dx;
+			`$INSTANCE_NAME`_StepRange(y0, stepy, `$INSTANCE_NAME`_clipY0, `$INSTANCE_NAME`_clipY1, &first, &last);
+			`$INSTANCE_NAME`_StepRange(x0, stepx, `$INSTANCE_NAME`_clipX0, `$INSTANCE_NAME`_clipX1, &minFirst, &minLast);
+			minFirst = -`$INSTANCE_NAME`_FloorDiv(dy - (2 * dy * minFirst), 2 * dx);
+			minLast = `$INSTANCE_NAME`_FloorDiv((2 * dy * minLast) + dy - 1, 2 * dx);
+			first = (minFirst > first) ? minFirst : first;
+			last = (minLast < last) ? minLast : last;
+		}
+		minor = ((2 * dx * first) + dy) / (2 * dy);
+	}
+	if (first > last)
+	{
+		return;
+	}
+
 	dy <<= 1; /* dy is now 2*dy  */
 	dx <<= 1; /* dx is now 2*dx  */
-	`$INSTANCE_NAME`_Pixel(x0, y0, color);
 
+	/* Pixels that share a row or column are sent as one run, so only the  */
+	/* steps of the minor axis cost a new address window.                  */
 	if (dx > dy) 
 	{
-		int fraction = dy - (dx >> 1);
+		int fraction = (dy - (dx >> 1)) + (dy * first) - (dx * minor);
+		int32 runStart;
+		x1 = x0 + (stepx * last);
+		x0 += stepx * first;
+		y0 += stepy * minor;
+		runStart = x0;
 		while (x0 != x1)
 		{
 			if (fraction >= 0)
 			{
+				`$INSTANCE_NAME`_FillArea(runStart, y0, x0, y0, color);
+				runStart = x0 + stepx;
 				y0 += stepy;
 				fraction -= dx;
 			}
 			x0 += stepx;
 			fraction += dy;
-			`$INSTANCE_NAME`_Pixel(x0, y0, color);
 		}
+		`$INSTANCE_NAME`_FillArea(runStart, y0, x0, y0, color);
 	}
 	else
 	{
-		int fraction = dx - (dy >> 1);
+		int fraction = (dx - (dy >> 1)) + (dx * first) - (dy * minor);
+		int32 runStart;
+		y1 = y0 + (stepy * last);
+		y0 += stepy * first;
+		x0 += stepx * minor;
+		runStart = y0;
 		while (y0 != y1)
 		{
 			if (fraction >= 0)
 			{
+				`$INSTANCE_NAME`_FillArea(x0, runStart, x0, y0, color);
+				runStart = y0 + stepy;
 				x0 += stepx;
 				fraction -= dy;
 			}
 			y0 += stepy;
 			fraction += dx;
-			`$INSTANCE_NAME`_Pixel( x0, y0, color);
 		}
+		`$INSTANCE_NAME`_FillArea(x0, runStart, x0, y0, color);
+	}
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_DrawHLine
+********************************************************************************
+*
+* Summary:
+*  Draw a horizontal line along row x: one address window and a run of
+*  color data.  The line is clipped.
+*
+* Parameters:  
+*  x:       Row of the line
+*  y0, y1:  The two endpoints, in either order
+*  color:   Color of the line.
+*
+* Return: 
+*  None 
+*  
+*******************************************************************************/
+void `$INSTANCE_NAME`_DrawHLine(int32 x, int32 y0, int32 y1, int32 color)
+{
+	if (y0 > y1)
+	{
+		`$INSTANCE_NAME`_FillSpan(x, y1, y0, color);
+	}
+	else
+	{
+		`$INSTANCE_NAME`_FillSpan(x, y0, y1, color);
 	}
 }
 
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_DrawVLine
+********************************************************************************
+*
+* Summary:
+*  Draw a vertical line down column y: one address window and a run of
+*  color data.  The line is clipped.
+*
+* Parameters:  
+*  x0, x1:  The two endpoints, in either order
+*  y:       Column of the line
+*  color:   Color of the line.
+*
+* Return: 
+*  None 
+*  
+*******************************************************************************/
+void `$INSTANCE_NAME`_DrawVLine(int32 x0, int32 x1, int32 y, int32 color)
+{
+	`$INSTANCE_NAME`_FillArea(x0, y, x1, y, color);
+}
+
 /*******************************************************************************
 * Function Name: `$INSTANCE_NAME`_DrawRect
 ********************************************************************************
@@ -666,41 +3292,19 @@ void `$INSTANCE_NAME`_DrawLine(int32 x0, int32 y0, int32 x1, int32 y1, int32 col
 *******************************************************************************/
 void `$INSTANCE_NAME`_DrawRect(int32 x0, int32 y0, int32 x1, int32 y1, int32 fill, int32 color)
 {	
-     int xDiff;
 	/* Check if the rectangle is to be filled    */
 	if (fill != 0)
 	{	
-        /* Find the difference between the x vars */
-		if(x0 > x1)
-		{
-			xDiff = x0 - x1; 
-		}
-		else
-		{
-			xDiff = x1 - x0;
-		}
-	
-	    /* Fill it with lines  */
-		while(xDiff >= 0)
-		{
-			`$INSTANCE_NAME`_DrawLine(x0, y0, x0, y1, color);
-		
-			if(x0 > x1)
-				x0--;
-			else
-				x0++;
-		
-			xDiff--;
-		}
-
+	    /* Fill it as a single window  */
+		`$INSTANCE_NAME`_FillArea(x0, y0, x1, y1, color);
 	}
 	else 
 	{
 		/* Draw the four sides of the rectangle */
-		`$INSTANCE_NAME`_DrawLine(x0, y0, x1, y0, color);
-		`$INSTANCE_NAME`_DrawLine(x0, y1, x1, y1, color);
-		`$INSTANCE_NAME`_DrawLine(x0, y0, x0, y1, color);
-		`$INSTANCE_NAME`_DrawLine(x1, y0, x1, y1, color);
+		`$INSTANCE_NAME`_DrawVLine(x0, x1, y0, color);
+		`$INSTANCE_NAME`_DrawVLine(x0, x1, y1, color);
+		`$INSTANCE_NAME`_DrawHLine(x0, y0, y1, color);
+		`$INSTANCE_NAME`_DrawHLine(x1, y0, y1, color);
 	}
 }
 
@@ -0,0 +1,290 @@
+/*******************************************************************************
+* File Name: `$INSTANCE_NAME`_Input.c
+* Version `$CY_MAJOR_VERSION`.`$CY_MINOR_VERSION`
+*
+*  Description:
+*    Buttons on GPIO interrupts.  A port interrupt notes the time of each
+*    edge of a button pin; once the pin has been quiet for the debounce time
+*    the SysTick callback takes its level, and if that changed queues a
+*    pressed or released event stamped with the first edge.  A button kept
+*    down gives a held event, then repeats.  The queue has one writer, the
+*    SysTick interrupt, and one reader, the main loop, so it needs no lock.
+*
+*    Presses are caught however long the main loop takes over a frame, and
+*    their times are the times of the presses.
+*
+********************************************************************************/
+
+#include <stddef.h>
+#include "cytypes.h"
+#include "CyLib.h"
+#include "`$INSTANCE_NAME`.h"
+
+#define `$INSTANCE_NAME`_INPUT_F_DOWN      0x01u   /* debounced level: pressed      */
+#define `$INSTANCE_NAME`_INPUT_F_PENDING   0x02u   /* edges since the last look     */
+#define `$INSTANCE_NAME`_INPUT_F_HELD      0x04u   /* held event given              */
+#define `$INSTANCE_NAME`_INPUT_F_QUIET     0x08u   /* down from the start, no events */
+
+#if((`$INSTANCE_NAME`_INPUT_QUEUE & (`$INSTANCE_NAME`_INPUT_QUEUE - 1u)) != 0u)
+    #error `$INSTANCE_NAME`_INPUT_QUEUE must be a power of 2
+#endif
+
+typedef struct
+{
+    uint16 firstEdge;           /* first edge of a change                    */
+    uint16 lastEdge;            /* the latest edge, for the debounce time    */
+    uint16 next;                /* when the next held or repeat event is due */
+    uint8  flags;
+} `$INSTANCE_NAME`_INPUT_STATE;
+
+static const `$INSTANCE_NAME`_INPUT_PIN *`$INSTANCE_NAME`_inputPins = NULL;
+static uint32 `$INSTANCE_NAME`_inputCount = 0u;
+static `$INSTANCE_NAME`_INPUT_STATE `$INSTANCE_NAME`_inputState[`$INSTANCE_NAME`_INPUT_MAX];
+static volatile uint16 `$INSTANCE_NAME`_inputNow = 0u;
+
+static `$INSTANCE_NAME`_INPUT_EVENT `$INSTANCE_NAME`_inputQueue[`$INSTANCE_NAME`_INPUT_QUEUE];
+static volatile uint8 `$INSTANCE_NAME`_inputHead = 0u;     /* written by the SysTick interrupt */
+static volatile uint8 `$INSTANCE_NAME`_inputTail = 0u;     /* written by the main loop        */
+static volatile uint16 `$INSTANCE_NAME`_inputLost = 0u;
+
+static void `$INSTANCE_NAME`_InputTick(void);
+static void `$INSTANCE_NAME`_InputPush(uint32 button, uint32 type, uint16 time);
+static CY_ISR_PROTO(`$INSTANCE_NAME`_InputIsr);
+
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_InputStart
+********************************************************************************
+*
+* Summary:
+*  Watch the button pins: each pin interrupts on both edges, and its port
+*  interrupt is pointed at the input handler.  Buttons are numbered in the
+*  order of the table, pressed when the pin reads 0.  Starts the SysTick
+*  timer at 1 ms if it is not running already.
+*
+* Parameters:
+*  pins:   Table of pins, made with `$INSTANCE_NAME`_INPUT_PIN_INIT(); it is
+*          kept, not copied
+*  count:  Number of pins, up to `$INSTANCE_NAME`_INPUT_MAX
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_InputStart(const `$INSTANCE_NAME`_INPUT_PIN *pins, uint32 count)
+{
+    const `$INSTANCE_NAME`_INPUT_PIN *pin;
+    uint32 i;
+    uint8 intr;
+
+    count = (count > `$INSTANCE_NAME`_INPUT_MAX) ? `$INSTANCE_NAME`_INPUT_MAX : count;
+
+    intr = CyEnterCriticalSection();
+    `$INSTANCE_NAME`_inputPins = pins;
+    `$INSTANCE_NAME`_inputCount = count;
+    for(i = 0u; i < count; i++)
+    {
+        pin = &pins[i];
+        `$INSTANCE_NAME`_inputState[i].flags = ((*pin->ps & (1u << pin->shift)) == 0u) ?
+                                               (`$INSTANCE_NAME`_INPUT_F_DOWN | `$INSTANCE_NAME`_INPUT_F_QUIET) : 0u;
+        *pin->intcfg = (*pin->intcfg & ~(3u << (pin->shift * 2u))) | (3u << (pin->shift * 2u));
+        *pin->intstat = (1u << pin->shift);
+        (void)CyIntSetVector(pin->irq, &`$INSTANCE_NAME`_InputIsr);
+        CyIntEnable(pin->irq);
+    }
+    CyExitCriticalSection(intr);
+
+    CySysTickStart();
+    (void)CySysTickSetCallback(`$INSTANCE_NAME`_INPUT_SYSTICK_SLOT, &`$INSTANCE_NAME`_InputTick);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_InputRead
+********************************************************************************
+*
+* Summary:
+*  Take the oldest event off the queue.
+*
+* Parameters:
+*  event:  Filled in with the event
+*
+* Return:
+*  1 if there was one, 0 if the queue is empty
+*
+*******************************************************************************/
+uint32 `$INSTANCE_NAME`_InputRead(`$INSTANCE_NAME`_INPUT_EVENT *event)
+{
+    uint8 tail = `$INSTANCE_NAME`_inputTail;
+
+    if(tail == `$INSTANCE_NAME`_inputHead)
+    {
+        return (0u);
+    }
+    *event = `$INSTANCE_NAME`_inputQueue[tail];
+    `$INSTANCE_NAME`_inputTail = (uint8)((tail + 1u) & (`$INSTANCE_NAME`_INPUT_QUEUE - 1u));
+    return (1u);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_InputHeld
+********************************************************************************
+*
+* Summary:
+*  The buttons down now, debounced.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Bit n set while button n is down
+*
+*******************************************************************************/
+uint32 `$INSTANCE_NAME`_InputHeld(void)
+{
+    uint32 held = 0u;
+    uint32 i;
+
+    for(i = 0u; i < `$INSTANCE_NAME`_inputCount; i++)
+    {
+        if((`$INSTANCE_NAME`_inputState[i].flags & `$INSTANCE_NAME`_INPUT_F_DOWN) != 0u)
+        {
+            held |= (1u << i);
+        }
+    }
+    return (held);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_InputLost
+********************************************************************************
+*
+* Summary:
+*  Events dropped because the queue was full.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Number of events lost since the start
+*
+*******************************************************************************/
+uint32 `$INSTANCE_NAME`_InputLost(void)
+{
+    return (`$INSTANCE_NAME`_inputLost);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_InputIsr
+********************************************************************************
+*
+* Summary:
+*  Port interrupt for the button pins: clears their interrupts and notes
+*  the time of the edges.
+*
+*******************************************************************************/
+static CY_ISR(`$INSTANCE_NAME`_InputIsr)
+{
+    const `$INSTANCE_NAME`_INPUT_PIN *pin;
+    `$INSTANCE_NAME`_INPUT_STATE *st;
+    uint16 now = `$INSTANCE_NAME`_inputNow;
+    uint32 i;
+
+    for(i = 0u; i < `$INSTANCE_NAME`_inputCount; i++)
+    {
+        pin = &`$INSTANCE_NAME`_inputPins[i];
+        if((*pin->intstat & (1u << pin->shift)) != 0u)
+        {
+            *pin->intstat = (1u << pin->shift);
+            st = &`$INSTANCE_NAME`_inputState[i];
+            if((st->flags & `$INSTANCE_NAME`_INPUT_F_PENDING) == 0u)
+            {
+                st->firstEdge = now;
+                st->flags |= `$INSTANCE_NAME`_INPUT_F_PENDING;
+            }
+            st->lastEdge = now;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_InputTick
+********************************************************************************
+*
+* Summary:
+*  SysTick callback, every millisecond.  Takes the level of the pins that
+*  have been quiet for the debounce time since an edge, and gives held and
+*  repeat events for the buttons kept down.
+*
+*******************************************************************************/
+static void `$INSTANCE_NAME`_InputTick(void)
+{
+    `$INSTANCE_NAME`_INPUT_STATE *st;
+    const `$INSTANCE_NAME`_INPUT_PIN *pin;
+    uint16 now = `$INSTANCE_NAME`_inputNow + 1u;
+    uint32 down;
+    uint32 i;
+    uint8 intr;
+
+    `$INSTANCE_NAME`_inputNow = now;
+    for(i = 0u; i < `$INSTANCE_NAME`_inputCount; i++)
+    {
+        st = &`$INSTANCE_NAME`_inputState[i];
+        pin = &`$INSTANCE_NAME`_inputPins[i];
+
+        /* The port interrupt may come in between */
+        intr = CyEnterCriticalSection();
+        if(((st->flags & `$INSTANCE_NAME`_INPUT_F_PENDING) != 0u) &&
+           ((uint16)(now - st->lastEdge) >= `$INSTANCE_NAME`_INPUT_DEBOUNCE_MS))
+        {
+            st->flags &= (uint8)~`$INSTANCE_NAME`_INPUT_F_PENDING;
+            down = ((*pin->ps & (1u << pin->shift)) == 0u) ? `$INSTANCE_NAME`_INPUT_F_DOWN : 0u;
+            if(down != (st->flags & `$INSTANCE_NAME`_INPUT_F_DOWN))
+            {
+                st->flags &= (uint8)~(`$INSTANCE_NAME`_INPUT_F_DOWN | `$INSTANCE_NAME`_INPUT_F_HELD | `$INSTANCE_NAME`_INPUT_F_QUIET);
+                st->flags |= (uint8)down;
+                st->next = st->firstEdge + `$INSTANCE_NAME`_INPUT_HOLD_MS;
+                `$INSTANCE_NAME`_InputPush(i, (down != 0u) ? `$INSTANCE_NAME`_INPUT_PRESSED : `$INSTANCE_NAME`_INPUT_RELEASED,
+                                           st->firstEdge);
+            }
+        }
+
+        /* Held down since a press, and no edge since */
+        if(((st->flags & (`$INSTANCE_NAME`_INPUT_F_DOWN | `$INSTANCE_NAME`_INPUT_F_PENDING | `$INSTANCE_NAME`_INPUT_F_QUIET)) == `$INSTANCE_NAME`_INPUT_F_DOWN) &&
+           ((int16)(now - st->next) >= 0))
+        {
+            `$INSTANCE_NAME`_InputPush(i, ((st->flags & `$INSTANCE_NAME`_INPUT_F_HELD) == 0u) ?
+                                       `$INSTANCE_NAME`_INPUT_HELD : `$INSTANCE_NAME`_INPUT_REPEAT, now);
+            st->flags |= `$INSTANCE_NAME`_INPUT_F_HELD;
+            st->next = now + `$INSTANCE_NAME`_INPUT_REPEAT_MS;
+        }
+        CyExitCriticalSection(intr);
+    }
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_InputPush
+********************************************************************************
+*
+* Summary:
+*  Put an event on the queue, or count it lost if the queue is full.
+*
+*******************************************************************************/
+static void `$INSTANCE_NAME`_InputPush(uint32 button, uint32 type, uint16 time)
+{
+    `$INSTANCE_NAME`_INPUT_EVENT *e;
+    uint8 head = `$INSTANCE_NAME`_inputHead;
+    uint8 next = (uint8)((head + 1u) & (`$INSTANCE_NAME`_INPUT_QUEUE - 1u));
+
+    if(next == `$INSTANCE_NAME`_inputTail)
+    {
+        `$INSTANCE_NAME`_inputLost++;
+        return;
+    }
+    e = &`$INSTANCE_NAME`_inputQueue[head];
+    e->time = time;
+    e->button = (uint8)button;
+    e->type = (uint8)type;
+    `$INSTANCE_NAME`_inputHead = next;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,316 @@
+/*******************************************************************************
+* File Name: `$INSTANCE_NAME`_List.c
+* Version `$CY_MAJOR_VERSION`.`$CY_MINOR_VERSION`
+*
+*  Description:
+*    Display list.  Between `$INSTANCE_NAME`_BeginFrame() and
+*    `$INSTANCE_NAME`_EndFrame() pixels and filled spans and rectangles,
+*    whichever drawing call made them, are recorded instead of sent.  At the
+*    end of the frame the list is played out: anything a later entry covers
+*    completely is dropped, the rest is put in screen order where that does
+*    not change what overlaps what, and neighbours on a row go out through
+*    one window.
+*
+*    Window streams (`$INSTANCE_NAME`_SetWindow() and what uses it: text,
+*    tiles, sprites, the band) cannot be recorded; the list so far is played
+*    out before them so that everything still lands in the order drawn.
+*
+********************************************************************************/
+
+#include "cytypes.h"
+#include "`$INSTANCE_NAME`.h"
+
+typedef struct
+{
+    uint8  x0, y0;              /* corners, on the screen, x0 <= x1, y0 <= y1 */
+    uint8  x1, y1;
+    uint16 color;
+} `$INSTANCE_NAME`_LIST_ENTRY;
+
+uint8 `$INSTANCE_NAME`_recording = 0u;
+
+static `$INSTANCE_NAME`_LIST_ENTRY `$INSTANCE_NAME`_list[`$INSTANCE_NAME`_LIST_SIZE];
+static uint32 `$INSTANCE_NAME`_listCount = 0u;
+
+static `$INSTANCE_NAME`_FRAME_STATS `$INSTANCE_NAME`_frame;
+static `$INSTANCE_NAME`_FRAME_STATS `$INSTANCE_NAME`_lastFrame;
+
+static void `$INSTANCE_NAME`_ListSort(void);
+
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_BeginFrame
+********************************************************************************
+*
+* Summary:
+*  Start recording a frame.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_BeginFrame(void)
+{
+    `$INSTANCE_NAME`_ListPlay();
+    `$INSTANCE_NAME`_frame.recorded = 0u;
+    `$INSTANCE_NAME`_frame.culled = 0u;
+    `$INSTANCE_NAME`_frame.merged = 0u;
+    `$INSTANCE_NAME`_frame.windows = 0u;
+    `$INSTANCE_NAME`_frame.bytes = 0u;
+    `$INSTANCE_NAME`_recording = 1u;
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_EndFrame
+********************************************************************************
+*
+* Summary:
+*  Play out what was recorded and stop recording.  Its cost is then given
+*  by `$INSTANCE_NAME`_FrameStats().
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_EndFrame(void)
+{
+    `$INSTANCE_NAME`_ListPlay();
+    `$INSTANCE_NAME`_recording = 0u;
+    `$INSTANCE_NAME`_lastFrame = `$INSTANCE_NAME`_frame;
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_FrameStats
+********************************************************************************
+*
+* Summary:
+*  What the last frame recorded and sent.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Counts for the frame ended by the last `$INSTANCE_NAME`_EndFrame()
+*
+*******************************************************************************/
+const `$INSTANCE_NAME`_FRAME_STATS *`$INSTANCE_NAME`_FrameStats(void)
+{
+    return (&`$INSTANCE_NAME`_lastFrame);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_ListRecord
+********************************************************************************
+*
+* Summary:
+*  Record a filled rectangle, called by the drawing functions while a frame
+*  is being recorded.  The part off the screen is dropped, and so are the
+*  entries already recorded that it covers completely.  When the list is
+*  full it is played out first.
+*
+* Parameters:
+*  x0, y0:  One corner
+*  x1, y1:  The opposite corner (inclusive)
+*  color:   Fill color
+*
+* Return:
+*  1 when recorded, 0 when not recording
+*
+*******************************************************************************/
+uint32 `$INSTANCE_NAME`_ListRecord(int32 x0, int32 y0, int32 x1, int32 y1, int32 color)
+{
+    `$INSTANCE_NAME`_LIST_ENTRY *e;
+    int32 tmp;
+    uint32 i;
+    uint32 kept = 0u;
+
+    if(`$INSTANCE_NAME`_recording == 0u)
+    {
+        return (0u);
+    }
+
+    if(x0 > x1)
+    {
+        tmp = x0; x0 = x1; x1 = tmp;
+    }
+    if(y0 > y1)
+    {
+        tmp = y0; y0 = y1; y1 = tmp;
+    }
+    x0 = (x0 < (int32)`$INSTANCE_NAME`_MINX) ? (int32)`$INSTANCE_NAME`_MINX : x0;
+    y0 = (y0 < (int32)`$INSTANCE_NAME`_MINY) ? (int32)`$INSTANCE_NAME`_MINY : y0;
+    x1 = (x1 > (int32)`$INSTANCE_NAME`_MAXX) ? (int32)`$INSTANCE_NAME`_MAXX : x1;
+    y1 = (y1 > (int32)`$INSTANCE_NAME`_MAXY) ? (int32)`$INSTANCE_NAME`_MAXY : y1;
+    if((x0 > x1) || (y0 > y1))
+    {
+        return (1u);
+    }
+
+    for(i = 0u; i < `$INSTANCE_NAME`_listCount; i++)
+    {
+        e = &`$INSTANCE_NAME`_list[i];
+        if(((int32)e->x0 >= x0) && ((int32)e->x1 <= x1) && ((int32)e->y0 >= y0) && ((int32)e->y1 <= y1))
+        {
+            `$INSTANCE_NAME`_frame.culled++;
+        }
+        else
+        {
+            `$INSTANCE_NAME`_list[kept++] = *e;
+        }
+    }
+    `$INSTANCE_NAME`_listCount = kept;
+
+    if(`$INSTANCE_NAME`_listCount >= `$INSTANCE_NAME`_LIST_SIZE)
+    {
+        `$INSTANCE_NAME`_ListPlay();
+    }
+    e = &`$INSTANCE_NAME`_list[`$INSTANCE_NAME`_listCount++];
+    e->x0 = (uint8)x0;
+    e->y0 = (uint8)y0;
+    e->x1 = (uint8)x1;
+    e->y1 = (uint8)y1;
+    e->color = (uint16)color;
+    `$INSTANCE_NAME`_frame.recorded++;
+    return (1u);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_ListPlay
+********************************************************************************
+*
+* Summary:
+*  Send the entries recorded so far and empty the list; recording goes on.
+*  Single-row entries that follow on along a row share one window, each
+*  streaming its own color.  Same-colored rectangles stacked over the same
+*  columns are sent as one.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_ListPlay(void)
+{
+    const `$INSTANCE_NAME`_LIST_ENTRY *e;
+    const `$INSTANCE_NAME`_LIST_ENTRY *next;
+    uint32 bytes;
+    uint32 n;
+    uint32 i, k, m;
+    int32 end;
+
+    if(`$INSTANCE_NAME`_listCount == 0u)
+    {
+        return;
+    }
+    `$INSTANCE_NAME`_recording = 0u;
+    bytes = `$INSTANCE_NAME`_BytesSent();
+
+    n = `$INSTANCE_NAME`_listCount;
+    `$INSTANCE_NAME`_ListSort();
+
+    for(i = 0u; i < n; i = k)
+    {
+        e = &`$INSTANCE_NAME`_list[i];
+        k = i + 1u;
+
+        /* A run along one row */
+        end = e->y1;
+        if(e->x0 == e->x1)
+        {
+            for( ; k < n; k++)
+            {
+                next = &`$INSTANCE_NAME`_list[k];
+                if((next->x0 != e->x0) || (next->x1 != e->x0) || ((int32)next->y0 != (end + 1)))
+                {
+                    break;
+                }
+                end = next->y1;
+            }
+        }
+        if(k > (i + 1u))
+        {
+            `$INSTANCE_NAME`_SetScan(`$INSTANCE_NAME`_SCAN_ROWS);
+            `$INSTANCE_NAME`_SetWindow(e->x0, e->y0, e->x0, end);
+            for(m = i; m < k; m++)
+            {
+                next = &`$INSTANCE_NAME`_list[m];
+                `$INSTANCE_NAME`_FillWindow((int32)next->color, ((uint32)next->y1 - next->y0) + 1u);
+            }
+        }
+        else
+        {
+            /* Or the same color over the same columns, row after row */
+            end = e->x1;
+            for( ; k < n; k++)
+            {
+                next = &`$INSTANCE_NAME`_list[k];
+                if((next->color != e->color) || (next->y0 != e->y0) || (next->y1 != e->y1) ||
+                   ((int32)next->x0 != (end + 1)))
+                {
+                    break;
+                }
+                end = next->x1;
+            }
+            if(((int32)e->x0 == end) && (e->y0 == e->y1))
+            {
+                `$INSTANCE_NAME`_Pixel(e->x0, e->y0, (int32)e->color);
+            }
+            else
+            {
+                `$INSTANCE_NAME`_DrawRect(e->x0, e->y0, end, e->y1, 1, (int32)e->color);
+            }
+        }
+        `$INSTANCE_NAME`_frame.merged += (uint16)((k - i) - 1u);
+        `$INSTANCE_NAME`_frame.windows++;
+    }
+
+    `$INSTANCE_NAME`_listCount = 0u;
+    `$INSTANCE_NAME`_frame.bytes += `$INSTANCE_NAME`_BytesSent() - bytes;
+    `$INSTANCE_NAME`_recording = 1u;
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_ListSort
+********************************************************************************
+*
+* Summary:
+*  Put the entries in screen order, by row and then column.  An entry is
+*  never moved ahead of one it overlaps, so overlapping entries are still
+*  drawn in the order they were recorded.
+*
+*******************************************************************************/
+static void `$INSTANCE_NAME`_ListSort(void)
+{
+    `$INSTANCE_NAME`_LIST_ENTRY e;
+    const `$INSTANCE_NAME`_LIST_ENTRY *prev;
+    uint32 i, j;
+
+    for(i = 1u; i < `$INSTANCE_NAME`_listCount; i++)
+    {
+        e = `$INSTANCE_NAME`_list[i];
+        for(j = i; j > 0u; j--)
+        {
+            prev = &`$INSTANCE_NAME`_list[j - 1u];
+            if((prev->x0 < e.x0) || ((prev->x0 == e.x0) && (prev->y0 <= e.y0)))
+            {
+                break;
+            }
+            if((prev->x0 <= e.x1) && (prev->x1 >= e.x0) && (prev->y0 <= e.y1) && (prev->y1 >= e.y0))
+            {
+                break;
+            }
+            `$INSTANCE_NAME`_list[j] = *prev;
+        }
+        `$INSTANCE_NAME`_list[j] = e;
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,299 @@
+/*******************************************************************************
+* File Name: `$INSTANCE_NAME`_Tile.c
+* Version `$CY_MAJOR_VERSION`.`$CY_MINOR_VERSION`
+*
+*  Description:
+*    Background tile layer.  The screen is covered by a map of 8x8 tiles,
+*    one byte each, whose images are RRRGGGBB palette indices kept in flash.
+*    There is no frame buffer: changing a map entry only marks the tile
+*    dirty, and `$INSTANCE_NAME`_TileFlush() sends the dirty tiles, a run of
+*    neighbouring tiles in a row at a time through one address window.
+*    Map entries set to `$INSTANCE_NAME`_TILE_NONE are not part of the
+*    layer and are never drawn, so other drawing shows there.
+*
+********************************************************************************/
+
+#include <stddef.h>
+#include "cytypes.h"
+#include "`$INSTANCE_NAME`.h"
+
+#if (`$INSTANCE_NAME`_TILE_COLS > 32u)
+    #error "a row of tiles must fit the 32-bit dirty mask"
+#endif
+
+#define `$INSTANCE_NAME`_TILE_ALL   ((uint32)((1uL << `$INSTANCE_NAME`_TILE_COLS) - 1uL))
+
+typedef struct
+{
+    const uint8 *graphics;                          /* NULL: nothing to draw */
+    uint8  map[`$INSTANCE_NAME`_TILE_ROWS][`$INSTANCE_NAME`_TILE_COLS];
+    uint32 dirty[`$INSTANCE_NAME`_TILE_ROWS];       /* bit c: tile (r, c)     */
+} `$INSTANCE_NAME`_TILE_LAYER;
+
+static `$INSTANCE_NAME`_TILE_LAYER `$INSTANCE_NAME`_tiles;
+
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_TileSetGraphics
+********************************************************************************
+*
+* Summary:
+*  Give the layer its tile images and mark the whole map to be drawn.
+*
+* Parameters:
+*  graphics:  `$INSTANCE_NAME`_TILE_BYTES bytes per tile, tile 0 first; each
+*             tile is 8 rows of 8 RRRGGGBB indices, top row first
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_TileSetGraphics(const uint8 *graphics)
+{
+    `$INSTANCE_NAME`_tiles.graphics = graphics;
+    `$INSTANCE_NAME`_TileInvalidate(`$INSTANCE_NAME`_MINX, `$INSTANCE_NAME`_MINY, `$INSTANCE_NAME`_MAXX, `$INSTANCE_NAME`_MAXY);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_TileSet
+********************************************************************************
+*
+* Summary:
+*  Put a tile in the map.  The tile is marked dirty only if it changes.
+*
+* Parameters:
+*  row:   Tile row, 0 .. `$INSTANCE_NAME`_TILE_ROWS - 1, covering screen rows
+*         8 * row to 8 * row + 7
+*  col:   Tile column, 0 .. `$INSTANCE_NAME`_TILE_COLS - 1
+*  tile:  Tile number, or `$INSTANCE_NAME`_TILE_NONE
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_TileSet(uint32 row, uint32 col, uint32 tile)
+{
+    if((row < `$INSTANCE_NAME`_TILE_ROWS) && (col < `$INSTANCE_NAME`_TILE_COLS) &&
+       (`$INSTANCE_NAME`_tiles.map[row][col] != (uint8)tile))
+    {
+        `$INSTANCE_NAME`_tiles.map[row][col] = (uint8)tile;
+        `$INSTANCE_NAME`_tiles.dirty[row] |= (uint32)1u << col;
+    }
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_TileGet
+********************************************************************************
+*
+* Summary:
+*  The tile at a place in the map.
+*
+* Parameters:
+*  row, col:  Tile row and column
+*
+* Return:
+*  Tile number, or `$INSTANCE_NAME`_TILE_NONE off the map
+*
+*******************************************************************************/
+uint32 `$INSTANCE_NAME`_TileGet(uint32 row, uint32 col)
+{
+    uint32 tile = `$INSTANCE_NAME`_TILE_NONE;
+
+    if((row < `$INSTANCE_NAME`_TILE_ROWS) && (col < `$INSTANCE_NAME`_TILE_COLS))
+    {
+        tile = `$INSTANCE_NAME`_tiles.map[row][col];
+    }
+    return (tile);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_TilePixel
+********************************************************************************
+*
+* Summary:
+*  The color the tile layer has at a pixel, for drawing other layers over it.
+*
+* Parameters:
+*  x, y:  Pixel
+*
+* Return:
+*  `$INSTANCE_NAME`_INDEX() color, or -1 where the layer has no tile
+*
+*******************************************************************************/
+int32 `$INSTANCE_NAME`_TilePixel(int32 x, int32 y)
+{
+    uint32 tile;
+    int32 color = -1;
+
+    if((`$INSTANCE_NAME`_tiles.graphics != NULL) && (x >= 0) && (y >= 0))
+    {
+        tile = `$INSTANCE_NAME`_TileGet((uint32)x / `$INSTANCE_NAME`_TILE_SIZE, (uint32)y / `$INSTANCE_NAME`_TILE_SIZE);
+        if(tile != `$INSTANCE_NAME`_TILE_NONE)
+        {
+            color = `$INSTANCE_NAME`_INDEX(`$INSTANCE_NAME`_tiles.graphics[(tile * `$INSTANCE_NAME`_TILE_BYTES) +
+                ((((uint32)x % `$INSTANCE_NAME`_TILE_SIZE) * `$INSTANCE_NAME`_TILE_SIZE) + ((uint32)y % `$INSTANCE_NAME`_TILE_SIZE))]);
+        }
+    }
+    return (color);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_TileFill
+********************************************************************************
+*
+* Summary:
+*  Set every map entry to one tile and mark them all dirty.
+*
+* Parameters:
+*  tile:  Tile number, or `$INSTANCE_NAME`_TILE_NONE to empty the layer
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_TileFill(uint32 tile)
+{
+    uint32 r;
+    uint32 c;
+
+    for(r = 0u; r < `$INSTANCE_NAME`_TILE_ROWS; r++)
+    {
+        for(c = 0u; c < `$INSTANCE_NAME`_TILE_COLS; c++)
+        {
+            `$INSTANCE_NAME`_tiles.map[r][c] = (uint8)tile;
+        }
+        `$INSTANCE_NAME`_tiles.dirty[r] = `$INSTANCE_NAME`_TILE_ALL;
+    }
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_TileInvalidate
+********************************************************************************
+*
+* Summary:
+*  Mark the tiles under a rectangle of the screen dirty, e.g. after drawing
+*  over them, so that the next flush puts the background back.
+*
+* Parameters:
+*  x0, y0:  One corner of the rectangle
+*  x1, y1:  The opposite corner (inclusive); parts off the screen are ignored
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_TileInvalidate(int32 x0, int32 y0, int32 x1, int32 y1)
+{
+    int32 tmp;
+    uint32 mask;
+
+    if(x0 > x1)
+    {
+        tmp = x0; x0 = x1; x1 = tmp;
+    }
+    if(y0 > y1)
+    {
+        tmp = y0; y0 = y1; y1 = tmp;
+    }
+    if((x1 < (int32)`$INSTANCE_NAME`_MINX) || (x0 > (int32)`$INSTANCE_NAME`_MAXX) ||
+       (y1 < (int32)`$INSTANCE_NAME`_MINY) || (y0 > (int32)`$INSTANCE_NAME`_MAXY))
+    {
+        return;
+    }
+    x0 = (x0 < (int32)`$INSTANCE_NAME`_MINX) ? (int32)`$INSTANCE_NAME`_MINX : x0;
+    y0 = (y0 < (int32)`$INSTANCE_NAME`_MINY) ? (int32)`$INSTANCE_NAME`_MINY : y0;
+    x1 = (x1 > (int32)`$INSTANCE_NAME`_MAXX) ? (int32)`$INSTANCE_NAME`_MAXX : x1;
+    y1 = (y1 > (int32)`$INSTANCE_NAME`_MAXY) ? (int32)`$INSTANCE_NAME`_MAXY : y1;
+
+    /* Columns y0 / 8 .. y1 / 8 */
+    mask = ((uint32)2u << (y1 / (int32)`$INSTANCE_NAME`_TILE_SIZE)) - ((uint32)1u << (y0 / (int32)`$INSTANCE_NAME`_TILE_SIZE));
+    for(tmp = x0 / (int32)`$INSTANCE_NAME`_TILE_SIZE; tmp <= (x1 / (int32)`$INSTANCE_NAME`_TILE_SIZE); tmp++)
+    {
+        `$INSTANCE_NAME`_tiles.dirty[tmp] |= mask;
+    }
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_TileFlush
+********************************************************************************
+*
+* Summary:
+*  Draw the dirty tiles and mark them clean.  Neighbouring dirty tiles in a
+*  row are sent through one window, row by row across all of them, and the
+*  tiles on the bottom and right edges are cut to the screen.  Sprites the
+*  tiles were drawn over are marked to be drawn again.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Number of tiles drawn
+*
+*******************************************************************************/
+uint32 `$INSTANCE_NAME`_TileFlush(void)
+{
+    const uint8 *pRow;
+    uint32 r, c, c0, c1;
+    uint32 bits;
+    uint32 drawn = 0u;
+    int32 x0, x1, y1;
+    int32 i;
+
+    if(`$INSTANCE_NAME`_tiles.graphics == NULL)
+    {
+        return (0u);
+    }
+    `$INSTANCE_NAME`_SetScan(`$INSTANCE_NAME`_SCAN_ROWS);
+
+    for(r = 0u; r < `$INSTANCE_NAME`_TILE_ROWS; r++)
+    {
+        bits = `$INSTANCE_NAME`_tiles.dirty[r];
+        `$INSTANCE_NAME`_tiles.dirty[r] = 0u;
+
+        /* Leave out tiles that are not part of the layer */
+        for(c = 0u; c < `$INSTANCE_NAME`_TILE_COLS; c++)
+        {
+            if(`$INSTANCE_NAME`_tiles.map[r][c] == `$INSTANCE_NAME`_TILE_NONE)
+            {
+                bits &= ~((uint32)1u << c);
+            }
+        }
+
+        x0 = (int32)(r * `$INSTANCE_NAME`_TILE_SIZE);
+        x1 = x0 + (int32)(`$INSTANCE_NAME`_TILE_SIZE - 1u);
+        x1 = (x1 > (int32)`$INSTANCE_NAME`_MAXX) ? (int32)`$INSTANCE_NAME`_MAXX : x1;
+
+        for(c0 = 0u; bits != 0u; c0 = c1 + 1u)
+        {
+            /* Next run of dirty tiles, c0 .. c1 */
+            while((bits & ((uint32)1u << c0)) == 0u)
+            {
+                c0++;
+            }
+            for(c1 = c0; (bits & ((uint32)2u << c1)) != 0u; c1++)
+            {
+            }
+            bits &= ~(((uint32)2u << c1) - ((uint32)1u << c0));
+            drawn += (c1 - c0) + 1u;
+
+            y1 = (int32)((c1 * `$INSTANCE_NAME`_TILE_SIZE) + (`$INSTANCE_NAME`_TILE_SIZE - 1u));
+            y1 = (y1 > (int32)`$INSTANCE_NAME`_MAXY) ? (int32)`$INSTANCE_NAME`_MAXY : y1;
+            `$INSTANCE_NAME`_SetWindow(x0, (int32)(c0 * `$INSTANCE_NAME`_TILE_SIZE), x1, y1);
+            `$INSTANCE_NAME`_SpriteInvalidate(x0, (int32)(c0 * `$INSTANCE_NAME`_TILE_SIZE), x1, y1);
+
+            for(i = 0; i <= (x1 - x0); i++)
+            {
+                for(c = c0; c < c1; c++)
+                {
+                    pRow = `$INSTANCE_NAME`_tiles.graphics + ((uint32)`$INSTANCE_NAME`_tiles.map[r][c] * `$INSTANCE_NAME`_TILE_BYTES) + ((uint32)i * `$INSTANCE_NAME`_TILE_SIZE);
+                    `$INSTANCE_NAME`_WriteIndexed(pRow, `$INSTANCE_NAME`_TILE_SIZE);
+                }
+                pRow = `$INSTANCE_NAME`_tiles.graphics + ((uint32)`$INSTANCE_NAME`_tiles.map[r][c1] * `$INSTANCE_NAME`_TILE_BYTES) + ((uint32)i * `$INSTANCE_NAME`_TILE_SIZE);
+                `$INSTANCE_NAME`_WriteIndexed(pRow, (uint32)(y1 - (int32)(c1 * `$INSTANCE_NAME`_TILE_SIZE)) + 1u);
+            }
+        }
+    }
+    return (drawn);
+}
+
+/* [] END OF FILE */
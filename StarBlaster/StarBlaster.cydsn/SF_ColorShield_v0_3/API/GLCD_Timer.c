@@ -0,0 +1,316 @@
+/*******************************************************************************
+* File Name: `$INSTANCE_NAME`_Timer.c
+* Version `$CY_MAJOR_VERSION`.`$CY_MINOR_VERSION`
+*
+*  Description:
+*    Timers in milliseconds on the SysTick timer, kept in a hashed timer
+*    wheel: a timer goes in the slot its expiry time falls in, modulo the
+*    number of slots, so arming and cancelling are a list insert and unlink
+*    and each SysTick interrupt looks at one slot only.  Timers that expire
+*    are moved to a due list; their callbacks run from the main loop, in
+*    `$INSTANCE_NAME`_TimerService(), where they may draw.
+*
+*    The timers themselves belong to the caller, usually as statics.
+*
+********************************************************************************/
+
+#include <stddef.h>
+#include "cytypes.h"
+#include "CyLib.h"
+#include "`$INSTANCE_NAME`.h"
+
+#define `$INSTANCE_NAME`_TIMER_IDLE     0u
+#define `$INSTANCE_NAME`_TIMER_ARMED    1u
+#define `$INSTANCE_NAME`_TIMER_DUE      2u
+
+/* The due list is the one after the wheel slots */
+#define `$INSTANCE_NAME`_TIMER_DUE_LIST `$INSTANCE_NAME`_TIMER_SLOTS
+
+#if((`$INSTANCE_NAME`_TIMER_SLOTS & (`$INSTANCE_NAME`_TIMER_SLOTS - 1u)) != 0u)
+    #error `$INSTANCE_NAME`_TIMER_SLOTS must be a power of 2
+#endif
+
+static volatile uint32 `$INSTANCE_NAME`_timerNow = 0u;
+static `$INSTANCE_NAME`_TIMER * volatile `$INSTANCE_NAME`_timerLists[`$INSTANCE_NAME`_TIMER_SLOTS + 1u];
+static `$INSTANCE_NAME`_TIMER *`$INSTANCE_NAME`_timerDueLast = NULL;
+
+static void `$INSTANCE_NAME`_TimerTick(void);
+static void `$INSTANCE_NAME`_TimerLink(`$INSTANCE_NAME`_TIMER *timer, uint32 list);
+static void `$INSTANCE_NAME`_TimerUnlink(`$INSTANCE_NAME`_TIMER *timer);
+
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_TimerStart
+********************************************************************************
+*
+* Summary:
+*  Start the SysTick timer at 1 ms, if it is not running already, and hook
+*  the timer wheel onto it.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_TimerStart(void)
+{
+    CySysTickStart();
+    (void)CySysTickSetCallback(`$INSTANCE_NAME`_TIMER_SYSTICK_SLOT, &`$INSTANCE_NAME`_TimerTick);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_TimerNow
+********************************************************************************
+*
+* Summary:
+*  Milliseconds since `$INSTANCE_NAME`_TimerStart(), the time timers go by.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Time in milliseconds
+*
+*******************************************************************************/
+uint32 `$INSTANCE_NAME`_TimerNow(void)
+{
+    return (`$INSTANCE_NAME`_timerNow);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_TimerArm
+********************************************************************************
+*
+* Summary:
+*  Set a timer going, first cancelling it if it is armed.  Its callback
+*  runs from `$INSTANCE_NAME`_TimerService() once delay ms have passed, then
+*  every period ms after that, counted from when it was due so that a
+*  periodic timer does not drift when the callback is late.
+*
+* Parameters:
+*  timer:   The timer, owned by the caller
+*  delay:   Milliseconds to the first time, at least 1
+*  period:  Milliseconds between times after that, or 0 for once only
+*  func:    The callback
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_TimerArm(`$INSTANCE_NAME`_TIMER *timer, uint32 delay, uint32 period, `$INSTANCE_NAME`_TIMER_FUNC func)
+{
+    uint8 intr;
+
+    intr = CyEnterCriticalSection();
+    if(timer->state != `$INSTANCE_NAME`_TIMER_IDLE)
+    {
+        `$INSTANCE_NAME`_TimerUnlink(timer);
+    }
+    timer->func = func;
+    timer->period = period;
+    timer->expires = `$INSTANCE_NAME`_timerNow + ((delay == 0u) ? 1u : delay);
+    `$INSTANCE_NAME`_TimerLink(timer, timer->expires & (`$INSTANCE_NAME`_TIMER_SLOTS - 1u));
+    CyExitCriticalSection(intr);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_TimerCancel
+********************************************************************************
+*
+* Summary:
+*  Stop a timer, also when it is due and its callback has not run yet.
+*
+* Parameters:
+*  timer:  The timer
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_TimerCancel(`$INSTANCE_NAME`_TIMER *timer)
+{
+    uint8 intr;
+
+    intr = CyEnterCriticalSection();
+    if(timer->state != `$INSTANCE_NAME`_TIMER_IDLE)
+    {
+        `$INSTANCE_NAME`_TimerUnlink(timer);
+    }
+    CyExitCriticalSection(intr);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_TimerArmed
+********************************************************************************
+*
+* Summary:
+*  Whether a timer is armed or due.
+*
+* Parameters:
+*  timer:  The timer
+*
+* Return:
+*  Non-zero while armed
+*
+*******************************************************************************/
+uint32 `$INSTANCE_NAME`_TimerArmed(const `$INSTANCE_NAME`_TIMER *timer)
+{
+    return ((timer->state != `$INSTANCE_NAME`_TIMER_IDLE) ? 1u : 0u);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_TimerService
+********************************************************************************
+*
+* Summary:
+*  Run the callbacks of the timers that are due, in the order they came
+*  due; call it from the main loop.  A periodic timer is armed again before
+*  its callback runs, so the callback may cancel it or arm it anew.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Number of callbacks run
+*
+*******************************************************************************/
+uint32 `$INSTANCE_NAME`_TimerService(void)
+{
+    `$INSTANCE_NAME`_TIMER *timer;
+    uint32 n = 0u;
+    uint8 intr;
+
+    for(;;)
+    {
+        intr = CyEnterCriticalSection();
+        timer = `$INSTANCE_NAME`_timerLists[`$INSTANCE_NAME`_TIMER_DUE_LIST];
+        if(timer == NULL)
+        {
+            CyExitCriticalSection(intr);
+            break;
+        }
+        `$INSTANCE_NAME`_TimerUnlink(timer);
+        if(timer->period != 0u)
+        {
+            timer->expires += timer->period;
+            if((int32)(`$INSTANCE_NAME`_timerNow - timer->expires) >= 0)
+            {
+                /* A whole period behind: start again from now */
+                timer->expires = `$INSTANCE_NAME`_timerNow + 1u;
+            }
+            `$INSTANCE_NAME`_TimerLink(timer, timer->expires & (`$INSTANCE_NAME`_TIMER_SLOTS - 1u));
+        }
+        CyExitCriticalSection(intr);
+
+        timer->func(timer);
+        n++;
+    }
+    return (n);
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_TimerTick
+********************************************************************************
+*
+* Summary:
+*  SysTick callback, every millisecond.  Moves the timers of this
+*  millisecond's slot that have expired to the end of the due list; those
+*  a turn of the wheel or more away stay.
+*
+*******************************************************************************/
+static void `$INSTANCE_NAME`_TimerTick(void)
+{
+    `$INSTANCE_NAME`_TIMER *timer;
+    `$INSTANCE_NAME`_TIMER *next;
+    uint32 now = `$INSTANCE_NAME`_timerNow + 1u;
+
+    `$INSTANCE_NAME`_timerNow = now;
+    for(timer = `$INSTANCE_NAME`_timerLists[now & (`$INSTANCE_NAME`_TIMER_SLOTS - 1u)]; timer != NULL; timer = next)
+    {
+        next = timer->next;
+        if((int32)(now - timer->expires) >= 0)
+        {
+            `$INSTANCE_NAME`_TimerUnlink(timer);
+            `$INSTANCE_NAME`_TimerLink(timer, `$INSTANCE_NAME`_TIMER_DUE_LIST);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_TimerLink
+********************************************************************************
+*
+* Summary:
+*  Put a timer in a wheel slot, at the front, or on the due list, at the
+*  end.  Called with interrupts off, or from the SysTick interrupt.
+*
+*******************************************************************************/
+static void `$INSTANCE_NAME`_TimerLink(`$INSTANCE_NAME`_TIMER *timer, uint32 list)
+{
+    `$INSTANCE_NAME`_TIMER *first;
+
+    timer->list = (uint8)list;
+    if(list == `$INSTANCE_NAME`_TIMER_DUE_LIST)
+    {
+        timer->state = `$INSTANCE_NAME`_TIMER_DUE;
+        timer->next = NULL;
+        timer->prev = `$INSTANCE_NAME`_timerDueLast;
+        if(`$INSTANCE_NAME`_timerDueLast != NULL)
+        {
+            `$INSTANCE_NAME`_timerDueLast->next = timer;
+        }
+        else
+        {
+            `$INSTANCE_NAME`_timerLists[list] = timer;
+        }
+        `$INSTANCE_NAME`_timerDueLast = timer;
+    }
+    else
+    {
+        timer->state = `$INSTANCE_NAME`_TIMER_ARMED;
+        first = `$INSTANCE_NAME`_timerLists[list];
+        timer->prev = NULL;
+        timer->next = first;
+        if(first != NULL)
+        {
+            first->prev = timer;
+        }
+        `$INSTANCE_NAME`_timerLists[list] = timer;
+    }
+}
+
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_TimerUnlink
+********************************************************************************
+*
+* Summary:
+*  Take a timer off the list it is on and make it idle.  Called with
+*  interrupts off, or from the SysTick interrupt.
+*
+*******************************************************************************/
+static void `$INSTANCE_NAME`_TimerUnlink(`$INSTANCE_NAME`_TIMER *timer)
+{
+    if(timer->prev != NULL)
+    {
+        timer->prev->next = timer->next;
+    }
+    else
+    {
+        `$INSTANCE_NAME`_timerLists[timer->list] = timer->next;
+    }
+    if(timer->next != NULL)
+    {
+        timer->next->prev = timer->prev;
+    }
+    else if(timer->list == `$INSTANCE_NAME`_TIMER_DUE_LIST)
+    {
+        `$INSTANCE_NAME`_timerDueLast = timer->prev;
+    }
+    timer->next = NULL;
+    timer->prev = NULL;
+    timer->state = `$INSTANCE_NAME`_TIMER_IDLE;
+}
+
+/* [] END OF FILE */
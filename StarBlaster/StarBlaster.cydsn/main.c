@@ -8,58 +8,507 @@
 #include <project.h>
 #include <stdlib.h>
 
-//Make a struct to store coordinates of a star
+//1 to fly through the stars: the whole background moves down a line every
+//frame by the LCD's scroll register, and only the line that comes in at the
+//top is drawn. 0 for the still star field, redrawn every frame.
+#define SCROLLING_STARFIELD 1
+
+//Make a struct to store coordinates of a star. Both fit a byte, which keeps
+//the 150 stars to 300 bytes of the 4 KB of RAM
 struct Star {
-    int16 x_Coor;
-    int16 y_Coor;
+    uint8 x_Coor;
+    uint8 y_Coor;
+};
+struct Star stars[150]; //Array of 150 stars
+
+//The game runs in ticks of 20 ms, whatever time drawing a frame takes
+#define TICK_HZ 50
+
+//Stars twinkle in groups, each group on its own animated color slot:
+//white for a while, a quick fade to gray and back. Times are in steps of
+//the animation timer
+#define ANIM_MS 20
+#define TWINKLE_GROUPS 6
+static const GLCD_ANIM_KEY twinkle[TWINKLE_GROUPS][3] = {
+    {{GLCD_WHITE,58},{GLCD_WHITE,5},{GLCD_GRAY,5}},
+    {{GLCD_WHITE,73},{GLCD_WHITE,5},{GLCD_GRAY,5}},
+    {{GLCD_WHITE,78},{GLCD_WHITE,5},{GLCD_GRAY,5}},
+    {{GLCD_WHITE,93},{GLCD_WHITE,5},{GLCD_GRAY,5}},
+    {{GLCD_WHITE,103},{GLCD_WHITE,5},{GLCD_GRAY,5}},
+    {{GLCD_WHITE,108},{GLCD_WHITE,5},{GLCD_GRAY,5}},
+};
+
+//The charge meter is a row of tiles in the top band of the screen, which
+//stays put while the star field scrolls. Stars live below it.
+#define HUD_ROWS 8                      //screen rows taken by the meter
+#define FIELD_ROWS (132-HUD_ROWS)       //rows of the star field
+#define HUD_CELLS 12                    //cells in the meter, tile columns 2..13
+enum { TILE_BLANK, TILE_EMPTY, TILE_RED, TILE_GREEN, TILE_BLUE };
+static const uint8 hudTiles[5][GLCD_TILE_BYTES] = {
+    { //blank
+        0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+        0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+        0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+        0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+        0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+        0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+        0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+        0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00
+    },
+    { //empty cell
+        0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+        0x00,0x49,0x49,0x49,0x49,0x49,0x49,0x00,
+        0x00,0x49,0x00,0x00,0x00,0x00,0x49,0x00,
+        0x00,0x49,0x00,0x00,0x00,0x00,0x49,0x00,
+        0x00,0x49,0x00,0x00,0x00,0x00,0x49,0x00,
+        0x00,0x49,0x00,0x00,0x00,0x00,0x49,0x00,
+        0x00,0x49,0x49,0x49,0x49,0x49,0x49,0x00,
+        0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00
+    },
+    { //charging, red
+        0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+        0x00,0x49,0x49,0x49,0x49,0x49,0x49,0x00,
+        0x00,0x49,0xE0,0xE0,0xE0,0xE0,0x49,0x00,
+        0x00,0x49,0xE0,0xE0,0xE0,0xE0,0x49,0x00,
+        0x00,0x49,0xE0,0xE0,0xE0,0xE0,0x49,0x00,
+        0x00,0x49,0xE0,0xE0,0xE0,0xE0,0x49,0x00,
+        0x00,0x49,0x49,0x49,0x49,0x49,0x49,0x00,
+        0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00
+    },
+    { //charged, green
+        0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+        0x00,0x49,0x49,0x49,0x49,0x49,0x49,0x00,
+        0x00,0x49,0x1C,0x1C,0x1C,0x1C,0x49,0x00,
+        0x00,0x49,0x1C,0x1C,0x1C,0x1C,0x49,0x00,
+        0x00,0x49,0x1C,0x1C,0x1C,0x1C,0x49,0x00,
+        0x00,0x49,0x1C,0x1C,0x1C,0x1C,0x49,0x00,
+        0x00,0x49,0x49,0x49,0x49,0x49,0x49,0x00,
+        0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00
+    },
+    { //hypercharged, blue
+        0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+        0x00,0x49,0x49,0x49,0x49,0x49,0x49,0x00,
+        0x00,0x49,0x17,0x17,0x17,0x17,0x49,0x00,
+        0x00,0x49,0x17,0x17,0x17,0x17,0x49,0x00,
+        0x00,0x49,0x17,0x17,0x17,0x17,0x49,0x00,
+        0x00,0x49,0x17,0x17,0x17,0x17,0x49,0x00,
+        0x00,0x49,0x49,0x49,0x49,0x49,0x49,0x00,
+        0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00
+    },
+};
+
+//Milliseconds of charging to each state
+#define CHARGED_MS 2500
+#define HYPERCHARGED_MS 5000
+
+//Fill the meter up to the time charged: red while empty, green once charged,
+//blue when hypercharged. Only cells that change are drawn by GLCD_TileFlush()
+void hud(uint32 ms) {
+    int16 i, full, tile;
+
+    full = (ms >= HYPERCHARGED_MS) ? HUD_CELLS : (int16)((ms * HUD_CELLS) / HYPERCHARGED_MS);
+    tile = (ms >= HYPERCHARGED_MS) ? TILE_BLUE : ((ms >= CHARGED_MS) ? TILE_GREEN : TILE_RED);
+    for (i=0;i<HUD_CELLS;i++) {
+        GLCD_TileSet(0, 2+i, (i < full) ? tile : TILE_EMPTY);
+    }
+}
+
+//Draw star i, and tell the sprite layer in case the crosshair is over it
+void drawStar(int16 i) {
+    GLCD_Pixel(stars[i].x_Coor, stars[i].y_Coor,GLCD_SLOT(i % TWINKLE_GROUPS));
+    GLCD_SpriteInvalidate(stars[i].x_Coor, stars[i].y_Coor, stars[i].x_Coor, stars[i].y_Coor);
+}
+
+//Draw again the stars in a box that got painted over
+void redrawStars(int x0, int y0, int x1, int y1) {
+    int16 i;
+    for (i=0;i<150;i++) {
+        if (stars[i].x_Coor >= x0 && stars[i].x_Coor <= x1 && stars[i].y_Coor >= y0 && stars[i].y_Coor <= y1)
+            drawStar(i);
+    }
+}
+
+//What is under the crosshair: black, with the stars of row x
+void starRow(int32 x, int32 y0, int32 y1, uint16 *colors) {
+    int16 i;
+    int32 y;
+    for (y=y0;y<=y1;y++)
+        colors[y-y0] = GLCD_BLACK;
+    for (i=0;i<150;i++) {
+        if (stars[i].x_Coor == x && stars[i].y_Coor >= y0 && stars[i].y_Coor <= y1)
+            colors[stars[i].y_Coor-y0] = GLCD_SLOT(i % TWINKLE_GROUPS);
+    }
+}
+
+//The crosshair is a sprite: moving it draws again only the box it leaves
+//and the box it moves to, with the stars under it put back. It goes
+//behind the charge meter.
+static const uint8 crosshairPixels[21*21] = {
+    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFC,0xFC,0xFC,0xFC,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+    0x00,0x00,0x00,0x00,0x00,0x00,0xFC,0xFC,0x00,0x00,0xFC,0x00,0x00,0xFC,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,
+    0x00,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0x00,
+    0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,
+    0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,
+    0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,
+    0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,
+    0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,
+    0xFC,0xFC,0xFC,0xFC,0xFC,0xFC,0xFC,0xFC,0xFC,0xFC,0xFC,0xFC,0xFC,0xFC,0xFC,0xFC,0xFC,0xFC,0xFC,0xFC,0xFC,
+    0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,
+    0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,
+    0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,
+    0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,
+    0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,
+    0x00,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0x00,
+    0x00,0x00,0x00,0x00,0x00,0x00,0xFC,0xFC,0x00,0x00,0xFC,0x00,0x00,0xFC,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,
+    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFC,0xFC,0xFC,0xFC,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00
 };
+static const GLCD_SPRITE_IMAGE crosshairImage = { 21, 21, 0x00, crosshairPixels };
+
+//Put the crosshair's center at screen row x, column y. The background
+//scrolls under it, so it goes in the memory rows that are showing there;
+//near the wrap round of the memory a second sprite shows the part that
+//comes out at the other end.
+void placeCrosshair(int x, int y) {
+    int row = GLCD_ScrollRamRow(x);
+    GLCD_SpriteMove(0,row-10,y-10);
+#if SCROLLING_STARFIELD
+    if (row < HUD_ROWS+10)
+        GLCD_SpriteShow(1,&crosshairImage,row+FIELD_ROWS-10,y-10,GLCD_SPRITE_BEHIND);
+    else if (row > 121)
+        GLCD_SpriteShow(1,&crosshairImage,row-FIELD_ROWS-10,y-10,GLCD_SPRITE_BEHIND);
+    else
+        GLCD_SpriteHide(1);
+#endif
+}
+
+#if SCROLLING_STARFIELD
+//Move the star field down to offset. The stars keep their rows in LCD
+//memory, so the ones already showing move with it; the memory rows that
+//come in at the top are cleared and their stars get new places on them.
+void scrollStars(struct Star *stars, int16 *offset, int16 to) {
+    int16 i, n, newRows, row;
+    int16 shown = GLCD_ScrollTo(to);
+
+    newRows = (shown - *offset + FIELD_ROWS) % FIELD_ROWS;
+    for (n=0;n<newRows;n++) {
+        row = GLCD_ScrollRamRow(HUD_ROWS+n);
+        GLCD_DrawHLine(row,0,131,GLCD_BLACK);
+        GLCD_SpriteInvalidate(row,0,row,131);
+        for (i=0;i<150;i++) {
+            if (stars[i].x_Coor == row) {
+                stars[i].y_Coor = rand() % 132;
+                drawStar(i);
+            }
+        }
+    }
+    *offset = shown;
+}
+#endif
+
+//Blasts, the twinkling and the crosshair are tasks: each draws a slice a
+//frame and gives way, so they all move on together and none holds up input
+
+//Twinkling stars: the groups that changed color are drawn again, a few
+//stars a frame
+#define STARS_PER_SLICE 50
+uint32 changed;        //twinkle groups that changed color, set by animate()
+#if SCROLLING_STARFIELD
+uint32 twinkleTask(GLCD_TASK *t) {
+    int16 i;
+    GLCD_TASK_BEGIN(t);
+    for (;;) {
+        GLCD_TASK_WAIT(t, changed != 0);
+        t->x = (int16)changed;
+        changed = 0;
+        for (t->n=0;t->n<150;t->n+=STARS_PER_SLICE) {
+            for (i=t->n;i<t->n+STARS_PER_SLICE;i++) {
+                if (t->x & (1u << (i % TWINKLE_GROUPS)))
+                    drawStar(i);
+            }
+            GLCD_TASK_YIELD(t);
+        }
+    }
+    GLCD_TASK_END(t);
+}
+#endif
+
+int16 xCur=62,yCur=62; //current coordinates of the crosshair
+
+//The crosshair follows the buttons, a move a frame
+uint32 crosshairTask(GLCD_TASK *t) {
+    GLCD_TASK_BEGIN(t);
+    for (;;) {
+        placeCrosshair(xCur,yCur);
+        GLCD_TASK_YIELD(t);
+    }
+    GLCD_TASK_END(t);
+}
+
+//Blasts are this big. The big blast's ring grows out of the crosshair,
+//BLAST_STEP a tick
+#define BLAST_RADIUS 24
+#define BLAST_STEP 2
+
+//Blasts are drawn in LCD memory rows, and in the scrolling star field the
+//row after 131 is row HUD_ROWS. A blast that runs over one end of the
+//field has that part drawn again at the other end, like the crosshair:
+//this gives the shift for the second copy, 0 when there is none
+#if SCROLLING_STARFIELD
+int16 blastWrap(int16 row) {
+    if (row-BLAST_RADIUS < HUD_ROWS)
+        return FIELD_ROWS;
+    if (row+BLAST_RADIUS > 131)
+        return -FIELD_ROWS;
+    return 0;
+}
+#else
+#define blastWrap(row) 0
+#endif
+
+//A disc of the small explosion, clipped to the star field so the meter is
+//left alone
+void blastDisc(int x, int y, uint16 color) {
+    int16 wrap = blastWrap(x);
+    GLCD_SetClip(HUD_ROWS,0,131,131);
+    GLCD_FillCircle(x,y,BLAST_RADIUS,color);
+    if (wrap)
+        GLCD_FillCircle(x+wrap,y,BLAST_RADIUS,color);
+    GLCD_ClearClip();
+}
+
+//Put back the stars and the crosshair in the box of a blast
+void blastClear(int x, int y) {
+    GLCD_SpriteInvalidate(x-BLAST_RADIUS,y-BLAST_RADIUS,x+BLAST_RADIUS,y+BLAST_RADIUS);
+    redrawStars(x-BLAST_RADIUS,y-BLAST_RADIUS,x+BLAST_RADIUS,y+BLAST_RADIUS);
+}
+
+//A frame of the big blast: the ring, none when r is 0, and what is under
+//it made again in the box of size r round it, at both ends when it wraps
+void blastRing(int x, int y, int r, int box) {
+    int16 wrap = blastWrap(x);
+    GLCD_SetClip(HUD_ROWS,0,131,131);
+    if (r)
+        GLCD_BandRing(x,y,r,2,GLCD_WHITE);
+    GLCD_BandRender(x-box,y-box,x+box,y+box);
+    if (wrap) {
+        if (r)
+            GLCD_BandRing(x+wrap,y,r,2,GLCD_WHITE);
+        GLCD_BandRender(x+wrap-box,y-box,x+wrap+box,y+box);
+    }
+    GLCD_ClearClip();
+}
 
-//Function to draw the crosshair, takes 4 integers as its parameters:
-//x and y are the coordinates of the crosshair's center, radius of the circle and the color of it.
-void crosshair(int x, int y, int radius, int color) {
-    GLCD_DrawCircle(x,y,radius,color);
-    GLCD_DrawLine(x-10,y,x+10,y,color);
-    GLCD_DrawLine(x,y-10,x,y+10,color);
+//Blaster in the charged state with Green LED, started with the center of
+//the explosion on the screen. One disc a frame
+uint32 fire1(GLCD_TASK *t) {
+    GLCD_TASK_BEGIN(t);
+    t->x = GLCD_ScrollRamRow(t->x);
+    blastDisc(t->x,t->y,GLCD_PINK);
+    GLCD_TASK_YIELD(t);
+    blastDisc(t->x,t->y,GLCD_SKYBLUE);
+    GLCD_TASK_YIELD(t);
+    blastDisc(t->x,t->y,GLCD_BLACK);
+    blastClear(t->x,t->y);
+    if (blastWrap(t->x))
+        blastClear(t->x+blastWrap(t->x),t->y);
+    GLCD_TASK_END(t);
 }
 
-//Blaster in the charged state with Green LED
-//Takes 2 integers as the center of the explosion
-void fire1(int x,int y) {
-    for (int i=0;i<25;i++) {
-        GLCD_DrawCircle(x,y,i,GLCD_PINK);
+//Big blaster in the hypecharged state with Blue LED, started with the
+//center of the explosion on the screen.
+//The whole screen flashes inverted and dims, done by the LCD controller,
+//while the ring is drawn through the band renderer: the box round the ring
+//is made again in RAM from the stars, the ring, the charge meter and the
+//crosshair and sent once, which also rubs out the last ring. The ring's
+//size goes by the ticks since the blast, so it keeps its speed when frames
+//are skipped. The center is a row in LCD memory, so with the scrolling
+//star field the ring drifts with it
+uint32 fire2(GLCD_TASK *t) {
+    int16 r;
+    GLCD_TASK_BEGIN(t);
+    t->x = GLCD_ScrollRamRow(t->x);
+    t->n = (int16)GLCD_LoopTicks();
+    GLCD_FlashInvert(5);
+    GLCD_FadeContrast(GLCD_GetContrast()-30,8,20);
+    for (;;) {
+        r = BLAST_STEP * ((int16)(GLCD_LoopTicks() - (uint32)t->n) + 1);
+        if (r > BLAST_RADIUS)
+            break;
+        blastRing(t->x,t->y,r,r);
+        GLCD_TASK_YIELD(t);
     }
-    for (int i=0;i<25;i++) {
-        GLCD_DrawCircle(x,y,i,GLCD_SKYBLUE);
-        GLCD_DrawCircle(x,y,i,GLCD_BLACK);
+    blastRing(t->x,t->y,0,BLAST_RADIUS);
+    GLCD_TASK_END(t);
+}
+
+//The blaster charges on timers, by the clock: the LEDs change when each
+//level is reached, however the frames are going
+enum { EMPTY, CHARGED, HYPERCHARGED };
+int16 charge = HYPERCHARGED;
+uint32 chargeStart = -HYPERCHARGED_MS; //GLCD_TimerNow() when it was last fired
+GLCD_TIMER chargeTimer;
+
+//Hypercharged state with Blue LED
+void hypercharged(GLCD_TIMER *t) {
+    (void)t;
+    LED_Green_Write(1);
+    LED_Blue_Write(0);
+    charge = HYPERCHARGED;
+}
+
+//Charged state with Green LED, hypercharged later on
+void charged(GLCD_TIMER *t) {
+    LED_Red_Write(1);
+    LED_Green_Write(0);
+    charge = CHARGED;
+    GLCD_TimerArm(t,HYPERCHARGED_MS-CHARGED_MS,0,hypercharged);
+}
+
+//Empty state with Red LED, after a shot
+void fired(void) {
+    LED_Green_Write(1);
+    LED_Blue_Write(1);
+    LED_Red_Write(0);
+    charge = EMPTY;
+    chargeStart = GLCD_TimerNow();
+    GLCD_TimerArm(&chargeTimer,CHARGED_MS,0,charged);
+}
+
+//Stars twinkle and the screen effects move on, every ANIM_MS
+GLCD_TIMER animTimer;
+void animate(GLCD_TIMER *t) {
+    (void)t;
+    changed |= GLCD_AnimTick();
+    GLCD_EffectTick();
+}
+
+//Game state, changed only by update() once a tick
+#if SCROLLING_STARFIELD
+uint32 scrollPos;      //how far the star field has moved down, in 1/256 rows,
+                       //kept within one turn of the field so it never wraps
+int16 scroll = 0;      //how far it has been drawn moved down
+#define SCROLL_SPEED 102   //rows a tick in 1/256, 20 rows a second
+#endif
+
+//The buttons come in on pin interrupts, debounced, as events; a button is
+//numbered by its place in the table
+enum { BUTTON_UP, BUTTON_RIGHT, BUTTON_DOWN, BUTTON_LEFT, BUTTON_FIRE };
+#define BUTTON(b) (1u << (b))
+static const GLCD_INPUT_PIN buttonPins[] = {
+    GLCD_INPUT_PIN_INIT(A),
+    GLCD_INPUT_PIN_INIT(B),
+    GLCD_INPUT_PIN_INIT(C),
+    GLCD_INPUT_PIN_INIT(D),
+    GLCD_INPUT_PIN_INIT(Joy_Center),
+};
+
+//Buttons for the next tick: those held down, and those pressed since the
+//last tick even if already let go, so that no press is missed
+uint32 buttons;
+uint32 pressed;
+
+void input(void) {
+    GLCD_INPUT_EVENT e;
+
+    //Timers that came due since the last pass
+    GLCD_TimerService();
+    while (GLCD_InputRead(&e)) {
+        if (e.type == GLCD_INPUT_PRESSED)
+            pressed |= BUTTON(e.button);
     }
+    buttons = GLCD_InputHeld() | pressed;
 }
 
-//Big blaster in the hypecharged state with Blue LED
-//Takes 2 integers as the center of the explosion
-void fire2(int x, int y) {
-    for (int i=0;i<45;i++) {
-        GLCD_DrawCircle(x,y,i,GLCD_WHITE);
+//One tick of the game: nothing is drawn here, blasts are started as tasks
+void update(void) {
+    uint32 down = buttons;
+    uint32 fire = pressed & BUTTON(BUTTON_FIRE);
+
+    //A press counts for the first tick after it only
+    buttons = GLCD_InputHeld();
+    pressed = 0;
+#if SCROLLING_STARFIELD
+    scrollPos = (scrollPos + SCROLL_SPEED) % (FIELD_ROWS*256u);
+#endif
+
+   //Movement of the crosshair with 4 control buttons, shown next frame
+    //D to move left
+    if ((down & BUTTON(BUTTON_LEFT)) && yCur>=13){
+        yCur = yCur - 2;
     }
-    for (int i=0;i<45;i++) {
-        GLCD_DrawCircle(x,y,i,GLCD_BLACK);
+    //A to move up
+    if ((down & BUTTON(BUTTON_UP)) && xCur>=13){
+        xCur=xCur-2;
     }
+    //B to move right
+    if ((down & BUTTON(BUTTON_RIGHT)) && yCur <=118){
+        yCur=yCur+2;
+    }
+    //C to move down
+    if ((down & BUTTON(BUTTON_DOWN)) && xCur <=118){
+        xCur=xCur+2;
+    }
+    //No explosion when joystick is pushed in empyty state; one shot a push
+    if (!fire || charge == EMPTY)
+        return;
+    //Small explosion when joystick is pushed in charged state,
+    //large explosion in hypercharged state
+    if (charge == CHARGED)
+        GLCD_TaskStart(fire1,xCur,yCur);
+    else
+        GLCD_TaskStart(fire2,xCur,yCur);
+    fired();
 }
+
+//Draw a frame of the game as it is, with the star field moved on by alpha
+//(0 to 255) of a tick's scroll since the last tick
+void render(uint32 alpha) {
+#if !SCROLLING_STARFIELD
+    int16 i;
+#endif
+
+    //Drawing is recorded from here on and sent in screen order at the end
+    //of the frame, with anything drawn over in the meantime left out
+    GLCD_BeginFrame();
+    
+#if SCROLLING_STARFIELD
+    scrollStars(stars,&scroll,(int16)(((scrollPos + ((SCROLL_SPEED*alpha) >> 8)) >> 8) % FIELD_ROWS));
+#else
+    //Draw stars, each in its group's color now
+    (void)alpha;
+    for (i=0;i<150;i++) {
+        drawStar(i);
+    }
+    changed = 0;
+#endif
+    
+    //Blasts, twinkling and the crosshair: a slice each
+    GLCD_TaskRun();
+    
+    //Charge meter: the cells that changed, and any that got drawn over;
+    //then the crosshair where it has moved to or got drawn over
+    hud(GLCD_TimerNow() - chargeStart);
+    GLCD_TileFlush();
+    GLCD_SpriteFlush();
+    GLCD_EndFrame();
+}
+
+static const GLCD_GAME game = { input, update, render };
+
 int main(void)
 {
     CyGlobalIntEnable; /* Enable global interrupts. */
     
     int16 i;
-    int16 x_Center = 62; //x-coordinate of center point
-    int16 y_Center = 62; //y-coordinate of center point
-    int16 xCur=x_Center,yCur=y_Center; //current coordinates of the crosshair
-    int16 count = 100; //Counter for LED states
 
     
-    struct Star stars[150]; //Array of 150 stars
-    
     //Randomly put stars into the2 array
     for (i=0;i<150;i++) {
-        stars[i].x_Coor = rand() % 132;
+        stars[i].x_Coor = HUD_ROWS + rand() % FIELD_ROWS;
         stars[i].y_Coor = rand() % 132;
     }
     
@@ -67,82 +516,40 @@ int main(void)
     GLCD_Start();  
     Backlight_Write(1);       // turn on backlight
     GLCD_Clear(GLCD_BLACK);   //turn background to black
+    for (i=0;i<TWINKLE_GROUPS;i++) {
+        GLCD_AnimSetKeys(i, twinkle[i], 3, GLCD_ANIM_LOOP, GLCD_CURVE_LINEAR);
+    }
+    //The meter's band is all tiles, the rest of the screen is left to the stars
+    GLCD_TileFill(GLCD_TILE_NONE);
+    for (i=0;i<GLCD_TILE_COLS;i++) {
+        GLCD_TileSet(0, i, TILE_BLANK);
+    }
+    GLCD_TileSetGraphics(&hudTiles[0][0]);
+    GLCD_SpriteSetBackground(&starRow);
+    GLCD_SpriteShow(0,&crosshairImage,xCur-10,yCur-10,GLCD_SPRITE_BEHIND);
     LED_Red_Write(1); LED_Green_Write(1); LED_Blue_Write(0);  // Blue LED is first ON, Green and Red LED are OFF
     
+#if SCROLLING_STARFIELD
+    //Everything below the meter scrolls; draw the stars once, after that only new rows
+    GLCD_ScrollSetArea(HUD_ROWS,131);
+    for (i=0;i<150;i++) {
+        drawStar(i);
+    }
+#endif
+    
+    GLCD_TimerStart();
+    GLCD_InputStart(buttonPins, sizeof(buttonPins)/sizeof(buttonPins[0]));
+    GLCD_TimerArm(&animTimer,ANIM_MS,ANIM_MS,animate);
+    GLCD_TaskStart(crosshairTask,0,0);
+#if SCROLLING_STARFIELD
+    GLCD_TaskStart(twinkleTask,0,0);
+#endif
+    
+    //Sleep until the next tick, run the ticks due, then draw a frame;
+    //frames are skipped when drawing falls behind, the game never slows
+    GLCD_LoopStart(TICK_HZ);
     for(;;) {
-        //Draw stars
-        for (i=0;i<150;i++) {
-            GLCD_Pixel(stars[i].x_Coor, stars[i].y_Coor,GLCD_WHITE);
-        }
-        
-        //Draw the crosshair
-        crosshair(xCur,yCur,8,GLCD_YELLOW);
-        
-        //Make the starts twinking
-        int16 randomS = rand() % 150;
-        GLCD_Pixel(stars[randomS].x_Coor, stars[randomS].y_Coor,GLCD_BLACK);
-        CyDelay(50);
-        GLCD_Pixel(stars[randomS].x_Coor, stars[randomS].y_Coor,GLCD_WHITE);
-        
-        
-       //Movement of the crosshair with 4 control buttons
-        //D to move left
-        if (D_Read()==0 && yCur>=15){
-            crosshair(xCur,yCur,8,GLCD_BLACK);
-            crosshair(xCur,yCur-4,8,GLCD_YELLOW);
-            yCur = yCur - 4;
-        }
-        //A to move up
-        if (A_Read()==0 && xCur>=15){
-            crosshair(xCur-4,yCur,8,GLCD_YELLOW);
-            crosshair(xCur,yCur,8,GLCD_BLACK);
-            xCur=xCur-4;
-        }
-        //B to move right
-        if (B_Read()==0 && yCur <=116){
-            crosshair(xCur,yCur+4,8,GLCD_YELLOW);
-            crosshair(xCur,yCur,8,GLCD_BLACK);
-            yCur=yCur+4;
-        }
-        //C to move down
-        if (C_Read()==0 && xCur <=116){
-            crosshair(xCur+4,yCur,8,GLCD_YELLOW);
-            crosshair(xCur,yCur,8,GLCD_BLACK);
-            xCur=xCur+4;
-        }
-        //Empty state       
-        if (count == 0) {
-            LED_Red_Write(0);
-        }
-        //No explosion when joystick is pushed in empyty state
-        if ((LED_Red_Read() == 0)&& (Joy_Center_Read()==0))
-            continue;
-        //Charged state
-        if (count == 50) {       
-            LED_Red_Write(1);
-            LED_Green_Write(0);
-        }
-        //Small explosion when joystick is pushed in charged state
-        if ((count >=50) && (count <100) && (Joy_Center_Read()==0)){
-            fire1(xCur,yCur);
-            LED_Green_Write(1);
-            LED_Red_Write(0);
-            count = 0;
-        }
-        //Hypercharged state
-        if (count == 100) {      
-            LED_Green_Write(1);
-            LED_Blue_Write(0);
-        }
-        //Large explosion when joystick is pushed in hypercharged state
-        if ((count >=100) && (Joy_Center_Read()==0)) {
-            fire2(xCur,yCur);
-            LED_Blue_Write(1);
-            LED_Red_Write(0);
-            count = 0;
-        }
-        //Increment of counter
-        count++;
+        GLCD_LoopStep(&game);
     }
 }
 
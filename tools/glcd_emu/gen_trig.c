@@ -0,0 +1,79 @@
+/*******************************************************************************
+* File Name: gen_trig.c
+*
+*  Description:
+*    Generates the component's GLCD_Trig.c: one quadrant of sin() in Q1.15,
+*    sampled every 1/steps degree, as a const table that links into flash.
+*    The output keeps the `$INSTANCE_NAME` placeholders and CRLF line ends
+*    of the other component API sources.
+*
+*    Usage: gen_trig [steps]    (steps per degree, default 4)
+*
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define DEFAULT_STEPS   4
+#define PER_LINE        8
+
+int main(int argc, char **argv)
+{
+    const double pi = 3.14159265358979323846;
+    int steps = DEFAULT_STEPS;
+    int n;
+    int i;
+
+    if(argc > 1)
+    {
+        steps = atoi(argv[1]);
+    }
+    if((steps < 1) || (steps > 64))
+    {
+        fprintf(stderr, "usage: %s [steps per degree, 1..64]\n", argv[0]);
+        return 2;
+    }
+    n = (90 * steps) + 1;
+
+    printf("/*******************************************************************************\r\n");
+    printf("* File Name: `$INSTANCE_NAME`_Trig.c  \r\n");
+    printf("* Version `$CY_MAJOR_VERSION`.`$CY_MINOR_VERSION`\r\n");
+    printf("*\r\n");
+    printf("*  Description:\r\n");
+    printf("*    Quarter-wave sine table used by the fixed-point trig helpers.\r\n");
+    printf("*    sin(k / %d degrees) for k = 0..%d, in Q1.15.\r\n", steps, n - 1);
+    printf("*\r\n");
+    printf("*    Generated by tools/glcd_emu/gen_trig.c, do not edit.\r\n");
+    printf("*\r\n");
+    printf("********************************************************************************/\r\n");
+    printf("\r\n");
+    printf("#include \"cytypes.h\"\r\n");
+    printf("#include \"`$INSTANCE_NAME`.h\"\r\n");
+    printf("\r\n");
+    printf("#if (`$INSTANCE_NAME`_TRIG_STEPS != %du)\r\n", steps);
+    printf("    #error \"`$INSTANCE_NAME`_Trig.c was generated for %d steps per degree\"\r\n", steps);
+    printf("#endif\r\n");
+    printf("\r\n");
+    printf("const int16 `$INSTANCE_NAME`_SIN_TABLE[`$INSTANCE_NAME`_TRIG_QUADRANT + 1u] = {\r\n");
+    for(i = 0; i < n; i++)
+    {
+        long v = lround(sin(((double)i * pi) / (180.0 * (double)steps)) * 32767.0);
+
+        if((i % PER_LINE) == 0)
+        {
+            printf("   ");
+        }
+        printf(" %5ld%s", v, (i == (n - 1)) ? "" : ",");
+        if(((i % PER_LINE) == (PER_LINE - 1)) || (i == (n - 1)))
+        {
+            printf("\r\n");
+        }
+    }
+    printf("};\r\n");
+    printf("\r\n");
+    printf("/* [] END OF FILE */\r\n");
+
+    return 0;
+}
+
+/* [] END OF FILE */
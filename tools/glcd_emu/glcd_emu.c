@@ -0,0 +1,639 @@
+/*******************************************************************************
+* File Name: glcd_emu.c
+*
+*  Description:
+*    Host-side model of the PCF8833 / S1D15G10 LCD controller.  See
+*    glcd_emu.h.
+*
+*    Display RAM is kept in controller coordinates (page = row, column).  The
+*    shield mounts the glass rotated by 180 degrees, so the visible image is
+*    the RAM read back to front; Emu_WritePpm() and Emu_GetPixel() apply
+*    that rotation so driver coordinates (x = row, y = column) line up with
+*    the picture.
+*
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "glcd_emu.h"
+
+#define EMU_MAX_ARGS    24u
+
+/* Philips PCF8833 command set */
+#define PH_NOP          0x00u
+#define PH_BSTRON       0x03u
+#define PH_SLEEPIN      0x10u
+#define PH_SLEEPOUT     0x11u
+#define PH_NORON        0x13u
+#define PH_DINVOFF      0x20u
+#define PH_DINVON       0x21u
+#define PH_SETCONST     0x25u
+#define PH_DISPOFF      0x28u
+#define PH_DISPON       0x29u
+#define PH_CASET        0x2Au
+#define PH_PASET        0x2Bu
+#define PH_RAMWR        0x2Cu
+#define PH_RGBSET       0x2Du
+#define PH_VSCRDEF      0x33u
+#define PH_MADCTL       0x36u
+#define PH_VSCRSADD     0x37u
+#define PH_COLMOD       0x3Au
+
+#define PH_MADCTL_MY    0x80u
+#define PH_MADCTL_MX    0x40u
+#define PH_MADCTL_V     0x20u
+
+#define PH_COLMOD_8BIT  0x02u
+#define PH_COLMOD_12BIT 0x03u
+#define PH_COLMOD_16BIT 0x05u
+
+/* Epson S1D15G10 command set */
+#define EP_CASET        0x15u
+#define EP_NOP          0x25u
+#define EP_RAMWR        0x5Cu
+#define EP_PASET        0x75u
+#define EP_SETCONST     0x81u
+#define EP_DISNOR       0xA6u
+#define EP_DISINV       0xA7u
+#define EP_DISOFF       0xAEu
+#define EP_DISON        0xAFu
+#define EP_DATCTL       0xBCu
+#define EP_RGBSET8      0xCEu
+#define EP_ASCSET       0xAAu
+#define EP_SCSTART      0xABu
+
+typedef struct
+{
+    uint32_t controller;
+    uint32_t bitRate;
+
+    uint16_t ram[EMU_SIZE][EMU_SIZE];
+
+    uint32_t cmd;               /* last command word                   */
+    uint32_t nArgs;             /* data words received since it        */
+    uint8_t  args[EMU_MAX_ARGS];
+
+    uint32_t pageStart, pageEnd;
+    uint32_t colStart, colEnd;
+    uint32_t page, col;         /* RAMWR write pointer                 */
+    uint32_t inRamwr;
+
+    uint32_t colmod;
+    uint32_t madctl;
+    uint32_t inverted;          /* DINVON / DISINV in effect           */
+    uint32_t displayOn;
+    uint32_t contrast;
+    uint8_t  lut[20];           /* RGBSET: 8 red, 8 green, 4 blue      */
+
+    uint32_t scrollTop;         /* first line of the scrolling area    */
+    uint32_t scrollLines;       /* lines in it                         */
+    uint32_t scrollStart;       /* RAM line shown at its top           */
+
+    uint32_t pixelBits;         /* pending bits of a packed pixel      */
+    uint32_t pixelBitCount;
+
+    EMU_STATS stats;
+} EMU_STATE;
+
+static EMU_STATE emu;
+
+
+/*******************************************************************************
+* Function Name: Emu_Init
+********************************************************************************
+*
+* Summary:
+*  Reset the controller model, as the hardware reset line would.
+*
+* Parameters:
+*  controller:  EMU_PHILIPS or EMU_EPSON
+*  bitRate:     SPI bit rate used for the wire time estimate, 0 for default
+*
+*******************************************************************************/
+void Emu_Init(uint32_t controller, uint32_t bitRate)
+{
+    uint32_t i;
+
+    memset(&emu, 0, sizeof(emu));
+    emu.controller = controller;
+    emu.bitRate = (bitRate != 0u) ? bitRate : EMU_DEFAULT_BITRATE;
+    emu.pageEnd = EMU_SIZE - 1u;
+    emu.colEnd = EMU_SIZE - 1u;
+    emu.colmod = PH_COLMOD_12BIT;
+    emu.scrollLines = EMU_SIZE;
+
+    /* Default LUT: linear ramp, as after RGBSET with the usual table. */
+    for(i = 0u; i < 8u; i++)
+    {
+        emu.lut[i] = (uint8_t)((i * 15u) / 7u);
+        emu.lut[8u + i] = (uint8_t)((i * 15u) / 7u);
+    }
+    for(i = 0u; i < 4u; i++)
+    {
+        emu.lut[16u + i] = (uint8_t)((i * 15u) / 3u);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Emu_Reset
+********************************************************************************
+*
+* Summary:
+*  Hardware reset through the reset pin.  Controller registers and display
+*  RAM are cleared; the transfer counters keep running.
+*
+*******************************************************************************/
+void Emu_Reset(void)
+{
+    EMU_STATS stats = emu.stats;
+
+    Emu_Init(emu.controller, emu.bitRate);
+    emu.stats = stats;
+}
+
+
+/*******************************************************************************
+* Function Name: Emu_StorePixel
+********************************************************************************
+*
+* Summary:
+*  Store one 12-bit pixel at the write pointer and advance it through the
+*  window in the order selected by MADCTL.
+*
+*******************************************************************************/
+static void Emu_StorePixel(uint32_t color)
+{
+    uint32_t row = emu.page;
+    uint32_t col = emu.col;
+
+    if((emu.madctl & PH_MADCTL_MY) != 0u)
+    {
+        row = (EMU_SIZE - 1u) - row;
+    }
+    if((emu.madctl & PH_MADCTL_MX) != 0u)
+    {
+        col = (EMU_SIZE - 1u) - col;
+    }
+    if((row < EMU_SIZE) && (col < EMU_SIZE))
+    {
+        emu.ram[row][col] = (uint16_t)(color & 0x0FFFu);
+    }
+    emu.stats.pixels++;
+
+    if((emu.madctl & PH_MADCTL_V) == 0u)
+    {
+        if(++emu.col > emu.colEnd)
+        {
+            emu.col = emu.colStart;
+            if(++emu.page > emu.pageEnd)
+            {
+                emu.page = emu.pageStart;
+            }
+        }
+    }
+    else
+    {
+        if(++emu.page > emu.pageEnd)
+        {
+            emu.page = emu.pageStart;
+            if(++emu.col > emu.colEnd)
+            {
+                emu.col = emu.colStart;
+            }
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Emu_RamByte
+********************************************************************************
+*
+* Summary:
+*  Feed one RAMWR data byte through the pixel format decoder.
+*
+*******************************************************************************/
+static void Emu_RamByte(uint32_t b)
+{
+    uint32_t c;
+
+    if(emu.colmod == PH_COLMOD_8BIT)
+    {
+        /* RRRGGGBB looked up through the RGBSET table */
+        c = ((uint32_t)emu.lut[(b >> 5) & 0x07u] << 8) |
+            ((uint32_t)emu.lut[8u + ((b >> 2) & 0x07u)] << 4) |
+             (uint32_t)emu.lut[16u + (b & 0x03u)];
+        Emu_StorePixel(c);
+        return;
+    }
+
+    emu.pixelBits = (emu.pixelBits << 8) | (b & 0xFFu);
+    emu.pixelBitCount += 8u;
+
+    if(emu.colmod == PH_COLMOD_16BIT)
+    {
+        if(emu.pixelBitCount == 16u)
+        {
+            /* RRRRRGGGGGGBBBBB truncated to 4 bits per channel */
+            c = emu.pixelBits;
+            Emu_StorePixel(((c >> 12) << 8) | (((c >> 7) & 0x0Fu) << 4) | ((c >> 1) & 0x0Fu));
+            emu.pixelBits = 0u;
+            emu.pixelBitCount = 0u;
+        }
+        return;
+    }
+
+    /* 12-bit: two pixels in three bytes, each stored once its 12 bits are in */
+    if(emu.pixelBitCount == 16u)
+    {
+        Emu_StorePixel(emu.pixelBits >> 4);
+    }
+    else if(emu.pixelBitCount == 24u)
+    {
+        Emu_StorePixel(emu.pixelBits);
+        emu.pixelBits = 0u;
+        emu.pixelBitCount = 0u;
+    }
+    else
+    {
+        /* first byte of a pair: wait for more */
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Emu_EndRamwr
+********************************************************************************
+*
+* Summary:
+*  A command ends a memory write and drops any partly received pixel.
+*
+*******************************************************************************/
+static void Emu_EndRamwr(void)
+{
+    emu.pixelBits = 0u;
+    emu.pixelBitCount = 0u;
+    emu.inRamwr = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: Emu_PhilipsArg
+********************************************************************************
+*
+* Summary:
+*  Apply a Philips command once its nArgs'th argument has arrived.
+*
+*******************************************************************************/
+static void Emu_PhilipsArg(void)
+{
+    switch(emu.cmd)
+    {
+    case PH_CASET:
+        if(emu.nArgs == 2u)
+        {
+            emu.colStart = emu.args[0];
+            emu.colEnd = emu.args[1];
+        }
+        break;
+    case PH_PASET:
+        if(emu.nArgs == 2u)
+        {
+            emu.pageStart = emu.args[0];
+            emu.pageEnd = emu.args[1];
+        }
+        break;
+    case PH_COLMOD:
+        if(emu.nArgs == 1u)
+        {
+            emu.colmod = emu.args[0] & 0x07u;
+        }
+        break;
+    case PH_MADCTL:
+        if(emu.nArgs == 1u)
+        {
+            emu.madctl = emu.args[0];
+        }
+        break;
+    case PH_SETCONST:
+        if(emu.nArgs == 1u)
+        {
+            emu.contrast = emu.args[0];
+        }
+        break;
+    case PH_VSCRDEF:
+        /* top fixed area, scroll area, bottom fixed area */
+        if(emu.nArgs == 3u)
+        {
+            emu.scrollTop = emu.args[0];
+            emu.scrollLines = emu.args[1];
+        }
+        break;
+    case PH_VSCRSADD:
+        if(emu.nArgs == 1u)
+        {
+            emu.scrollStart = emu.args[0];
+        }
+        break;
+    case PH_RGBSET:
+        if(emu.nArgs <= 20u)
+        {
+            emu.lut[emu.nArgs - 1u] = emu.args[emu.nArgs - 1u] & 0x0Fu;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Emu_EpsonArg
+********************************************************************************
+*
+* Summary:
+*  Apply an Epson command once its nArgs'th argument has arrived.
+*
+*******************************************************************************/
+static void Emu_EpsonArg(void)
+{
+    switch(emu.cmd)
+    {
+    case EP_CASET:
+        if(emu.nArgs == 2u)
+        {
+            emu.colStart = emu.args[0];
+            emu.colEnd = emu.args[1];
+        }
+        break;
+    case EP_PASET:
+        if(emu.nArgs == 2u)
+        {
+            emu.pageStart = emu.args[0];
+            emu.pageEnd = emu.args[1];
+        }
+        break;
+    case EP_DATCTL:
+        /* 1st parameter: page inverse, column inverse, page scan first;  */
+        /* kept as the matching MADCTL bits                               */
+        if(emu.nArgs == 1u)
+        {
+            emu.madctl = (((emu.args[0] & 0x01u) != 0u) ? PH_MADCTL_MY : 0u) |
+                         (((emu.args[0] & 0x02u) != 0u) ? PH_MADCTL_MX : 0u) |
+                         (((emu.args[0] & 0x04u) != 0u) ? PH_MADCTL_V : 0u);
+        }
+        /* 3rd parameter: 1 = 8-bit, 2 = 12-bit type A */
+        if(emu.nArgs == 3u)
+        {
+            emu.colmod = (emu.args[2] == 1u) ? PH_COLMOD_8BIT : PH_COLMOD_12BIT;
+        }
+        break;
+    case EP_SETCONST:
+        if(emu.nArgs == 1u)
+        {
+            emu.contrast = emu.args[0];
+        }
+        break;
+    case EP_ASCSET:
+        /* top block, bottom block, last block, mode; blocks of 4 lines */
+        if(emu.nArgs == 4u)
+        {
+            emu.scrollTop = emu.args[0] * 4u;
+            emu.scrollLines = ((uint32_t)emu.args[1] - emu.args[0] + 1u) * 4u;
+            if(emu.args[3] == 3u)
+            {
+                emu.scrollTop = 0u;
+                emu.scrollLines = EMU_SIZE;
+            }
+        }
+        break;
+    case EP_SCSTART:
+        if(emu.nArgs == 1u)
+        {
+            emu.scrollStart = emu.args[0] * 4u;
+        }
+        break;
+    case EP_RGBSET8:
+        if(emu.nArgs <= 20u)
+        {
+            emu.lut[emu.nArgs - 1u] = emu.args[emu.nArgs - 1u] & 0x0Fu;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Emu_Command
+********************************************************************************
+*
+* Summary:
+*  Decode a command word.
+*
+*******************************************************************************/
+static void Emu_Command(uint32_t c)
+{
+    uint32_t philips = (emu.controller == EMU_PHILIPS);
+
+    Emu_EndRamwr();
+    emu.cmd = c;
+    emu.nArgs = 0u;
+    emu.stats.commands++;
+
+    if(c == (philips ? PH_CASET : EP_CASET) || c == (philips ? PH_PASET : EP_PASET))
+    {
+        emu.stats.addrCommands++;
+    }
+    else if(c == (philips ? PH_RAMWR : EP_RAMWR))
+    {
+        emu.stats.ramwrCommands++;
+        emu.inRamwr = 1u;
+        emu.page = emu.pageStart;
+        emu.col = emu.colStart;
+    }
+    else if(c == (philips ? PH_DINVON : EP_DISINV))
+    {
+        emu.inverted = 1u;
+    }
+    else if(c == (philips ? PH_DINVOFF : EP_DISNOR))
+    {
+        emu.inverted = 0u;
+    }
+    else if(c == (philips ? PH_DISPON : EP_DISON))
+    {
+        emu.displayOn = 1u;
+    }
+    else if(c == (philips ? PH_DISPOFF : EP_DISOFF))
+    {
+        emu.displayOn = 0u;
+    }
+    else
+    {
+        /* No state change until arguments arrive */
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Emu_Word
+********************************************************************************
+*
+* Summary:
+*  Feed one 9-bit SPI word.  Bit 8 set marks data, clear marks a command.
+*
+*******************************************************************************/
+void Emu_Word(uint32_t word)
+{
+    emu.stats.wireTimeUs += (EMU_WORD_BITS * 1.0e6) / (double)emu.bitRate;
+
+    if((word & 0x100u) == 0u)
+    {
+        Emu_Command(word & 0xFFu);
+        return;
+    }
+
+    emu.stats.dataBytes++;
+    if(emu.inRamwr)
+    {
+        Emu_RamByte(word & 0xFFu);
+        return;
+    }
+
+    if(emu.nArgs < EMU_MAX_ARGS)
+    {
+        emu.args[emu.nArgs++] = (uint8_t)word;
+        if(emu.controller == EMU_PHILIPS)
+        {
+            Emu_PhilipsArg();
+        }
+        else
+        {
+            Emu_EpsonArg();
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Emu_GetRam
+********************************************************************************
+*
+* Summary:
+*  Read display RAM in controller coordinates.
+*
+*******************************************************************************/
+uint16_t Emu_GetRam(uint32_t page, uint32_t col)
+{
+    return ((page < EMU_SIZE) && (col < EMU_SIZE)) ? emu.ram[page][col] : 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: Emu_GetPixel
+********************************************************************************
+*
+* Summary:
+*  Read the color shown at driver coordinates (x = row, y = column) as seen
+*  on the mounted panel, after vertical scrolling and before display
+*  inversion.
+*
+*******************************************************************************/
+uint16_t Emu_GetPixel(int32_t x, int32_t y)
+{
+    uint32_t line;
+    uint32_t end = emu.scrollTop + emu.scrollLines;
+
+    if((x < 0) || (y < 0) || (x >= (int32_t)EMU_SIZE) || (y >= (int32_t)EMU_SIZE))
+    {
+        return 0u;
+    }
+
+    line = (EMU_SIZE - 1u) - (uint32_t)x;
+    if((emu.scrollLines != 0u) && (end <= EMU_SIZE) && (line >= emu.scrollTop) && (line < end) &&
+       (emu.scrollStart >= emu.scrollTop) && (emu.scrollStart < end))
+    {
+        line = emu.scrollTop + (((line - emu.scrollTop) + (emu.scrollStart - emu.scrollTop)) % emu.scrollLines);
+    }
+    return emu.ram[line][(EMU_SIZE - 1u) - (uint32_t)y];
+}
+
+
+/*******************************************************************************
+* Function Name: Emu_WritePpm
+********************************************************************************
+*
+* Summary:
+*  Write what the panel currently shows as a binary PPM image.
+*
+* Return:
+*  0 on success, -1 if the file cannot be written.
+*
+*******************************************************************************/
+int Emu_WritePpm(const char *path)
+{
+    FILE *f = fopen(path, "wb");
+    int32_t x, y;
+    uint32_t c;
+    uint8_t rgb[3];
+
+    if(f == NULL)
+    {
+        return -1;
+    }
+
+    fprintf(f, "P6\n%u %u\n255\n", EMU_SIZE, EMU_SIZE);
+    for(x = 0; x < (int32_t)EMU_SIZE; x++)
+    {
+        for(y = 0; y < (int32_t)EMU_SIZE; y++)
+        {
+            c = Emu_GetPixel(x, y);
+            /* The Epson panels on these shields show normal colours */
+            /* under DISINV, which the driver's start-up sends.       */
+            if(emu.inverted != (emu.controller == EMU_EPSON))
+            {
+                c = ~c & 0x0FFFu;
+            }
+            if(!emu.displayOn)
+            {
+                c = 0u;
+            }
+            rgb[0] = (uint8_t)(((c >> 8) & 0x0Fu) * 17u);
+            rgb[1] = (uint8_t)(((c >> 4) & 0x0Fu) * 17u);
+            rgb[2] = (uint8_t)((c & 0x0Fu) * 17u);
+            fwrite(rgb, 1u, 3u, f);
+        }
+    }
+    return (fclose(f) == 0) ? 0 : -1;
+}
+
+
+/*******************************************************************************
+* Function Name: Emu_ResetStats / Emu_GetStats / Emu_PrintStats
+********************************************************************************
+*
+* Summary:
+*  Per-frame transfer accounting.
+*
+*******************************************************************************/
+void Emu_ResetStats(void)
+{
+    memset(&emu.stats, 0, sizeof(emu.stats));
+}
+
+const EMU_STATS * Emu_GetStats(void)
+{
+    return &emu.stats;
+}
+
+void Emu_PrintStats(const char *label)
+{
+    const EMU_STATS *s = &emu.stats;
+
+    printf("%-16s cmds %7u  data %7u  addr %6u  ramwr %6u  pixels %7u  wire %9.1f us\n",
+           label, s->commands, s->dataBytes, s->addrCommands, s->ramwrCommands,
+           s->pixels, s->wireTimeUs);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,50 @@
+/*******************************************************************************
+* File Name: glcd_emu.h
+*
+*  Description:
+*    Host-side model of the Nokia 6100 LCD controller (Philips PCF8833, with
+*    the Epson S1D15G10 address commands) used on the SparkFun Color LCD
+*    shield.  The model is fed the same 9-bit SPI words the PSoC SPIM would
+*    shift out, decodes them into a 132x132 12-bit frame buffer and keeps
+*    transfer statistics so rendering changes can be measured on a PC.
+*
+*******************************************************************************/
+#if !defined(GLCD_EMU_H)
+#define GLCD_EMU_H
+
+#include <stdint.h>
+
+#define EMU_SIZE            132u
+#define EMU_WORD_BITS       9u          /* D/C bit + 8 data bits per word   */
+#define EMU_DEFAULT_BITRATE 6000000u    /* 12 MHz SPIM clock / 2            */
+
+/* Controller family decoded by the model. */
+#define EMU_PHILIPS         1u
+#define EMU_EPSON           0u
+
+/* Transfer counters, reset with Emu_ResetStats(). */
+typedef struct
+{
+    uint32_t commands;          /* command words                           */
+    uint32_t dataBytes;         /* data words                              */
+    uint32_t addrCommands;      /* PAGEADDR + COLADDR commands             */
+    uint32_t ramwrCommands;     /* RAMWR commands                          */
+    uint32_t pixels;            /* pixels stored into display RAM          */
+    double   wireTimeUs;        /* estimated SPI wire time                 */
+} EMU_STATS;
+
+void     Emu_Init(uint32_t controller, uint32_t bitRate);
+void     Emu_Reset(void);
+void     Emu_Word(uint32_t word);
+
+uint16_t Emu_GetRam(uint32_t page, uint32_t col);
+uint16_t Emu_GetPixel(int32_t x, int32_t y);
+int      Emu_WritePpm(const char *path);
+
+void              Emu_ResetStats(void);
+const EMU_STATS * Emu_GetStats(void);
+void              Emu_PrintStats(const char *label);
+
+#endif /* GLCD_EMU_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,305 @@
+/*******************************************************************************
+* File Name: glcd_hal.c
+*
+*  Description:
+*    Host implementations of the PSoC APIs the GLCD component calls.  The
+*    SPI TX data register of either SPI Master flavour feeds the emulated
+*    controller one 9-bit word at a time.  The TX FIFO never fills, so an
+*    unmasked TX interrupt is run straight away, from the call that
+*    unmasked it.  The SAR ADC has just what the joystick code needs: a
+*    scan started by firmware ends at the next SysTick with its interrupt.
+*
+*******************************************************************************/
+#include "cytypes.h"
+#include "CyLib.h"
+#include "cyPm.h"
+#include "GLCD_Reset.h"
+#include "GLCD_SPIM_UDB.h"
+#include "GLCD_SPIM_SCB_SPI_UART.h"
+#include "ADC.h"
+#include "glcd_emu.h"
+
+#define HAL_NO_WORD     0xFFFFFFFFu
+#define HAL_VECTORS     32u
+#define HAL_SYSTICK_RELOAD  23999u      /* 24 MHz clock, 1 ms period */
+
+/* Time the firmware spent in CyDelay(), for reference next to wire time. */
+uint32 Hal_delayUs = 0u;
+
+/* UDB SPIM TX data register */
+reg16 Hal_udbTxData;
+
+/* SCB TX FIFO write register; holds a word until the next access moves it */
+/* on to the emulator.                                                     */
+static reg32 scbTxSlot = HAL_NO_WORD;
+
+static cyisraddress vectors[HAL_VECTORS];
+static uint32 enabled[HAL_VECTORS];
+static void (*scbHandler)(void) = NULL;
+static uint32 inIsr = 0u;
+
+/* Simulated time and the SysTick timer */
+static uint32 nowUs = 0u;
+static uint32 sysTickOn = 0u;
+static cySysTickCallback sysTickCallbacks[CY_SYS_SYST_NUM_OF_CALLBACKS];
+
+/* SAR ADC: the start and interrupt registers, what each channel reads */
+/* and the results of the last scan.                                   */
+reg32 Hal_adcStartCtrl = 0u;
+reg32 Hal_adcIntr = 0u;
+int16 Hal_adcInput[ADC_CHANNELS];
+static int16 adcResult[ADC_CHANNELS];
+
+static void Hal_ScbDrain(void)
+{
+    if(scbTxSlot != HAL_NO_WORD)
+    {
+        Emu_Word(scbTxSlot);
+        scbTxSlot = HAL_NO_WORD;
+    }
+}
+
+/* Run an interrupt handler unless one is already running (no nesting). */
+static void Hal_RunIsr(cyisraddress isr)
+{
+    if((isr != NULL) && (inIsr == 0u))
+    {
+        inIsr = 1u;
+        isr();
+        Hal_ScbDrain();
+        inIsr = 0u;
+    }
+}
+
+void Hal_SetReg16(reg16 *addr, uint16 value)
+{
+    *addr = value;
+    if(addr == &Hal_udbTxData)
+    {
+        Emu_Word(value);
+    }
+}
+
+reg32 *Hal_ScbTxFifoWr(void)
+{
+    Hal_ScbDrain();
+    return &scbTxSlot;
+}
+
+cyisraddress CyIntSetVector(uint8 number, cyisraddress address)
+{
+    cyisraddress old = vectors[number % HAL_VECTORS];
+
+    vectors[number % HAL_VECTORS] = address;
+    return old;
+}
+
+void CyIntEnable(uint8 number)
+{
+    enabled[number % HAL_VECTORS] = 1u;
+}
+
+void CyIntDisable(uint8 number)
+{
+    enabled[number % HAL_VECTORS] = 0u;
+}
+
+void Hal_RaiseIrq(uint8 number)
+{
+    if(enabled[number % HAL_VECTORS] != 0u)
+    {
+        Hal_RunIsr(vectors[number % HAL_VECTORS]);
+    }
+}
+
+void CyDelay(uint32 milliseconds)
+{
+    Hal_delayUs += milliseconds * 1000u;
+    Hal_Advance(milliseconds * 1000u);
+}
+
+void CyDelayUs(uint16 microseconds)
+{
+    Hal_delayUs += microseconds;
+    Hal_Advance(microseconds);
+}
+
+/* End a scan started since the last SysTick: latch the inputs and raise */
+/* the interrupt.  The handler's write clears the flag, as on the part.  */
+static void Hal_AdcEndScan(void)
+{
+    if((Hal_adcStartCtrl & ADC_FW_TRIGGER) != 0u)
+    {
+        Hal_adcStartCtrl = 0u;
+        memcpy(adcResult, Hal_adcInput, sizeof(adcResult));
+        Hal_adcIntr |= ADC_EOS_MASK;
+        Hal_RaiseIrq(ADC_INTC_NUMBER);
+        Hal_adcIntr = 0u;
+    }
+}
+
+/* Move simulated time on, running the SysTick callbacks at each */
+/* millisecond boundary passed.                                   */
+void Hal_Advance(uint32 microseconds)
+{
+    uint32 i;
+    uint32 step;
+
+    while(microseconds != 0u)
+    {
+        step = 1000u - (nowUs % 1000u);
+        step = (step > microseconds) ? microseconds : step;
+        nowUs += step;
+        microseconds -= step;
+        if((sysTickOn != 0u) && ((nowUs % 1000u) == 0u))
+        {
+            Hal_AdcEndScan();
+            for(i = 0u; i < CY_SYS_SYST_NUM_OF_CALLBACKS; i++)
+            {
+                if(sysTickCallbacks[i] != NULL)
+                {
+                    sysTickCallbacks[i]();
+                }
+            }
+        }
+    }
+}
+
+void CySysTickStart(void)
+{
+    sysTickOn = 1u;
+}
+
+uint32 CySysTickGetValue(void)
+{
+    return HAL_SYSTICK_RELOAD - (((nowUs % 1000u) * (HAL_SYSTICK_RELOAD + 1u)) / 1000u);
+}
+
+uint32 CySysTickGetReload(void)
+{
+    return HAL_SYSTICK_RELOAD;
+}
+
+cySysTickCallback CySysTickSetCallback(uint32 number, cySysTickCallback function)
+{
+    cySysTickCallback old = sysTickCallbacks[number % CY_SYS_SYST_NUM_OF_CALLBACKS];
+
+    sysTickCallbacks[number % CY_SYS_SYST_NUM_OF_CALLBACKS] = function;
+    return old;
+}
+
+cySysTickCallback CySysTickGetCallback(uint32 number)
+{
+    return sysTickCallbacks[number % CY_SYS_SYST_NUM_OF_CALLBACKS];
+}
+
+/* Sleep until the next SysTick interrupt */
+void CySysPmSleep(void)
+{
+    Hal_Advance(1000u - (nowUs % 1000u));
+}
+
+uint8 CyEnterCriticalSection(void)
+{
+    return 0u;
+}
+
+void CyExitCriticalSection(uint8 savedIntrStatus)
+{
+    (void)savedIntrStatus;
+}
+
+void GLCD_Reset_Write(uint8 value)
+{
+    if(value == 0u)
+    {
+        Emu_Reset();
+    }
+}
+
+void GLCD_SPIM_UDB_Start(void)
+{
+}
+
+void GLCD_SPIM_UDB_Stop(void)
+{
+}
+
+uint8 GLCD_SPIM_UDB_ReadTxStatus(void)
+{
+    return (uint8)(GLCD_SPIM_UDB_STS_SPI_DONE | GLCD_SPIM_UDB_STS_SPI_IDLE |
+                   GLCD_SPIM_UDB_STS_TX_FIFO_EMPTY | GLCD_SPIM_UDB_STS_TX_FIFO_NOT_FULL);
+}
+
+void GLCD_SPIM_UDB_WriteTxData(uint16 txData)
+{
+    Emu_Word(txData);
+}
+
+void GLCD_SPIM_UDB_SetTxInterruptMode(uint8 intSrc)
+{
+#if (0 != EMU_TX_ISR)
+    if(((intSrc & GLCD_SPIM_UDB_STS_TX_FIFO_NOT_FULL) != 0u) &&
+       (enabled[GLCD_SPIM_UDB_TX_ISR_NUMBER % HAL_VECTORS] != 0u))
+    {
+        Hal_RunIsr(vectors[GLCD_SPIM_UDB_TX_ISR_NUMBER % HAL_VECTORS]);
+    }
+#else
+    (void)intSrc;
+#endif
+}
+
+void GLCD_SPIM_SCB_Start(void)
+{
+}
+
+void GLCD_SPIM_SCB_Stop(void)
+{
+}
+
+void GLCD_SPIM_SCB_SpiSetActiveSlaveSelect(uint32 slaveSelect)
+{
+    (void)slaveSelect;
+}
+
+void GLCD_SPIM_SCB_SetCustomInterruptHandler(void (*func)(void))
+{
+    scbHandler = func;
+}
+
+void GLCD_SPIM_SCB_SetTxInterruptMode(uint32 interruptMask)
+{
+    if((interruptMask & GLCD_SPIM_SCB_INTR_TX_NOT_FULL) != 0u)
+    {
+        Hal_RunIsr(scbHandler);
+    }
+}
+
+void GLCD_SPIM_SCB_ClearTxInterruptSource(uint32 interruptMask)
+{
+    (void)interruptMask;
+}
+
+void GLCD_SPIM_SCB_SpiUartWriteTxData(uint32 txData)
+{
+    Emu_Word(txData);
+}
+
+uint32 GLCD_SPIM_SCB_SpiUartGetTxBufferSize(void)
+{
+    return 0u;
+}
+
+void ADC_Start(void)
+{
+    Hal_adcStartCtrl = 0u;
+    Hal_adcIntr = 0u;
+    (void)CyIntSetVector(ADC_INTC_NUMBER, &ADC_ISR);
+}
+
+int16 ADC_GetResult16(uint32 chan)
+{
+    return adcResult[chan % ADC_CHANNELS];
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,1404 @@
+/*******************************************************************************
+* File Name: glcd_scenes.c
+*
+*  Description:
+*    Runs the GLCD component API against the controller emulator.  Each scene
+*    starts from a black screen, draws the kind of picture the games draw,
+*    prints the SPI traffic it cost and writes a PPM snapshot.  Snapshots can
+*    be compared against a directory of golden images recorded earlier.
+*    Scenes whose results are known in advance, such as pixels compared
+*    with a reference, timings and input events, check them as well; any
+*    difference fails the run, with or without golden images.
+*
+*    Usage: glcd_emu [-o outdir] [-g goldendir] [-r bitrate]
+*
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cytypes.h"
+#include "GLCD.h"
+#include "CyLib.h"
+#include "glcd_emu.h"
+#include "ADC.h"
+#include "header01.h"
+
+#define PPM_HEADER_LEN  15u     /* "P6\n132 132\n255\n" */
+#define PPM_LEN         (PPM_HEADER_LEN + (EMU_SIZE * EMU_SIZE * 3u))
+
+typedef struct
+{
+    const char *name;
+    void (*draw)(void);
+} SCENE;
+
+static uint32 seed = 1u;
+static uint32 sceneErrors;  /* results that differ from what the scene expects */
+
+/*******************************************************************************
+* Function Name: Scene_Expect
+********************************************************************************
+*
+* Summary:
+*  Check a result a scene knows in advance, and report and count it if it
+*  differs.
+*
+*******************************************************************************/
+static void Scene_Expect(const char *what, long got, long want)
+{
+    if(got != want)
+    {
+        printf("%-16s FAILED: %s is %ld, expected %ld\n", "", what, got, want);
+        sceneErrors++;
+    }
+}
+
+/* Small LCG so the star field is the same on every host. */
+static int32 Scene_Rand(int32 range)
+{
+    seed = (seed * 1103515245u) + 12345u;
+    return (int32)((seed >> 16) % (uint32)range);
+}
+
+static void Scene_Start(void)
+{
+    GLCD_Start();
+}
+
+static void Scene_Clear(void)
+{
+    GLCD_Clear(GLCD_BLUE);
+}
+
+static void Scene_Stars(void)
+{
+    int32 i;
+
+    seed = 1u;
+    for(i = 0; i < 150; i++)
+    {
+        GLCD_Pixel(Scene_Rand(132), Scene_Rand(132), GLCD_WHITE);
+    }
+}
+
+static void Scene_Lines(void)
+{
+    int32 i;
+
+    for(i = 0; i <= 120; i += 12)
+    {
+        GLCD_DrawLine(62, 62, 2, 2 + i, GLCD_GREEN);
+        GLCD_DrawLine(62, 62, 122, 2 + i, GLCD_RED);
+    }
+    GLCD_DrawLine(10, 5, 10, 126, GLCD_WHITE);
+    GLCD_DrawLine(5, 10, 126, 10, GLCD_WHITE);
+}
+
+static void Scene_Rects(void)
+{
+    GLCD_DrawRect(10, 10, 59, 59, 1, GLCD_YELLOW);
+    GLCD_DrawRect(70, 70, 120, 120, 0, GLCD_CYAN);
+    GLCD_DrawRect(75, 20, 110, 40, 1, GLCD_ORANGE);
+}
+
+/* A grid of horizontal and vertical lines, the outer ones clipped */
+static void Scene_Grid(void)
+{
+    int32 i;
+
+    for(i = 0; i < 132; i += 12)
+    {
+        GLCD_DrawHLine(i, -20, 150, GLCD_GRAY);
+        GLCD_DrawVLine(150, -20, i, GLCD_TEAL);
+    }
+    GLCD_DrawLine(66, 0, 66, 131, GLCD_WHITE);
+    GLCD_DrawLine(131, 66, 0, 66, GLCD_WHITE);
+    GLCD_DrawHLine(-1, 0, 131, GLCD_RED);
+    GLCD_DrawVLine(0, 131, 132, GLCD_RED);
+}
+
+static void Scene_Circles(void)
+{
+    int32 r;
+
+    for(r = 4; r < 60; r += 8)
+    {
+        GLCD_DrawCircle(66, 66, r, GLCD_SKYBLUE);
+    }
+}
+
+static void Scene_Text(void)
+{
+    GLCD_PrintString("StarBlaster", 10, 10, GLCD_WHITE, GLCD_BLACK);
+    GLCD_PrintString("Pacmania", 40, 20, GLCD_YELLOW, GLCD_NAVY);
+}
+
+/* Pacmania's body */
+static void Scene_Pacman(void)
+{
+    GLCD_FillCircle(62, 62, 49, GLCD_YELLOW);
+}
+
+/* Pacmania's mouth opening and closing one degree at a time */
+static void Scene_Mouth(void)
+{
+    int32 i;
+
+    GLCD_FillCircle(62, 62, 49, GLCD_YELLOW);
+    Emu_ResetStats();
+    for(i = 0; i < 35; i++)
+    {
+        GLCD_FillSector(62, 62, 49, i, i + 1, GLCD_BLACK);
+        GLCD_FillSector(62, 62, 49, -i - 1, -i, GLCD_BLACK);
+    }
+    for(i = 35; i > 20; i--)
+    {
+        GLCD_FillSector(62, 62, 49, i - 1, i, GLCD_YELLOW);
+        GLCD_FillSector(62, 62, 49, -i, -i + 1, GLCD_YELLOW);
+    }
+}
+
+/* StarBlaster's fire2(): a white disc, then a black one */
+static void Scene_Blast(void)
+{
+    GLCD_FillCircle(62, 62, 44, GLCD_WHITE);
+    GLCD_FillCircle(62, 62, 44, GLCD_BLACK);
+}
+
+/* fire2() done with controller effects: an inversion flash and contrast */
+/* dip started in a few bytes, with a small ring growing over the frames  */
+static void Scene_Flash(void)
+{
+    int32 r;
+    uint32 frame;
+    uint32 busy = 1u;
+
+    GLCD_FlashInvert(2u);
+    GLCD_FadeContrast(GLCD_GetContrast() - 30, 3u, 8u);
+    for(frame = 0u; busy != 0u; frame++)
+    {
+        r = 4 + ((int32)frame * 4);
+        if((r > 4) && (r <= 28))
+        {
+            GLCD_DrawCircle(62, 62, r - 4, GLCD_BLACK);
+        }
+        if(r <= 24)
+        {
+            GLCD_DrawCircle(62, 62, r, GLCD_WHITE);
+        }
+        busy = GLCD_EffectTick();
+    }
+    printf("%-16s %u frames, contrast back to %d\n", "", frame, (int)GLCD_GetContrast());
+}
+
+/* Filled circles with their outlines, some hanging off the display */
+static void Scene_Discs(void)
+{
+    GLCD_FillCircle(66, 66, 30, GLCD_BLUE);
+    GLCD_DrawCircle(66, 66, 30, GLCD_WHITE);
+    GLCD_FillCircle(15, 120, 40, GLCD_RED);
+    GLCD_FillCircle(-10, -10, 30, GLCD_GREEN);
+    GLCD_FillCircle(100, 20, 0, GLCD_WHITE);
+}
+
+/* The clear scene again at one byte per pixel */
+static void Scene_Clear8(void)
+{
+    GLCD_SetColorMode(GLCD_COLOR_8BIT);
+    GLCD_Clear(GLCD_BLUE);
+    GLCD_SetColorMode(GLCD_COLOR_12BIT);
+}
+
+/* Indexed and 12-bit colors in 8-bit mode, then a dimmed palette */
+static void Scene_Palette(void)
+{
+    static const uint8 dim[GLCD_PALETTE_SIZE] =
+    {
+        0u, 1u, 2u, 3u, 4u, 5u, 6u, 7u,
+        0u, 1u, 2u, 3u, 4u, 5u, 6u, 7u,
+        0u, 2u, 5u, 7u
+    };
+    static const uint8 bars[8] = { 0x03u, 0x1Cu, 0x1Fu, 0xE0u, 0xE3u, 0xFCu, 0xFFu, 0x92u };
+    int32 i;
+
+    GLCD_SetColorMode(GLCD_COLOR_8BIT);
+    for(i = 0; i < 8; i++)
+    {
+        GLCD_DrawRect(4 + (i * 8), 4, 10 + (i * 8), 127, 1, GLCD_INDEX(bars[i]));
+    }
+    GLCD_FillCircle(100, 66, 25, GLCD_YELLOW);
+    GLCD_PrintString("8-bit", 100, 40, GLCD_WHITE, GLCD_INDEX(0x02u));
+
+    GLCD_SetPalette(dim);
+    GLCD_SetWindow(70, 4, 77, 127);
+    GLCD_WriteIndexed(bars, 8u);
+    GLCD_FillWindow(GLCD_INDEX(0xFFu), (8u * 124u) - 8u);
+    GLCD_SetPalette(GLCD_DEFAULT_PALETTE);
+    GLCD_SetColorMode(GLCD_COLOR_12BIT);
+}
+
+/* Eight bars on animated color slots: a twinkle, a ping-pong fade and a */
+/* cycling rainbow, ticked for 40 frames redrawing only changed slots    */
+static void Scene_Anim(void)
+{
+    static const GLCD_ANIM_KEY twinkle[] =
+    {
+        { GLCD_WHITE, 7u }, { GLCD_WHITE, 3u }, { GLCD_SLATE, 3u }
+    };
+    static const GLCD_ANIM_KEY pulse[] =
+    {
+        { GLCD_NAVY, 12u }, { GLCD_CYAN, 12u }
+    };
+    static const uint16 rainbow[6] = { GLCD_RED, GLCD_ORANGE, GLCD_YELLOW, GLCD_GREEN, GLCD_BLUE, GLCD_PURPLE };
+    uint32 changed;
+    uint32 redraws = 0u;
+    int32 i;
+    int32 frame;
+
+    GLCD_AnimSetKeys(0u, twinkle, 3u, GLCD_ANIM_LOOP, GLCD_CURVE_LINEAR);
+    GLCD_AnimSetKeys(1u, pulse, 2u, GLCD_ANIM_PINGPONG, GLCD_CURVE_EASE);
+    for(i = 0; i < 6; i++)
+    {
+        GLCD_AnimSetColor(2u + (uint32)i, rainbow[i]);
+    }
+    GLCD_AnimCycle(0u, 2u, 6u, 4u);
+
+    for(frame = 0; frame < 40; frame++)
+    {
+        changed = GLCD_AnimTick();
+        for(i = 0; i < 8; i++)
+        {
+            if((changed & (1uL << i)) != 0u)
+            {
+                GLCD_DrawRect(4 + (i * 16), 4, 14 + (i * 16), 127, 1, GLCD_SLOT(i));
+                redraws++;
+            }
+        }
+    }
+    printf("%-16s %u bar redraws in 40 frames\n", "", redraws);
+
+    for(i = 0; i < 8; i++)
+    {
+        GLCD_AnimSetColor((uint32)i, GLCD_BLACK);
+    }
+    GLCD_AnimCycle(0u, 0u, 0u, 0u);
+}
+
+/* Hardware scroll: a star field moved a row per frame by the scroll  */
+/* address, drawing only the rows that come in at the top.  The rows  */
+/* outside a partial scrolling area must stay put.                    */
+static void Scene_Scroll(void)
+{
+    static uint16 before[EMU_SIZE][EMU_SIZE];
+    int32 x, y;
+    int32 frame;
+    int32 row;
+    int32 shown;
+    int32 offset = 0;
+    long wrong = 0;
+
+    seed = 7u;
+    for(x = 0; x < 132; x++)
+    {
+        GLCD_Pixel(x, Scene_Rand(132), GLCD_WHITE);
+    }
+    GLCD_PrintString("scroll", 50, 40, GLCD_YELLOW, GLCD_BLACK);
+    GLCD_Flush();
+    for(x = 0; x < 132; x++)
+    {
+        for(y = 0; y < 132; y++)
+        {
+            before[x][y] = Emu_GetPixel(x, y);
+        }
+    }
+
+    /* Part of the screen: rows 20..99 move down 32 rows, the rest stays */
+    GLCD_ScrollSetArea(20, 99);
+    GLCD_ScrollTo(32);
+    for(x = 0; x < 132; x++)
+    {
+        row = ((x < 20) || (x > 99)) ? x : (20 + (((x - 20) + 80 - 32) % 80));
+        for(y = 0; y < 132; y++)
+        {
+            wrong += (Emu_GetPixel(x, y) != before[row][y]);
+        }
+    }
+
+    /* The whole screen, one row per frame for 40 frames */
+    Emu_ResetStats();
+    GLCD_ScrollSetArea(GLCD_MINX, GLCD_MAXX);
+    for(frame = 1; frame <= 40; frame++)
+    {
+        shown = GLCD_ScrollTo(frame);
+        for(x = 0; x < (shown - offset); x++)
+        {
+            row = GLCD_ScrollRamRow(x);
+            GLCD_DrawHLine(row, 0, 131, GLCD_BLACK);
+            GLCD_Pixel(row, Scene_Rand(132), GLCD_CYAN);
+        }
+        offset = shown;
+    }
+    GLCD_Flush();
+    for(x = 40; x < 132; x++)
+    {
+        for(y = 0; y < 132; y++)
+        {
+            wrong += (Emu_GetPixel(x, y) != before[x - 40][y]);
+        }
+    }
+    printf("%-16s %ld pixels out of place after scrolling\n", "", wrong);
+    Scene_Expect("scroll pixels wrong", wrong, 0);
+
+    GLCD_ScrollTo(0);
+}
+
+/* Tile layer: a maze of 8x8 tiles drawn once, then a frame where a few */
+/* dots are eaten.  The counters cover only that frame.                 */
+static uint8 tileGfx[4][GLCD_TILE_BYTES];
+
+static void Scene_Tiles(void)
+{
+    uint32 r, c, i;
+    uint32 first, eaten = 0u;
+    int32 x, y;
+    long wrong = 0;
+
+    for(i = 0u; i < GLCD_TILE_BYTES; i++)
+    {
+        x = (int32)(i / GLCD_TILE_SIZE);
+        y = (int32)(i % GLCD_TILE_SIZE);
+        tileGfx[0][i] = 0x00u;                                          /* floor */
+        tileGfx[1][i] = ((x == 0) || (y == 0) || (x == 7) || (y == 7)) ? 0x03u : 0x01u; /* wall */
+        tileGfx[2][i] = ((x >= 3) && (x <= 4) && (y >= 3) && (y <= 4)) ? 0xF6u : 0x00u; /* dot */
+        tileGfx[3][i] = (((x ^ y) & 4) != 0) ? 0xFCu : 0x00u;           /* checker */
+    }
+
+    GLCD_TileSetGraphics(&tileGfx[0][0]);
+    for(r = 0u; r < GLCD_TILE_ROWS; r++)
+    {
+        for(c = 0u; c < GLCD_TILE_COLS; c++)
+        {
+            GLCD_TileSet(r, c, ((r == 0u) || (c == 0u) || (r == 15u) || (c == 15u) ||
+                                (((r % 4u) == 2u) && ((c % 6u) != 3u))) ? 1u : 2u);
+        }
+    }
+    GLCD_TileSet(16u, 16u, 3u);
+    first = GLCD_TileFlush();
+
+    Emu_ResetStats();
+    for(c = 1u; c <= 5u; c++)
+    {
+        GLCD_TileSet(7u, c, 0u);
+    }
+    GLCD_TileSet(5u, 9u, 0u);
+    GLCD_TileSet(5u, 9u, 0u);
+    eaten = GLCD_TileFlush();
+    GLCD_Flush();
+
+    for(x = 0; x < 132; x++)
+    {
+        for(y = 0; y < 132; y++)
+        {
+            i = GLCD_TileGet((uint32)x / GLCD_TILE_SIZE, (uint32)y / GLCD_TILE_SIZE);
+            wrong += (Emu_GetPixel(x, y) != GLCD_PaletteColor(tileGfx[i][((x % 8) * 8) + (y % 8)]));
+        }
+    }
+    printf("%-16s %u tiles, then %u; %ld pixels wrong\n", "", (unsigned)first, (unsigned)eaten, wrong);
+    Scene_Expect("tiles drawn at first", (long)first, (long)(GLCD_TILE_ROWS * GLCD_TILE_COLS));
+    /* 5 along row 7 and one set twice: only the changed tiles go out */
+    Scene_Expect("tiles redrawn", (long)eaten, 6);
+    Scene_Expect("tile pixels wrong", wrong, 0);
+    GLCD_TileFill(GLCD_TILE_NONE);
+}
+
+/* Sprite layer: a crosshair and a block that passes behind the tiles */
+/* move over a dotted background and a band of tiles.  The counters    */
+/* cover only the moves; the result is checked against the layers.     */
+static uint8 ringPixels[21 * 21];
+static uint8 blockPixels[10 * 10];
+static const GLCD_SPRITE_IMAGE ring = { 21u, 21u, 0x00u, ringPixels };
+static const GLCD_SPRITE_IMAGE block = { 10u, 10u, 0x00u, blockPixels };
+
+static uint16 Scene_Dots(int32 x, int32 y)
+{
+    return ((((x * 7) + (y * 13)) % 29) == 0) ? GLCD_WHITE : GLCD_NAVY;
+}
+
+static void Scene_DotsRow(int32 x, int32 y0, int32 y1, uint16 *colors)
+{
+    int32 y;
+
+    for(y = y0; y <= y1; y++)
+    {
+        colors[y - y0] = Scene_Dots(x, y);
+    }
+}
+
+static void Scene_Sprites(void)
+{
+    static uint16 row[132];
+    int32 x, y, i, d;
+    int32 rx = 30, ry = 10, bx = 20, by = 100;
+    int32 tile;
+    uint32 sent = 0u;
+    uint16 want;
+    long wrong = 0;
+
+    for(i = 0; i < (21 * 21); i++)
+    {
+        x = (i / 21) - 10;
+        y = (i % 21) - 10;
+        d = (x * x) + (y * y);
+        ringPixels[i] = (((d >= 56) && (d <= 72)) || (x == 0) || (y == 0)) ? 0xFCu : 0x00u;
+    }
+    for(i = 0; i < (10 * 10); i++)
+    {
+        blockPixels[i] = 0xE0u;
+    }
+
+    /* Background straight to the screen, then a band of tiles */
+    GLCD_SetWindow(0, 0, 131, 131);
+    for(x = 0; x < 132; x++)
+    {
+        Scene_DotsRow(x, 0, 131, row);
+        GLCD_WritePixels(row, 132u);
+    }
+    GLCD_TileSetGraphics(&tileGfx[0][0]);
+    GLCD_TileFill(GLCD_TILE_NONE);
+    for(i = 0; i < (int32)GLCD_TILE_COLS; i++)
+    {
+        GLCD_TileSet(6u, (uint32)i, 3u);
+    }
+    GLCD_TileFlush();
+
+    GLCD_SpriteSetBackground(&Scene_DotsRow);
+    GLCD_SpriteShow(0u, &ring, rx, ry, 0u);
+    GLCD_SpriteShow(1u, &block, bx, by, GLCD_SPRITE_BEHIND);
+    GLCD_SpriteFlush();
+
+    Emu_ResetStats();
+    for(i = 0; i < 12; i++)
+    {
+        rx += 3;
+        ry += 4;
+        bx += 4;
+        GLCD_SpriteMove(0u, rx, ry);
+        GLCD_SpriteMove(1u, bx, by);
+        sent += GLCD_SpriteFlush();
+    }
+    GLCD_Flush();
+
+    for(x = 0; x < 132; x++)
+    {
+        for(y = 0; y < 132; y++)
+        {
+            tile = GLCD_TilePixel(x, y);
+            want = (tile >= 0) ? (uint16)GLCD_PaletteColor((uint32)tile) : Scene_Dots(x, y);
+            if((x >= bx) && (x < (bx + 10)) && (y >= by) && (y < (by + 10)) && (tile < 0))
+            {
+                want = (uint16)GLCD_PaletteColor(0xE0u);
+            }
+            if((x >= rx) && (x < (rx + 21)) && (y >= ry) && (y < (ry + 21)) &&
+               (ringPixels[((x - rx) * 21) + (y - ry)] != 0x00u))
+            {
+                want = (uint16)GLCD_PaletteColor(0xFCu);
+            }
+            wrong += (Emu_GetPixel(x, y) != want);
+        }
+    }
+    printf("%-16s %u pixels sent for 12 moves; %ld pixels wrong\n", "", (unsigned)sent, wrong);
+    Scene_Expect("sprite pixels wrong", wrong, 0);
+
+    GLCD_SpriteSetBackground(NULL);
+    GLCD_TileFill(GLCD_TILE_NONE);
+}
+
+/* Band renderer: an explosion over the dotted background, the tile band */
+/* and a sprite, drawn first with the direct primitives (overdrawing) and */
+/* then again through the band with every pixel sent once.              */
+static void Scene_Band(void)
+{
+    static uint16 row[132];
+    static uint16 ref[132 * 132];
+    int32 x, y, i;
+    uint32 direct, band;
+    long wrong = 0;
+
+    GLCD_SpriteHide(0u);
+    GLCD_SpriteHide(1u);
+    GLCD_SpriteFlush();
+    GLCD_SpriteSetBackground(&Scene_DotsRow);
+    GLCD_TileSetGraphics(&tileGfx[0][0]);
+    for(i = 0; i < (int32)GLCD_TILE_COLS; i++)
+    {
+        GLCD_TileSet(6u, (uint32)i, 3u);
+    }
+
+    Emu_ResetStats();
+    GLCD_SetWindow(0, 0, 131, 131);
+    for(x = 0; x < 132; x++)
+    {
+        Scene_DotsRow(x, 0, 131, row);
+        GLCD_WritePixels(row, 132u);
+    }
+    GLCD_DrawRect(10, 10, 30, 120, 1, GLCD_BLUE);
+    GLCD_FillCircle(60, 66, 44, GLCD_RED);
+    GLCD_FillCircle(60, 66, 32, GLCD_ORANGE);
+    GLCD_FillCircle(60, 66, 18, GLCD_YELLOW);
+    GLCD_FillCircle(60, 66, 8, GLCD_WHITE);
+    GLCD_TileInvalidate(0, 0, 131, 131);
+    GLCD_TileFlush();
+    GLCD_Flush();
+    direct = Emu_GetStats()->pixels;
+
+    /* The sprite layer can only put back the background and tiles, so the */
+    /* sprite goes into the reference by hand, behind the tiles            */
+    for(x = 0; x < 132; x++)
+    {
+        for(y = 0; y < 132; y++)
+        {
+            ref[(x * 132) + y] = Emu_GetPixel(x, y);
+            if((x >= 40) && (x < 61) && (y >= 56) && (y < 77) && (GLCD_TilePixel(x, y) < 0) &&
+               (ringPixels[((x - 40) * 21) + (y - 56)] != 0x00u))
+            {
+                ref[(x * 132) + y] = (uint16)GLCD_PaletteColor(ringPixels[((x - 40) * 21) + (y - 56)]);
+            }
+        }
+    }
+    GLCD_SpriteShow(0u, &ring, 40, 56, GLCD_SPRITE_BEHIND);
+
+    GLCD_Clear(GLCD_BLACK);
+    Emu_ResetStats();
+    GLCD_BandRect(10, 10, 30, 120, GLCD_BLUE);
+    GLCD_BandDisc(60, 66, 44, GLCD_RED);
+    GLCD_BandDisc(60, 66, 32, GLCD_ORANGE);
+    GLCD_BandDisc(60, 66, 18, GLCD_YELLOW);
+    GLCD_BandDisc(60, 66, 8, GLCD_WHITE);
+    GLCD_BandRender(0, 0, 131, 131);
+    GLCD_Flush();
+    band = Emu_GetStats()->pixels;
+    for(x = 0; x < 132; x++)
+    {
+        for(y = 0; y < 132; y++)
+        {
+            wrong += (Emu_GetPixel(x, y) != ref[(x * 132) + y]);
+        }
+    }
+    printf("%-16s %u pixels sent drawing directly, %u through the band; %ld pixels wrong\n",
+           "", (unsigned)direct, (unsigned)band, wrong);
+    Scene_Expect("band pixels wrong", wrong, 0);
+    Scene_Expect("band pixels sent each once", (long)band, 132L * 132L);
+    Scene_Expect("band sends fewer than direct", (long)(band < direct), 1);
+
+    /* A ring over the result, only its box redrawn */
+    GLCD_BandRing(100, 30, 20, 3, GLCD_GREEN);
+    GLCD_BandRender(80, 10, 120, 50);
+
+    GLCD_SpriteHide(0u);
+    GLCD_SpriteFlush();
+    GLCD_SpriteSetBackground(NULL);
+    GLCD_TileFill(GLCD_TILE_NONE);
+}
+
+/* Shadow: pixels and spans drawn a second time are not sent, and the    */
+/* pixels read back from the shadow match the screen.                    */
+static void Scene_Shadow(void)
+{
+    int32 i, pass;
+#if (GLCD_SHADOW != 0u)
+    int32 x, y;
+    int32 value;
+    uint32 skipped = GLCD_ShadowSkipped();
+    long known = 0;
+    long wrong = 0;
+#endif
+
+    for(pass = 0; pass < 2; pass++)
+    {
+        seed = 7u;
+        for(i = 0; i < 150; i++)
+        {
+            GLCD_Pixel(Scene_Rand(132), Scene_Rand(132), (i & 1) ? GLCD_WHITE : GLCD_CYAN);
+        }
+        GLCD_DrawRect(20, 20, 60, 100, 1, GLCD_BLUE);
+        GLCD_DrawRect(30 + pass, 30, 50, 90, 1, GLCD_YELLOW);
+        GLCD_FillCircle(90, 66, 20, GLCD_RED);
+        GLCD_PrintString("shadow", 100, 60, GLCD_WHITE, GLCD_NAVY);
+    }
+    GLCD_Flush();
+
+#if (GLCD_SHADOW != 0u)
+    for(x = 0; x < 132; x++)
+    {
+        for(y = 0; y < 132; y++)
+        {
+            value = GLCD_GetPixel(x, y);
+            if(value >= 0)
+            {
+                known++;
+                wrong += (Emu_GetPixel(x, y) != (uint16)value);
+            }
+        }
+    }
+    printf("%-16s %u pixels skipped; %ld pixels known, %ld of them wrong\n",
+           "", (unsigned)(GLCD_ShadowSkipped() - skipped), known, wrong);
+    /* The second pass draws almost the same picture again */
+    Scene_Expect("shadow skipped some pixels", (long)((GLCD_ShadowSkipped() - skipped) > 0u), 1);
+    Scene_Expect("shadow knows some pixels", (long)(known > 0), 1);
+    Scene_Expect("shadow pixels wrong", wrong, 0);
+#else
+    printf("%-16s built without the shadow (SHADOW=1)\n", "");
+#endif
+}
+
+/* Display list: a StarBlaster frame (stars, a crosshair, fire1's three */
+/* discs) drawn directly and then recorded and played out at the end.   */
+static void Scene_ListFrame(void)
+{
+    int32 i;
+
+    seed = 11u;
+    for(i = 0; i < 150; i++)
+    {
+        GLCD_Pixel(Scene_Rand(132), Scene_Rand(132), (i & 1) ? GLCD_WHITE : GLCD_CYAN);
+    }
+    GLCD_DrawCircle(40, 90, 8, GLCD_YELLOW);
+    GLCD_DrawLine(30, 90, 50, 90, GLCD_YELLOW);
+    GLCD_DrawLine(40, 80, 40, 100, GLCD_YELLOW);
+    GLCD_FillCircle(80, 50, 24, GLCD_PINK);
+    GLCD_FillCircle(80, 50, 24, GLCD_SKYBLUE);
+    GLCD_FillCircle(80, 50, 24, GLCD_BLACK);
+    GLCD_DrawRect(100, 10, 110, 120, 1, GLCD_BLUE);
+}
+
+static void Scene_List(void)
+{
+    static uint16 ref[132 * 132];
+    const GLCD_FRAME_STATS *stats;
+    int32 x, y;
+    uint32 direct;
+    long wrong = 0;
+
+    direct = GLCD_BytesSent();
+    Scene_ListFrame();
+    GLCD_Flush();
+    direct = GLCD_BytesSent() - direct;
+    for(x = 0; x < 132; x++)
+    {
+        for(y = 0; y < 132; y++)
+        {
+            ref[(x * 132) + y] = Emu_GetPixel(x, y);
+        }
+    }
+
+    GLCD_Clear(GLCD_BLACK);
+    GLCD_BeginFrame();
+    Scene_ListFrame();
+    GLCD_EndFrame();
+    GLCD_Flush();
+    for(x = 0; x < 132; x++)
+    {
+        for(y = 0; y < 132; y++)
+        {
+            wrong += (Emu_GetPixel(x, y) != ref[(x * 132) + y]);
+        }
+    }
+    stats = GLCD_FrameStats();
+    printf("%-16s %u recorded, %u culled, %u merged, %u sent; %u bytes against %u drawn directly; %ld pixels wrong\n",
+           "", stats->recorded, stats->culled, stats->merged, stats->windows,
+           (unsigned)stats->bytes, (unsigned)direct, wrong);
+    Scene_Expect("list pixels wrong", wrong, 0);
+    Scene_Expect("list bytes over direct", (long)(stats->bytes > direct), 0);
+}
+
+/* Clipping: lines, circles, rectangles and text, many of them running */
+/* off the screen, drawn in full and then inside a clip rectangle.  The */
+/* clipped drawing must match the full one inside and leave the rest.  */
+static void Scene_ClipDraw(void)
+{
+    int32 i;
+
+    seed = 5u;
+    for(i = 0; i < 24; i++)
+    {
+        GLCD_DrawLine(Scene_Rand(600) - 234, Scene_Rand(600) - 234,
+                      Scene_Rand(600) - 234, Scene_Rand(600) - 234, GLCD_YELLOW);
+    }
+    GLCD_DrawCircle(20, 110, 45, GLCD_WHITE);
+    GLCD_DrawCircle(66, 66, 70, GLCD_CYAN);
+    GLCD_FillCircle(120, 10, 30, GLCD_ORANGE);
+    GLCD_FillSector(60, 66, 40, 30, 150, GLCD_GREEN);
+    GLCD_DrawRect(-20, 40, 30, 200, 0, GLCD_RED);
+    GLCD_DrawRect(90, -10, 140, 30, 1, GLCD_BLUE);
+    GLCD_PrintString("clip", 16, 40, GLCD_WHITE, GLCD_NAVY);
+    GLCD_PrintString("edge", 50, 120, GLCD_WHITE, GLCD_NAVY);
+}
+
+static void Scene_Clip(void)
+{
+    static uint16 ref[132 * 132];
+    int32 x, y;
+    uint32 full, clipped;
+    long wrong = 0;
+
+    full = GLCD_BytesSent();
+    Scene_ClipDraw();
+    GLCD_Flush();
+    full = GLCD_BytesSent() - full;
+    for(x = 0; x < 132; x++)
+    {
+        for(y = 0; y < 132; y++)
+        {
+            ref[(x * 132) + y] = Emu_GetPixel(x, y);
+        }
+    }
+
+    GLCD_Clear(GLCD_BLACK);
+    GLCD_SetClip(30, 20, 99, 111);
+    clipped = GLCD_BytesSent();
+    Scene_ClipDraw();
+    GLCD_Flush();
+    clipped = GLCD_BytesSent() - clipped;
+    GLCD_ClearClip();
+    for(x = 0; x < 132; x++)
+    {
+        for(y = 0; y < 132; y++)
+        {
+            if((x >= 30) && (x <= 99) && (y >= 20) && (y <= 111))
+            {
+                wrong += (Emu_GetPixel(x, y) != ref[(x * 132) + y]);
+            }
+            else
+            {
+                wrong += (Emu_GetPixel(x, y) != 0u);
+            }
+        }
+    }
+    GLCD_DrawRect(29, 19, 100, 112, 0, GLCD_GRAY);
+    GLCD_Flush();
+    printf("%-16s %u bytes clipped against %u for the screen; %ld pixels wrong\n",
+           "", (unsigned)clipped, (unsigned)full, wrong);
+    Scene_Expect("clipped pixels wrong", wrong, 0);
+}
+
+/* Run-length encoded image: a picture with flat areas encoded by a   */
+/* simple encoder, blitted whole and cut by a clip rectangle, against */
+/* the same picture streamed pixel by pixel.                          */
+static uint32 Scene_RleEncode(const uint16 *pixels, uint32 n, uint16 *out)
+{
+    uint32 i = 0u;
+    uint32 words = 0u;
+    uint32 run, lit;
+
+    while(i < n)
+    {
+        for(run = 1u; ((i + run) < n) && (pixels[i + run] == pixels[i]); run++)
+        {
+        }
+        if(run >= 3u)
+        {
+            out[words++] = GLCD_RLE_RUN(run);
+            out[words++] = pixels[i];
+            i += run;
+            continue;
+        }
+        for(lit = 1u; ((i + lit) < n) && ((i + lit + 2u) >= n || (pixels[i + lit] != pixels[i + lit + 1u]) ||
+                                           (pixels[i + lit] != pixels[i + lit + 2u])); lit++)
+        {
+        }
+        out[words++] = GLCD_RLE_COPY(lit);
+        memcpy(&out[words], &pixels[i], lit * sizeof(uint16));
+        words += lit;
+        i += lit;
+    }
+    return words;
+}
+
+static void Scene_Rle(void)
+{
+    static uint16 image[48 * 64];
+    static uint16 rle[48 * 64 * 2];
+    int32 x, y, dx, dy;
+    uint32 words, raw, packed;
+    long wrong = 0;
+
+    for(x = 0; x < 48; x++)
+    {
+        for(y = 0; y < 64; y++)
+        {
+            dx = x - 24;
+            dy = y - 40;
+            image[(x * 64) + y] = ((dx * dx) + (dy * dy) < 300) ? GLCD_YELLOW :
+                                  (x < 8) ? GLCD_NAVY :
+                                  ((y & 15) == 0) ? (uint16)(x * 85 & 0xFFF) : GLCD_BLACK;
+        }
+    }
+    words = Scene_RleEncode(image, 48u * 64u, rle);
+
+    /* Both start from a window that shares no range with theirs, so each */
+    /* pays for the same address commands and only the pixels differ      */
+    GLCD_SetWindow(0, 0, 0, 0);
+    raw = GLCD_BytesSent();
+    GLCD_SetWindow(10, 2, 57, 65);
+    GLCD_WritePixels(image, 48u * 64u);
+    GLCD_Flush();
+    raw = GLCD_BytesSent() - raw;
+
+    GLCD_SetWindow(0, 0, 0, 0);
+    packed = GLCD_BytesSent();
+    (void)GLCD_BlitRLE(10, 67, 57, 130, rle);
+    GLCD_Flush();
+    packed = GLCD_BytesSent() - packed;
+
+    GLCD_SetClip(70, 20, 100, 90);
+    (void)GLCD_BlitRLE(62, 40, 109, 103, rle);
+    GLCD_ClearClip();
+    GLCD_Flush();
+
+    for(x = 0; x < 48; x++)
+    {
+        for(y = 0; y < 64; y++)
+        {
+            wrong += (Emu_GetPixel(10 + x, 2 + y) != Emu_GetPixel(10 + x, 67 + y));
+            if(((62 + x) >= 70) && ((62 + x) <= 100) && ((40 + y) <= 90))
+            {
+                wrong += (Emu_GetPixel(62 + x, 40 + y) != Emu_GetPixel(10 + x, 2 + y));
+            }
+        }
+    }
+    printf("%-16s %u words for %u pixels; %u bytes sent, %u streamed; %ld pixels wrong\n",
+           "", (unsigned)words, 48u * 64u, (unsigned)packed, (unsigned)raw, wrong);
+    Scene_Expect("RLE pixels wrong", wrong, 0);
+    Scene_Expect("RLE bytes sent", (long)packed, (long)raw);
+}
+
+/* Column order: a bitmap stored column by column streamed into one   */
+/* window, and pixel runs down a column that stream without being     */
+/* addressed one by one.                                              */
+static void Scene_Scan(void)
+{
+    static uint16 bitmap[24 * 40];
+    int32 x, y;
+    long wrong = 0;
+
+    for(y = 0; y < 24; y++)
+    {
+        for(x = 0; x < 40; x++)
+        {
+            bitmap[(y * 40) + x] = (uint16)(((x * 15 / 39) << 8) | ((y * 15 / 23) << 4) | 0x4u);
+        }
+    }
+    GLCD_SetScan(GLCD_SCAN_COLUMNS);
+    GLCD_SetWindow(20, 30, 59, 53);
+    GLCD_WritePixels(bitmap, 24u * 40u);
+    GLCD_SetScan(GLCD_SCAN_ROWS);
+
+    for(y = 70; y < 120; y += 6)
+    {
+        for(x = 20; x < 110; x++)
+        {
+            GLCD_Pixel(x, y + ((x / 16) & 1), GLCD_YELLOW);
+        }
+    }
+    GLCD_PrintString("scan", 100, 30, GLCD_WHITE, GLCD_BLACK);
+    GLCD_Flush();
+
+    for(y = 0; y < 24; y++)
+    {
+        for(x = 0; x < 40; x++)
+        {
+            wrong += (Emu_GetPixel(20 + x, 30 + y) != bitmap[(y * 40) + x]);
+        }
+    }
+    printf("%-16s %ld pixels out of place in the column bitmap\n", "", wrong);
+    Scene_Expect("column bitmap pixels wrong", wrong, 0);
+}
+
+/* Fixed-timestep loop: a ball moves 1.5 pixels a tick at 50 Hz while the */
+/* simulated cost of a tick and a frame goes from light, to more than the */
+/* 20 ms tick together, to a stall.  The ball keeps its speed and renders */
+/* are skipped instead; the stall is more than the loop may catch up, so  */
+/* ticks are dropped.                                                     */
+static uint32 loopPos;
+static int32  loopDrawn = -1;
+static uint32 loopCost;
+
+static void Scene_LoopUpdate(void)
+{
+    uint32 heavy = ((GLCD_LoopTicks() >= 60u) && (GLCD_LoopTicks() < 100u));
+
+    loopPos += 384u;
+    loopCost = heavy ? 14000u : ((GLCD_LoopTicks() == 110u) ? 150000u : 2000u);
+    Hal_Advance(heavy ? 9000u : 500u);
+}
+
+static void Scene_LoopRender(uint32 alpha)
+{
+    int32 y = 12 + (int32)(((loopPos + ((384u * alpha) >> 8)) >> 8) % 108u);
+
+    if(loopDrawn >= 0)
+    {
+        GLCD_FillCircle(66, loopDrawn, 10, GLCD_BLACK);
+    }
+    GLCD_FillCircle(66, y, 10, GLCD_YELLOW);
+    GLCD_Flush();
+    loopDrawn = y;
+    Hal_Advance(loopCost);
+}
+
+static void Scene_Loop(void)
+{
+    static const GLCD_GAME game = { NULL, Scene_LoopUpdate, Scene_LoopRender };
+    const GLCD_LOOP_STATS *stats;
+    uint32 start;
+
+    GLCD_LoopStart(50u);
+    start = GLCD_LoopMicros();
+    while(GLCD_LoopTicks() < 150u)
+    {
+        GLCD_LoopStep(&game);
+    }
+    stats = GLCD_LoopStats();
+    printf("%-16s %u ticks in %u ms: %u renders, %u skipped, %u dropped\n", "",
+           (unsigned)GLCD_LoopTicks(), (unsigned)((GLCD_LoopMicros() - start) / 1000u),
+           (unsigned)stats->renders, (unsigned)stats->skipped, (unsigned)stats->dropped);
+    Scene_Expect("loop time", (long)((GLCD_LoopMicros() - start) / 1000u), 3062);
+    Scene_Expect("renders", (long)stats->renders, 139);
+    Scene_Expect("renders skipped", (long)stats->skipped, 8);
+    Scene_Expect("ticks dropped", (long)stats->dropped, 3);
+}
+
+/* Cooperative tasks: two bars that grow a step a slice, one of them only */
+/* every other tick, and three discs a slice apart all run at once under  */
+/* the game loop.  Each frame gets a slice of each.                       */
+static uint32 taskFrames;
+static uint32 taskDone[2];
+
+static uint32 Scene_TaskBar(GLCD_TASK *t)
+{
+    GLCD_TASK_BEGIN(t);
+    for(t->n = 0; t->n < 25; t->n++)
+    {
+        GLCD_DrawRect(t->x, 10 + (t->n * 4), t->x + 7, 13 + (t->n * 4), 1, GLCD_GREEN);
+        GLCD_TASK_SLEEP(t, t->y);
+    }
+    taskDone[t->y - 1] = GLCD_LoopTicks();
+    GLCD_TASK_END(t);
+}
+
+static uint32 Scene_TaskDiscs(GLCD_TASK *t)
+{
+    GLCD_TASK_BEGIN(t);
+    GLCD_FillCircle(t->x, t->y, 20, GLCD_PINK);
+    GLCD_TASK_YIELD(t);
+    GLCD_FillCircle(t->x, t->y, 14, GLCD_SKYBLUE);
+    GLCD_TASK_YIELD(t);
+    GLCD_FillCircle(t->x, t->y, 8, GLCD_WHITE);
+    GLCD_TASK_END(t);
+}
+
+static void Scene_TaskRender(uint32 alpha)
+{
+    (void)alpha;
+    if(GLCD_TaskRun() != 0u)
+    {
+        taskFrames++;
+    }
+    GLCD_Flush();
+    Hal_Advance(3000u);
+}
+
+static void Scene_Tasks(void)
+{
+    static const GLCD_GAME game = { NULL, NULL, Scene_TaskRender };
+    GLCD_LoopStart(50u);
+    (void)GLCD_TaskStart(Scene_TaskBar, 20, 1);
+    (void)GLCD_TaskStart(Scene_TaskBar, 40, 2);
+    (void)GLCD_TaskStart(Scene_TaskDiscs, 90, 66);
+    while(GLCD_TaskRunning(Scene_TaskBar) != 0u)
+    {
+        GLCD_LoopStep(&game);
+    }
+    printf("%-16s %u frames with tasks; bars done after %u and %u ticks, %u tasks left\n", "",
+           (unsigned)taskFrames, (unsigned)taskDone[0], (unsigned)taskDone[1], (unsigned)GLCD_TaskRun());
+    Scene_Expect("task frames", (long)taskFrames, 50);
+    Scene_Expect("bar 1 done at tick", (long)taskDone[0], 26);
+    Scene_Expect("bar 2 done at tick", (long)taskDone[1], 51);
+    Scene_Expect("tasks left", (long)GLCD_TaskRun(), 0);
+}
+
+/* Timer wheel: timers of different periods, one a turn of the wheel and */
+/* more away and one cancelled by its own callback, serviced every 5 ms   */
+/* for a second.  Each firing is a dot along its timer's row, at the time */
+/* it was due.                                                            */
+static GLCD_TIMER sceneTimers[5];
+static uint32 timerFires[5];
+static uint32 timerLate;
+static uint32 timerStart;
+
+static void Scene_TimerFire(GLCD_TIMER *timer)
+{
+    uint32 i = (uint32)(timer - sceneTimers);
+    uint32 due = timer->expires - ((timer->period != 0u) ? timer->period : 0u);
+    uint32 late = GLCD_TimerNow() - due;
+
+    timerLate = (late > timerLate) ? late : timerLate;
+    timerFires[i]++;
+    due -= timerStart;
+    GLCD_DrawRect(20 + (i * 20), 2 + (due / 8u), 30 + (i * 20), 2 + (due / 8u), 1, GLCD_GREEN);
+    if((i == 2u) && (timerFires[i] == 5u))
+    {
+        GLCD_TimerCancel(timer);
+    }
+}
+
+static void Scene_Timers(void)
+{
+    static const uint32 fires[5] = { 50u, 1u, 5u, 1u, 8u };
+    static GLCD_TIMER cancelled;
+    uint32 armed;
+    uint32 ms;
+    uint32 i;
+
+    GLCD_TimerStart();
+    timerStart = GLCD_TimerNow();
+    GLCD_TimerArm(&sceneTimers[0], 20u, 20u, Scene_TimerFire);
+    GLCD_TimerArm(&sceneTimers[1], 35u, 0u, Scene_TimerFire);
+    GLCD_TimerArm(&sceneTimers[2], 7u, 7u, Scene_TimerFire);
+    GLCD_TimerArm(&sceneTimers[3], 1000u, 0u, Scene_TimerFire);
+    GLCD_TimerArm(&sceneTimers[4], 3u, 125u, Scene_TimerFire);
+    GLCD_TimerArm(&cancelled, 50u, 0u, Scene_TimerFire);
+    GLCD_TimerCancel(&cancelled);
+
+    for(ms = 0u; ms < 1000u; ms += 5u)
+    {
+        Hal_Advance(5000u);
+        (void)GLCD_TimerService();
+    }
+    armed = GLCD_TimerArmed(&sceneTimers[0]) + GLCD_TimerArmed(&sceneTimers[1]) +
+            GLCD_TimerArmed(&sceneTimers[2]) + GLCD_TimerArmed(&sceneTimers[3]) +
+            GLCD_TimerArmed(&sceneTimers[4]) + GLCD_TimerArmed(&cancelled);
+    printf("%-16s fired %u %u %u %u %u times, at most %u ms late; %u still armed\n", "",
+           (unsigned)timerFires[0], (unsigned)timerFires[1], (unsigned)timerFires[2],
+           (unsigned)timerFires[3], (unsigned)timerFires[4], (unsigned)timerLate, (unsigned)armed);
+    for(i = 0u; i < 5u; i++)
+    {
+        Scene_Expect("timer firings", (long)timerFires[i], (long)fires[i]);
+    }
+    Scene_Expect("timers still armed", (long)armed, 2);
+    /* Serviced every 5 ms, a timer can be due just after a service */
+    Scene_Expect("timers over 5 ms late", (long)(timerLate >= 5u), 0);
+    GLCD_TimerCancel(&sceneTimers[0]);
+    GLCD_TimerCancel(&sceneTimers[4]);
+}
+
+/* Buttons: two pins of a port that only exists here.  Button 0 bounces */
+/* as it goes down, stays down long enough to be held and repeat, then   */
+/* bounces up; button 1 is tapped for 8 ms, then glitches for 2 ms, which */
+/* the debounce takes as no press.  Each event is a mark along its        */
+/* button's row at the time it was stamped with, from the first press,    */
+/* longest for presses.                                                   */
+static reg32 emuPs = 0xFFu;
+static reg32 emuIntcfg;
+static reg32 emuIntstat;
+
+#define EmuBtn0__PS         (&emuPs)
+#define EmuBtn0__INTCFG     (&emuIntcfg)
+#define EmuBtn0__INTSTAT    (&emuIntstat)
+#define EmuBtn0__SHIFT      2u
+#define EmuBtn0__PORT       2u
+#define EmuBtn1__PS         (&emuPs)
+#define EmuBtn1__INTCFG     (&emuIntcfg)
+#define EmuBtn1__INTSTAT    (&emuIntstat)
+#define EmuBtn1__SHIFT      5u
+#define EmuBtn1__PORT       2u
+
+/* Set a pin and raise the port interrupt.  The status bit is set by the */
+/* edge and cleared when the handler writes it, as the hardware does.    */
+static void Scene_PinEdge(uint32 shift, uint32 high)
+{
+    emuPs = high ? (emuPs | (1u << shift)) : (emuPs & ~(1u << shift));
+    emuIntstat |= (1u << shift);
+    Hal_RaiseIrq(EmuBtn0__PORT);
+    emuIntstat = 0u;
+}
+
+static void Scene_Ms(uint32 ms)
+{
+    Hal_Advance(ms * 1000u);
+}
+
+static void Scene_Buttons(void)
+{
+    static const GLCD_INPUT_PIN pins[2] = { GLCD_INPUT_PIN_INIT(EmuBtn0), GLCD_INPUT_PIN_INIT(EmuBtn1) };
+    static const char *names[4] = { "pressed", "released", "held", "repeat" };
+    /* Button, type and time of each event expected, in order */
+    static const uint16 want[7][3] =
+    {
+        { 0u, GLCD_INPUT_PRESSED,  0u   },
+        { 0u, GLCD_INPUT_HELD,     500u },
+        { 0u, GLCD_INPUT_REPEAT,   600u },
+        { 0u, GLCD_INPUT_REPEAT,   700u },
+        { 0u, GLCD_INPUT_RELEASED, 750u },
+        { 1u, GLCD_INPUT_PRESSED,  790u },
+        { 1u, GLCD_INPUT_RELEASED, 798u },
+    };
+    GLCD_INPUT_EVENT e;
+    uint16 start = 0u;
+    uint32 n = 0u;
+
+    GLCD_InputStart(pins, 2u);
+
+    /* Button 0 down at 0 ms, up at 750 ms, bouncing each way */
+    Scene_Ms(10u);
+    Scene_PinEdge(2u, 0u); Scene_Ms(1u); Scene_PinEdge(2u, 1u); Scene_Ms(1u); Scene_PinEdge(2u, 0u);
+    Scene_Ms(748u);
+    Scene_PinEdge(2u, 1u); Scene_Ms(2u); Scene_PinEdge(2u, 0u); Scene_Ms(1u); Scene_PinEdge(2u, 1u);
+    /* Button 1 tapped at 790 ms, glitched at 840 ms */
+    Scene_Ms(37u);
+    Scene_PinEdge(5u, 0u); Scene_Ms(8u); Scene_PinEdge(5u, 1u);
+    Scene_Ms(42u);
+    Scene_PinEdge(5u, 0u); Scene_Ms(2u); Scene_PinEdge(5u, 1u);
+    Scene_Ms(20u);
+
+    while(GLCD_InputRead(&e) != 0u)
+    {
+        if(n == 0u)
+        {
+            start = e.time;
+        }
+        printf("%-16s button %u %-8s at %4u ms\n", "", (unsigned)e.button, names[e.type],
+               (unsigned)(uint16)(e.time - start));
+        GLCD_DrawRect(30 + (e.button * 40), 2 + ((uint16)(e.time - start) / 8u),
+                      ((e.type == GLCD_INPUT_PRESSED) ? 60 : 45) + (e.button * 40),
+                      2 + ((uint16)(e.time - start) / 8u), 1,
+                      (e.type == GLCD_INPUT_RELEASED) ? GLCD_RED : GLCD_GREEN);
+        if(n < 7u)
+        {
+            Scene_Expect("event button", (long)e.button, (long)want[n][0]);
+            Scene_Expect("event type", (long)e.type, (long)want[n][1]);
+            Scene_Expect("event time", (long)(uint16)(e.time - start), (long)want[n][2]);
+        }
+        n++;
+    }
+    printf("%-16s %u events, %u lost, held now %u\n", "", (unsigned)n, (unsigned)GLCD_InputLost(),
+           (unsigned)GLCD_InputHeld());
+    Scene_Expect("events", (long)n, 7);
+    Scene_Expect("events lost", (long)GLCD_InputLost(), 0);
+    Scene_Expect("buttons held", (long)GLCD_InputHeld(), 0);
+}
+
+/* Analog joystick: Pacmania's ADC_INT.c on the ADC stand-in.  The stick */
+/* rests off middle, with noise, while the centre is found; then it is    */
+/* moved inside the dead zone, half way and to either end of each axis.   */
+/* Each reading is a dot in a box that stands for the whole range.        */
+#define JOY_X0      1100    /* resting readings, off the middle of 0..2047 */
+#define JOY_Y0      950
+
+static void Scene_JoystickAt(int16 x, int16 y, int16 wantX, int16 wantY)
+{
+    JOYSTICK stick;
+
+    Hal_adcInput[0] = x;
+    Hal_adcInput[1] = y;
+    Scene_Ms(40u);
+    Joystick_Read(&stick);
+    printf("%-16s reading %4d %4d is %4d %4d\n", "", x, y, stick.x, stick.y);
+    Scene_Expect("joystick x", stick.x, wantX);
+    Scene_Expect("joystick y", stick.y, wantY);
+    GLCD_FillCircle(66 + (stick.x / 5), 66 + (stick.y / 5), 2, GLCD_YELLOW);
+}
+
+static void Scene_Joystick(void)
+{
+    JOYSTICK stick;
+    uint32 ms;
+
+    GLCD_DrawRect(10, 10, 122, 122, 0, GLCD_WHITE);
+    GLCD_DrawRect(66 - 4, 66 - 4, 66 + 4, 66 + 4, 0, GLCD_GRAY);
+
+    Joystick_Start();
+    for(ms = 0u; ms < 80u; ms++)
+    {
+        Hal_adcInput[0] = (int16)(JOY_X0 + (((ms & 1u) != 0u) ? 20 : -20));
+        Hal_adcInput[1] = (int16)(JOY_Y0 + (((ms & 2u) != 0u) ? 12 : -12));
+        Scene_Ms(1u);
+        if(ms == 60u)
+        {
+            Joystick_Read(&stick);
+            Scene_Expect("ready before 64 scans", stick.ready, 0);
+        }
+    }
+    Joystick_Read(&stick);
+    Scene_Expect("ready after 64 scans", stick.ready, 1);
+
+    Scene_JoystickAt(JOY_X0, JOY_Y0, 0, 0);
+    /* Dead zone, 64 counts about the centre */
+    Scene_JoystickAt(JOY_X0 + 60, JOY_Y0 - 60, 0, 0);
+    /* Half way between the dead zone and the edge: half linear, half square */
+    Scene_JoystickAt(JOY_X0 + 64 + ((2047 - JOY_X0 - 96) / 2), JOY_Y0 - 64 - ((JOY_Y0 - 96) / 2), 95, -95);
+    /* Full scale at the ends, and within 32 counts of them */
+    Scene_JoystickAt(2047, 0, 256, -256);
+    Scene_JoystickAt(0, 2047, -256, 256);
+    Scene_JoystickAt(2047 - 30, 30, 256, -256);
+}
+
+static const SCENE scenes[] =
+{
+    { "start",   Scene_Start   },
+    { "clear",   Scene_Clear   },
+    { "stars",   Scene_Stars   },
+    { "lines",   Scene_Lines   },
+    { "rects",   Scene_Rects   },
+    { "grid",    Scene_Grid    },
+    { "circles", Scene_Circles },
+    { "text",    Scene_Text    },
+    { "pacman",  Scene_Pacman  },
+    { "mouth",   Scene_Mouth   },
+    { "blast",   Scene_Blast   },
+    { "flash",   Scene_Flash   },
+    { "discs",   Scene_Discs   },
+    { "clear8",  Scene_Clear8  },
+    { "palette", Scene_Palette },
+    { "anim",    Scene_Anim    },
+    { "scroll",  Scene_Scroll  },
+    { "scan",    Scene_Scan    },
+    { "tiles",   Scene_Tiles   },
+    { "sprites", Scene_Sprites },
+    { "band",    Scene_Band    },
+    { "shadow",  Scene_Shadow  },
+    { "list",    Scene_List    },
+    { "clip",    Scene_Clip    },
+    { "rle",     Scene_Rle     },
+    { "loop",    Scene_Loop    },
+    { "tasks",   Scene_Tasks   },
+    { "timers",  Scene_Timers  },
+    { "buttons", Scene_Buttons },
+    { "joystick", Scene_Joystick },
+};
+
+
+/*******************************************************************************
+* Function Name: Scene_Compare
+********************************************************************************
+*
+* Summary:
+*  Compare two PPM snapshots.
+*
+* Return:
+*  Number of differing pixels, or -1 if the golden image cannot be read.
+*
+*******************************************************************************/
+static long Scene_Compare(const char *outPath, const char *goldPath)
+{
+    static uint8 a[PPM_LEN];
+    static uint8 b[PPM_LEN];
+    FILE *fa = fopen(outPath, "rb");
+    FILE *fb = fopen(goldPath, "rb");
+    size_t na = 0u;
+    size_t nb = 0u;
+    long diff = 0;
+    uint32 i;
+
+    if(fa != NULL)
+    {
+        na = fread(a, 1u, sizeof(a), fa);
+        fclose(fa);
+    }
+    if(fb != NULL)
+    {
+        nb = fread(b, 1u, sizeof(b), fb);
+        fclose(fb);
+    }
+    if((na != PPM_LEN) || (nb != PPM_LEN))
+    {
+        return -1;
+    }
+    for(i = PPM_HEADER_LEN; i < PPM_LEN; i += 3u)
+    {
+        if(memcmp(&a[i], &b[i], 3u) != 0)
+        {
+            diff++;
+        }
+    }
+    return diff;
+}
+
+int main(int argc, char **argv)
+{
+    const char *outDir = ".";
+    const char *goldDir = NULL;
+    uint32 bitRate = 0u;
+    char outPath[512];
+    char goldPath[512];
+    uint32 i;
+    int failures = 0;
+    long diff;
+
+    for(i = 1u; i < (uint32)argc; i++)
+    {
+        if((strcmp(argv[i], "-o") == 0) && ((i + 1u) < (uint32)argc))
+        {
+            outDir = argv[++i];
+        }
+        else if((strcmp(argv[i], "-g") == 0) && ((i + 1u) < (uint32)argc))
+        {
+            goldDir = argv[++i];
+        }
+        else if((strcmp(argv[i], "-r") == 0) && ((i + 1u) < (uint32)argc))
+        {
+            bitRate = (uint32)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [-o outdir] [-g goldendir] [-r bitrate]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    Emu_Init(GLCD_Controller, bitRate);
+
+    for(i = 0u; i < (sizeof(scenes) / sizeof(scenes[0])); i++)
+    {
+        if(i != 0u)
+        {
+            GLCD_Clear(GLCD_BLACK);
+        }
+        Emu_ResetStats();
+        GLCD_WindowCacheResetStats();
+        scenes[i].draw();
+        GLCD_Flush();
+        Emu_PrintStats(scenes[i].name);
+        printf("%-16s window cache: %u address commands skipped, %u sent\n", "",
+               GLCD_WindowCacheHits(), GLCD_WindowCacheMisses());
+        if(sceneErrors != 0u)
+        {
+            printf("%-16s FAILED: %u of its checks\n", scenes[i].name,
+                   (unsigned)sceneErrors);
+            failures++;
+            sceneErrors = 0u;
+        }
+
+        snprintf(outPath, sizeof(outPath), "%s/%s.ppm", outDir, scenes[i].name);
+        if(Emu_WritePpm(outPath) != 0)
+        {
+            fprintf(stderr, "cannot write %s\n", outPath);
+            return 2;
+        }
+
+        if(goldDir != NULL)
+        {
+            snprintf(goldPath, sizeof(goldPath), "%s/%s.ppm", goldDir, scenes[i].name);
+            diff = Scene_Compare(outPath, goldPath);
+            if(diff != 0)
+            {
+                printf("%-16s MISMATCH: %ld pixels differ from %s\n", scenes[i].name, diff, goldPath);
+                failures++;
+            }
+        }
+    }
+
+    return (failures == 0) ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,38 @@
+/*******************************************************************************
+* File Name: ADC.h
+*
+*  Description:
+*    Host stand-in for Pacmania's SAR ADC, enough to run the joystick code
+*    in its ADC_INT.c.  The scene sets what each channel reads.  A scan
+*    started through the start register ends at the next SysTick, which
+*    raises the ADC interrupt with the end of scan flag set.
+*
+*******************************************************************************/
+#if !defined(CY_ADC_SAR_SEQ_ADC_H)
+#define CY_ADC_SAR_SEQ_ADC_H
+
+#include "cytypes.h"
+#include "CyLib.h"
+
+#define ADC_IRQ_REMOVE          (0u)
+#define ADC_INTC_NUMBER         (4u)
+#define ADC_CHANNELS            (2u)
+
+#define ADC_FW_TRIGGER          (0x00000001Lu)
+#define ADC_EOS_MASK            (0x00000001Lu)
+
+extern reg32 Hal_adcStartCtrl;
+extern reg32 Hal_adcIntr;
+extern int16 Hal_adcInput[ADC_CHANNELS];
+
+#define ADC_SAR_START_CTRL_REG  (Hal_adcStartCtrl)
+#define ADC_SAR_INTR_REG        (Hal_adcIntr)
+
+void  ADC_Start(void);
+int16 ADC_GetResult16(uint32 chan);
+
+CY_ISR_PROTO( ADC_ISR );
+
+#endif /* CY_ADC_SAR_SEQ_ADC_H */
+
+/* [] END OF FILE */
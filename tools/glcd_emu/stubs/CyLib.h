@@ -0,0 +1,47 @@
+/*******************************************************************************
+* File Name: CyLib.h
+*
+*  Description:
+*    Host stand-in for the cy_boot system library.  Delays are recorded but
+*    do not sleep.  Interrupt vectors are recorded so the HAL can run
+*    the SPIM TX interrupt when its source is unmasked.  Time is simulated:
+*    delays move it on, and the SysTick callbacks run at each millisecond
+*    it passes once the SysTick timer has been started.
+*
+*******************************************************************************/
+#if !defined(CY_BOOT_CYLIB_H)
+#define CY_BOOT_CYLIB_H
+
+#include "cytypes.h"
+#include <string.h>
+
+void  CyDelay(uint32 milliseconds);
+void  CyDelayUs(uint16 microseconds);
+uint8 CyEnterCriticalSection(void);
+void  CyExitCriticalSection(uint8 savedIntrStatus);
+
+cyisraddress CyIntSetVector(uint8 number, cyisraddress address);
+void  CyIntEnable(uint8 number);
+void  CyIntDisable(uint8 number);
+
+typedef void (*cySysTickCallback)(void);
+
+#define CY_SYS_SYST_NUM_OF_CALLBACKS    (5u)
+
+void   CySysTickStart(void);
+uint32 CySysTickGetValue(void);
+uint32 CySysTickGetReload(void);
+cySysTickCallback CySysTickSetCallback(uint32 number, cySysTickCallback function);
+cySysTickCallback CySysTickGetCallback(uint32 number);
+
+/* Host only: let simulated time pass, running the SysTick callbacks, */
+/* and raise an interrupt, which runs its vector if it is enabled.    */
+void   Hal_Advance(uint32 microseconds);
+void   Hal_RaiseIrq(uint8 number);
+
+#define CyGlobalIntEnable   do { } while(0)
+#define CyGlobalIntDisable  do { } while(0)
+
+#endif /* CY_BOOT_CYLIB_H */
+
+/* [] END OF FILE */
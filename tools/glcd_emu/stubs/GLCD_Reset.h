@@ -0,0 +1,18 @@
+/*******************************************************************************
+* File Name: GLCD_Reset.h
+*
+*  Description:
+*    Host stand-in for the LCD reset pin.  Pulling it low resets the
+*    emulated controller.
+*
+*******************************************************************************/
+#if !defined(CY_PINS_GLCD_Reset_H)
+#define CY_PINS_GLCD_Reset_H
+
+#include "cytypes.h"
+
+void GLCD_Reset_Write(uint8 value);
+
+#endif /* CY_PINS_GLCD_Reset_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,39 @@
+/*******************************************************************************
+* File Name: GLCD_SPIM_SCB.h
+*
+*  Description:
+*    Host stand-in for the SCB SPI Master used by the GLCD component.
+*
+*******************************************************************************/
+#if !defined(CY_SCB_GLCD_SPIM_SCB_H)
+#define CY_SCB_GLCD_SPIM_SCB_H
+
+#include "cytypes.h"
+#include "cyfitter.h"
+#include "CyLib.h"
+
+#if !defined(EMU_TX_ISR)
+#define EMU_TX_ISR  0
+#endif
+#define GLCD_SPIM_SCB_REMOVE_SCB_IRQ    ((0 != EMU_TX_ISR) ? 0u : 1u)
+#define GLCD_SPIM_SCB_SCB_IRQ_INTERNAL  (0u == GLCD_SPIM_SCB_REMOVE_SCB_IRQ)
+
+#define GLCD_SPIM_SCB_FIFO_SIZE         (8u)
+#define GLCD_SPIM_SCB_INTR_TX_NOT_FULL  ((uint32) 0x01u)
+#define GLCD_SPIM_SCB_INTR_TX_EMPTY     ((uint32) 0x10u)
+
+/* The FIFO is drained into the emulator as fast as it is filled. */
+reg32 *Hal_ScbTxFifoWr(void);
+#define GLCD_SPIM_SCB_TX_FIFO_WR_REG        (*Hal_ScbTxFifoWr())
+#define GLCD_SPIM_SCB_GET_TX_FIFO_ENTRIES   (0u)
+
+void GLCD_SPIM_SCB_Start(void);
+void GLCD_SPIM_SCB_Stop(void);
+void GLCD_SPIM_SCB_SpiSetActiveSlaveSelect(uint32 slaveSelect);
+void GLCD_SPIM_SCB_SetCustomInterruptHandler(void (*func)(void));
+void GLCD_SPIM_SCB_SetTxInterruptMode(uint32 interruptMask);
+void GLCD_SPIM_SCB_ClearTxInterruptSource(uint32 interruptMask);
+
+#endif /* CY_SCB_GLCD_SPIM_SCB_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,20 @@
+/*******************************************************************************
+* File Name: GLCD_SPIM_SCB_SPI_UART.h
+*
+*  Description:
+*    Host stand-in for the SCB SPI/UART data API.
+*
+*******************************************************************************/
+#if !defined(CY_SCB_SPI_UART_GLCD_SPIM_SCB_H)
+#define CY_SCB_SPI_UART_GLCD_SPIM_SCB_H
+
+#include "GLCD_SPIM_SCB.h"
+
+void   GLCD_SPIM_SCB_SpiUartWriteTxData(uint32 txData);
+uint32 GLCD_SPIM_SCB_SpiUartGetTxBufferSize(void);
+
+#define GLCD_SPIM_SCB_SpiIsBusBusy()    (0u)
+
+#endif /* CY_SCB_SPI_UART_GLCD_SPIM_SCB_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,46 @@
+/*******************************************************************************
+* File Name: GLCD_SPIM_UDB.h
+*
+*  Description:
+*    Host stand-in for the UDB SPI Master used by the GLCD component.  Words
+*    written to the TX FIFO go straight to the emulated controller, so the
+*    status register always reads back done and idle, and the TX interrupt
+*    runs as soon as its source is unmasked.
+*
+*******************************************************************************/
+#if !defined(CY_SPIM_GLCD_SPIM_UDB_H)
+#define CY_SPIM_GLCD_SPIM_UDB_H
+
+#include "cytypes.h"
+#include "cyfitter.h"
+#include "CyLib.h"
+
+#define GLCD_SPIM_UDB_DATA_WIDTH                 (9u)
+#define GLCD_SPIM_UDB_FIFO_SIZE                  (4u)
+
+/* Build with -DEMU_TX_ISR=1 to model a SPIM with its TX interrupt placed. */
+#if !defined(EMU_TX_ISR)
+#define EMU_TX_ISR  0
+#endif
+#define GLCD_SPIM_UDB_INTERNAL_TX_INT_ENABLED    (EMU_TX_ISR)
+#define GLCD_SPIM_UDB_TX_ISR_NUMBER     ((uint8) (GLCD_SPIM_UDB_TxInternalInterrupt__INTC_NUMBER))
+#define GLCD_SPIM_UDB_TX_ISR_PRIORITY   ((uint8) (GLCD_SPIM_UDB_TxInternalInterrupt__INTC_PRIOR_NUM))
+
+extern reg16 Hal_udbTxData;
+#define GLCD_SPIM_UDB_TXDATA_PTR        (&Hal_udbTxData)
+
+#define GLCD_SPIM_UDB_STS_SPI_DONE           ((uint8) 0x01u)
+#define GLCD_SPIM_UDB_STS_TX_FIFO_EMPTY      ((uint8) 0x02u)
+#define GLCD_SPIM_UDB_STS_TX_FIFO_NOT_FULL   ((uint8) 0x04u)
+#define GLCD_SPIM_UDB_STS_BYTE_COMPLETE      ((uint8) 0x08u)
+#define GLCD_SPIM_UDB_STS_SPI_IDLE           ((uint8) 0x10u)
+
+void  GLCD_SPIM_UDB_Start(void);
+void  GLCD_SPIM_UDB_Stop(void);
+uint8 GLCD_SPIM_UDB_ReadTxStatus(void);
+void  GLCD_SPIM_UDB_WriteTxData(uint16 txData);
+void  GLCD_SPIM_UDB_SetTxInterruptMode(uint8 intSrc);
+
+#endif /* CY_SPIM_GLCD_SPIM_UDB_H */
+
+/* [] END OF FILE */
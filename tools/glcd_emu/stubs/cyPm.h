@@ -0,0 +1,18 @@
+/*******************************************************************************
+* File Name: cyPm.h
+*
+*  Description:
+*    Host stand-in for the cy_boot power management API.  Sleep lasts until
+*    the next SysTick interrupt.
+*
+*******************************************************************************/
+#if !defined(CY_BOOT_CYPM_H)
+#define CY_BOOT_CYPM_H
+
+#include "cytypes.h"
+
+void CySysPmSleep(void);
+
+#endif /* CY_BOOT_CYPM_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,17 @@
+/*******************************************************************************
+* File Name: cyfitter.h
+*
+*  Description:
+*    Host stand-in for the fitter output.  Nothing is placed on a PC.
+*
+*******************************************************************************/
+#if !defined(INCLUDED_CYFITTER_H)
+#define INCLUDED_CYFITTER_H
+
+/* Interrupt numbers, used only when EMU_TX_ISR builds the TX interrupt in. */
+#define GLCD_SPIM_UDB_TxInternalInterrupt__INTC_NUMBER      1u
+#define GLCD_SPIM_UDB_TxInternalInterrupt__INTC_PRIOR_NUM   3u
+
+#endif /* INCLUDED_CYFITTER_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,43 @@
+/*******************************************************************************
+* File Name: cytypes.h
+*
+*  Description:
+*    Host stand-in for the PSoC Creator type definitions, enough to compile
+*    the GLCD component API with a native compiler.
+*
+*******************************************************************************/
+#if !defined(CY_BOOT_CYTYPES_H)
+#define CY_BOOT_CYTYPES_H
+
+#include <stdint.h>
+
+typedef uint8_t   uint8;
+typedef uint16_t  uint16;
+typedef uint32_t  uint32;
+typedef int8_t    int8;
+typedef int16_t   int16;
+typedef int32_t   int32;
+typedef float     float32;
+typedef double    float64;
+typedef int64_t   int64;
+typedef uint64_t  uint64;
+typedef char      char8;
+
+typedef volatile uint8  reg8;
+typedef volatile uint16 reg16;
+typedef volatile uint32 reg32;
+
+typedef void (* cyisraddress)(void);
+
+#define CYCODE
+#define CY_INLINE               inline
+#define CY_ISR(FuncName)        void FuncName (void)
+#define CY_ISR_PROTO(FuncName)  void FuncName (void)
+
+/* Register writes go through the HAL so the emulated TX FIFOs can see them. */
+void Hal_SetReg16(reg16 *addr, uint16 value);
+#define CY_SET_REG16(addr, value)   Hal_SetReg16((reg16 *)(addr), (uint16)(value))
+
+#endif /* CY_BOOT_CYTYPES_H */
+
+/* [] END OF FILE */